@@ -0,0 +1,144 @@
+// Аллокаторы движка против общей кучи: кадровая арена на мелких временных выделениях,
+// пул на оттоке объектов одного размера, пересоздание сущностей ECS и цена учёта памяти
+#include "benchmarkutils.h"
+#include "Core/linearallocator.h"
+#include "Core/memorytracker.h"
+#include "Core/poolallocator.h"
+#include "Scene/components.h"
+#include "Scene/ecs.h"
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using core::MemoryTag;
+using core::MemoryTracker;
+
+struct Particle {
+    float position[3];
+    float velocity[3];
+    float life;
+    uint32_t color;
+};
+
+static volatile uintptr_t sink = 0;
+
+int main() {
+    QElapsedTimer timer;
+
+    // Кадр: 20 000 выделений случайного размера 16..256 байт, в конце кадра всё освобождается
+    const int frames = 200;
+    const int allocationsPerFrame = 20000;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> sizeDistribution(16, 256);
+    std::vector<size_t> sizes(allocationsPerFrame);
+    for (size_t &size : sizes)
+        size = sizeDistribution(random);
+    std::vector<void *> pointers(allocationsPerFrame);
+
+    timer.start();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < allocationsPerFrame; ++i) {
+            pointers[size_t(i)] = ::operator new(sizes[size_t(i)]);
+            std::memset(pointers[size_t(i)], 0, 16);
+        }
+        for (void *pointer : pointers)
+            ::operator delete(pointer);
+    }
+    const qint64 heapFrames = timer.nsecsElapsed();
+    Benchmark::report("frame temporaries, new/delete", heapFrames,
+                      QString("%1 ns/alloc").arg(double(heapFrames) / (frames * allocationsPerFrame), 0, 'f', 2));
+
+    core::FrameArena frameArena(MemoryTag::General);
+    timer.restart();
+    for (int frame = 0; frame < frames; ++frame) {
+        frameArena.beginFrame();
+        core::LinearArena &arena = frameArena.current();
+        for (int i = 0; i < allocationsPerFrame; ++i) {
+            pointers[size_t(i)] = arena.allocate(sizes[size_t(i)]);
+            std::memset(pointers[size_t(i)], 0, 16);
+        }
+    }
+    const qint64 arenaFrames = timer.nsecsElapsed();
+    Benchmark::report("frame temporaries, FrameArena", arenaFrames,
+                      QString("%1 ns/alloc, %2x, capacity %3 KB")
+                          .arg(double(arenaFrames) / (frames * allocationsPerFrame), 0, 'f', 2)
+                          .arg(double(heapFrames) / double(arenaFrames), 0, 'f', 1)
+                          .arg(frameArena.current().capacity() / 1024));
+
+    // Отток: держим 100 000 живых объектов и заменяем случайные по одному
+    const size_t liveCount = 100000;
+    const size_t replacements = 5000000;
+    std::vector<size_t> victims(replacements);
+    std::uniform_int_distribution<size_t> victimDistribution(0, liveCount - 1);
+    for (size_t &victim : victims)
+        victim = victimDistribution(random);
+
+    std::vector<Particle *> particles(liveCount);
+    timer.restart();
+    for (Particle *&particle : particles)
+        particle = new Particle();
+    for (size_t victim : victims) {
+        delete particles[victim];
+        particles[victim] = new Particle();
+    }
+    for (Particle *particle : particles)
+        delete particle;
+    const qint64 heapChurn = timer.nsecsElapsed();
+    Benchmark::report("object churn, new/delete", heapChurn,
+                      QString("%1 ns/replace").arg(double(heapChurn) / replacements, 0, 'f', 2));
+
+    {
+        core::ObjectPool<Particle> pool(4096, MemoryTag::General);
+        timer.restart();
+        for (Particle *&particle : particles)
+            particle = pool.create();
+        for (size_t victim : victims) {
+            pool.destroy(particles[victim]);
+            particles[victim] = pool.create();
+        }
+        for (Particle *particle : particles)
+            pool.destroy(particle);
+        const qint64 poolChurn = timer.nsecsElapsed();
+        Benchmark::report("object churn, ObjectPool", poolChurn,
+                          QString("%1 ns/replace, %2x")
+                              .arg(double(poolChurn) / replacements, 0, 'f', 2)
+                              .arg(double(heapChurn) / double(poolChurn), 0, 'f', 1));
+    }
+
+    // ECS: пересоздание сущностей заставляет чанки то освобождаться, то выделяться снова
+    {
+        ecs::World world;
+        std::vector<ecs::Entity> entities;
+        const int rounds = 20;
+        timer.restart();
+        for (int round = 0; round < rounds; ++round) {
+            entities.clear();
+            world.createBatch(100000, entities, Transform());
+            world.destroyBatch(entities);
+        }
+        const qint64 ecsChurn = timer.nsecsElapsed();
+        const MemoryTracker::TagStatistics scene = MemoryTracker::statistics(MemoryTag::Scene);
+        Benchmark::report("ECS create/destroy 100k x20", ecsChurn,
+                          QString("%1 ns/entity, Scene peak %2 KB, %3 heap blocks")
+                              .arg(double(ecsChurn) / (rounds * 100000), 0, 'f', 2)
+                              .arg(scene.peakBytes / 1024)
+                              .arg(scene.allocations));
+    }
+
+    // Цена учёта: пара allocated/freed на каждый блок, взятый у кучи
+    const int trackerCalls = 10000000;
+    timer.restart();
+    for (int i = 0; i < trackerCalls; ++i) {
+        MemoryTracker::allocated(MemoryTag::General, 64);
+        MemoryTracker::freed(MemoryTag::General, 64);
+    }
+    const qint64 tracking = timer.nsecsElapsed();
+    Benchmark::report("tracker allocated+freed x10M", tracking,
+                      QString("%1 ns/pair").arg(double(tracking) / trackerCalls, 0, 'f', 2));
+
+    sink = uintptr_t(pointers[0]);
+    std::printf("\nTracked at exit: %lld bytes, resident %.1f MB\n", static_cast<long long>(MemoryTracker::totalBytes()),
+                Benchmark::residentMemoryMB());
+    return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <cstdio>
+
+// Общие помощники для бенчмарков
+namespace Benchmark {
+
+inline void report(const char *name, qint64 nanoseconds, const QString &extra = QString()) {
+    std::printf("%-40s %12.3f ms  %s\n", name, nanoseconds / 1e6, qPrintable(extra));
+    std::fflush(stdout);
+}
+
+// Резидентная память процесса в мегабайтах (Linux), -1 если недоступно
+inline double residentMemoryMB() {
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1.0;
+    QTextStream stream(&statm);
+    qint64 size = 0, resident = 0;
+    stream >> size >> resident;
+    return resident * 4096.0 / (1024.0 * 1024.0);
+}
+
+} // namespace Benchmark
+
+#endif // BENCHMARKUTILS_H
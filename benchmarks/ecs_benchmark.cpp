@@ -0,0 +1,74 @@
+// Обход, добавление/удаление компонентов и пересоздание сущностей на 1M сущностей
+#include "benchmarkutils.h"
+#include "Scene/components.h"
+#include "Scene/ecs.h"
+
+struct Velocity {
+    float value[3] = {1.0f, 0.5f, 0.25f};
+};
+
+int main() {
+    const size_t entityCount = 1000000;
+    QElapsedTimer timer;
+    ecs::World world;
+    std::vector<ecs::Entity> entities;
+
+    timer.start();
+    world.createBatch(entityCount, entities, Transform(), Velocity());
+    Benchmark::report("create 1M (Transform, Velocity)", timer.nsecsElapsed());
+
+    // Обход по чанкам: столбцы непрерывны, цикл векторизуется компилятором
+    const int iterations = 20;
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        world.eachChunk<Transform, Velocity>([](size_t count, ecs::Entity *, Transform *transforms, Velocity *velocities) {
+            for (size_t row = 0; row < count; ++row) {
+                transforms[row].position[0] += velocities[row].value[0] * 0.016f;
+                transforms[row].position[1] += velocities[row].value[1] * 0.016f;
+                transforms[row].position[2] += velocities[row].value[2] * 0.016f;
+            }
+        });
+    }
+    qint64 iterateTime = timer.nsecsElapsed() / iterations;
+    Benchmark::report("iterate 1M (per pass)", iterateTime,
+                      QString("%1 ns/entity").arg(double(iterateTime) / entityCount, 0, 'f', 2));
+
+    timer.restart();
+    world.each<Transform>([](Transform &transform) { transform.scale[0] *= 1.0001f; });
+    Benchmark::report("iterate 1M single component", timer.nsecsElapsed());
+
+    timer.restart();
+    world.removeBatch<Velocity>(entities);
+    Benchmark::report("remove component x1M", timer.nsecsElapsed());
+
+    timer.restart();
+    world.addBatch<Velocity>(entities);
+    Benchmark::report("add component x1M", timer.nsecsElapsed());
+
+    // Отложенные изменения через CommandBuffer
+    ecs::CommandBuffer commands;
+    for (size_t i = 0; i < entities.size(); i += 2)
+        commands.remove<Velocity>(entities[i]);
+    timer.restart();
+    world.apply(commands);
+    Benchmark::report("apply 500k deferred removes", timer.nsecsElapsed());
+
+    // Пересоздание: уничтожаем и создаём все сущности заново несколько раз
+    const int churnRounds = 5;
+    timer.restart();
+    for (int round = 0; round < churnRounds; ++round) {
+        world.destroyBatch(entities);
+        entities.clear();
+        world.createBatch(entityCount, entities, Transform(), Velocity());
+    }
+    Benchmark::report("churn destroy+create 1M (per round)", timer.nsecsElapsed() / churnRounds,
+                      QString("%1 alive").arg(world.entityCount()));
+
+    // Случайный доступ по дескрипторам
+    timer.restart();
+    float sum = 0.0f;
+    for (size_t i = 0; i < entities.size(); i += 7)
+        sum += world.get<Transform>(entities[(i * 2654435761u) % entities.size()])->position[0];
+    Benchmark::report("random get<Transform> x143k", timer.nsecsElapsed(), QString("checksum %1").arg(sum));
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Заполнение, раскрытие и прокрутка дерева иерархии на 1M узлов
+#include "benchmarkutils.h"
+#include "UI/scenehierarchymodel.h"
+#include <QApplication>
+#include <QScrollBar>
+#include <QTreeView>
+
+static void runScenario(const char *title, int topLevel, int childrenPerNode) {
+    std::printf("--- %s: %d x %d\n", title, topLevel, childrenPerNode);
+    QElapsedTimer timer;
+
+    Scene scene;
+    SceneGraph &graph = scene.graph();
+    timer.start();
+    graph.reserve(topLevel + topLevel * childrenPerNode);
+    std::vector<SceneGraph::NodeId> roots = scene.createObjects(SceneGraph::RootNode, topLevel, "Object");
+    for (SceneGraph::NodeId root : roots) {
+        scene.createObjects(root, childrenPerNode, "Child");
+    }
+    Benchmark::report("populate graph", timer.nsecsElapsed(),
+                      QString("%1 nodes, RSS %2 MB").arg(graph.nodeCount()).arg(Benchmark::residentMemoryMB(), 0, 'f', 1));
+
+    SceneHierarchyModel model(&scene);
+    QTreeView view;
+    view.setUniformRowHeights(true);
+    view.setHeaderHidden(true);
+    view.resize(400, 800);
+
+    timer.restart();
+    view.setModel(&model);
+    view.show();
+    QApplication::processEvents();
+    Benchmark::report("attach model + first paint", timer.nsecsElapsed());
+
+    // Подгружаем все строки верхнего уровня и раскрываем каждую
+    timer.restart();
+    while (model.canFetchMore(QModelIndex()))
+        model.fetchMore(QModelIndex());
+    for (int row = 0; row < model.rowCount(); ++row)
+        view.expand(model.index(row, 0));
+    QApplication::processEvents();
+    Benchmark::report("expand all top-level", timer.nsecsElapsed(),
+                      QString("RSS %1 MB").arg(Benchmark::residentMemoryMB(), 0, 'f', 1));
+
+    // Прокрутка сверху вниз: каждая остановка — отрисовка и, при необходимости, fetchMore
+    const int steps = 200;
+    timer.restart();
+    for (int step = 0; step <= steps; ++step) {
+        QScrollBar *bar = view.verticalScrollBar();
+        bar->setValue(bar->maximum() * step / steps);
+        view.viewport()->repaint();
+        QApplication::processEvents();
+    }
+    qint64 scrollTime = timer.nsecsElapsed();
+    Benchmark::report("scroll top to bottom", scrollTime,
+                      QString("%1 ms/step").arg(scrollTime / 1e6 / (steps + 1), 0, 'f', 3));
+
+    // Пакетное удаление половины объектов верхнего уровня
+    std::vector<SceneGraph::NodeId> doomed(roots.begin(), roots.begin() + roots.size() / 2);
+    timer.restart();
+    model.removeNodes(doomed);
+    QApplication::processEvents();
+    Benchmark::report("batch remove half", timer.nsecsElapsed(), QString("%1 nodes left").arg(graph.nodeCount()));
+}
+
+int main(int argc, char *argv[]) {
+    QApplication app(argc, argv);
+    runScenario("flat", 1000000, 0);
+    runScenario("nested", 1000, 1000);
+    return 0;
+}
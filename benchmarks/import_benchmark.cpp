@@ -0,0 +1,121 @@
+// «Add to Project» на 10 000 файлов: холодный импорт, повторный импорт в том же проекте
+// и импорт в новую рабочую копию с уже заполненным кэшем приготовленных ассетов
+#include "benchmarkutils.h"
+#include "Assets/assetimport.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QImage>
+#include <QTemporaryDir>
+#include <random>
+
+namespace {
+
+const int FileCount = 10000;
+
+// Треть — уникальные PNG 64×64, треть — небольшие OBJ, остальное — текст
+QStringList generateSources(const QString &directory, qint64 *totalBytes) {
+    std::mt19937 rng(7);
+    QStringList files;
+    *totalBytes = 0;
+    for (int i = 0; i < FileCount; ++i) {
+        QByteArray data;
+        QString name;
+        if (i % 3 == 0) {
+            QImage image(64, 64, QImage::Format_RGBA8888);
+            image.fill(QColor::fromRgb(rng()));
+            for (int p = 0; p < 64; ++p)
+                image.setPixel(int(rng() % 64), int(rng() % 64), rng());
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::WriteOnly);
+            image.save(&buffer, "PNG");
+            name = QString("texture_%1.png").arg(i);
+        } else if (i % 3 == 1) {
+            // Сетка 8×8 квадов со случайными высотами
+            for (int y = 0; y <= 8; ++y)
+                for (int x = 0; x <= 8; ++x)
+                    data += QString("v %1 %2 %3\n").arg(x).arg((rng() % 1000) / 1000.0).arg(y).toUtf8();
+            for (int y = 0; y < 8; ++y)
+                for (int x = 0; x < 8; ++x) {
+                    const int v = y * 9 + x + 1;
+                    data += QString("f %1 %2 %3 %4\n").arg(v).arg(v + 1).arg(v + 10).arg(v + 9).toUtf8();
+                }
+            name = QString("mesh_%1.obj").arg(i);
+        } else {
+            data = QString("asset %1 seed %2\n").arg(i).arg(rng()).toUtf8().repeated(8);
+            name = QString("notes_%1.txt").arg(i);
+        }
+        QFile file(directory + '/' + name);
+        file.open(QIODevice::WriteOnly);
+        file.write(data);
+        files << file.fileName();
+        *totalBytes += data.size();
+    }
+    return files;
+}
+
+void runImport(const char *name, const QString &cacheDirectory, const QStringList &files, const QString &project,
+               qint64 totalBytes) {
+    QDir().mkpath(project);
+    AssetImportPipeline pipeline(cacheDirectory);
+    QEventLoop loop;
+    QVector<ImportResult> results;
+    qint64 elapsed = 0;
+    QObject::connect(&pipeline, &AssetImportPipeline::finished, &loop,
+                     [&](const QVector<ImportResult> &finished, qint64 milliseconds) {
+                         results = finished;
+                         elapsed = milliseconds;
+                         loop.quit();
+                     });
+    QElapsedTimer timer;
+    timer.start();
+    pipeline.import(files, project);
+    if (pipeline.isRunning())
+        loop.exec();
+    const qint64 nanoseconds = timer.nsecsElapsed();
+
+    int cached = 0, failed = 0;
+    for (const ImportResult &result : results) {
+        cached += result.cached;
+        failed += !result.ok;
+    }
+    const double seconds = qMax<qint64>(nanoseconds, 1) / 1e9;
+    Benchmark::report(name, nanoseconds,
+                      QString("%1 files/s, %2 MB/s, %3 from cache, %4 failed (pipeline %5 ms)")
+                          .arg(results.size() / seconds, 0, 'f', 0)
+                          .arg(totalBytes / seconds / (1024.0 * 1024.0), 0, 'f', 1)
+                          .arg(cached)
+                          .arg(failed)
+                          .arg(elapsed));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTemporaryDir workspace;
+    const QString sources = workspace.filePath("sources");
+    const QString cache = workspace.filePath("cache");
+    QDir().mkpath(sources);
+
+    qint64 totalBytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    const QStringList files = generateSources(sources, &totalBytes);
+    Benchmark::report("generate sources", timer.nsecsElapsed(),
+                      QString("%1 files, %2 MB").arg(files.size()).arg(totalBytes / (1024.0 * 1024.0), 0, 'f', 1));
+
+    // Исходники вне проекта: первый импорт копирует их в assets/
+    runImport("cold import", cache, files, workspace.filePath("project"), totalBytes);
+
+    // Повторный импорт тех же файлов, уже лежащих в проекте, — только stat и манифест
+    QStringList projectFiles;
+    for (const QString &file : files)
+        projectFiles << workspace.filePath("project/assets/") + QFileInfo(file).fileName();
+    runImport("reimport unchanged", cache, projectFiles, workspace.filePath("project"), totalBytes);
+
+    // Другая рабочая копия без манифеста с тем же кэшем: файлы читаются и хэшируются, но не готовятся
+    runImport("fresh checkout, shared cache", cache, files, workspace.filePath("checkout"), totalBytes);
+    return 0;
+}
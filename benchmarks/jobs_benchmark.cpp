@@ -0,0 +1,86 @@
+// Планировщик задач: масштабирование от 1 до N потоков на трёх видах нагрузки.
+// Максимальное число потоков задаётся аргументом (по умолчанию — число ядер)
+#include "benchmarkutils.h"
+#include "Core/jobsystem.h"
+#include <QThread>
+#include <cmath>
+#include <vector>
+
+using core::JobHandle;
+using core::JobSystem;
+
+// Крупные независимые куски: parallelFor по массиву с заметной работой на элемент
+static double computeBound(JobSystem &jobs, std::vector<float> &data) {
+    jobs.parallelFor(0, data.size(), 16384, [&data](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            data[i] = std::sqrt(std::sin(data[i]) * std::sin(data[i]) + 1.0f);
+    });
+    double sum = 0.0;
+    for (float value : data)
+        sum += value;
+    return sum;
+}
+
+static long serialFibonacci(int n) {
+    return n < 2 ? n : serialFibonacci(n - 1) + serialFibonacci(n - 2);
+}
+
+// Мелкие вложенные задачи: рекурсивное дерево с ожиданием дочерних, листья считаются последовательно
+static long fibonacci(JobSystem &jobs, int n) {
+    if (n < 20)
+        return serialFibonacci(n);
+    long left = 0;
+    JobHandle child = jobs.run([&jobs, &left, n]() { left = fibonacci(jobs, n - 1); });
+    const long right = fibonacci(jobs, n - 2);
+    jobs.wait(child);
+    return left + right;
+}
+
+int main(int argc, char **argv) {
+    const int maxThreads = argc > 1 ? QString(argv[1]).toInt() : QThread::idealThreadCount();
+    const int emptyJobs = 1000000;
+    std::vector<float> data(size_t(16) * 1024 * 1024);
+    qint64 baseline[3] = {0, 0, 0};
+
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        JobSystem jobs(threads - 1); // Вызывающий поток работает наравне с рабочими
+        QElapsedTimer timer;
+
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = float(i % 1000) * 0.001f;
+        timer.start();
+        const double sum = computeBound(jobs, data);
+        const qint64 compute = timer.nsecsElapsed();
+
+        timer.restart();
+        const long fib = fibonacci(jobs, 34);
+        const qint64 nested = timer.nsecsElapsed();
+
+        // Пустые задачи из одной родительской: накладные расходы на создание, кражу и завершение
+        std::atomic<int> executed(0);
+        timer.restart();
+        JobHandle root = jobs.run([&jobs, &executed, emptyJobs]() {
+            for (int i = 0; i < emptyJobs; ++i)
+                jobs.runChild([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+        });
+        jobs.wait(root);
+        const qint64 overhead = timer.nsecsElapsed();
+
+        if (threads == 1) {
+            baseline[0] = compute;
+            baseline[1] = nested;
+            baseline[2] = overhead;
+        }
+        std::printf("--- %d thread(s)\n", threads);
+        Benchmark::report("parallelFor 16M elements", compute,
+                          QString("x%1, checksum %2").arg(double(baseline[0]) / compute, 0, 'f', 2).arg(sum, 0, 'g', 10));
+        Benchmark::report("nested jobs fib(34)", nested,
+                          QString("x%1, result %2").arg(double(baseline[1]) / nested, 0, 'f', 2).arg(fib));
+        Benchmark::report("1M empty child jobs", overhead,
+                          QString("x%1, %2 ns/job, executed %3")
+                              .arg(double(baseline[2]) / overhead, 0, 'f', 2)
+                              .arg(double(overhead) / emptyJobs, 0, 'f', 1)
+                              .arg(executed.load()));
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Загрузка OBJ на несколько миллионов треугольников: ObjLoader (mmap, свой разбор чисел,
+// параллельные куски) против типичного разбора через std::ifstream и потоки строк
+#include "benchmarkutils.h"
+#include "Assets/objloader.h"
+#include "Core/jobsystem.h"
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Рельеф size×size квадов: позиции, текстурные координаты, нормали, грани v/vt/vn
+void writeTerrain(const QString &path, int size) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> height(0.0f, 4.0f);
+    std::FILE *file = std::fopen(qPrintable(path), "wb");
+    std::fprintf(file, "# terrain %dx%d\no terrain\n", size, size);
+    for (int y = 0; y <= size; ++y)
+        for (int x = 0; x <= size; ++x)
+            std::fprintf(file, "v %.6f %.6f %.6f\n", x * 0.5f, height(rng), y * 0.5f);
+    for (int y = 0; y <= size; ++y)
+        for (int x = 0; x <= size; ++x)
+            std::fprintf(file, "vt %.6f %.6f\n", float(x) / size, float(y) / size);
+    for (int y = 0; y <= size; ++y)
+        for (int x = 0; x <= size; ++x)
+            std::fprintf(file, "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f);
+    std::fprintf(file, "usemtl ground\ns 1\n");
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x) {
+            const int a = y * (size + 1) + x + 1, b = a + 1, c = a + size + 2, d = a + size + 1;
+            std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+        }
+    std::fclose(file);
+}
+
+// Так OBJ обычно читают «по учебнику»: строка, istringstream, словарь углов
+bool loadNaive(const QString &path, MeshData *mesh) {
+    std::ifstream input(path.toStdString());
+    if (!input)
+        return false;
+    std::vector<float> positions, texCoords, normals;
+    std::unordered_map<std::string, uint32_t> cornerToVertex;
+    mesh->vertices.clear();
+    mesh->indices.clear();
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+        if (type == "v" || type == "vn") {
+            float x, y, z;
+            stream >> x >> y >> z;
+            std::vector<float> &target = type == "v" ? positions : normals;
+            target.insert(target.end(), {x, y, z});
+        } else if (type == "vt") {
+            float u, v;
+            stream >> u >> v;
+            texCoords.insert(texCoords.end(), {u, v});
+        } else if (type == "f") {
+            std::vector<uint32_t> face;
+            std::string corner;
+            while (stream >> corner) {
+                auto found = cornerToVertex.find(corner);
+                if (found == cornerToVertex.end()) {
+                    int v = 0, vt = 0, vn = 0;
+                    std::sscanf(corner.c_str(), "%d/%d/%d", &v, &vt, &vn);
+                    MeshVertex vertex = {};
+                    std::copy_n(&positions[size_t(v - 1) * 3], 3, vertex.position);
+                    if (vt)
+                        std::copy_n(&texCoords[size_t(vt - 1) * 2], 2, vertex.texCoord);
+                    if (vn)
+                        std::copy_n(&normals[size_t(vn - 1) * 3], 3, vertex.normal);
+                    found = cornerToVertex.emplace(corner, uint32_t(mesh->vertices.size())).first;
+                    mesh->vertices.push_back(vertex);
+                }
+                face.push_back(found->second);
+            }
+            for (size_t i = 2; i < face.size(); ++i)
+                mesh->indices.insert(mesh->indices.end(), {face[0], face[i - 1], face[i]});
+        }
+    }
+    return true;
+}
+
+template<typename Load>
+void measure(const char *name, const QString &path, Load load) {
+    const double megabytes = QFileInfo(path).size() / (1024.0 * 1024.0);
+    MeshData mesh;
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = load(path, &mesh);
+    const qint64 nanoseconds = timer.nsecsElapsed();
+    Benchmark::report(name, nanoseconds,
+                      QString("%1 MB/s, %2 vertices, %3 triangles%4")
+                          .arg(megabytes / (nanoseconds / 1e9), 0, 'f', 1)
+                          .arg(mesh.vertices.size())
+                          .arg(mesh.triangleCount())
+                          .arg(ok ? "" : ", FAILED"));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    // Размер сетки можно задать аргументом; по умолчанию 1 000×1 000 и 1 500×1 500 квадов (2 и 4.5 млн треугольников)
+    std::vector<int> sizes = {1000, 1500};
+    if (argc > 1)
+        sizes = {std::atoi(argv[1])};
+    QTemporaryDir directory;
+    for (int size : sizes) {
+        const QString path = directory.filePath(QString("terrain_%1.obj").arg(size));
+        writeTerrain(path, size);
+        std::printf("\n%s: %.1f MB\n", qPrintable(QFileInfo(path).fileName()), QFileInfo(path).size() / (1024.0 * 1024.0));
+        // Первое чтение прогревает страничный кэш, чтобы все варианты читали из памяти
+        measure("ifstream + istringstream", path, loadNaive);
+        measure("ObjLoader, 1 thread", path, [](const QString &file, MeshData *mesh) {
+            return ObjLoader::load(file, mesh, nullptr, 1);
+        });
+        measure("ObjLoader, all threads", path, [](const QString &file, MeshData *mesh) {
+            return ObjLoader::load(file, mesh);
+        });
+    }
+    std::printf("\nthreads: %d\n", core::JobSystem::instance().concurrency());
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Запуск игры: чтение всех ресурсов из files/ россыпью против чтения из game.pak.
+// Оба варианта меряются на прогретом кэше страниц — разница в системных вызовах и распаковке, а не в диске
+#include "benchmarkutils.h"
+#include "Core/packarchive.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include <random>
+
+namespace {
+
+const int FileCount = 5000;
+
+// Как в типичном проекте: мелкие тексты и конфиги, средние бинарные данные и уже сжатые картинки
+qint64 generateFiles(const QString &directory) {
+    std::mt19937 rng(21);
+    qint64 totalBytes = 0;
+    for (int i = 0; i < FileCount; ++i) {
+        const QString subdirectory = directory + QString("/group_%1").arg(i % 50);
+        QDir().mkpath(subdirectory);
+        QByteArray data;
+        QString name;
+        if (i % 4 == 0) {
+            // Случайные байты несжимаемы, как у PNG и OGG
+            data.resize(int(16 * 1024 + rng() % (48 * 1024)));
+            for (char &c : data)
+                c = char(rng());
+            name = QString("sprite_%1.png").arg(i);
+        } else if (i % 4 == 1) {
+            for (int v = 0; v < 2000; ++v)
+                data += QString("v %1 %2 %3\n").arg(v % 97).arg((rng() % 1000) / 1000.0).arg(v / 97).toUtf8();
+            name = QString("mesh_%1.obj").arg(i);
+        } else {
+            data = QString("{\"id\": %1, \"seed\": %2, \"enabled\": true}\n").arg(i).arg(rng()).toUtf8().repeated(
+                int(4 + rng() % 60));
+            name = QString("entity_%1.json").arg(i);
+        }
+        QFile file(subdirectory + '/' + name);
+        file.open(QIODevice::WriteOnly);
+        file.write(data);
+        totalBytes += data.size();
+    }
+    return totalBytes;
+}
+
+void reportRead(const char *name, qint64 nanoseconds, int files, qint64 bytes) {
+    const double seconds = qMax<qint64>(nanoseconds, 1) / 1e9;
+    Benchmark::report(name, nanoseconds,
+                      QString("%1 files/s, %2 MB/s")
+                          .arg(files / seconds, 0, 'f', 0)
+                          .arg(bytes / seconds / (1024.0 * 1024.0), 0, 'f', 1));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTemporaryDir workspace;
+    const QString files = workspace.filePath("files");
+    const QString archive = workspace.filePath("game.pak");
+
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 totalBytes = generateFiles(files);
+    Benchmark::report("generate files", timer.nsecsElapsed(),
+                      QString("%1 files, %2 MB").arg(FileCount).arg(totalBytes / (1024.0 * 1024.0), 0, 'f', 1));
+
+    core::PackWriter::Statistics stats;
+    QString error;
+    timer.restart();
+    if (!core::PackWriter::pack(files, archive, &stats, &error)) {
+        std::printf("pack failed: %s\n", qPrintable(error));
+        return 1;
+    }
+    Benchmark::report("pack", timer.nsecsElapsed(),
+                      QString("%1 MB -> %2 MB")
+                          .arg(stats.inputBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                          .arg(stats.archiveBytes / (1024.0 * 1024.0), 0, 'f', 1));
+    timer.restart();
+    core::PackWriter::pack(files, archive, &stats);
+    Benchmark::report("pack unchanged", timer.nsecsElapsed(), stats.upToDate ? "up to date" : "rewritten");
+
+    // Россыпь: обход каталога, затем open + readAll на каждый файл
+    timer.restart();
+    int looseFiles = 0;
+    qint64 looseBytes = 0;
+    QDirIterator it(files, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QFile file(it.next());
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        looseBytes += file.readAll().size();
+        ++looseFiles;
+    }
+    reportRead("startup, loose files", timer.nsecsElapsed(), looseFiles, looseBytes);
+
+    // Архив: одно отображение и параллельное чтение всех записей
+    timer.restart();
+    core::PackArchive pack;
+    if (!pack.open(archive, &error)) {
+        std::printf("open failed: %s\n", qPrintable(error));
+        return 1;
+    }
+    QVector<int> indices(pack.count());
+    for (int i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+    qint64 packBytes = 0;
+    for (const QByteArray &data : pack.readMany(indices))
+        packBytes += data.size();
+    reportRead("startup, pack", timer.nsecsElapsed(), pack.count(), packBytes);
+
+    // Поиск по пути: то, чем игра пользуется после запуска
+    timer.restart();
+    int found = 0;
+    for (int i = 0; i < pack.count(); ++i)
+        found += pack.indexOf(pack.name(i)) == i;
+    Benchmark::report("lookup by path", timer.nsecsElapsed(), QString("%1 of %2 found").arg(found).arg(pack.count()));
+    return packBytes == looseBytes && found == pack.count() ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+// Профилировщик: цена замера выключенного и включённого, сбор снимка и экспорт в Chrome Trace.
+// Замер выключенного профилировщика должен стоить единицы наносекунд
+#include "benchmarkutils.h"
+#include "Core/jobsystem.h"
+#include "Core/profiler.h"
+#include <QDir>
+#include <atomic>
+
+using core::JobSystem;
+using core::Profiler;
+
+static std::atomic<int> sink(0);
+
+// Замер вокруг почти пустой работы; noinline, чтобы компилятор не выбросил цикл
+__attribute__((noinline)) static void probe() {
+    SPECTER_PROFILE_SCOPE("probe");
+    sink.fetch_add(1, std::memory_order_relaxed);
+}
+
+__attribute__((noinline)) static void bare() {
+    sink.fetch_add(1, std::memory_order_relaxed);
+}
+
+int main() {
+    const int iterations = 10000000;
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        bare();
+    const qint64 baseline = timer.nsecsElapsed();
+    Benchmark::report("10M calls without probe", baseline,
+                      QString("%1 ns/call").arg(double(baseline) / iterations, 0, 'f', 2));
+
+    timer.restart();
+    for (int i = 0; i < iterations; ++i)
+        probe();
+    const qint64 disabled = timer.nsecsElapsed();
+    Benchmark::report("10M probes, profiler disabled", disabled,
+                      QString("%1 ns/probe over baseline").arg(double(disabled - baseline) / iterations, 0, 'f', 2));
+
+    Profiler::beginCapture();
+    timer.restart();
+    for (int i = 0; i < iterations; ++i)
+        probe();
+    const qint64 enabled = timer.nsecsElapsed();
+    Benchmark::report("10M probes, profiler enabled", enabled,
+                      QString("%1 ns/probe over baseline").arg(double(enabled - baseline) / iterations, 0, 'f', 2));
+
+    // Снимок с потоков планировщика: кольцо каждого потока хранит последние RingCapacity событий
+    JobSystem &jobs = JobSystem::instance();
+    jobs.parallelFor(0, 1 << 20, 256, [](size_t first, size_t last) {
+        SPECTER_PROFILE_SCOPE("chunk");
+        for (size_t i = first; i < last; ++i)
+            probe();
+    });
+    timer.restart();
+    const Profiler::Capture capture = Profiler::endCapture();
+    Benchmark::report("endCapture", timer.nsecsElapsed(),
+                      QString("%1 events, %2 threads").arg(capture.eventCount()).arg(capture.threads.size()));
+
+    const QString path = QDir::temp().filePath("specter_profiler_benchmark.json");
+    timer.restart();
+    QString error;
+    const bool written = Profiler::writeChromeTrace(capture, path, &error);
+    Benchmark::report("writeChromeTrace", timer.nsecsElapsed(), written ? QString() : error);
+
+    Profiler::Capture loaded;
+    timer.restart();
+    const bool read = Profiler::readChromeTrace(path, &loaded, &error);
+    Benchmark::report("readChromeTrace", timer.nsecsElapsed(),
+                      read ? QString("%1 events").arg(loaded.eventCount()) : error);
+    QFile::remove(path);
+    return written && read && loaded.eventCount() == capture.eventCount() ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Программный растеризатор: FPS на стандартных сценах в 1920x1080, один поток против всех ядер.
+// Число кадров задаётся аргументом (по умолчанию 60). Заодно считаются выделения памяти во время
+// замеренных кадров: после прогрева рендер не должен выделять ничего сам
+#include "benchmarkutils.h"
+#include "Render/rasterizer.h"
+#include <QThread>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<qint64> allocationCount(0);
+
+void *operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+using namespace render;
+
+struct TestScene {
+    const char *name;
+    Mat4 viewProjection;
+    std::vector<std::pair<const Mesh *, Mat4>> objects;
+};
+
+static Mat4 translation(float x, float y, float z, float scale = 1.0f) {
+    const float position[3] = {x, y, z};
+    const float rotation[3] = {0.0f, 0.0f, 0.0f};
+    const float scales[3] = {scale, scale, scale};
+    return Mat4::fromTransform(position, rotation, scales);
+}
+
+int main(int argc, char **argv) {
+    const int frames = argc > 1 ? QString(argv[1]).toInt() : 60;
+    const int width = 1920;
+    const int height = 1080;
+    const Mat4 projection = Mat4::perspective(60.0f, float(width) / height, 0.1f, 500.0f);
+
+    const Mesh cube = Mesh::cube();
+    const Mesh sphere = Mesh::sphere(48, 96);
+    const Mesh quad = Mesh::quad();
+    std::vector<TestScene> scenes;
+
+    // Много мелких объектов: сетка 32x32x10 кубов (~123K треугольников)
+    TestScene cubes{"cubes 10K", projection * Mat4::lookAt({40, 35, 60}, {0, 0, 0}, {0, 1, 0}), {}};
+    for (int x = 0; x < 32; ++x)
+        for (int y = 0; y < 10; ++y)
+            for (int z = 0; z < 32; ++z)
+                cubes.objects.push_back({&cube, translation((x - 16) * 1.5f, (y - 5) * 1.5f, (z - 16) * 1.5f)});
+    scenes.push_back(cubes);
+
+    // Плотные сетки: 64 сферы по 9216 треугольников (~590K)
+    TestScene spheres{"spheres 590K tris", projection * Mat4::lookAt({0, 6, 16}, {0, 0, 0}, {0, 1, 0}), {}};
+    for (int x = 0; x < 8; ++x)
+        for (int z = 0; z < 8; ++z)
+            spheres.objects.push_back({&sphere, translation((x - 3.5f) * 2.2f, 0.0f, (z - 3.5f) * 2.2f, 2.0f)});
+    scenes.push_back(spheres);
+
+    // Заполнение: 32 полноэкранных слоя, от дальнего к ближнему (худший случай для глубины)
+    TestScene overdraw{"overdraw 32 layers", projection * Mat4::lookAt({0, 0, 10}, {0, 0, 0}, {0, 1, 0}), {}};
+    for (int layer = 0; layer < 32; ++layer)
+        overdraw.objects.push_back({&quad, translation(0.0f, 0.0f, layer * 0.2f, 40.0f)});
+    scenes.push_back(overdraw);
+
+    const int cores = QThread::idealThreadCount();
+    for (const TestScene &scene : scenes) {
+        for (int threads : {1, cores}) {
+            Rasterizer rasterizer(threads);
+            rasterizer.resize(width, height);
+            auto submit = [&]() {
+                rasterizer.beginFrame(scene.viewProjection, 0x202020);
+                for (const auto &object : scene.objects)
+                    rasterizer.draw(*object.first, object.second, 0x4F9BE8);
+            };
+            // Прогрев: корзины и массивы вырастают до нужной ёмкости
+            for (int i = 0; i < 3; ++i) {
+                submit();
+                rasterizer.render();
+            }
+
+            const qint64 allocationsBefore = allocationCount.load();
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < frames; ++i) {
+                submit();
+                rasterizer.render();
+            }
+            const qint64 elapsed = timer.nsecsElapsed();
+            const qint64 allocations = allocationCount.load() - allocationsBefore;
+
+            const QString name = QString("%1, %2 threads").arg(scene.name).arg(threads);
+            Benchmark::report(qPrintable(name), elapsed / frames,
+                              QString("%1 FPS, %2/%3 tris visible, %4 allocations/frame")
+                                  .arg(frames * 1e9 / elapsed, 0, 'f', 1)
+                                  .arg(rasterizer.visibleTriangles())
+                                  .arg(rasterizer.submittedTriangles())
+                                  .arg(double(allocations) / frames, 0, 'f', 1));
+            if (threads == cores)
+                break;
+        }
+    }
+    return 0;
+}
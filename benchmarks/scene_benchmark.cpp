@@ -0,0 +1,180 @@
+// Сохранение и загрузка сцены: двоичный формат через mmap против построчного текстового.
+// Число узлов задаётся аргументом (по умолчанию 1M, ~90 MB файла; 6M даёт уровень на ~500 MB)
+#include "benchmarkutils.h"
+#include "Scene/components.h"
+#include "Scene/scene.h"
+#include "Scene/scenefile.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+#include <cstring>
+
+static void buildScene(Scene &scene, int nodeCount) {
+    // Три уровня: группы по 100 объектов, у каждого объекта по 9 детей
+    const int perGroup = 100 * 10;
+    std::vector<SceneGraph::NodeId> groups = scene.createObjects(SceneGraph::RootNode, qMax(1, nodeCount / perGroup), "Group");
+    for (SceneGraph::NodeId group : groups) {
+        for (SceneGraph::NodeId object : scene.createObjects(group, 100, "Object"))
+            scene.createObjects(object, 9, "Part");
+    }
+    float value = 0.0f;
+    scene.world().each<Transform>([&value](Transform &transform) {
+        transform.position[0] = value;
+        transform.position[1] = value * 0.5f;
+        transform.rotation[2] = value * 0.25f;
+        value += 1.0f;
+    });
+}
+
+// Текстовый формат для сравнения: "parent px py pz rx ry rz sx sy sz name" на строку, узлы в прямом порядке
+static bool writeText(Scene &scene, const QString &path) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QTextStream out(&file);
+    out.setRealNumberPrecision(9); // Достаточно для точного восстановления float
+    const SceneGraph &graph = scene.graph();
+    std::vector<uint32_t> fileIndex(graph.capacity(), SceneFile::NoParent);
+    std::vector<SceneGraph::NodeId> stack;
+    for (int row = graph.childCount(SceneGraph::RootNode) - 1; row >= 0; --row)
+        stack.push_back(graph.child(SceneGraph::RootNode, row));
+    uint32_t index = 0;
+    while (!stack.empty()) {
+        SceneGraph::NodeId node = stack.back();
+        stack.pop_back();
+        fileIndex[node] = index++;
+        SceneGraph::NodeId parent = graph.parent(node);
+        const Transform *t = scene.world().get<Transform>(scene.entity(node));
+        out << qint64(parent == SceneGraph::RootNode ? -1 : qint64(fileIndex[parent]));
+        for (const float *component : {t->position, t->rotation, t->scale})
+            out << ' ' << component[0] << ' ' << component[1] << ' ' << component[2];
+        out << ' ' << graph.name(node) << '\n';
+        for (int row = graph.childCount(node) - 1; row >= 0; --row)
+            stack.push_back(graph.child(node, row));
+    }
+    out.flush();
+    return file.commit();
+}
+
+static bool readText(Scene &scene, const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QTextStream in(&file);
+    std::vector<uint32_t> parents;
+    std::vector<Transform> transforms;
+    QStringList names;
+    QString line;
+    while (in.readLineInto(&line)) {
+        const QVector<QStringRef> fields = line.splitRef(' ');
+        if (fields.size() < 11)
+            return false;
+        const qint64 parent = fields[0].toLongLong();
+        parents.push_back(parent < 0 ? SceneFile::NoParent : uint32_t(parent));
+        Transform t;
+        float *values[] = {t.position, t.rotation, t.scale};
+        for (int i = 0; i < 9; ++i)
+            values[i / 3][i % 3] = fields[1 + i].toFloat();
+        transforms.push_back(t);
+        names.append(fields[10].toString());
+    }
+    scene.load(uint32_t(parents.size()), parents.data(), transforms.data(), nullptr,
+               [&names](uint32_t index) { return names.at(int(index)); });
+    return true;
+}
+
+// Сравнение деревьев обходом в порядке строк: имена и Transform должны совпасть побайтно
+static bool sameScene(Scene &a, Scene &b) {
+    if (a.graph().nodeCount() != b.graph().nodeCount())
+        return false;
+    std::vector<std::pair<SceneGraph::NodeId, SceneGraph::NodeId>> stack{{SceneGraph::RootNode, SceneGraph::RootNode}};
+    while (!stack.empty()) {
+        auto [left, right] = stack.back();
+        stack.pop_back();
+        if (a.graph().childCount(left) != b.graph().childCount(right))
+            return false;
+        if (left != SceneGraph::RootNode) {
+            if (a.graph().name(left) != b.graph().name(right))
+                return false;
+            const Transform *ta = a.world().get<Transform>(a.entity(left));
+            const Transform *tb = b.world().get<Transform>(b.entity(right));
+            if (!ta || !tb || std::memcmp(ta, tb, sizeof(Transform)) != 0)
+                return false;
+        }
+        for (int row = 0; row < a.graph().childCount(left); ++row)
+            stack.push_back({a.graph().child(left, row), b.graph().child(right, row)});
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const int nodeCount = argc > 1 ? QString(argv[1]).toInt() : 1000000;
+    const QString binaryPath = QDir::temp().filePath("specter_scene_benchmark.sscene");
+    const QString textPath = QDir::temp().filePath("specter_scene_benchmark.txt");
+    QElapsedTimer timer;
+
+    Scene source;
+    timer.start();
+    buildScene(source, nodeCount);
+    Benchmark::report("build scene", timer.nsecsElapsed(), QString("%1 nodes").arg(source.graph().nodeCount()));
+
+    QString error;
+    timer.restart();
+    if (!SceneFile::write(source, binaryPath, &error)) {
+        std::printf("binary write failed: %s\n", qPrintable(error));
+        return 1;
+    }
+    Benchmark::report("binary write", timer.nsecsElapsed(),
+                      QString("%1 MB").arg(QFileInfo(binaryPath).size() / 1048576.0, 0, 'f', 1));
+
+    timer.restart();
+    if (!writeText(source, textPath)) {
+        std::printf("text write failed\n");
+        return 1;
+    }
+    Benchmark::report("text write", timer.nsecsElapsed(),
+                      QString("%1 MB").arg(QFileInfo(textPath).size() / 1048576.0, 0, 'f', 1));
+
+    // Открытие: mmap + проверка заголовка. Массивы сразу доступны без разбора
+    SceneFile file;
+    timer.restart();
+    if (!file.open(binaryPath)) {
+        std::printf("binary open failed: %s\n", qPrintable(file.errorString()));
+        return 1;
+    }
+    Benchmark::report("binary open (mmap)", timer.nsecsElapsed());
+
+    timer.restart();
+    double checksum = 0.0;
+    const Transform *transforms = file.transforms();
+    for (uint32_t i = 0; i < file.nodeCount(); ++i)
+        checksum += transforms[i].position[0];
+    Benchmark::report("read transforms from mapping", timer.nsecsElapsed(), QString("checksum %1").arg(checksum, 0, 'g', 12));
+
+    Scene binaryLoaded;
+    timer.restart();
+    if (!file.instantiate(binaryLoaded)) {
+        std::printf("instantiate failed: %s\n", qPrintable(file.errorString()));
+        return 1;
+    }
+    Benchmark::report("binary instantiate into Scene", timer.nsecsElapsed());
+
+    Scene textLoaded;
+    timer.restart();
+    if (!readText(textLoaded, textPath)) {
+        std::printf("text read failed\n");
+        return 1;
+    }
+    Benchmark::report("text read + instantiate", timer.nsecsElapsed());
+
+    // Проверка туда-обратно для обоих форматов
+    const bool binaryOk = sameScene(source, binaryLoaded);
+    const bool textOk = sameScene(source, textLoaded);
+    std::printf("round-trip: binary %s, text %s\n", binaryOk ? "ok" : "MISMATCH", textOk ? "ok" : "MISMATCH");
+
+    file.close();
+    QFile::remove(binaryPath);
+    QFile::remove(textPath);
+    return binaryOk ? 0 : 1;
+}
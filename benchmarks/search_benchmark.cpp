@@ -0,0 +1,106 @@
+// Поиск по мере ввода: воспроизведение последовательностей нажатий на синтетическом корпусе путей
+#include "benchmarkutils.h"
+#include "Assets/assetsearchindex.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int MaxResults = 500;
+
+// Корпус из слов, собранных из слогов: похоже на имена ассетов и не вырождается в пару тысяч строк
+std::vector<std::string> buildCorpus(size_t count, std::vector<std::string> &words) {
+    std::mt19937 rng(42);
+    const char *syllables[] = {"ka", "ro", "mi", "shi", "ta", "ne", "lo", "va", "gra", "sto", "fo", "ghe",
+                               "dar", "wyn", "el", "tor", "bri", "qua", "zen", "pol", "mur", "fen", "ix", "ash"};
+    const char *roots[] = {"textures", "models", "audio", "scripts", "scenes", "materials", "shaders", "prefabs"};
+    const char *extensions[] = {".png", ".obj", ".ogg", ".lua", ".scene", ".mat", ".glsl", ".prefab"};
+
+    words.clear();
+    for (int i = 0; i < 3000; ++i) {
+        std::string word;
+        int syllableCount = 2 + int(rng() % 2);
+        for (int s = 0; s < syllableCount; ++s)
+            word += syllables[rng() % 24];
+        words.push_back(word);
+    }
+    auto word = [&]() -> const std::string & { return words[rng() % words.size()]; };
+
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int root = int(rng() % 8);
+        std::string path = std::string(roots[root]) + "/" + word() + "/" + word() + "/";
+        path += word() + "_" + word() + "_" + std::to_string(rng() % 100) + extensions[root];
+        // Часть имён с заглавными буквами, как в реальных проектах
+        if (i % 3 == 0)
+            path[path.find_last_of('/') + 1] = char(std::toupper(path[path.find_last_of('/') + 1]));
+        paths.push_back(std::move(path));
+    }
+    return paths;
+}
+
+// Последовательность состояний строки поиска: набор по буквам, опечатка с исправлением, вставка
+std::vector<std::string> keystrokes(const std::vector<std::string> &words) {
+    std::vector<std::string> states;
+    auto type = [&states](std::string current, const std::string &text) {
+        for (char c : text) {
+            current += c;
+            states.push_back(current);
+        }
+        return current;
+    };
+
+    type("", words[7] + "_" + words[11]);
+    std::string typo = type("", words[20] + "x");
+    states.push_back(typo.substr(0, typo.size() - 1)); // Backspace
+    type(typo.substr(0, typo.size() - 1), "/" + words[21].substr(0, 3));
+    type("", "tex/" + words[30].substr(0, 4));
+    type("", words[40].substr(0, 2) + words[41].substr(0, 2) + "png");
+    states.push_back(words[50] + "_" + words[51]); // Вставка из буфера обмена
+    return states;
+}
+
+void run(size_t corpusSize) {
+    std::vector<std::string> words;
+    std::vector<std::string> paths = buildCorpus(corpusSize, words);
+    QElapsedTimer timer;
+
+    AssetSearchIndex index;
+    timer.start();
+    for (const std::string &path : paths)
+        index.add(path);
+    Benchmark::report("build index", timer.nsecsElapsed(),
+                      QString("%1 paths, RSS %2 MB").arg(corpusSize).arg(Benchmark::residentMemoryMB(), 0, 'f', 1));
+
+    std::vector<qint64> times;
+    for (const std::string &query : keystrokes(words)) {
+        timer.restart();
+        const std::vector<AssetSearchIndex::Match> &matches = index.search(query, MaxResults);
+        qint64 elapsed = timer.nsecsElapsed();
+        times.push_back(elapsed);
+        std::printf("    %-28s %9.3f ms  %zu results\n", query.c_str(), elapsed / 1e6, matches.size());
+    }
+
+    std::vector<qint64> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    qint64 total = 0;
+    for (qint64 t : times)
+        total += t;
+    Benchmark::report("keystroke mean", total / qint64(times.size()));
+    Benchmark::report("keystroke p50", sorted[sorted.size() / 2]);
+    Benchmark::report("keystroke p95", sorted[sorted.size() * 95 / 100]);
+    Benchmark::report("keystroke max", sorted.back());
+}
+
+} // namespace
+
+int main() {
+    for (size_t corpusSize : {size_t(200000), size_t(1000000)}) {
+        std::printf("--- corpus %zu paths\n", corpusSize);
+        run(corpusSize);
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Сторож зависаний: цена отметок enter/leave на событие и проверка, что ожидание во вложенном
+// цикле событий (как у модального диалога) зависанием не считается, а занятость — считается,
+// в том числе когда обработчик сам шлёт много коротких синхронных событий (создание виджетов)
+#include "benchmarkutils.h"
+#include "UI/editorapplication.h"
+#include <QDir>
+#include <QEventLoop>
+#include <QTimer>
+
+// nested — получатель синхронных событий, которые обработчик шлёт по ходу работы
+static void busy(int milliseconds, QObject *nested = nullptr) {
+    QElapsedTimer timer;
+    timer.start();
+    QEvent event(QEvent::User);
+    while (timer.elapsed() < milliseconds) {
+        if (nested)
+            QCoreApplication::sendEvent(nested, &event);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const QString log = QDir::temp().absoluteFilePath("specter_stall_benchmark.jsonl");
+    QFile::remove(log);
+    qputenv("SPECTER_STALL_LOG", QFile::encodeName(log));
+    qputenv("SPECTER_STALL_BUDGET_MS", "50");
+    EditorApplication app(argc, argv);
+    const core::StallWatchdog &watchdog = app.stallWatchdog();
+
+    QObject receiver;
+    QEvent event(QEvent::User);
+    const int iterations = 1000000;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        QCoreApplication::sendEvent(&receiver, &event);
+    Benchmark::report("1M events through notify", timer.nsecsElapsed(),
+                      QString("%1 ns/event").arg(double(timer.nsecsElapsed()) / iterations, 0, 'f', 1));
+
+    int afterIdle = -1;
+    int afterBusy = -1;
+    int afterNested = -1;
+    QTimer::singleShot(0, [&]() {
+        // Вложенный цикл полсекунды спит, как диалог, ждущий пользователя
+        QEventLoop loop;
+        QTimer::singleShot(500, &loop, &QEventLoop::quit);
+        loop.exec();
+        afterIdle = watchdog.statistics().stalls;
+        QTimer::singleShot(0, [&]() {
+            busy(200);
+        });
+        QTimer::singleShot(50, [&]() {
+            afterBusy = watchdog.statistics().stalls;
+            busy(200, &receiver);
+            QTimer::singleShot(0, [&]() {
+                afterNested = watchdog.statistics().stalls;
+                app.quit();
+            });
+        });
+    });
+    app.exec();
+
+    Benchmark::report("nested idle loop, 500 ms", 0, QString("%1 stalls (%2)").arg(afterIdle).arg(afterIdle == 0 ? "ok" : "FAILED"));
+    Benchmark::report("busy handler, 200 ms", 0,
+                      QString("%1 stalls (%2)").arg(afterBusy - afterIdle).arg(afterBusy - afterIdle == 1 ? "ok" : "FAILED"));
+    Benchmark::report("busy handler with nested events, 200 ms", 0,
+                      QString("%1 stalls (%2)").arg(afterNested - afterBusy).arg(afterNested - afterBusy == 1 ? "ok" : "FAILED"));
+    QFile::remove(log);
+    return afterIdle == 0 && afterBusy - afterIdle == 1 && afterNested - afterBusy == 1 ? 0 : 1;
+}
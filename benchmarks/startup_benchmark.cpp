@@ -0,0 +1,58 @@
+// Запуск редактора: время до первого кадра и до готовности к работе для StartupDialog и EditorWindow.
+// Время считается от начала main, включая создание приложения.
+// Без дисплея: QT_QPA_PLATFORM=offscreen ./startup_benchmark
+#include "benchmarkutils.h"
+#include "UI/editorapplication.h"
+#include "UI/editorwindow.h"
+#include "UI/startupdialog.h"
+#include "UI/startupsequence.h"
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTimer>
+
+// Показывает окно и крутит цикл событий, пока оно не станет готовым к работе
+template<typename Window>
+static void measureWindow(const char *title, qint64 origin, Window *window) {
+    const qint64 constructed = StartupSequence::sinceLaunch();
+    StartupSequence *startup = window->startupSequence();
+    qint64 firstFrame = -1;
+    qint64 interactive = -1;
+    QEventLoop loop;
+    QObject::connect(startup, &StartupSequence::firstFrame, [&firstFrame](qint64 time) { firstFrame = time; });
+    QObject::connect(startup, &StartupSequence::interactive, [&](qint64 time) {
+        interactive = time;
+        loop.quit();
+    });
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+    window->show();
+    loop.exec();
+
+    std::printf("--- %s\n", title);
+    Benchmark::report("construct", constructed - origin);
+    Benchmark::report("time to first frame", firstFrame < 0 ? -1 : firstFrame - origin);
+    Benchmark::report("time to interactive", interactive < 0 ? -1 : interactive - origin);
+}
+
+int main(int argc, char *argv[]) {
+    StartupSequence::sinceLaunch();
+    EditorApplication app(argc, argv);
+    const qint64 applicationReady = StartupSequence::sinceLaunch();
+    Benchmark::report("application + theme", applicationReady);
+
+    {
+        StartupDialog dialog;
+        measureWindow("StartupDialog (from main)", 0, &dialog);
+    }
+
+    QTemporaryDir project;
+    QFile config(project.filePath("config.cfg"));
+    config.open(QIODevice::WriteOnly);
+    config.write("[Project]\nName=Startup Benchmark\n");
+    config.close();
+
+    const qint64 editorStart = StartupSequence::sinceLaunch();
+    EditorWindow *editor = new EditorWindow(project.path());
+    measureWindow("EditorWindow (from construction)", editorStart, editor);
+    delete editor;
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Стадии TexturePipeline на текстурах 4K и 8K: декодирование PNG, мип-цепочка (box и Кайзер),
+// сжатие BC1/BC3, а также параллельное декодирование пачки файлов
+#include "benchmarkutils.h"
+#include "Assets/texturepipeline.h"
+#include "Core/jobsystem.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// Похоже на фотографию: плавные градиенты, шум и полупрозрачные области
+QImage makeImage(int size) {
+    QImage image(size, size, QImage::Format_RGBA8888);
+    std::mt19937 rng(size);
+    for (int y = 0; y < size; ++y) {
+        uchar *row = image.scanLine(y);
+        for (int x = 0; x < size; ++x, row += 4) {
+            const int noise = int(rng() % 24);
+            row[0] = uchar(std::min(255, x * 200 / size + noise));
+            row[1] = uchar(std::min(255, 127 + int(100 * std::sin(x * 0.01 + y * 0.007)) + noise));
+            row[2] = uchar(std::min(255, y * 200 / size + noise));
+            row[3] = uchar((x / 256 + y / 256) % 3 == 0 ? 160 : 255);
+        }
+    }
+    return image;
+}
+
+QString megapixelsPerSecond(double megapixels, qint64 nanoseconds) {
+    return QString("%1 MP/s").arg(megapixels / (nanoseconds / 1e9), 0, 'f', 1);
+}
+
+void runStages(int size) {
+    const double megapixels = double(size) * size / 1e6;
+    const double chainMegapixels = megapixels * 4.0 / 3.0;
+    const QImage source = makeImage(size);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    source.save(&buffer, "PNG", 90);
+    std::printf("\n%dx%d, PNG %.1f MB\n", size, size, png.size() / (1024.0 * 1024.0));
+
+    QElapsedTimer timer;
+    QImage image;
+    timer.start();
+    TexturePipeline::decode(png, &image);
+    Benchmark::report("decode PNG", timer.nsecsElapsed(), megapixelsPerSecond(megapixels, timer.nsecsElapsed()));
+
+    TexturePipeline::Options options;
+    TextureData texture;
+    for (MipFilter filter : {MipFilter::Box, MipFilter::Kaiser}) {
+        options.filter = filter;
+        timer.restart();
+        TexturePipeline::buildMips(image, options, &texture);
+        const qint64 elapsed = timer.nsecsElapsed();
+        Benchmark::report(filter == MipFilter::Box ? "mips, box" : "mips, Kaiser", elapsed,
+                          QString("%1 of source, %2 levels").arg(megapixelsPerSecond(megapixels, elapsed)).arg(texture.levels.size()));
+    }
+
+    for (TextureFormat format : {TextureFormat::BC1, TextureFormat::BC3}) {
+        TextureData compressed = texture;
+        timer.restart();
+        TexturePipeline::compress(&compressed, format);
+        const qint64 elapsed = timer.nsecsElapsed();
+        Benchmark::report(format == TextureFormat::BC1 ? "compress BC1, full chain" : "compress BC3, full chain", elapsed,
+                          QString("%1, %2 MB").arg(megapixelsPerSecond(chainMegapixels, elapsed))
+                              .arg(compressed.storage.size() / (1024.0 * 1024.0), 0, 'f', 1));
+    }
+}
+
+// Декодеры Qt однопоточны: пачка файлов декодируется по файлу на поток
+void runBatchDecode(int size, int count) {
+    QTemporaryDir directory;
+    const QImage source = makeImage(size);
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        paths << directory.filePath(QString("texture_%1.png").arg(i));
+        source.save(paths.last(), "PNG", 90);
+    }
+    TexturePipeline::Options options;
+    options.format = TextureFormat::RGBA8;
+    options.mipmaps = false;
+    const double megapixels = double(size) * size * count / 1e6;
+    std::printf("\n%d PNG files %dx%d\n", count, size, size);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QString &path : paths) {
+        QImage image;
+        TexturePipeline::decode(path, &image);
+    }
+    Benchmark::report("decode one by one", timer.nsecsElapsed(), megapixelsPerSecond(megapixels, timer.nsecsElapsed()));
+
+    std::vector<TextureData> textures;
+    QStringList errors;
+    timer.restart();
+    TexturePipeline::processFiles(paths, options, &textures, &errors);
+    Benchmark::report("decode in parallel", timer.nsecsElapsed(), megapixelsPerSecond(megapixels, timer.nsecsElapsed()));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    std::printf("threads: %d\n", core::JobSystem::instance().concurrency());
+    runStages(4096);
+    runStages(8192);
+    runBatchDecode(2048, 16);
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Удаление 100k объектов и его отмена через историю правок, в том числе из временного файла
+#include "benchmarkutils.h"
+#include "Scene/commandhistory.h"
+#include "UI/scenehierarchymodel.h"
+#include <QApplication>
+#include <QTreeView>
+
+static bool run(SceneHierarchyModel &model, Scene &scene, SceneCommand &command, bool forward) {
+    const int count = int(command.fragments.size());
+    std::vector<Scene::ObjectId> parentObjects;
+    for (const SceneFragment &fragment : command.fragments)
+        parentObjects.push_back(fragment.parent);
+    std::vector<SceneGraph::NodeId> parents;
+    scene.resolve(parentObjects, parents);
+    for (int i = 0; i < count; ++i) {
+        const int index = forward ? i : count - 1 - i;
+        SceneFragment &fragment = command.fragments[index];
+        if (!forward) {
+            if (!model.restoreChildren(fragment, parents[index]))
+                return false;
+            continue;
+        }
+        model.removeChildren(scene.node(fragment.parent, parents[index]), fragment.firstRow, fragment.count, &fragment);
+    }
+    return true;
+}
+
+static void runScenario(const char *title, int objects, int childrenPerObject, qint64 budget) {
+    std::printf("--- %s: %d objects x %d children, budget %lld KB\n", title, objects, childrenPerObject,
+                static_cast<long long>(budget / 1024));
+    QElapsedTimer timer;
+
+    Scene scene;
+    std::vector<SceneGraph::NodeId> roots = scene.createObjects(SceneGraph::RootNode, objects + 1000, "Object");
+    for (int i = 0; i < objects && childrenPerObject > 0; ++i)
+        scene.createObjects(roots[i], childrenPerObject, "Child");
+
+    SceneHierarchyModel model(&scene);
+    QTreeView view;
+    view.setUniformRowHeights(true);
+    view.setModel(&model);
+    view.show();
+    QApplication::processEvents();
+
+    CommandHistory history;
+    history.setMemoryBudget(budget);
+    // Через одну строку: тысячи отдельных диапазонов вместо одного
+    std::vector<SceneGraph::NodeId> doomed;
+    for (int i = 0; i < objects; i += 2)
+        doomed.push_back(roots[i]);
+    for (int i = objects; i < objects + 1000; ++i)
+        doomed.push_back(roots[i]);
+
+    timer.start();
+    SceneCommand command;
+    command.type = SceneCommand::Remove;
+    model.removeNodes(doomed, &command.fragments);
+    Benchmark::report("delete + capture", timer.nsecsElapsed(), QString("%1 ranges").arg(command.fragments.size()));
+
+    timer.restart();
+    history.push(command);
+    // Ещё одна правка, чтобы удаление стало старой записью и ушло на диск при малом бюджете
+    history.push(SceneCommand::rename(scene, roots[1], "Object2", "Renamed"));
+    Benchmark::report("encode into history", timer.nsecsElapsed(),
+                      QString("%1 KB in memory, %2 KB spilled")
+                          .arg(history.memoryUsage() / 1024).arg(history.spilledBytes() / 1024));
+
+    // Переименование сцене уже неважно, отменяем его без изменений
+    history.undo([](SceneCommand &) { return true; });
+    const int before = scene.graph().nodeCount();
+    timer.restart();
+    const bool undone = history.undo([&](SceneCommand &step) { return run(model, scene, step, false); });
+    QApplication::processEvents();
+    Benchmark::report("undo delete", timer.nsecsElapsed(),
+                      QString("%1, %2 -> %3 nodes").arg(undone ? "ok" : "FAILED").arg(before).arg(scene.graph().nodeCount()));
+
+    timer.restart();
+    const bool redone = history.redo([&](SceneCommand &step) { return run(model, scene, step, true); });
+    QApplication::processEvents();
+    Benchmark::report("redo delete", timer.nsecsElapsed(),
+                      QString("%1, %2 nodes").arg(redone ? "ok" : "FAILED").arg(scene.graph().nodeCount()));
+}
+
+int main(int argc, char *argv[]) {
+    QApplication app(argc, argv);
+    runScenario("flat, in memory", 200000, 0, CommandHistory::DefaultMemoryBudget);
+    runScenario("flat, spilled", 200000, 0, 64 * 1024);
+    runScenario("nested, spilled", 20000, 9, 64 * 1024);
+    return 0;
+}
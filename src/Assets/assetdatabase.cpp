@@ -0,0 +1,476 @@
+#include "assetdatabase.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const quint32 IndexMagic = 0x53414442; // "SADB"
+const quint32 IndexVersion = 1;
+
+} // namespace
+
+AssetType assetTypeForSuffix(const QString &suffix) {
+    static const QHash<QString, AssetType> types = {
+        {"png", AssetType::Texture}, {"jpg", AssetType::Texture}, {"jpeg", AssetType::Texture},
+        {"bmp", AssetType::Texture}, {"tga", AssetType::Texture}, {"dds", AssetType::Texture},
+        {"obj", AssetType::Model}, {"fbx", AssetType::Model}, {"gltf", AssetType::Model}, {"glb", AssetType::Model},
+        {"wav", AssetType::Audio}, {"ogg", AssetType::Audio}, {"mp3", AssetType::Audio},
+        {"cpp", AssetType::Script}, {"h", AssetType::Script}, {"lua", AssetType::Script},
+        {"scene", AssetType::Scene},
+        {"cfg", AssetType::Config}, {"ini", AssetType::Config}, {"json", AssetType::Config}
+    };
+    return types.value(suffix.toLower(), AssetType::Unknown);
+}
+
+QDataStream &operator<<(QDataStream &stream, const AssetRecord &record) {
+    return stream << record.path << record.size << record.modified << quint8(record.type);
+}
+
+QDataStream &operator>>(QDataStream &stream, AssetRecord &record) {
+    quint8 type;
+    stream >> record.path >> record.size >> record.modified >> type;
+    record.type = static_cast<AssetType>(type);
+    return stream;
+}
+
+// AssetScanner
+
+AssetScanner::AssetScanner(const QString &projectRoot, QObject *parent)
+    : QObject(parent), projectRoot(QDir(projectRoot).absolutePath()),
+      indexPath(QDir(projectRoot).absoluteFilePath(".specter/assetdb.bin")),
+      watcher(nullptr), changeTimer(nullptr), saveTimer(nullptr), sweepTimer(nullptr), initialScan(true),
+      stopRequested(false) {
+}
+
+void AssetScanner::start() {
+    // Наблюдатель и таймеры создаются здесь, чтобы принадлежать рабочему потоку
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &AssetScanner::onDirectoryChanged);
+    changeTimer = new QTimer(this);
+    changeTimer->setSingleShot(true);
+    changeTimer->setInterval(100);
+    connect(changeTimer, &QTimer::timeout, this, &AssetScanner::processChangedDirectories);
+    saveTimer = new QTimer(this);
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(2000);
+    connect(saveTimer, &QTimer::timeout, this, &AssetScanner::saveIndex);
+    sweepTimer = new QTimer(this);
+    sweepTimer->setInterval(StatSweepInterval);
+    connect(sweepTimer, &QTimer::timeout, this, &AssetScanner::sweepFiles);
+
+    if (loadIndex()) {
+        // Сначала отдаём сохранённый индекс целиком, затем сверяем каталоги
+        QVector<AssetRecord> cached;
+        for (auto it = directories.cbegin(); it != directories.cend(); ++it) {
+            for (const AssetRecord &record : it.value().files) {
+                cached.append(record);
+                if (cached.size() >= BatchSize) {
+                    emit recordsAdded(cached);
+                    cached.clear();
+                }
+            }
+        }
+        if (!cached.isEmpty())
+            emit recordsAdded(cached);
+
+        const QStringList knownDirectories = directories.keys();
+        for (const QString &relativeDir : knownDirectories) {
+            if (!directories.contains(relativeDir))
+                continue; // Уже забыт вместе с удалённым родителем
+            QFileInfo info(absolutePath(relativeDir));
+            if (!info.isDir()) {
+                forgetDirectory(relativeDir);
+            } else if (info.lastModified().toMSecsSinceEpoch() != directories[relativeDir].modified) {
+                rescanDirectory(relativeDir);
+            } else {
+                // Состав каталога тот же, но файлы могли перезаписать на месте, пока редактор был закрыт
+                restatFiles(relativeDir);
+                flush(false);
+            }
+        }
+    } else {
+        rescanDirectory(QString());
+    }
+    if (stopRequested)
+        return;
+
+    initialScan = false;
+    QStringList watched;
+    for (auto it = directories.cbegin(); it != directories.cend(); ++it)
+        watched.append(absolutePath(it.key()));
+    if (!watched.isEmpty())
+        watcher->addPaths(watched);
+
+    flush(true);
+    saveIndex();
+    sweepTimer->start();
+    emit indexingFinished();
+}
+
+QString AssetScanner::absolutePath(const QString &relativeDir) const {
+    return relativeDir.isEmpty() ? projectRoot : projectRoot + '/' + relativeDir;
+}
+
+bool AssetScanner::isIgnored(const QString &name) {
+    // Служебные каталоги и результаты сборки не являются ассетами
+    return name.startsWith('.') || name == "build";
+}
+
+void AssetScanner::rescanDirectory(const QString &relativeDir) {
+    if (stopRequested)
+        return;
+    const QString dirPath = absolutePath(relativeDir);
+    QFileInfo dirInfo(dirPath);
+    if (!dirInfo.isDir()) {
+        forgetDirectory(relativeDir);
+        return;
+    }
+
+    if (!initialScan && !directories.contains(relativeDir))
+        watcher->addPath(dirPath);
+    DirectoryEntry &entry = directories[relativeDir];
+    entry.modified = dirInfo.lastModified().toMSecsSinceEpoch();
+    const QString prefix = relativeDir.isEmpty() ? QString() : relativeDir + '/';
+
+    QSet<QString> seenFiles;
+    QStringList subdirectories;
+    QDirIterator it(dirPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+    while (it.hasNext() && !stopRequested) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString name = info.fileName();
+        if (isIgnored(name))
+            continue;
+        if (info.isDir()) {
+            subdirectories.append(prefix + name);
+            continue;
+        }
+
+        seenFiles.insert(name);
+        AssetRecord record;
+        record.path = prefix + name;
+        record.size = info.size();
+        record.modified = info.lastModified().toMSecsSinceEpoch();
+        record.type = assetTypeForSuffix(info.suffix());
+
+        auto existing = entry.files.find(name);
+        if (existing == entry.files.end()) {
+            entry.files.insert(name, record);
+            pendingAdded.append(record);
+        } else if (existing->size != record.size || existing->modified != record.modified) {
+            *existing = record;
+            pendingUpdated.append(record);
+        }
+        flush(false);
+    }
+
+    for (auto file = entry.files.begin(); file != entry.files.end();) {
+        if (!seenFiles.contains(file.key())) {
+            pendingRemoved.append(file->path);
+            file = entry.files.erase(file);
+        } else {
+            ++file;
+        }
+    }
+
+    // Ссылку entry нельзя использовать после рекурсии: QHash может перераспределиться
+    const QStringList previousSubdirectories = entry.subdirectories;
+    entry.subdirectories = subdirectories;
+    for (const QString &subdirectory : previousSubdirectories) {
+        if (!subdirectories.contains(subdirectory))
+            forgetDirectory(subdirectory);
+    }
+    for (const QString &subdirectory : subdirectories) {
+        if (!directories.contains(subdirectory))
+            rescanDirectory(subdirectory);
+    }
+    flush(false);
+}
+
+int AssetScanner::restatFiles(const QString &relativeDir) {
+    auto entry = directories.find(relativeDir);
+    if (entry == directories.end())
+        return 0;
+    const QString prefix = absolutePath(relativeDir) + '/';
+    bool missing = false;
+    for (AssetRecord &record : entry->files) {
+        const QFileInfo info(prefix + record.path.mid(record.path.lastIndexOf('/') + 1));
+        if (!info.exists()) {
+            missing = true; // Удаления разбирает полный пересмотр каталога
+            continue;
+        }
+        const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        if (info.size() != record.size || modified != record.modified) {
+            record.size = info.size();
+            record.modified = modified;
+            pendingUpdated.append(record);
+        }
+    }
+    if (missing && !initialScan) {
+        changedDirectories.insert(relativeDir);
+        changeTimer->start();
+    }
+    return entry->files.size();
+}
+
+void AssetScanner::sweepFiles() {
+    if (sweepQueue.isEmpty())
+        sweepQueue = directories.keys();
+    const int updated = pendingUpdated.size();
+    int checked = 0;
+    while (!sweepQueue.isEmpty() && checked < StatSweepSize && !stopRequested)
+        checked += restatFiles(sweepQueue.takeLast());
+    if (pendingUpdated.size() == updated)
+        return;
+    flush(true);
+    saveTimer->start();
+}
+
+void AssetScanner::forgetDirectory(const QString &relativeDir) {
+    auto it = directories.find(relativeDir);
+    if (it == directories.end())
+        return;
+    for (const AssetRecord &record : it->files)
+        pendingRemoved.append(record.path);
+    const QStringList subdirectories = it->subdirectories;
+    directories.erase(it);
+    if (watcher)
+        watcher->removePath(absolutePath(relativeDir));
+    for (const QString &subdirectory : subdirectories)
+        forgetDirectory(subdirectory);
+}
+
+void AssetScanner::flush(bool force) {
+    if (!pendingAdded.isEmpty() && (force || pendingAdded.size() >= BatchSize)) {
+        emit recordsAdded(pendingAdded);
+        pendingAdded.clear();
+    }
+    if (!pendingUpdated.isEmpty() && (force || pendingUpdated.size() >= BatchSize)) {
+        emit recordsUpdated(pendingUpdated);
+        pendingUpdated.clear();
+    }
+    if (!pendingRemoved.isEmpty() && (force || pendingRemoved.size() >= BatchSize)) {
+        emit recordsRemoved(pendingRemoved);
+        pendingRemoved.clear();
+    }
+}
+
+void AssetScanner::onDirectoryChanged(const QString &absolutePath) {
+    QString relativeDir = QDir(projectRoot).relativeFilePath(absolutePath);
+    if (relativeDir == ".")
+        relativeDir.clear();
+    changedDirectories.insert(relativeDir);
+    changeTimer->start();
+}
+
+void AssetScanner::processChangedDirectories() {
+    const QSet<QString> changed = changedDirectories;
+    changedDirectories.clear();
+    for (const QString &relativeDir : changed) {
+        if (directories.contains(relativeDir))
+            rescanDirectory(relativeDir);
+    }
+    flush(true);
+    saveTimer->start();
+}
+
+bool AssetScanner::loadIndex() {
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_9);
+
+    quint32 magic, version;
+    QString storedRoot;
+    stream >> magic >> version >> storedRoot;
+    if (magic != IndexMagic || version != IndexVersion || storedRoot != projectRoot)
+        return false; // Проект перенесён или формат устарел — проще пересканировать
+
+    quint32 directoryCount;
+    stream >> directoryCount;
+    QHash<QString, DirectoryEntry> loaded;
+    loaded.reserve(directoryCount);
+    for (quint32 i = 0; i < directoryCount && stream.status() == QDataStream::Ok; ++i) {
+        QString relativeDir;
+        DirectoryEntry entry;
+        quint32 fileCount;
+        stream >> relativeDir >> entry.modified >> entry.subdirectories >> fileCount;
+        entry.files.reserve(fileCount);
+        for (quint32 j = 0; j < fileCount; ++j) {
+            AssetRecord record;
+            stream >> record;
+            entry.files.insert(record.path.mid(record.path.lastIndexOf('/') + 1), record);
+        }
+        loaded.insert(relativeDir, entry);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Asset index is corrupted, rescanning:" << indexPath;
+        return false;
+    }
+    directories.swap(loaded);
+    return true;
+}
+
+void AssetScanner::saveIndex() {
+    if (stopRequested && initialScan)
+        return;
+    QDir().mkpath(QFileInfo(indexPath).absolutePath());
+    // QSaveFile: при сбое во время записи старый индекс остаётся целым
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_9);
+    stream << IndexMagic << IndexVersion << projectRoot << quint32(directories.size());
+    for (auto it = directories.cbegin(); it != directories.cend(); ++it) {
+        stream << it.key() << it->modified << it->subdirectories << quint32(it->files.size());
+        for (const AssetRecord &record : it->files)
+            stream << record;
+    }
+    file.commit();
+}
+
+// AssetDatabase
+
+AssetDatabase::AssetDatabase(QObject *parent)
+    : QObject(parent), workerThread(nullptr), scanner(nullptr), indexing(false) {
+    qRegisterMetaType<AssetRecord>();
+    qRegisterMetaType<QVector<AssetRecord>>();
+}
+
+AssetDatabase::~AssetDatabase() {
+    close();
+}
+
+void AssetDatabase::open(const QString &projectPath) {
+    close();
+    root = QDir(projectPath).absolutePath();
+    indexing = true;
+
+    workerThread = new QThread(this);
+    workerThread->setObjectName("AssetScanner");
+    scanner = new AssetScanner(root);
+    scanner->moveToThread(workerThread);
+    connect(workerThread, &QThread::started, scanner, &AssetScanner::start);
+    connect(workerThread, &QThread::finished, scanner, &QObject::deleteLater);
+    connect(scanner, &AssetScanner::recordsAdded, this, &AssetDatabase::onRecordsAdded);
+    connect(scanner, &AssetScanner::recordsUpdated, this, &AssetDatabase::onRecordsUpdated);
+    connect(scanner, &AssetScanner::recordsRemoved, this, &AssetDatabase::onRecordsRemoved);
+    connect(scanner, &AssetScanner::indexingFinished, this, &AssetDatabase::onIndexingFinished);
+    workerThread->start(QThread::LowPriority);
+}
+
+void AssetDatabase::close() {
+    if (workerThread) {
+        disconnect(scanner, nullptr, this, nullptr);
+        if (indexing) {
+            scanner->requestStop();
+        } else {
+            QMetaObject::invokeMethod(scanner, "saveIndex", Qt::BlockingQueuedConnection);
+        }
+        workerThread->quit();
+        workerThread->wait();
+        delete workerThread;
+        workerThread = nullptr;
+        scanner = nullptr;
+    }
+    if (!records.isEmpty()) {
+        emit aboutToRemove(0, records.size() - 1);
+        records.clear();
+        rowByPath.clear();
+        emit removed();
+    }
+    searchIndex.clear();
+    pathBySearchId.clear();
+    searchIdByPath.clear();
+    indexing = false;
+}
+
+void AssetDatabase::onRecordsAdded(const QVector<AssetRecord> &added) {
+    int first = records.size();
+    emit aboutToAppend(first, first + added.size() - 1);
+    records.reserve(first + added.size());
+    for (const AssetRecord &record : added) {
+        rowByPath.insert(record.path, records.size());
+        records.append(record);
+        quint32 searchId = searchIndex.add(record.path.toStdString());
+        pathBySearchId.append(record.path);
+        searchIdByPath.insert(record.path, searchId);
+    }
+    emit appended();
+}
+
+void AssetDatabase::onRecordsUpdated(const QVector<AssetRecord> &updated) {
+    for (const AssetRecord &record : updated) {
+        int row = indexOf(record.path);
+        if (row < 0)
+            continue;
+        records[row] = record;
+        emit recordChanged(row);
+    }
+}
+
+void AssetDatabase::onRecordsRemoved(const QStringList &paths) {
+    QVector<int> rows;
+    rows.reserve(paths.size());
+    for (const QString &path : paths) {
+        int row = indexOf(path);
+        if (row >= 0) {
+            rows.append(row);
+            rowByPath.remove(path);
+        }
+        auto searchId = searchIdByPath.find(path);
+        if (searchId != searchIdByPath.end()) {
+            searchIndex.remove(*searchId);
+            searchIdByPath.erase(searchId);
+        }
+    }
+    if (rows.isEmpty())
+        return;
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+    // Файлы одного каталога приходили одной пачкой, поэтому удаляем непрерывными диапазонами
+    int i = 0;
+    while (i < rows.size()) {
+        int last = rows[i];
+        int first = last;
+        while (i + 1 < rows.size() && rows[i + 1] == first - 1) {
+            --first;
+            ++i;
+        }
+        ++i;
+        emit aboutToRemove(first, last);
+        records.erase(records.begin() + first, records.begin() + last + 1);
+        // Карта должна быть верна уже к removed(): обработчики ищут строки по путям.
+        // Сдвиг хвоста стоит столько же, сколько сам erase
+        for (int row = first; row < records.size(); ++row)
+            rowByPath[records[row].path] = row;
+        emit removed();
+    }
+}
+
+QVector<int> AssetDatabase::search(const QString &query, int maxResults) {
+    QVector<int> rows;
+    const std::vector<AssetSearchIndex::Match> &matches = searchIndex.search(query.toStdString(), maxResults);
+    rows.reserve(int(matches.size()));
+    for (const AssetSearchIndex::Match &match : matches) {
+        int row = indexOf(pathBySearchId[int(match.id)]);
+        if (row >= 0)
+            rows.append(row);
+    }
+    return rows;
+}
+
+void AssetDatabase::onIndexingFinished() {
+    indexing = false;
+    emit indexingFinished(records.size());
+}
@@ -0,0 +1,152 @@
+#ifndef ASSETDATABASE_H
+#define ASSETDATABASE_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include "assetsearchindex.h"
+
+enum class AssetType : quint8 {
+    Unknown,
+    Texture,
+    Model,
+    Audio,
+    Script,
+    Scene,
+    Config
+};
+
+AssetType assetTypeForSuffix(const QString &suffix);
+
+struct AssetRecord {
+    QString path;      // Относительно корня проекта, разделитель '/'
+    qint64 size = 0;
+    qint64 modified = 0; // мс с начала эпохи
+    AssetType type = AssetType::Unknown;
+};
+
+Q_DECLARE_METATYPE(AssetRecord)
+Q_DECLARE_METATYPE(QVector<AssetRecord>)
+
+// Обходчик проекта. Живёт в рабочем потоке AssetDatabase и присылает изменения пачками.
+// Индекс хранится по каталогам: при повторном открытии перечитываются лишь каталоги с новым
+// mtime, а файлы остальных только заново stat-ятся. mtime каталога и directoryChanged не
+// меняются при записи в файл на месте, поэтому известные файлы ещё и обходятся по кругу
+// небольшими порциями (StatSweepSize в секунду).
+class AssetScanner : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int BatchSize = 2048;
+    static constexpr int StatSweepSize = 4096;
+    static constexpr int StatSweepInterval = 1000; // мс
+
+    explicit AssetScanner(const QString &projectRoot, QObject *parent = nullptr);
+
+    // Потокобезопасно: прерывает текущий обход, частичный индекс не сохраняется
+    void requestStop() { stopRequested = true; }
+
+public slots:
+    void start();
+    void saveIndex();
+
+signals:
+    void recordsAdded(const QVector<AssetRecord> &records);
+    void recordsUpdated(const QVector<AssetRecord> &records);
+    void recordsRemoved(const QStringList &paths);
+    void indexingFinished();
+
+private slots:
+    void onDirectoryChanged(const QString &absolutePath);
+    void processChangedDirectories();
+    void sweepFiles();
+
+private:
+    struct DirectoryEntry {
+        qint64 modified = 0;
+        QStringList subdirectories;
+        QHash<QString, AssetRecord> files; // Ключ — имя файла
+    };
+
+    bool loadIndex();
+    void rescanDirectory(const QString &relativeDir);
+    void forgetDirectory(const QString &relativeDir);
+    // stat известных файлов каталога без его чтения; возвращает число проверенных
+    int restatFiles(const QString &relativeDir);
+    void flush(bool force);
+    QString absolutePath(const QString &relativeDir) const;
+    static bool isIgnored(const QString &name);
+
+    QString projectRoot;
+    QString indexPath;
+    QHash<QString, DirectoryEntry> directories;
+    QFileSystemWatcher *watcher;
+    QTimer *changeTimer;    // Склеивает серии уведомлений файловой системы
+    QTimer *saveTimer;      // Отложенное сохранение индекса после изменений
+    QTimer *sweepTimer;     // Круговой stat известных файлов
+    QStringList sweepQueue; // Каталоги, ещё не пройденные в текущем круге
+    QSet<QString> changedDirectories;
+    bool initialScan;       // Во время первого обхода каталоги ставятся на наблюдение разом в конце
+    std::atomic<bool> stopRequested;
+
+    QVector<AssetRecord> pendingAdded;
+    QVector<AssetRecord> pendingUpdated;
+    QStringList pendingRemoved;
+};
+
+// База ассетов проекта для UI-потока: зеркало индекса обходчика, пополняемое сигналами.
+// Обращения к диску происходят только в рабочем потоке.
+class AssetDatabase : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AssetDatabase(QObject *parent = nullptr);
+    ~AssetDatabase();
+
+    void open(const QString &projectPath);
+    void close();
+
+    QString projectRoot() const { return root; }
+    int count() const { return records.size(); }
+    const AssetRecord &record(int row) const { return records[row]; }
+    int indexOf(const QString &path) const { return rowByPath.value(path, -1); }
+    bool isIndexing() const { return indexing; }
+
+    // Нечёткий поиск по путям; возвращает строки базы в порядке релевантности
+    QVector<int> search(const QString &query, int maxResults);
+
+signals:
+    void aboutToAppend(int first, int last);
+    void appended();
+    void aboutToRemove(int first, int last);
+    void removed();
+    void recordChanged(int row);
+    void indexingFinished(int count);
+
+private slots:
+    void onRecordsAdded(const QVector<AssetRecord> &added);
+    void onRecordsUpdated(const QVector<AssetRecord> &updated);
+    void onRecordsRemoved(const QStringList &paths);
+    void onIndexingFinished();
+
+private:
+    QString root;
+    QThread *workerThread;
+    AssetScanner *scanner;
+    QVector<AssetRecord> records;
+    QHash<QString, int> rowByPath;
+    AssetSearchIndex searchIndex;
+    QVector<QString> pathBySearchId;
+    QHash<QString, quint32> searchIdByPath;
+    bool indexing;
+};
+
+#endif // ASSETDATABASE_H
@@ -0,0 +1,79 @@
+#include "assetdependencygraph.h"
+#include <algorithm>
+
+void AssetDependencyGraph::setDependencies(const QString &asset, const QStringList &dependencies) {
+    for (const QString &old : forward.value(asset)) {
+        auto it = reverse.find(old);
+        if (it != reverse.end()) {
+            it->remove(asset);
+            if (it->isEmpty())
+                reverse.erase(it);
+        }
+    }
+    forward.insert(asset, dependencies);
+    for (const QString &dependency : dependencies)
+        reverse[dependency].insert(asset);
+}
+
+void AssetDependencyGraph::remove(const QString &asset) {
+    setDependencies(asset, QStringList());
+    forward.remove(asset);
+}
+
+void AssetDependencyGraph::clear() {
+    forward.clear();
+    reverse.clear();
+}
+
+QStringList AssetDependencyGraph::files() const {
+    QSet<QString> nodes;
+    for (auto it = forward.cbegin(); it != forward.cend(); ++it) {
+        nodes.insert(it.key());
+        for (const QString &dependency : it.value())
+            nodes.insert(dependency);
+    }
+    return nodes.values();
+}
+
+QStringList AssetDependencyGraph::dependents(const QString &asset) const {
+    QStringList result = reverse.value(asset).values();
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QStringList AssetDependencyGraph::affected(const QStringList &changed) const {
+    // Вверх по обратным рёбрам: всё, что зависит от изменённого
+    QSet<QString> reached;
+    QStringList pending = changed;
+    while (!pending.isEmpty()) {
+        const QString node = pending.takeLast();
+        if (reached.contains(node))
+            continue;
+        reached.insert(node);
+        for (const QString &dependent : reverse.value(node))
+            pending.append(dependent);
+    }
+
+    // Обход в глубину по прямым рёбрам внутри найденного: зависимость попадает в порядок раньше
+    QStringList roots = reached.values();
+    std::sort(roots.begin(), roots.end());
+    QSet<QString> visited;
+    QStringList order;
+    for (const QString &node : roots)
+        visit(node, reached, &visited, &order);
+    return order;
+}
+
+void AssetDependencyGraph::visit(const QString &asset, const QSet<QString> &subset, QSet<QString> *visited,
+                                 QStringList *order) const {
+    if (visited->contains(asset))
+        return;
+    visited->insert(asset);
+    for (const QString &dependency : forward.value(asset)) {
+        if (subset.contains(dependency))
+            visit(dependency, subset, visited, order);
+    }
+    // Файл, на который ссылаются, но который сам не импортирован (например, текстура материала), не переимпортируется
+    if (forward.contains(asset))
+        order->append(asset);
+}
@@ -0,0 +1,37 @@
+#ifndef ASSETDEPENDENCYGRAPH_H
+#define ASSETDEPENDENCYGRAPH_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Граф зависимостей ассетов: ребро A → B значит, что A ссылается на B (модель на .mtl,
+// материал на текстуру). Пути относительно корня проекта. Узлы с записанными зависимостями
+// (пусть и пустыми) — импортированные ассеты; остальные узлы известны только как чьи-то зависимости
+class AssetDependencyGraph {
+public:
+    void setDependencies(const QString &asset, const QStringList &dependencies);
+    void remove(const QString &asset);
+    void clear();
+
+    bool contains(const QString &asset) const { return forward.contains(asset); }
+    QStringList assets() const { return forward.keys(); }
+    // Все узлы: ассеты и их зависимости
+    QStringList files() const;
+    QStringList dependencies(const QString &asset) const { return forward.value(asset); }
+    QStringList dependents(const QString &asset) const;
+
+    // Импортированные ассеты, которые нужно переимпортировать после изменения changed:
+    // сами изменённые и все, кто зависит от них транзитивно. Зависимости идут раньше зависимых;
+    // циклы не мешают — каждый ассет встречается один раз
+    QStringList affected(const QStringList &changed) const;
+
+private:
+    void visit(const QString &asset, const QSet<QString> &subset, QSet<QString> *visited, QStringList *order) const;
+
+    QHash<QString, QStringList> forward;
+    QHash<QString, QSet<QString>> reverse;
+};
+
+#endif // ASSETDEPENDENCYGRAPH_H
@@ -0,0 +1,160 @@
+#include "assethotreload.h"
+#include "Core/jobsystem.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <algorithm>
+#include <climits>
+
+AssetHotReload::AssetHotReload(QObject *parent) : AssetHotReload(CookedAssetCache::defaultDirectory(), parent) {}
+
+AssetHotReload::AssetHotReload(const QString &cacheDirectory, QObject *parent)
+    : QObject(parent), pipeline(cacheDirectory), watcher(new QFileSystemWatcher(this)), debounceTimer(new QTimer(this)),
+      generation(0) {
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(DebounceMs);
+    connect(debounceTimer, &QTimer::timeout, this, &AssetHotReload::flush);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, &AssetHotReload::onFileChanged);
+    connect(&pipeline, &AssetImportPipeline::finished, this, &AssetHotReload::onImportFinished);
+}
+
+AssetHotReload::~AssetHotReload() {
+    close();
+}
+
+QString AssetHotReload::journalPath(const QString &projectRoot) {
+    return projectRoot + "/.specter/reload.log";
+}
+
+void AssetHotReload::open(const QString &projectRoot) {
+    close();
+    root = QDir(projectRoot).absolutePath();
+    // Игра, запущенная в прошлом сеансе, увидит, что журнал стал короче, и начнёт сначала
+    QDir().mkpath(root + "/.specter");
+    QFile journal(journalPath(root));
+    journal.open(QIODevice::WriteOnly | QIODevice::Truncate);
+
+    const quint64 current = generation;
+    const QString manifestRoot = root;
+    core::JobSystem::instance().runThen([manifestRoot]() { return AssetImportPipeline::importedAssets(manifestRoot); },
+                                        this, [this, current](const QHash<QString, QStringList> &assets) {
+        if (current != generation)
+            return;
+        for (auto it = assets.cbegin(); it != assets.cend(); ++it)
+            graph.setDependencies(it.key(), it.value());
+        watch(graph.files());
+    });
+}
+
+void AssetHotReload::close() {
+    ++generation;
+    pipeline.cancel();
+    debounceTimer->stop();
+    firstChange.invalidate();
+    changed.clear();
+    reloading.clear();
+    graph.clear();
+    const QStringList watched = watcher->files();
+    if (!watched.isEmpty())
+        watcher->removePaths(watched);
+    root.clear();
+}
+
+void AssetHotReload::track(const QVector<ImportResult> &results) {
+    if (root.isEmpty())
+        return;
+    QStringList files;
+    for (const ImportResult &result : results) {
+        if (!result.ok)
+            continue;
+        graph.setDependencies(result.asset, result.dependencies);
+        files << result.asset << result.dependencies;
+    }
+    watch(files);
+}
+
+void AssetHotReload::watch(const QStringList &relativePaths) {
+    // Файл, сохранённый через переименование, выпадает из наблюдения — сюда он попадает снова
+    QSet<QString> watched;
+    for (const QString &path : watcher->files())
+        watched.insert(path);
+    QStringList added;
+    for (const QString &path : relativePaths) {
+        const QString absolute = root + '/' + path;
+        if (!watched.contains(absolute) && QFileInfo(absolute).isFile())
+            added << absolute;
+    }
+    added.removeDuplicates();
+    if (!added.isEmpty())
+        watcher->addPaths(added);
+}
+
+void AssetHotReload::onFileChanged(const QString &absolutePath) {
+    if (root.isEmpty())
+        return;
+    changed.insert(QDir(root).relativeFilePath(absolutePath));
+    if (!firstChange.isValid())
+        firstChange.start();
+    // Непрерывная серия сохранений не откладывает перезагрузку дольше MaxDelayMs
+    if (firstChange.elapsed() >= MaxDelayMs)
+        flush();
+    else
+        debounceTimer->start();
+}
+
+void AssetHotReload::flush() {
+    debounceTimer->stop();
+    // Во время перезагрузки изменения копятся и уходят следующей пачкой
+    if (changed.isEmpty() || pipeline.isRunning())
+        return;
+    firstChange.invalidate();
+    const QStringList paths = changed.values();
+    changed.clear();
+    watch(paths);
+
+    reloading.clear();
+    QStringList files;
+    for (const QString &asset : graph.affected(paths)) {
+        const QString absolute = root + '/' + asset;
+        if (QFileInfo(absolute).isFile()) {
+            reloading << asset;
+            files << absolute;
+        }
+    }
+    if (files.isEmpty())
+        return;
+    emit reloadStarted(reloading);
+    pipeline.import(files, root);
+}
+
+void AssetHotReload::onImportFinished(const QVector<ImportResult> &results, qint64 milliseconds) {
+    // Результаты приходят в порядке готовности; возвращаем порядок графа
+    QHash<QString, int> position;
+    for (int i = 0; i < reloading.size(); ++i)
+        position.insert(root + '/' + reloading[i], i);
+    QVector<ImportResult> ordered = results;
+    std::stable_sort(ordered.begin(), ordered.end(), [&position](const ImportResult &a, const ImportResult &b) {
+        return position.value(a.source, INT_MAX) < position.value(b.source, INT_MAX);
+    });
+    reloading.clear();
+
+    track(ordered);
+    appendJournal(ordered);
+    emit reloaded(ordered, milliseconds);
+    if (!changed.isEmpty())
+        debounceTimer->start();
+}
+
+void AssetHotReload::appendJournal(const QVector<ImportResult> &results) {
+    QFile journal(journalPath(root));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
+    QByteArray lines;
+    for (const ImportResult &result : results) {
+        if (result.ok)
+            lines += result.asset.toUtf8() + '\t' + pipeline.cache().pathFor(result.key).toUtf8() + '\n';
+    }
+    // Одной записью, чтобы игра не прочитала половину строки
+    journal.write(lines);
+}
@@ -0,0 +1,68 @@
+#ifndef ASSETHOTRELOAD_H
+#define ASSETHOTRELOAD_H
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "assetdependencygraph.h"
+#include "assetimport.h"
+
+// Горячая перезагрузка ассетов. Следит за файлами импортированных ассетов и их зависимостей
+// (AssetScanner видит только изменения каталогов, а запись поверх файла их не меняет).
+// Серия сохранений склеивается: перезагрузка начинается после DebounceMs тишины, но не позже
+// MaxDelayMs с первого изменения. Переимпортируются только изменившиеся ассеты и все, кто от них
+// зависит, в собственном AssetImportPipeline — «Add to Project» при этом не прерывается.
+// Результаты отдаются сигналом reloaded (зависимости раньше зависимых) и дописываются в журнал,
+// который читает запущенная игра: строка "<ассет>\t<файл в кэше приготовленных>"
+class AssetHotReload : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int DebounceMs = 200;
+    static constexpr int MaxDelayMs = 1000;
+
+    explicit AssetHotReload(QObject *parent = nullptr);
+    explicit AssetHotReload(const QString &cacheDirectory, QObject *parent = nullptr);
+    ~AssetHotReload();
+
+    // Граф читается из манифеста импорта в пуле потоков; журнал обрезается
+    void open(const QString &projectRoot);
+    void close();
+    // Начать следить за только что импортированными ассетами
+    void track(const QVector<ImportResult> &results);
+
+    QString projectRoot() const { return root; }
+    const AssetDependencyGraph &dependencies() const { return graph; }
+    bool isReloading() const { return pipeline.isRunning(); }
+
+    static QString journalPath(const QString &projectRoot);
+
+signals:
+    void reloadStarted(const QStringList &assets);
+    // Удачно переимпортированные идут в порядке графа; неудачные — с ok == false
+    void reloaded(const QVector<ImportResult> &results, qint64 milliseconds);
+
+private:
+    void onFileChanged(const QString &absolutePath);
+    void flush();
+    void onImportFinished(const QVector<ImportResult> &results, qint64 milliseconds);
+    void watch(const QStringList &relativePaths);
+    void appendJournal(const QVector<ImportResult> &results);
+
+    AssetImportPipeline pipeline;
+    AssetDependencyGraph graph;
+    QFileSystemWatcher *watcher;
+    QTimer *debounceTimer;
+    QElapsedTimer firstChange;  // С первого изменения текущей серии
+    QSet<QString> changed;      // Относительно корня проекта
+    QStringList reloading;      // Порядок текущей перезагрузки
+    QString root;
+    quint64 generation;         // Граф, прочитанный для закрытого проекта, отбрасывается
+};
+
+#endif // ASSETHOTRELOAD_H
@@ -0,0 +1,354 @@
+#include "assetimport.h"
+#include "objloader.h"
+#include "texturepipeline.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+const quint32 ManifestMagic = 0x4D495053; // "SPIM"
+const quint32 ManifestVersion = 2;
+
+template<typename T>
+void appendValue(QByteArray *out, T value) {
+    out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+bool isInside(const QDir &root, const QString &absolutePath) {
+    const QString relative = root.relativeFilePath(absolutePath);
+    return !relative.startsWith("..") && !QDir::isAbsolutePath(relative);
+}
+
+// Строки вида "<keyword> [опции] файл..."; takeLast — только последнее слово (после опций map_*)
+QStringList referencesAfter(const QByteArray &source, const QSet<QByteArray> &keywords, bool takeLast) {
+    QStringList references;
+    for (const QByteArray &rawLine : source.split('\n')) {
+        const QList<QByteArray> words = rawLine.simplified().split(' ');
+        if (words.size() < 2 || !keywords.contains(words.first()))
+            continue;
+        if (takeLast) {
+            references << QString::fromUtf8(words.last());
+        } else {
+            for (int i = 1; i < words.size(); ++i)
+                references << QString::fromUtf8(words[i]);
+        }
+    }
+    return references;
+}
+
+} // namespace
+
+// Импортёры
+
+bool TextureImporter::accepts(const QString &suffix) const {
+    static const QStringList suffixes = {"png", "jpg", "jpeg", "bmp", "tga", "gif"};
+    return suffixes.contains(suffix, Qt::CaseInsensitive);
+}
+
+bool TextureImporter::cook(const QByteArray &source, QByteArray *cooked, QString *error) const {
+    TextureData texture;
+    if (!TexturePipeline::process(source, TexturePipeline::Options(), &texture, error)) {
+        if (error->isEmpty())
+            *error = "Unsupported or corrupt image";
+        return false;
+    }
+    cooked->reserve(int(20 + texture.storage.size()));
+    appendValue(cooked, Magic);
+    appendValue(cooked, quint32(texture.width()));
+    appendValue(cooked, quint32(texture.height()));
+    appendValue(cooked, quint32(texture.format));
+    appendValue(cooked, quint32(texture.levels.size()));
+    cooked->append(reinterpret_cast<const char *>(texture.storage.data()), int(texture.storage.size()));
+    return true;
+}
+
+bool MeshImporter::accepts(const QString &suffix) const {
+    return suffix.compare("obj", Qt::CaseInsensitive) == 0;
+}
+
+bool MeshImporter::cook(const QByteArray &source, QByteArray *cooked, QString *error) const {
+    MeshData mesh;
+    // Импорт и так идёт в пуле по файлу на поток, поэтому файл не делится на куски
+    if (!ObjLoader::parse(source.constData(), size_t(source.size()), &mesh, error, 1))
+        return false;
+    const size_t vertexBytes = mesh.vertices.size() * sizeof(MeshVertex);
+    const size_t indexBytes = mesh.indices.size() * sizeof(uint32_t);
+    cooked->reserve(int(16 + vertexBytes + indexBytes));
+    appendValue(cooked, Magic);
+    appendValue(cooked, quint32(mesh.vertices.size()));
+    appendValue(cooked, quint32(mesh.indices.size()));
+    appendValue(cooked, quint32((mesh.hasTexCoords ? 1u : 0u) | (mesh.hasNormals ? 2u : 0u)));
+    cooked->append(reinterpret_cast<const char *>(mesh.vertices.data()), int(vertexBytes));
+    cooked->append(reinterpret_cast<const char *>(mesh.indices.data()), int(indexBytes));
+    return true;
+}
+
+QStringList MeshImporter::dependencies(const QByteArray &source) const {
+    return referencesAfter(source, {"mtllib"}, false);
+}
+
+bool RawImporter::cook(const QByteArray &source, QByteArray *cooked, QString *) const {
+    *cooked = source;
+    return true;
+}
+
+QStringList MaterialImporter::dependencies(const QByteArray &source) const {
+    static const QSet<QByteArray> maps = {"map_Ka", "map_Kd", "map_Ks", "map_Ns", "map_d", "map_Bump", "map_bump",
+                                          "bump", "disp", "decal", "norm", "map_Pr", "map_Pm", "map_Ke"};
+    return referencesAfter(source, maps, true);
+}
+
+// AssetImportPipeline
+
+AssetImportPipeline::AssetImportPipeline(QObject *parent)
+    : AssetImportPipeline(CookedAssetCache::defaultDirectory(), parent) {}
+
+AssetImportPipeline::AssetImportPipeline(const QString &cacheDirectory, QObject *parent)
+    : QObject(parent), cookedCache(cacheDirectory), batchId(0), total(0), running(false) {
+    qRegisterMetaType<ImportResult>();
+    qRegisterMetaType<QVector<ImportResult>>();
+    importers.emplace_back(new TextureImporter);
+    importers.emplace_back(new MeshImporter);
+    importers.emplace_back(new MaterialImporter);
+    importers.emplace_back(new RawImporter);
+}
+
+AssetImportPipeline::~AssetImportPipeline() {
+    cancel();
+    for (const core::JobHandle &job : jobs)
+        core::JobSystem::instance().wait(job);
+}
+
+const AssetImporter *AssetImportPipeline::importerFor(const QString &path) const {
+    const QString suffix = QFileInfo(path).suffix();
+    for (const auto &importer : importers) {
+        if (importer->accepts(suffix))
+            return importer.get();
+    }
+    return nullptr;
+}
+
+QString AssetImportPipeline::manifestPath(const QString &projectRoot) {
+    return projectRoot + "/.specter/imports.bin";
+}
+
+AssetImportPipeline::Manifest AssetImportPipeline::loadManifest(const QString &projectRoot) {
+    Manifest manifest;
+    QFile file(manifestPath(projectRoot));
+    if (!file.open(QIODevice::ReadOnly))
+        return manifest;
+    QDataStream stream(&file);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (magic != ManifestMagic || version != ManifestVersion)
+        return manifest;
+    manifest.reserve(int(count));
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString asset;
+        ManifestEntry entry;
+        stream >> asset >> entry.size >> entry.modified >> entry.importer >> entry.version >> entry.key
+            >> entry.dependencies;
+        manifest.insert(asset, entry);
+    }
+    return manifest;
+}
+
+void AssetImportPipeline::saveManifest(const QString &projectRoot, const Manifest &manifest) {
+    const QString path = manifestPath(projectRoot);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream stream(&file);
+    stream << ManifestMagic << ManifestVersion << quint32(manifest.size());
+    for (auto it = manifest.cbegin(); it != manifest.cend(); ++it)
+        stream << it.key() << it->size << it->modified << it->importer << it->version << it->key << it->dependencies;
+    file.commit();
+}
+
+// Пока шёл импорт, манифест мог переписать другой конвейер (горячая перезагрузка),
+// поэтому поверх файла записываются только записи этого импорта
+void AssetImportPipeline::commitManifest() {
+    Manifest merged = loadManifest(root);
+    for (auto it = imported.cbegin(); it != imported.cend(); ++it)
+        merged.insert(it.key(), it.value());
+    saveManifest(root, merged);
+    imported.clear();
+}
+
+QHash<QString, QStringList> AssetImportPipeline::importedAssets(const QString &projectRoot) {
+    const Manifest manifest = loadManifest(projectRoot);
+    QHash<QString, QStringList> assets;
+    assets.reserve(manifest.size());
+    for (auto it = manifest.cbegin(); it != manifest.cend(); ++it)
+        assets.insert(it.key(), it->dependencies);
+    return assets;
+}
+
+void AssetImportPipeline::import(const QStringList &files, const QString &projectRoot) {
+    if (running)
+        cancel();
+    root = QDir(projectRoot).absolutePath();
+    manifest = loadManifest(root);
+    imported.clear();
+    results.clear();
+    results.reserve(files.size());
+    total = files.size();
+    running = true;
+    timer.start();
+    const quint64 batch = ++batchId;
+    if (files.isEmpty()) {
+        running = false;
+        emit finished(results, 0);
+        return;
+    }
+
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const core::JobHandle &job) { return job.isFinished(); }),
+               jobs.end());
+    const QDir rootDir(root);
+    for (const QString &file : files) {
+        // Запись манифеста копируется: хэш меняется в UI-потоке, пока задачи работают
+        const QString absolute = QFileInfo(file).absoluteFilePath();
+        const ManifestEntry known =
+            isInside(rootDir, absolute) ? manifest.value(rootDir.relativeFilePath(absolute)) : ManifestEntry();
+        const QString projectRoot = root;
+        jobs.push_back(core::JobSystem::instance().runThen([this, batch, file, projectRoot, known]() {
+            // Импорт уже отменён, пока задача ждала очереди
+            if (batchId != batch)
+                return ImportResult();
+            return importFile(file, projectRoot, known);
+        }, this, [this, batch](const ImportResult &result) { onFileImported(batch, result); }));
+    }
+}
+
+void AssetImportPipeline::cancel() {
+    if (!running)
+        return;
+    ++batchId; // Ещё не начатые задачи увидят это и ничего не сделают
+    running = false;
+    // Уже импортированное остаётся в манифесте
+    commitManifest();
+}
+
+ImportResult AssetImportPipeline::importFile(const QString &source, const QString &projectRoot,
+                                             const ManifestEntry &known) const {
+    ImportResult result;
+    result.source = source;
+    const QFileInfo info(source);
+    if (!info.isFile()) {
+        result.error = "File not found";
+        return result;
+    }
+    const QDir rootDir(projectRoot);
+    const QString absolute = info.absoluteFilePath();
+    const bool inside = isInside(rootDir, absolute);
+    const AssetImporter *importer = importerFor(absolute);
+    result.importer = importer->id();
+    result.importerVersion = importer->version();
+    result.bytes = info.size();
+
+    // Файл проекта не менялся с прошлого импорта и его результат в кэше — ничего не читаем
+    if (inside && !known.key.isEmpty() && known.size == info.size()
+        && known.modified == info.lastModified().toMSecsSinceEpoch() && known.importer == result.importer
+        && known.version == result.importerVersion && cookedCache.contains(known.key)) {
+        result.asset = rootDir.relativeFilePath(absolute);
+        result.key = known.key;
+        result.modified = known.modified;
+        result.dependencies = known.dependencies;
+        result.ok = true;
+        result.cached = true;
+        return result;
+    }
+
+    QFile input(absolute);
+    if (!input.open(QIODevice::ReadOnly)) {
+        result.error = input.errorString();
+        return result;
+    }
+    const QByteArray data = input.readAll();
+    input.close();
+    const QByteArray sourceHash = CookedAssetCache::contentHash(data);
+
+    QString target = absolute;
+    if (!inside) {
+        // Копия в assets/; файл с тем же именем и другим содержимым не затираем
+        const QString directory = rootDir.filePath("assets");
+        QDir().mkpath(directory);
+        target = directory + '/' + info.fileName();
+        bool reserved = false;
+        for (int suffix = 1;; ++suffix) {
+            // Имя занимается созданием пустого файла (NewOnly): две задачи одного пакета с
+            // одинаковыми именами файлов не запишут в один путь — вторая уйдёт на следующий суффикс
+            QFile placeholder(target);
+            if (placeholder.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+                reserved = true;
+                break;
+            }
+            QFile existing(target);
+            if (!existing.exists()) {
+                result.error = "Cannot copy into project: " + placeholder.errorString();
+                return result;
+            }
+            if (existing.size() == data.size() && existing.open(QIODevice::ReadOnly)
+                && CookedAssetCache::contentHash(existing.readAll()) == sourceHash)
+                break;
+            target = QString("%1/%2_%3.%4").arg(directory, info.completeBaseName()).arg(suffix).arg(info.suffix());
+        }
+        if (reserved) {
+            QSaveFile output(target);
+            if (!output.open(QIODevice::WriteOnly) || output.write(data) != data.size() || !output.commit()) {
+                result.error = "Cannot copy into project: " + output.errorString();
+                QFile::remove(target);
+                return result;
+            }
+        }
+    }
+    result.asset = rootDir.relativeFilePath(target);
+    result.modified = QFileInfo(target).lastModified().toMSecsSinceEpoch();
+    const QDir assetDir = QFileInfo(target).absoluteDir();
+    for (const QString &reference : importer->dependencies(data)) {
+        const QString dependency = QDir::cleanPath(assetDir.absoluteFilePath(reference));
+        if (isInside(rootDir, dependency))
+            result.dependencies << rootDir.relativeFilePath(dependency);
+    }
+
+    result.key = CookedAssetCache::key(sourceHash, result.importer, result.importerVersion);
+    if (cookedCache.contains(result.key)) {
+        result.ok = true;
+        result.cached = true;
+        return result;
+    }
+    QByteArray cooked;
+    if (!importer->cook(data, &cooked, &result.error))
+        return result;
+    result.ok = cookedCache.store(result.key, cooked, &result.error);
+    return result;
+}
+
+void AssetImportPipeline::onFileImported(quint64 batch, const ImportResult &result) {
+    if (batch != batchId)
+        return;
+    results.append(result);
+    if (result.ok) {
+        const ManifestEntry entry{result.bytes, result.modified, result.importer, result.importerVersion, result.key,
+                                  result.dependencies};
+        manifest.insert(result.asset, entry);
+        imported.insert(result.asset, entry);
+    }
+
+    const int done = results.size();
+    const int step = qMax(1, total / 100);
+    if (done % step == 0 || done == total)
+        emit progress(done, total);
+    if (done < total)
+        return;
+    running = false;
+    commitManifest();
+    emit finished(results, timer.elapsed());
+}
@@ -0,0 +1,154 @@
+#ifndef ASSETIMPORT_H
+#define ASSETIMPORT_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "cookedassetcache.h"
+#include "Core/jobsystem.h"
+
+// Импортёр: превращает содержимое исходного файла в формат, готовый для рантайма.
+// Смена выходного формата — повод увеличить version(): старые записи кэша перестанут совпадать
+class AssetImporter {
+public:
+    virtual ~AssetImporter() = default;
+
+    virtual QByteArray id() const = 0;
+    virtual quint32 version() const = 0;
+    virtual bool accepts(const QString &suffix) const = 0;
+    // Вызывается из пула потоков
+    virtual bool cook(const QByteArray &source, QByteArray *cooked, QString *error) const = 0;
+    // Файлы, на которые ссылается source, — как записаны в нём (относительно каталога ассета)
+    virtual QStringList dependencies(const QByteArray &source) const {
+        Q_UNUSED(source);
+        return QStringList();
+    }
+};
+
+// Картинки → сжатая мип-цепочка (TexturePipeline, BC3 или BC1 для непрозрачных):
+// заголовок {magic, width, height, format, levelCount}, затем уровни подряд от нулевого
+class TextureImporter : public AssetImporter {
+public:
+    static constexpr quint32 Magic = 0x58455453; // "STEX"
+
+    QByteArray id() const override { return "texture"; }
+    quint32 version() const override { return 2; }
+    bool accepts(const QString &suffix) const override;
+    bool cook(const QByteArray &source, QByteArray *cooked, QString *error) const override;
+};
+
+// OBJ → индексированная сетка (ObjLoader): заголовок {magic, vertexCount, indexCount, flags},
+// массив MeshVertex, uint32 индексы. flags: бит 0 — есть текстурные координаты, бит 1 — нормали
+class MeshImporter : public AssetImporter {
+public:
+    static constexpr quint32 Magic = 0x48534D53; // "SMSH"
+
+    QByteArray id() const override { return "mesh"; }
+    quint32 version() const override { return 2; }
+    bool accepts(const QString &suffix) const override;
+    bool cook(const QByteArray &source, QByteArray *cooked, QString *error) const override;
+    QStringList dependencies(const QByteArray &source) const override; // mtllib
+};
+
+// Всё остальное хранится как есть: в кэше это даёт общий экземпляр одинаковых файлов
+class RawImporter : public AssetImporter {
+public:
+    QByteArray id() const override { return "raw"; }
+    quint32 version() const override { return 1; }
+    bool accepts(const QString &) const override { return true; }
+    bool cook(const QByteArray &source, QByteArray *cooked, QString *) const override;
+};
+
+// Материалы OBJ (.mtl) хранятся как есть, но ссылаются на текстуры (map_Kd, bump…)
+class MaterialImporter : public RawImporter {
+public:
+    QByteArray id() const override { return "material"; }
+    bool accepts(const QString &suffix) const override { return suffix.compare("mtl", Qt::CaseInsensitive) == 0; }
+    QStringList dependencies(const QByteArray &source) const override;
+};
+
+struct ImportResult {
+    QString source;    // Путь, указанный пользователем
+    QString asset;     // Относительно корня проекта
+    QStringList dependencies; // Ассеты, на которые ссылается этот, относительно корня проекта
+    QByteArray importer;
+    QByteArray key;    // Ключ в кэше приготовленных ассетов
+    qint64 bytes = 0;  // Размер исходника
+    qint64 modified = 0; // Время изменения ассета в проекте, мс
+    quint32 importerVersion = 0;
+    bool ok = false;
+    bool cached = false; // Готовить не пришлось
+    QString error;
+};
+
+Q_DECLARE_METATYPE(ImportResult)
+
+// Импорт «Add to Project»: исходники копируются в assets/ проекта (если лежат вне его),
+// хэшируются и готовятся в пуле потоков. Манифест проекта (.specter/imports.bin) помнит для
+// каждого ассета размер, время изменения и ключ: неизменённый файл не читается вовсе,
+// а совпадение хэша с уже приготовленным (в том числе в другой рабочей копии) — только читается
+class AssetImportPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AssetImportPipeline(QObject *parent = nullptr);
+    explicit AssetImportPipeline(const QString &cacheDirectory, QObject *parent = nullptr);
+    ~AssetImportPipeline();
+
+    CookedAssetCache &cache() { return cookedCache; }
+    bool isRunning() const { return running; }
+
+    // Импортёр, подходящий по расширению файла (последний зарегистрированный — RawImporter)
+    const AssetImporter *importerFor(const QString &path) const;
+
+    void import(const QStringList &files, const QString &projectRoot);
+    void cancel();
+
+    // Импортированные ассеты проекта из манифеста и их зависимости; читает диск
+    static QHash<QString, QStringList> importedAssets(const QString &projectRoot);
+
+signals:
+    void progress(int done, int total);
+    void finished(const QVector<ImportResult> &results, qint64 milliseconds);
+
+private:
+    struct ManifestEntry {
+        qint64 size = 0;
+        qint64 modified = 0;
+        QByteArray importer;
+        quint32 version = 0;
+        QByteArray key; // Пустой — записи нет
+        QStringList dependencies;
+    };
+    using Manifest = QHash<QString, ManifestEntry>; // Ключ — путь ассета относительно проекта
+
+    static QString manifestPath(const QString &projectRoot);
+    static Manifest loadManifest(const QString &projectRoot);
+    static void saveManifest(const QString &projectRoot, const Manifest &manifest);
+    void commitManifest();
+
+    ImportResult importFile(const QString &source, const QString &projectRoot, const ManifestEntry &known) const;
+    void onFileImported(quint64 batch, const ImportResult &result);
+
+    CookedAssetCache cookedCache;
+    std::vector<std::unique_ptr<AssetImporter>> importers;
+    std::vector<core::JobHandle> jobs; // Задачи используют importers — деструктор дожидается их
+    QString root;
+    Manifest manifest;
+    Manifest imported; // Записи текущего импорта
+    QVector<ImportResult> results;
+    QElapsedTimer timer;
+    std::atomic<quint64> batchId; // Задачи отменённого импорта пропускаются, их ответы отбрасываются
+    int total;
+    bool running;
+};
+
+#endif // ASSETIMPORT_H
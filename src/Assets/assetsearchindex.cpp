@@ -0,0 +1,276 @@
+#include "assetsearchindex.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPECTER_SEARCH_SSE2 1
+#endif
+
+namespace {
+
+inline char toLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+}
+
+inline int charBit(unsigned char c) {
+    if (c >= 'a' && c <= 'z')
+        return c - 'a';
+    if (c >= '0' && c <= '9')
+        return 26 + (c - '0');
+    switch (c) {
+    case '_': return 36;
+    case '-': return 37;
+    case '.': return 38;
+    case '/': return 39;
+    case ' ': return 40;
+    default: return 41 + (c % 23); // Прочие байты (в т.ч. UTF-8) делят оставшиеся биты
+    }
+}
+
+inline uint32_t trigramKey(const char *p) {
+    return (uint32_t(uint8_t(p[0])) << 16) | (uint32_t(uint8_t(p[1])) << 8) | uint32_t(uint8_t(p[2]));
+}
+
+inline bool isBoundary(char c) {
+    return c == '/' || c == '_' || c == '-' || c == '.' || c == ' ';
+}
+
+// Отбор id, у которых маска содержит все биты запроса. Непрерывный проход по всем записям — SSE2
+size_t filterAllByMask(const uint64_t *masks, size_t count, uint64_t queryMask, uint32_t *out) {
+    size_t found = 0;
+    size_t i = 0;
+#ifdef SPECTER_SEARCH_SSE2
+    const __m128i query = _mm_set1_epi64x(static_cast<long long>(queryMask));
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + i + 2));
+        // 64-битное равенство = равенство обеих 32-битных половин
+        int bitsA = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(a, query), query));
+        int bitsB = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(b, query), query));
+        if ((bitsA | bitsB) == 0)
+            continue;
+        if ((bitsA & 0x00FF) == 0x00FF) out[found++] = uint32_t(i);
+        if ((bitsA & 0xFF00) == 0xFF00) out[found++] = uint32_t(i + 1);
+        if ((bitsB & 0x00FF) == 0x00FF) out[found++] = uint32_t(i + 2);
+        if ((bitsB & 0xFF00) == 0xFF00) out[found++] = uint32_t(i + 3);
+    }
+#endif
+    for (; i < count; ++i) {
+        if ((masks[i] & queryMask) == queryMask)
+            out[found++] = uint32_t(i);
+    }
+    return found;
+}
+
+} // namespace
+
+uint32_t AssetSearchIndex::add(const std::string &path) {
+    uint32_t id = static_cast<uint32_t>(offsets.size());
+    uint32_t offset = static_cast<uint32_t>(text.size());
+    size_t nameStart = 0;
+    for (size_t i = 0; i < path.size(); ++i) {
+        char c = toLowerAscii(path[i]);
+        if (c == '/')
+            nameStart = i + 1;
+        text.push_back(c);
+    }
+    offsets.push_back(offset);
+    lengths.push_back(static_cast<uint32_t>(path.size()));
+    nameStarts.push_back(static_cast<uint32_t>(nameStart));
+    masks.push_back(charMask(pathText(id), path.size()));
+    matched.push_back(0);
+
+    // Каждая триграмма пути попадает в список один раз; id растут, списки остаются отсортированными
+    const char *p = pathText(id);
+    for (size_t i = 0; i + 3 <= path.size(); ++i) {
+        std::vector<uint32_t> &postings = trigrams[trigramKey(p + i)];
+        if (postings.empty() || postings.back() != id)
+            postings.push_back(id);
+    }
+    invalidateCache();
+    return id;
+}
+
+void AssetSearchIndex::remove(uint32_t id) {
+    if (id < masks.size())
+        masks[id] = 0; // Списки триграмм не трогаем: удалённые id отсекаются по маске
+    invalidateCache();
+}
+
+void AssetSearchIndex::clear() {
+    text.clear();
+    offsets.clear();
+    lengths.clear();
+    nameStarts.clear();
+    masks.clear();
+    trigrams.clear();
+    matched.clear();
+    results.clear();
+    invalidateCache();
+}
+
+void AssetSearchIndex::invalidateCache() {
+    substringStack.clear();
+    fuzzyStack.clear();
+}
+
+void AssetSearchIndex::popToPrefix(std::vector<CachedPrefix> &stack, const std::string &query) {
+    while (!stack.empty()) {
+        const std::string &cached = stack.back().query;
+        if (cached.size() <= query.size() && query.compare(0, cached.size(), cached) == 0)
+            return;
+        stack.pop_back();
+    }
+}
+
+uint64_t AssetSearchIndex::charMask(const char *text, size_t length) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < length; ++i)
+        mask |= uint64_t(1) << charBit(static_cast<unsigned char>(text[i]));
+    return mask;
+}
+
+int AssetSearchIndex::substringScore(size_t position, size_t length, size_t nameStart, const char *text) {
+    int score = 100000;
+    if (position >= nameStart)
+        score += 2000;
+    if (position == nameStart)
+        score += 1000;
+    if (position == 0 || isBoundary(text[position - 1]))
+        score += 500;
+    return score - static_cast<int>(length);
+}
+
+int AssetSearchIndex::fuzzyScore(const char *text, size_t length, size_t nameStart, const std::string &query) {
+    // Жадное сопоставление слева направо; memchr в glibc векторизован
+    int score = 0;
+    size_t position = 0;
+    size_t previous = size_t(-1);
+    for (char c : query) {
+        const void *found = std::memchr(text + position, c, length - position);
+        if (!found)
+            return -1;
+        size_t index = static_cast<const char *>(found) - text;
+        score += 10;
+        if (index == previous + 1)
+            score += 15;
+        if (index == 0 || isBoundary(text[index - 1]))
+            score += 20;
+        if (index >= nameStart)
+            score += 5;
+        previous = index;
+        position = index + 1;
+    }
+    return score - static_cast<int>(length / 4);
+}
+
+void AssetSearchIndex::collectSubstringMatches(const std::string &query) {
+    // Источник кандидатов: совпадения закэшированного префикса либо самый короткий список триграмм
+    popToPrefix(substringStack, query);
+    const std::vector<uint32_t> *source = nullptr;
+    if (!substringStack.empty()) {
+        source = &substringStack.back().ids;
+    } else {
+        for (size_t i = 0; i + 3 <= query.size(); ++i) {
+            auto it = trigrams.find(trigramKey(query.data() + i));
+            if (it == trigrams.end())
+                return;
+            if (!source || it->second.size() < source->size())
+                source = &it->second;
+        }
+    }
+
+    std::vector<uint32_t> hits;
+    for (uint32_t id : *source) {
+        if (masks[id] == 0)
+            continue;
+        std::string_view path(pathText(id), lengths[id]);
+        size_t position = path.find(query);
+        if (position == std::string_view::npos)
+            continue;
+        hits.push_back(id);
+        offer(id, substringScore(position, lengths[id], nameStarts[id], pathText(id)));
+        matched[id] = 1;
+        matchedIds.push_back(id);
+    }
+    if (substringStack.empty() || substringStack.back().query != query)
+        substringStack.push_back({query, std::move(hits)});
+}
+
+void AssetSearchIndex::collectFuzzyMatches(const std::string &query) {
+    popToPrefix(fuzzyStack, query);
+
+    const uint64_t queryMask = charMask(query.data(), query.size());
+    std::vector<uint32_t> candidates;
+    if (fuzzyStack.empty()) {
+        candidates.resize(masks.size());
+        candidates.resize(filterAllByMask(masks.data(), masks.size(), queryMask, candidates.data()));
+    } else {
+        const std::vector<uint32_t> &previous = fuzzyStack.back().ids;
+        candidates.reserve(previous.size());
+        for (uint32_t id : previous) {
+            if ((masks[id] & queryMask) == queryMask)
+                candidates.push_back(id);
+        }
+    }
+
+    // Оставляем только реальные совпадения — они станут кандидатами для следующей буквы
+    size_t kept = 0;
+    for (uint32_t id : candidates) {
+        int score = fuzzyScore(pathText(id), lengths[id], nameStarts[id], query);
+        if (score < 0)
+            continue;
+        candidates[kept++] = id;
+        if (!matched[id])
+            offer(id, score);
+    }
+    candidates.resize(kept);
+    if (fuzzyStack.empty() || fuzzyStack.back().query != query)
+        fuzzyStack.push_back({query, std::move(candidates)});
+}
+
+bool AssetSearchIndex::better(const Match &a, const Match &b) const {
+    if (a.score != b.score)
+        return a.score > b.score;
+    if (lengths[a.id] != lengths[b.id])
+        return lengths[a.id] < lengths[b.id];
+    return a.id < b.id;
+}
+
+void AssetSearchIndex::offer(uint32_t id, int score) {
+    // Ограниченная куча: совпадения хуже текущего худшего из лучших отбрасываются сразу
+    auto comparator = [this](const Match &a, const Match &b) { return better(a, b); };
+    Match match{id, score};
+    if (results.size() < resultLimit) {
+        results.push_back(match);
+        std::push_heap(results.begin(), results.end(), comparator);
+    } else if (better(match, results.front())) {
+        std::pop_heap(results.begin(), results.end(), comparator);
+        results.back() = match;
+        std::push_heap(results.begin(), results.end(), comparator);
+    }
+}
+
+const std::vector<AssetSearchIndex::Match> &AssetSearchIndex::search(const std::string &rawQuery, size_t maxResults) {
+    for (uint32_t id : matchedIds)
+        matched[id] = 0;
+    matchedIds.clear();
+    results.clear();
+    resultLimit = maxResults;
+    if (rawQuery.empty() || maxResults == 0)
+        return results;
+
+    std::string query(rawQuery.size(), '\0');
+    std::transform(rawQuery.begin(), rawQuery.end(), query.begin(), toLowerAscii);
+
+    if (query.size() >= 3)
+        collectSubstringMatches(query);
+    // Точные вхождения всегда выше нечётких; если их хватает на всю выдачу, нечёткий проход не нужен
+    if (matchedIds.size() < maxResults)
+        collectFuzzyMatches(query);
+
+    std::sort_heap(results.begin(), results.end(), [this](const Match &a, const Match &b) { return better(a, b); });
+    return results;
+}
@@ -0,0 +1,67 @@
+#ifndef ASSETSEARCHINDEX_H
+#define ASSETSEARCHINDEX_H
+
+#include "Core/memorytracker.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Индекс для поиска ассетов по мере ввода.
+// Два уровня: точные вхождения подстроки находятся пересечением триграммных списков,
+// нечёткие совпадения (символы запроса как подпоследовательность пути) — проходом по битовым
+// маскам символов с SIMD-фильтром. Наборы кандидатов нечёткого уровня кэшируются по префиксам
+// запроса, поэтому каждая следующая буква фильтрует уже суженный набор.
+class AssetSearchIndex {
+public:
+    struct Match {
+        uint32_t id;
+        int score;
+    };
+
+    uint32_t add(const std::string &path);
+    void remove(uint32_t id);
+    void clear();
+    size_t size() const { return offsets.size(); }
+
+    // Возвращает не более maxResults лучших совпадений, отсортированных по убыванию score
+    const std::vector<Match> &search(const std::string &query, size_t maxResults);
+
+private:
+    // Закэшированный результат для префикса запроса: все id, совпавшие с query
+    struct CachedPrefix {
+        std::string query;
+        std::vector<uint32_t> ids;
+    };
+
+    static uint64_t charMask(const char *text, size_t length);
+    static int fuzzyScore(const char *text, size_t length, size_t nameStart, const std::string &query);
+    static int substringScore(size_t position, size_t length, size_t nameStart, const char *text);
+    static void popToPrefix(std::vector<CachedPrefix> &stack, const std::string &query);
+
+    const char *pathText(uint32_t id) const { return text.data() + offsets[id]; }
+    void collectSubstringMatches(const std::string &query);
+    void collectFuzzyMatches(const std::string &query);
+    void invalidateCache();
+    void offer(uint32_t id, int score);
+    bool better(const Match &a, const Match &b) const;
+
+    template<typename T>
+    using Array = core::TaggedVector<T, core::MemoryTag::Assets>;
+
+    Array<char> text;           // Пути в нижнем регистре подряд
+    Array<uint32_t> offsets;
+    Array<uint32_t> lengths;
+    Array<uint32_t> nameStarts; // Начало имени файла после последнего '/'
+    Array<uint64_t> masks;      // 0 — запись удалена
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+
+    std::vector<CachedPrefix> substringStack; // id, содержащие query как подстроку
+    std::vector<CachedPrefix> fuzzyStack;     // id, содержащие query как подпоследовательность
+    std::vector<uint8_t> matched;     // Отметки id, совпавших как подстрока в текущем запросе
+    std::vector<uint32_t> matchedIds;
+    std::vector<Match> results;       // Куча лучших maxResults совпадений (вершина — худшее)
+    size_t resultLimit = 0;
+};
+
+#endif // ASSETSEARCHINDEX_H
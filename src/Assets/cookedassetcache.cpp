@@ -0,0 +1,95 @@
+#include "cookedassetcache.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const quint32 CookedMagic = 0x444B4353; // "SCKD"
+const quint32 CookedVersion = 1;
+
+struct CookedHeader {
+    quint32 magic;
+    quint32 version;
+    quint64 size; // Байт полезных данных после заголовка
+    char key[40];
+};
+
+} // namespace
+
+CookedAssetCache::CookedAssetCache(const QString &directory) : root(directory) {
+    QDir().mkpath(root);
+}
+
+QString CookedAssetCache::defaultDirectory() {
+    const QString shared = qEnvironmentVariable("SPECTER_COOKED_CACHE");
+    if (!shared.isEmpty())
+        return shared;
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/cooked";
+}
+
+QByteArray CookedAssetCache::contentHash(const QByteArray &data) {
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QByteArray CookedAssetCache::key(const QByteArray &sourceHash, const QByteArray &importer, quint32 version) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(sourceHash);
+    hash.addData(importer);
+    const quint32 littleEndianVersion = qToLittleEndian(version);
+    hash.addData(reinterpret_cast<const char *>(&littleEndianVersion), sizeof(littleEndianVersion));
+    return hash.result().toHex();
+}
+
+QString CookedAssetCache::pathFor(const QByteArray &key) const {
+    // Два уровня каталогов, чтобы в одном не копились сотни тысяч файлов
+    const QString name = QString::fromLatin1(key);
+    return root + '/' + name.left(2) + '/' + name.mid(2) + ".cooked";
+}
+
+bool CookedAssetCache::contains(const QByteArray &key) const {
+    return QFileInfo(pathFor(key)).isFile();
+}
+
+QByteArray CookedAssetCache::load(const QByteArray &key) const {
+    QFile file(pathFor(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    CookedHeader header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header)))
+        return QByteArray();
+    if (header.magic != CookedMagic || header.version != CookedVersion || key.size() != int(sizeof(header.key))
+        || std::memcmp(header.key, key.constData(), sizeof(header.key)) != 0
+        || header.size != quint64(file.size() - qint64(sizeof(header))))
+        return QByteArray();
+    return file.readAll();
+}
+
+bool CookedAssetCache::store(const QByteArray &key, const QByteArray &cooked, QString *error) const {
+    const QString path = pathFor(key);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    CookedHeader header{};
+    header.magic = CookedMagic;
+    header.version = CookedVersion;
+    header.size = quint64(cooked.size());
+    std::memcpy(header.key, key.constData(), qMin(size_t(key.size()), sizeof(header.key)));
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(cooked);
+    if (!file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
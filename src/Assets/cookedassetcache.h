@@ -0,0 +1,35 @@
+#ifndef COOKEDASSETCACHE_H
+#define COOKEDASSETCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+// Кэш готовых к рантайму («приготовленных») ассетов с адресацией по содержимому.
+// Ключ — SHA-1 от хэша исходного файла, имени импортёра и его версии, поэтому неизменённый
+// исходник никогда не готовится заново, а смена версии импортёра даёт новые ключи.
+// Файлы пишутся через QSaveFile (атомарное переименование), так что кэш можно делить между
+// рабочими копиями и процессами: по умолчанию он в каталоге кэша пользователя,
+// SPECTER_COOKED_CACHE указывает общий каталог. Все методы потокобезопасны
+class CookedAssetCache {
+public:
+    explicit CookedAssetCache(const QString &directory = defaultDirectory());
+
+    static QString defaultDirectory();
+    QString directory() const { return root; }
+
+    // SHA-1 содержимого
+    static QByteArray contentHash(const QByteArray &data);
+    // Ключ в шестнадцатеричном виде
+    static QByteArray key(const QByteArray &sourceHash, const QByteArray &importer, quint32 version);
+
+    bool contains(const QByteArray &key) const;
+    // Пустой массив, если записи нет или она повреждена
+    QByteArray load(const QByteArray &key) const;
+    bool store(const QByteArray &key, const QByteArray &cooked, QString *error = nullptr) const;
+    QString pathFor(const QByteArray &key) const;
+
+private:
+    QString root;
+};
+
+#endif // COOKEDASSETCACHE_H
@@ -0,0 +1,207 @@
+#include "librarycatalog.h"
+#include "Core/jobsystem.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const quint32 CatalogMagic = 0x534C4342; // "SLCB"
+const quint32 CatalogVersion = 2;
+
+} // namespace
+
+LibraryCatalog *LibraryCatalog::instance() {
+    static QPointer<LibraryCatalog> catalog;
+    if (!catalog)
+        catalog = new LibraryCatalog(QCoreApplication::instance());
+    return catalog;
+}
+
+LibraryCatalog::LibraryCatalog(QObject *parent)
+    : QObject(parent), loading(false), refreshQueued(false) {
+    qRegisterMetaType<QVector<LibraryInfo>>();
+}
+
+void LibraryCatalog::refresh(const QStringList &directories) {
+    if (loading) {
+        // Повторный запрос во время сканирования выполним после текущего
+        refreshQueued = true;
+        queuedDirectories = directories;
+        return;
+    }
+    loading = true;
+
+    core::JobSystem::instance().runThen([directories]() { return scan(directories); }, this,
+                                        [this](const QVector<LibraryInfo> &result) {
+        current = result;
+        loading = false;
+        emit loaded(current);
+        if (refreshQueued) {
+            refreshQueued = false;
+            refresh(queuedDirectories);
+        }
+    });
+}
+
+QString LibraryCatalog::cacheFile() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/librarycatalog.bin";
+}
+
+LibraryCatalog::Cache LibraryCatalog::loadCache() {
+    Cache cache;
+    QFile file(cacheFile());
+    if (!file.open(QIODevice::ReadOnly))
+        return cache;
+    QDataStream stream(&file);
+    quint32 magic, version, directoryCount;
+    stream >> magic >> version >> directoryCount;
+    if (magic != CatalogMagic || version != CatalogVersion)
+        return cache;
+    for (quint32 d = 0; d < directoryCount && stream.status() == QDataStream::Ok; ++d) {
+        QString path;
+        DirectoryEntry directory;
+        quint32 fileCount;
+        stream >> path >> directory.modified >> fileCount;
+        for (quint32 f = 0; f < fileCount && stream.status() == QDataStream::Ok; ++f) {
+            QString fileName;
+            FileEntry entry;
+            stream >> fileName >> entry.modified >> entry.size
+                   >> entry.info.name >> entry.info.description >> entry.info.avatarPath >> entry.info.configPath
+                   >> entry.info.modulePath >> entry.info.dependencies >> entry.info.initOrder >> entry.info.onDemand;
+            directory.files.insert(fileName, entry);
+        }
+        cache.insert(path, directory);
+    }
+    if (stream.status() != QDataStream::Ok)
+        cache.clear(); // Повреждённый кэш просто пересобирается
+    return cache;
+}
+
+void LibraryCatalog::saveCache(const Cache &cache) {
+    QDir().mkpath(QFileInfo(cacheFile()).absolutePath());
+    QSaveFile file(cacheFile());
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream stream(&file);
+    stream << CatalogMagic << CatalogVersion << quint32(cache.size());
+    for (auto dir = cache.cbegin(); dir != cache.cend(); ++dir) {
+        stream << dir.key() << dir->modified << quint32(dir->files.size());
+        for (auto it = dir->files.cbegin(); it != dir->files.cend(); ++it) {
+            stream << it.key() << it->modified << it->size
+                   << it->info.name << it->info.description << it->info.avatarPath << it->info.configPath
+                   << it->info.modulePath << it->info.dependencies << it->info.initOrder << it->info.onDemand;
+        }
+    }
+    file.commit();
+}
+
+LibraryInfo LibraryCatalog::parseConfig(const QString &configPath) {
+    LibraryInfo info;
+    QSettings settings(configPath, QSettings::IniFormat);
+    settings.beginGroup("Library");
+    info.name = settings.value("Name").toString();
+    info.description = settings.value("Description").toString();
+    const QString avatar = settings.value("Avatar").toString();
+    // Module=librender.so — файл рядом с .cfg; Depends — имена библиотек; Load=OnDemand — не открывать сразу
+    const QString module = settings.value("Module").toString();
+    info.dependencies = settings.value("Depends").toStringList();
+    info.initOrder = settings.value("Order", 0).toInt();
+    info.onDemand = settings.value("Load").toString().compare("OnDemand", Qt::CaseInsensitive) == 0;
+    settings.endGroup();
+    info.avatarPath = QFileInfo(configPath).dir().absoluteFilePath(avatar);
+    if (!module.isEmpty())
+        info.modulePath = QFileInfo(configPath).dir().absoluteFilePath(module);
+    info.configPath = configPath;
+    return info;
+}
+
+QVector<LibraryInfo> LibraryCatalog::scan(const QStringList &directories) {
+    const Cache cached = loadCache();
+    Cache updated;
+    bool changed = false;
+
+    struct Stale {
+        QString directory;
+        QString fileName;
+        QString configPath;
+    };
+    QVector<Stale> stale;
+
+    for (const QString &directoryPath : directories) {
+        QFileInfo directoryInfo(directoryPath);
+        if (!directoryInfo.isDir())
+            continue;
+        const QString absolute = directoryInfo.absoluteFilePath();
+        const DirectoryEntry previous = cached.value(absolute);
+        DirectoryEntry &entry = updated[absolute];
+        entry.modified = directoryInfo.lastModified().toMSecsSinceEpoch();
+
+        // Состав каталога не менялся — достаточно проверить mtime известных файлов без readdir
+        QFileInfoList files;
+        if (cached.contains(absolute) && previous.modified == entry.modified) {
+            for (auto it = previous.files.cbegin(); it != previous.files.cend(); ++it)
+                files.append(QFileInfo(absolute + '/' + it.key()));
+        } else {
+            files = QDir(absolute).entryInfoList(QStringList() << "*.cfg", QDir::Files);
+            changed = true;
+        }
+
+        for (const QFileInfo &file : files) {
+            if (!file.isFile()) {
+                changed = true;
+                continue;
+            }
+            const QString fileName = file.fileName();
+            const qint64 modified = file.lastModified().toMSecsSinceEpoch();
+            auto known = previous.files.constFind(fileName);
+            if (known != previous.files.constEnd() && known->modified == modified && known->size == file.size()) {
+                entry.files.insert(fileName, *known);
+                continue;
+            }
+            FileEntry &fresh = entry.files[fileName];
+            fresh.modified = modified;
+            fresh.size = file.size();
+            stale.append({absolute, fileName, file.absoluteFilePath()});
+        }
+    }
+    if (updated.size() != cached.size())
+        changed = true;
+
+    // Изменившиеся .cfg разбираются параллельно; каждый поток пишет только в свой слот
+    if (!stale.isEmpty()) {
+        changed = true;
+        std::vector<LibraryInfo> parsed(size_t(stale.size()));
+        core::JobSystem::instance().parallelFor(0, size_t(stale.size()), 4, [&stale, &parsed](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                parsed[i] = parseConfig(stale.at(int(i)).configPath);
+        });
+        for (int i = 0; i < stale.size(); ++i)
+            updated[stale[i].directory].files[stale[i].fileName].info = parsed[size_t(i)];
+    }
+
+    if (changed)
+        saveCache(updated);
+
+    // Порядок как раньше: каталоги в заданном порядке, внутри — по имени файла
+    QVector<LibraryInfo> result;
+    for (const QString &directoryPath : directories) {
+        const QString absolute = QFileInfo(directoryPath).absoluteFilePath();
+        auto dir = updated.constFind(absolute);
+        if (dir == updated.constEnd())
+            continue;
+        QStringList names = dir->files.keys();
+        std::sort(names.begin(), names.end());
+        for (const QString &name : names)
+            result.append(dir->files.value(name).info);
+    }
+    return result;
+}
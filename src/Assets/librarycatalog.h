@@ -0,0 +1,70 @@
+#ifndef LIBRARYCATALOG_H
+#define LIBRARYCATALOG_H
+
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct LibraryInfo {
+    QString name;
+    QString description;
+    QString avatarPath; // Абсолютный путь
+    QString configPath;
+    // Модуль движка (moduleabi.h); пусто — библиотека без двоичного модуля
+    QString modulePath; // Абсолютный путь
+    QStringList dependencies;
+    int initOrder = 0;
+    bool onDemand = false; // Открывается по запросу, а не при открытии проекта
+};
+
+Q_DECLARE_METATYPE(QVector<LibraryInfo>)
+
+// Каталог библиотек из libs/*. Разобранные .cfg кэшируются на диске вместе с mtime каталогов
+// и файлов: при повторном открытии перечитываются только изменившиеся файлы, причём параллельно
+// и вне UI-потока. Последний результат хранится в памяти и отдаётся сразу.
+class LibraryCatalog : public QObject {
+    Q_OBJECT
+
+public:
+    static LibraryCatalog *instance();
+
+    // Результат последнего сканирования (может быть пустым до первого loaded())
+    const QVector<LibraryInfo> &libraries() const { return current; }
+    bool isLoading() const { return loading; }
+
+    // Запускает фоновую проверку каталогов; по окончании — loaded()
+    void refresh(const QStringList &directories);
+
+signals:
+    void loaded(const QVector<LibraryInfo> &libraries);
+
+private:
+    struct FileEntry {
+        qint64 modified = 0;
+        qint64 size = 0;
+        LibraryInfo info;
+    };
+    struct DirectoryEntry {
+        qint64 modified = 0;
+        QHash<QString, FileEntry> files; // Ключ — имя .cfg
+    };
+    using Cache = QHash<QString, DirectoryEntry>; // Ключ — абсолютный путь каталога
+
+    explicit LibraryCatalog(QObject *parent = nullptr);
+
+    static QString cacheFile();
+    static Cache loadCache();
+    static void saveCache(const Cache &cache);
+    static LibraryInfo parseConfig(const QString &configPath);
+    static QVector<LibraryInfo> scan(const QStringList &directories);
+
+    QVector<LibraryInfo> current;
+    bool loading;
+    bool refreshQueued;
+    QStringList queuedDirectories;
+};
+
+#endif // LIBRARYCATALOG_H
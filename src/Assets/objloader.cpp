@@ -0,0 +1,412 @@
+#include "objloader.h"
+#include "Core/jobsystem.h"
+#include "Core/profiler.h"
+#include <QFile>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Меньше куски не окупают запуск задачи
+const size_t MinChunkBytes = 256 * 1024;
+const int32_t Missing = -1;
+
+// Степени десяти, точно представимые в double
+const double PowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Угол грани. Пока кусок не сведён с остальными, отрицательный индекс OBJ хранится
+// относительно начала куска (может уйти в минус — в предыдущие куски)
+struct Corner {
+    int32_t index[3]; // Позиция, текстурная координата, нормаль; Missing — не указан
+    uint8_t relative; // Бит i: index[i] ещё не сдвинут на начало куска
+};
+
+struct Chunk {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    std::vector<float> positions; // По 3
+    std::vector<float> texCoords; // По 2
+    std::vector<float> normals;   // По 3
+    std::vector<Corner> corners;  // По 3 на треугольник
+    size_t base[3] = {0, 0, 0};   // Атрибутов в предыдущих кусках
+    const char *errorAt = nullptr;
+    const char *error = nullptr;
+
+    size_t count(int attribute) const {
+        return attribute == 0 ? positions.size() / 3 : attribute == 1 ? texCoords.size() / 2 : normals.size() / 3;
+    }
+};
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(char c) {
+    return unsigned(c - '0') < 10;
+}
+
+inline const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+// Медленный путь: strtod на копии, потому что отображённый файл не завершён нулём
+const char *parseFloatSlow(const char *begin, const char *end, float *value) {
+    char buffer[128];
+    const size_t length = std::min<size_t>(size_t(end - begin), sizeof(buffer) - 1);
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char *stop;
+    const double result = std::strtod(buffer, &stop);
+    if (stop == buffer)
+        return nullptr;
+    *value = float(result);
+    return begin + (stop - buffer);
+}
+
+const char *parseIndex(const char *p, const char *end, long long *value) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    const char *start = p;
+    long long result = 0;
+    while (p < end && isDigit(*p) && result <= INT32_MAX) {
+        result = result * 10 + (*p - '0');
+        ++p;
+    }
+    if (p == start || result > INT32_MAX)
+        return nullptr;
+    *value = negative ? -result : result;
+    return p;
+}
+
+bool parseFloats(const char *p, const char *lineEnd, int required, int stored, std::vector<float> &out) {
+    for (int i = 0; i < stored; ++i) {
+        p = skipBlanks(p, lineEnd);
+        float value = 0.0f;
+        const char *next = p < lineEnd ? ObjLoader::parseFloat(p, lineEnd, &value) : nullptr;
+        if (!next) {
+            if (i < required)
+                return false;
+            value = 0.0f;
+        } else {
+            p = next;
+        }
+        out.push_back(value);
+    }
+    return true;
+}
+
+// Грань из трёх и более углов v, v/vt, v//vn или v/vt/vn; разбивается веером
+bool parseFace(Chunk &chunk, const char *p, const char *lineEnd, std::vector<Corner> &face) {
+    face.clear();
+    for (;;) {
+        p = skipBlanks(p, lineEnd);
+        if (p >= lineEnd)
+            break;
+        Corner corner = {{Missing, Missing, Missing}, 0};
+        for (int attribute = 0; attribute < 3; ++attribute) {
+            if (attribute > 0) {
+                if (p >= lineEnd || *p != '/')
+                    break;
+                ++p;
+                if (attribute == 1 && p < lineEnd && *p == '/')
+                    continue; // v//vn
+            }
+            long long value;
+            const char *next = parseIndex(p, lineEnd, &value);
+            if (!next || value == 0)
+                return false;
+            if (value > 0) {
+                corner.index[attribute] = int32_t(value - 1);
+            } else {
+                corner.index[attribute] = int32_t(int64_t(chunk.count(attribute)) + value);
+                corner.relative |= uint8_t(1u << attribute);
+            }
+            p = next;
+        }
+        if (corner.index[0] == Missing || (p < lineEnd && !isBlank(*p)))
+            return false;
+        face.push_back(corner);
+    }
+    if (face.size() < 3)
+        return false;
+    for (size_t i = 2; i < face.size(); ++i) {
+        chunk.corners.push_back(face[0]);
+        chunk.corners.push_back(face[i - 1]);
+        chunk.corners.push_back(face[i]);
+    }
+    return true;
+}
+
+void parseChunk(Chunk &chunk) {
+    std::vector<Corner> face;
+    const char *p = chunk.begin;
+    while (p < chunk.end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', size_t(chunk.end - p)));
+        if (!lineEnd)
+            lineEnd = chunk.end;
+        const char *line = skipBlanks(p, lineEnd);
+        bool ok = true;
+        if (lineEnd - line >= 2 && line[0] == 'v') {
+            if (isBlank(line[1]))
+                ok = parseFloats(line + 2, lineEnd, 3, 3, chunk.positions);
+            else if (lineEnd - line >= 3 && line[1] == 't' && isBlank(line[2]))
+                ok = parseFloats(line + 3, lineEnd, 1, 2, chunk.texCoords);
+            else if (lineEnd - line >= 3 && line[1] == 'n' && isBlank(line[2]))
+                ok = parseFloats(line + 3, lineEnd, 3, 3, chunk.normals);
+        } else if (lineEnd - line >= 2 && line[0] == 'f' && isBlank(line[1])) {
+            ok = parseFace(chunk, line + 2, lineEnd, face);
+        }
+        if (!ok) {
+            chunk.errorAt = line;
+            chunk.error = line[0] == 'f' ? "malformed face" : "malformed vertex attribute";
+            return;
+        }
+        p = lineEnd + 1;
+    }
+}
+
+struct VertexKey {
+    uint32_t index[3]; // Позиция, текстурная координата, нормаль; UINT32_MAX — нет
+};
+
+// Вершины, собранные по позициям: у каждой позиции список вершин с ней. Соседние грани ссылаются
+// на близкие позиции, поэтому поиск идёт по почти последовательной памяти, в отличие от хэш-таблицы
+class VertexTable {
+public:
+    explicit VertexTable(size_t positionCount) : firstVertex(positionCount, UINT32_MAX) {
+        keys.reserve(positionCount);
+        nextVertex.reserve(positionCount);
+    }
+
+    uint32_t insert(const VertexKey &key) {
+        uint32_t &first = firstVertex[key.index[0]];
+        for (uint32_t vertex = first; vertex != UINT32_MAX; vertex = nextVertex[vertex]) {
+            if (keys[vertex].index[1] == key.index[1] && keys[vertex].index[2] == key.index[2])
+                return vertex;
+        }
+        const uint32_t vertex = uint32_t(keys.size());
+        keys.push_back(key);
+        nextVertex.push_back(first);
+        first = vertex;
+        return vertex;
+    }
+
+    const std::vector<VertexKey> &vertices() const { return keys; }
+
+private:
+    std::vector<uint32_t> firstVertex; // По позиции
+    std::vector<uint32_t> nextVertex;  // По вершине: следующая с той же позицией
+    std::vector<VertexKey> keys;
+};
+
+int lineNumber(const char *data, const char *at) {
+    return int(std::count(data, at, '\n')) + 1;
+}
+
+} // namespace
+
+const char *ObjLoader::parseFloat(const char *begin, const char *end, float *value) {
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    int significant = 0; // Цифр в mantissa, не считая ведущих нулей
+    int exponent = 0;
+    bool anyDigits = false;
+    for (; p < end && isDigit(*p); ++p) {
+        anyDigits = true;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + uint64_t(*p - '0');
+            significant += mantissa != 0;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && isDigit(*p); ++p) {
+            anyDigits = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + uint64_t(*p - '0');
+                significant += mantissa != 0;
+                --exponent;
+            }
+        }
+    }
+    if (!anyDigits)
+        return parseFloatSlow(begin, end, value); // inf, nan
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+        if (q < end && isDigit(*q)) {
+            int written = 0;
+            for (; q < end && isDigit(*q); ++q)
+                written = std::min(written * 10 + (*q - '0'), 100000);
+            exponent += negativeExponent ? -written : written;
+            p = q;
+        }
+    }
+    // Точный быстрый путь: мантисса и степень десяти представимы в double без округления
+    if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+        return parseFloatSlow(begin, end, value);
+    double result = double(mantissa);
+    result = exponent < 0 ? result / PowersOfTen[-exponent] : result * PowersOfTen[exponent];
+    *value = float(negative ? -result : result);
+    return p;
+}
+
+bool ObjLoader::load(const QString &path, MeshData *mesh, QString *error, int threadCount) {
+    SPECTER_PROFILE_SCOPE("ObjLoader::load");
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size == 0)
+        return parse(nullptr, 0, mesh, error, threadCount);
+    const uchar *mapped = file.map(0, size);
+    if (!mapped) {
+        if (error)
+            *error = "Cannot map file: " + file.errorString();
+        return false;
+    }
+    const bool ok = parse(reinterpret_cast<const char *>(mapped), size_t(size), mesh, error, threadCount);
+    file.unmap(const_cast<uchar *>(mapped));
+    return ok;
+}
+
+bool ObjLoader::parse(const char *data, size_t size, MeshData *mesh, QString *error, int threadCount) {
+    SPECTER_PROFILE_SCOPE("ObjLoader::parse");
+    core::JobSystem &jobs = core::JobSystem::instance();
+    if (threadCount <= 0)
+        threadCount = jobs.concurrency();
+
+    // Куски режутся по концам строк
+    const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(size_t(threadCount), size / MinChunkBytes));
+    std::vector<Chunk> chunks(chunkCount);
+    const char *end = data + size;
+    const char *cursor = data;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        Chunk &chunk = chunks[i];
+        chunk.begin = cursor;
+        const char *target = i + 1 == chunkCount ? end : std::max(cursor, data + size / chunkCount * (i + 1));
+        const char *newline =
+            target < end ? static_cast<const char *>(std::memchr(target, '\n', size_t(end - target))) : nullptr;
+        chunk.end = newline ? newline + 1 : end;
+        cursor = chunk.end;
+    }
+    jobs.parallelFor(0, chunkCount, 1, [&chunks](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            parseChunk(chunks[i]);
+    });
+
+    size_t totals[3] = {0, 0, 0};
+    size_t cornerCount = 0;
+    for (Chunk &chunk : chunks) {
+        if (chunk.errorAt) {
+            if (error)
+                *error = QString("Line %1: %2").arg(lineNumber(data, chunk.errorAt)).arg(chunk.error);
+            return false;
+        }
+        for (int attribute = 0; attribute < 3; ++attribute) {
+            chunk.base[attribute] = totals[attribute];
+            totals[attribute] += chunk.count(attribute);
+        }
+        cornerCount += chunk.corners.size();
+    }
+    if (totals[0] >= size_t(INT32_MAX) || cornerCount >= size_t(UINT32_MAX)) {
+        if (error)
+            *error = "Mesh is too large";
+        return false;
+    }
+
+    // Индексы кусков → общие, с проверкой границ
+    std::vector<char> chunkValid(chunkCount, 1);
+    jobs.parallelFor(0, chunkCount, 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            Chunk &chunk = chunks[i];
+            for (Corner &corner : chunk.corners) {
+                for (int attribute = 0; attribute < 3; ++attribute) {
+                    int64_t index = corner.index[attribute];
+                    if (corner.relative & (1u << attribute))
+                        index += int64_t(chunk.base[attribute]);
+                    else if (index == Missing)
+                        continue;
+                    if (index < 0 || uint64_t(index) >= totals[attribute]) {
+                        chunkValid[i] = 0;
+                        return;
+                    }
+                    corner.index[attribute] = int32_t(index);
+                }
+            }
+        }
+    });
+    if (std::find(chunkValid.begin(), chunkValid.end(), 0) != chunkValid.end()) {
+        if (error)
+            *error = "Face index out of range";
+        return false;
+    }
+
+    // Атрибуты кусков подряд
+    std::vector<float> attributes[3];
+    for (int attribute = 0; attribute < 3; ++attribute)
+        attributes[attribute].resize(totals[attribute] * (attribute == 1 ? 2 : 3));
+    jobs.parallelFor(0, chunkCount, 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const Chunk &chunk = chunks[i];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), attributes[0].begin() + ptrdiff_t(chunk.base[0] * 3));
+            std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), attributes[1].begin() + ptrdiff_t(chunk.base[1] * 2));
+            std::copy(chunk.normals.begin(), chunk.normals.end(), attributes[2].begin() + ptrdiff_t(chunk.base[2] * 3));
+        }
+    });
+
+    mesh->hasTexCoords = totals[1] > 0;
+    mesh->hasNormals = totals[2] > 0;
+    mesh->indices.resize(cornerCount);
+
+    // Склейка углов в вершины в порядке первого появления: соседние треугольники остаются рядом в памяти
+    VertexTable table(totals[0]);
+    size_t written = 0;
+    for (const Chunk &chunk : chunks) {
+        for (const Corner &corner : chunk.corners) {
+            const VertexKey key = {{uint32_t(corner.index[0]), uint32_t(corner.index[1]), uint32_t(corner.index[2])}};
+            mesh->indices[written++] = table.insert(key);
+        }
+    }
+    chunks.clear();
+
+    const std::vector<VertexKey> &keys = table.vertices();
+    mesh->vertices.resize(keys.size());
+    jobs.parallelFor(0, keys.size(), 64 * 1024, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const VertexKey &key = keys[i];
+            MeshVertex &vertex = mesh->vertices[i];
+            std::memcpy(vertex.position, &attributes[0][size_t(key.index[0]) * 3], sizeof(vertex.position));
+            if (key.index[1] != UINT32_MAX)
+                std::memcpy(vertex.texCoord, &attributes[1][size_t(key.index[1]) * 2], sizeof(vertex.texCoord));
+            else
+                std::memset(vertex.texCoord, 0, sizeof(vertex.texCoord));
+            if (key.index[2] != UINT32_MAX)
+                std::memcpy(vertex.normal, &attributes[2][size_t(key.index[2]) * 3], sizeof(vertex.normal));
+            else
+                std::memset(vertex.normal, 0, sizeof(vertex.normal));
+        }
+    });
+    return true;
+}
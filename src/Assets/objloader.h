@@ -0,0 +1,41 @@
+#ifndef OBJLOADER_H
+#define OBJLOADER_H
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include "Core/memorytracker.h"
+
+struct MeshVertex {
+    float position[3];
+    float texCoord[2];
+    float normal[3];
+};
+
+// Индексированная сетка: одинаковые сочетания позиции, текстурной координаты и нормали
+// становятся одной вершиной. Отсутствующие в файле атрибуты заполнены нулями
+struct MeshData {
+    core::TaggedVector<MeshVertex, core::MemoryTag::Assets> vertices;
+    core::TaggedVector<uint32_t, core::MemoryTag::Assets> indices;
+    bool hasTexCoords = false;
+    bool hasNormals = false;
+
+    size_t triangleCount() const { return indices.size() / 3; }
+};
+
+// Загрузчик Wavefront OBJ (v, vt, vn, f; прочие директивы пропускаются).
+// Файл отображается в память и режется по границам строк на куски, которые разбираются
+// параллельно в core::JobSystem; числа читаются собственной процедурой без локали и копий.
+// Затем индексы кусков сводятся к общим (с учётом отрицательных индексов OBJ),
+// а одинаковые углы граней склеиваются в одну вершину. Многоугольники разбиваются веером
+class ObjLoader {
+public:
+    // threadCount — на сколько кусков делить файл; 0 — по числу потоков планировщика
+    static bool load(const QString &path, MeshData *mesh, QString *error = nullptr, int threadCount = 0);
+    static bool parse(const char *data, size_t size, MeshData *mesh, QString *error = nullptr, int threadCount = 0);
+
+    // Число с плавающей точкой из [begin, end); nullptr, если числа нет
+    static const char *parseFloat(const char *begin, const char *end, float *value);
+};
+
+#endif // OBJLOADER_H
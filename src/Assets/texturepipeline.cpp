@@ -0,0 +1,416 @@
+#include "texturepipeline.h"
+#include "Core/jobsystem.h"
+#include "Core/profiler.h"
+#include <QBuffer>
+#include <QImageReader>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPECTER_TEXTURE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const int MaxTaps = 8;
+// Шагов таблицы линейный → sRGB: 14 бит хватает, чтобы не терять тёмные оттенки
+const int LinearSteps = 16383;
+
+struct Kernel {
+    int first; // Первый отсчёт исходного уровня относительно 2x
+    int taps;
+    float weights[MaxTaps];
+};
+
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+Kernel makeKernel(MipFilter filter) {
+    Kernel kernel = {};
+    if (filter == MipFilter::Box) {
+        kernel.first = 0;
+        kernel.taps = 2;
+        kernel.weights[0] = kernel.weights[1] = 0.5f;
+        return kernel;
+    }
+    // sinc с частотой среза нового уровня в окне Кайзера (alpha = 4, радиус 4 исходных текселя).
+    // Центр выходного текселя x — между исходными 2x и 2x+1, отсчёты на расстояниях ±0.5…±3.5
+    const double alpha = 4.0, radius = 4.0, pi = 3.14159265358979323846;
+    kernel.first = -3;
+    kernel.taps = 8;
+    double weights[MaxTaps], sum = 0.0;
+    for (int t = 0; t < kernel.taps; ++t) {
+        const double offset = t - 3.5;
+        const double x = pi * offset / 2.0;
+        const double sinc = std::sin(x) / x;
+        const double u = offset / radius;
+        weights[t] = sinc * besselI0(alpha * std::sqrt(1.0 - u * u)) / besselI0(alpha);
+        sum += weights[t];
+    }
+    for (int t = 0; t < kernel.taps; ++t)
+        kernel.weights[t] = float(weights[t] / sum);
+    return kernel;
+}
+
+const Kernel &kernelFor(MipFilter filter) {
+    static const Kernel box = makeKernel(MipFilter::Box);
+    static const Kernel kaiser = makeKernel(MipFilter::Kaiser);
+    return filter == MipFilter::Box ? box : kaiser;
+}
+
+struct ColorTables {
+    float toLinear[256];
+    uint8_t fromLinear[LinearSteps + 1];
+
+    explicit ColorTables(bool srgb) {
+        for (int i = 0; i < 256; ++i) {
+            const double c = i / 255.0;
+            toLinear[i] = float(!srgb ? c : c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+        }
+        for (int i = 0; i <= LinearSteps; ++i) {
+            const double l = double(i) / LinearSteps;
+            const double c = !srgb ? l : l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+            fromLinear[i] = uint8_t(std::lround(std::min(1.0, std::max(0.0, c)) * 255.0));
+        }
+    }
+};
+
+const ColorTables &colorTables(bool srgb) {
+    static const ColorTables srgbTables(true);
+    static const ColorTables linearTables(false);
+    return srgb ? srgbTables : linearTables;
+}
+
+// Строка RGBA8 → линейные float4; альфа всегда линейна
+void rowToLinear(const uint8_t *row, int width, const ColorTables &tables, float *out) {
+    for (int x = 0; x < width; ++x, row += 4, out += 4) {
+        out[0] = tables.toLinear[row[0]];
+        out[1] = tables.toLinear[row[1]];
+        out[2] = tables.toLinear[row[2]];
+        out[3] = row[3] * (1.0f / 255.0f);
+    }
+}
+
+void filterHorizontal(const float *source, int sourceWidth, const Kernel &kernel, float *out, int width) {
+    for (int x = 0; x < width; ++x) {
+        const int base = 2 * x + kernel.first;
+        const bool inside = base >= 0 && base + kernel.taps <= sourceWidth;
+#ifdef SPECTER_TEXTURE_SSE2
+        __m128 sum = _mm_setzero_ps();
+        for (int t = 0; t < kernel.taps; ++t) {
+            const int i = inside ? base + t : std::min(std::max(base + t, 0), sourceWidth - 1);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(kernel.weights[t]), _mm_loadu_ps(source + 4 * i)));
+        }
+        _mm_storeu_ps(out + 4 * x, sum);
+#else
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int t = 0; t < kernel.taps; ++t) {
+            const int i = inside ? base + t : std::min(std::max(base + t, 0), sourceWidth - 1);
+            for (int c = 0; c < 4; ++c)
+                sum[c] += kernel.weights[t] * source[4 * i + c];
+        }
+        std::memcpy(out + 4 * x, sum, sizeof(sum));
+#endif
+    }
+}
+
+// Свёртка отфильтрованных по горизонтали строк и возврат в RGBA8
+void filterVertical(const float *const *rows, const Kernel &kernel, int width, const ColorTables &tables, uint8_t *out) {
+#ifdef SPECTER_TEXTURE_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_setr_ps(float(LinearSteps), float(LinearSteps), float(LinearSteps), 255.0f);
+    alignas(16) int32_t index[4];
+    for (int x = 0; x < width; ++x, out += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (int t = 0; t < kernel.taps; ++t)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(kernel.weights[t]), _mm_loadu_ps(rows[t] + 4 * x)));
+        // Отрицательные лепестки Кайзера дают выход за [0, 1]
+        sum = _mm_min_ps(_mm_max_ps(sum, zero), one);
+        _mm_store_si128(reinterpret_cast<__m128i *>(index), _mm_cvtps_epi32(_mm_mul_ps(sum, scale)));
+        out[0] = tables.fromLinear[index[0]];
+        out[1] = tables.fromLinear[index[1]];
+        out[2] = tables.fromLinear[index[2]];
+        out[3] = uint8_t(index[3]);
+    }
+#else
+    for (int x = 0; x < width; ++x, out += 4) {
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int t = 0; t < kernel.taps; ++t)
+            for (int c = 0; c < 4; ++c)
+                sum[c] += kernel.weights[t] * rows[t][4 * x + c];
+        for (int c = 0; c < 4; ++c)
+            sum[c] = std::min(std::max(sum[c], 0.0f), 1.0f);
+        out[0] = tables.fromLinear[std::lround(sum[0] * LinearSteps)];
+        out[1] = tables.fromLinear[std::lround(sum[1] * LinearSteps)];
+        out[2] = tables.fromLinear[std::lround(sum[2] * LinearSteps)];
+        out[3] = uint8_t(std::lround(sum[3] * 255.0f));
+    }
+#endif
+}
+
+void downsample(const uint8_t *source, size_t sourcePitch, int sourceWidth, int sourceHeight, uint8_t *target,
+                int width, int height, const Kernel &kernel, const ColorTables &tables) {
+    const size_t rowFloats = size_t(width) * 4;
+    core::JobSystem::instance().parallelFor(0, size_t(height), 32, [&](size_t first, size_t last) {
+        // Кольцо строк по номеру исходной строки: соседние выходные строки делят taps - 2 отсчёта
+        std::vector<float> linear(size_t(sourceWidth) * 4);
+        std::vector<float> ring(rowFloats * size_t(kernel.taps));
+        int ringRow[MaxTaps];
+        std::fill(ringRow, ringRow + MaxTaps, -1);
+        const float *rows[MaxTaps];
+        for (size_t y = first; y < last; ++y) {
+            for (int t = 0; t < kernel.taps; ++t) {
+                const int row = std::min(std::max(2 * int(y) + kernel.first + t, 0), sourceHeight - 1);
+                const int slot = row % kernel.taps;
+                float *filtered = ring.data() + rowFloats * size_t(slot);
+                if (ringRow[slot] != row) {
+                    rowToLinear(source + sourcePitch * size_t(row), sourceWidth, tables, linear.data());
+                    filterHorizontal(linear.data(), sourceWidth, kernel, filtered, width);
+                    ringRow[slot] = row;
+                }
+                rows[t] = filtered;
+            }
+            filterVertical(rows, kernel, width, tables, target + size_t(width) * 4 * y);
+        }
+    });
+}
+
+// Блочное сжатие. Концы отрезка — углы описанного параллелепипеда цветов, сдвинутые внутрь
+// на 1/16 размаха (крайние значения редки); индекс — ближайшая точка палитры на этом отрезке
+
+inline uint16_t to565(const int *rgb) {
+    return uint16_t((((rgb[0] * 31 + 127) / 255) << 11) | (((rgb[1] * 63 + 127) / 255) << 5) | ((rgb[2] * 31 + 127) / 255));
+}
+
+inline void from565(uint16_t color, int *rgb) {
+    const int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void encodeColorBlock(const uint8_t *pixels, uint8_t *out) {
+    int low[3] = {255, 255, 255}, high[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c) {
+            low[c] = std::min(low[c], int(pixels[4 * i + c]));
+            high[c] = std::max(high[c], int(pixels[4 * i + c]));
+        }
+    for (int c = 0; c < 3; ++c) {
+        const int inset = (high[c] - low[c]) >> 4;
+        low[c] += inset;
+        high[c] -= inset;
+    }
+    uint16_t color0 = to565(high), color1 = to565(low);
+    if (color0 < color1)
+        std::swap(color0, color1);
+    out[0] = uint8_t(color0);
+    out[1] = uint8_t(color0 >> 8);
+    out[2] = uint8_t(color1);
+    out[3] = uint8_t(color1 >> 8);
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        int palette[2][3];
+        from565(color0, palette[0]);
+        from565(color1, palette[1]);
+        // Проекция на отрезок palette[1] → palette[0]: шаг 0…3 от color1 к color0
+        static const uint32_t indexForStep[4] = {1, 3, 2, 0};
+        int axis[3];
+        for (int c = 0; c < 3; ++c)
+            axis[c] = palette[0][c] - palette[1][c];
+        const int lengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        for (int i = 0; i < 16; ++i) {
+            int dot = 0;
+            for (int c = 0; c < 3; ++c)
+                dot += (int(pixels[4 * i + c]) - palette[1][c]) * axis[c];
+            const int step = std::min(std::max((dot * 3 + lengthSquared / 2) / std::max(lengthSquared, 1), 0), 3);
+            indices |= indexForStep[step] << (2 * i);
+        }
+    }
+    for (int b = 0; b < 4; ++b)
+        out[4 + b] = uint8_t(indices >> (8 * b));
+}
+
+void encodeAlphaBlock(const uint8_t *pixels, uint8_t *out) {
+    int low = 255, high = 0;
+    for (int i = 0; i < 16; ++i) {
+        low = std::min(low, int(pixels[4 * i + 3]));
+        high = std::max(high, int(pixels[4 * i + 3]));
+    }
+    out[0] = uint8_t(high);
+    out[1] = uint8_t(low);
+    uint64_t indices = 0;
+    if (high != low) {
+        // Режим восьми значений: 0 — high, 1 — low, 2…7 — равномерно от high к low
+        const int range = high - low;
+        for (int i = 0; i < 16; ++i) {
+            const int step = ((high - int(pixels[4 * i + 3])) * 14 + range) / (2 * range);
+            const uint64_t index = step == 0 ? 0 : step == 7 ? 1 : uint64_t(step + 1);
+            indices |= index << (3 * i);
+        }
+    }
+    for (int b = 0; b < 6; ++b)
+        out[2 + b] = uint8_t(indices >> (8 * b));
+}
+
+void compressLevel(const uint8_t *source, size_t pitch, int width, int height, TextureFormat format, uint8_t *target) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t blockBytes = format == TextureFormat::BC1 ? 8 : 16;
+    core::JobSystem::instance().parallelFor(0, size_t(blocksY), 8, [&](size_t first, size_t last) {
+        uint8_t pixels[64];
+        for (size_t by = first; by < last; ++by) {
+            uint8_t *out = target + by * size_t(blocksX) * blockBytes;
+            for (int bx = 0; bx < blocksX; ++bx, out += blockBytes) {
+                // Неполные блоки на краях дополняются повтором крайних текселей
+                for (int y = 0; y < 4; ++y) {
+                    const uint8_t *row = source + pitch * size_t(std::min(int(by) * 4 + y, height - 1));
+                    for (int x = 0; x < 4; ++x)
+                        std::memcpy(pixels + 16 * y + 4 * x, row + 4 * std::min(bx * 4 + x, width - 1), 4);
+                }
+                if (format == TextureFormat::BC3) {
+                    encodeAlphaBlock(pixels, out);
+                    encodeColorBlock(pixels, out + 8);
+                } else {
+                    encodeColorBlock(pixels, out);
+                }
+            }
+        }
+    });
+}
+
+bool decodeFrom(QImageReader &reader, QImage *image, QString *error) {
+    reader.setAutoTransform(true);
+    if (!reader.read(image)) {
+        if (error)
+            *error = reader.errorString();
+        return false;
+    }
+    const QImage::Format format = image->hasAlphaChannel() ? QImage::Format_RGBA8888 : QImage::Format_RGBX8888;
+    // Из 32-битных форматов декодера преобразование идёт на месте, второго буфера нет
+    *image = std::move(*image).convertToFormat(format);
+    return true;
+}
+
+} // namespace
+
+size_t TexturePipeline::levelSize(TextureFormat format, int width, int height) {
+    if (format == TextureFormat::RGBA8)
+        return size_t(width) * size_t(height) * 4;
+    const size_t blocks = size_t((width + 3) / 4) * size_t((height + 3) / 4);
+    return blocks * (format == TextureFormat::BC1 ? 8 : 16);
+}
+
+bool TexturePipeline::decode(const QString &path, QImage *image, QString *error) {
+    SPECTER_PROFILE_SCOPE("TexturePipeline::decode");
+    QImageReader reader(path);
+    return decodeFrom(reader, image, error);
+}
+
+bool TexturePipeline::decode(const QByteArray &encoded, QImage *image, QString *error) {
+    SPECTER_PROFILE_SCOPE("TexturePipeline::decode");
+    QBuffer buffer;
+    buffer.setData(encoded); // Разделяемые данные QByteArray, не копия
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    return decodeFrom(reader, image, error);
+}
+
+void TexturePipeline::buildMips(const QImage &base, const Options &options, TextureData *texture) {
+    SPECTER_PROFILE_SCOPE("TexturePipeline::buildMips");
+    texture->format = TextureFormat::RGBA8;
+    texture->base = base;
+    texture->levels.clear();
+    int width = base.width(), height = base.height();
+    texture->levels.push_back({width, height, 0, levelSize(TextureFormat::RGBA8, width, height)});
+    size_t offset = 0;
+    while (options.mipmaps && (width > 1 || height > 1)) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        const size_t size = levelSize(TextureFormat::RGBA8, width, height);
+        texture->levels.push_back({width, height, offset, size});
+        offset += size;
+    }
+    texture->storage.resize(offset);
+
+    const Kernel &kernel = kernelFor(options.filter);
+    const ColorTables &tables = colorTables(options.srgb);
+    for (size_t level = 1; level < texture->levels.size(); ++level) {
+        const TextureLevel &source = texture->levels[level - 1];
+        const TextureLevel &target = texture->levels[level];
+        const size_t pitch = level == 1 ? size_t(base.bytesPerLine()) : size_t(source.width) * 4;
+        downsample(texture->levelData(level - 1), pitch, source.width, source.height,
+                   texture->storage.data() + target.offset, target.width, target.height, kernel, tables);
+    }
+}
+
+void TexturePipeline::compress(TextureData *texture, TextureFormat format) {
+    SPECTER_PROFILE_SCOPE("TexturePipeline::compress");
+    if (format == TextureFormat::RGBA8 || texture->format != TextureFormat::RGBA8)
+        return;
+    std::vector<TextureLevel> levels = texture->levels;
+    size_t offset = 0;
+    for (TextureLevel &level : levels) {
+        level.offset = offset;
+        level.size = levelSize(format, level.width, level.height);
+        offset += level.size;
+    }
+    core::TaggedVector<uint8_t, core::MemoryTag::Assets> storage(offset);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const size_t pitch = i == 0 ? size_t(texture->base.bytesPerLine()) : size_t(levels[i].width) * 4;
+        compressLevel(texture->levelData(i), pitch, levels[i].width, levels[i].height, format,
+                      storage.data() + levels[i].offset);
+    }
+    texture->format = format;
+    texture->base = QImage();
+    texture->levels = std::move(levels);
+    texture->storage.swap(storage);
+}
+
+bool TexturePipeline::process(const QImage &image, const Options &options, TextureData *texture) {
+    if (image.isNull())
+        return false;
+    const bool ready = image.format() == QImage::Format_RGBA8888 || image.format() == QImage::Format_RGBX8888;
+    const QImage base = ready ? image
+                              : image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_RGBA8888
+                                                                              : QImage::Format_RGBX8888);
+    buildMips(base, options, texture);
+    TextureFormat format = options.format;
+    if (format == TextureFormat::BC3 && options.opaqueAsBC1 && !base.hasAlphaChannel())
+        format = TextureFormat::BC1;
+    compress(texture, format);
+    return true;
+}
+
+bool TexturePipeline::process(const QByteArray &encoded, const Options &options, TextureData *texture, QString *error) {
+    QImage image;
+    return decode(encoded, &image, error) && process(image, options, texture);
+}
+
+void TexturePipeline::processFiles(const QStringList &paths, const Options &options, std::vector<TextureData> *textures,
+                                   QStringList *errors) {
+    textures->clear();
+    textures->resize(size_t(paths.size()));
+    std::vector<QString> failures(size_t(paths.size()));
+    // Декодеры Qt однопоточны, поэтому параллельны файлы; мипы и сжатие внутри делятся ещё раз
+    core::JobSystem::instance().parallelFor(0, size_t(paths.size()), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            QImage image;
+            if (decode(paths[int(i)], &image, &failures[i]))
+                process(image, options, &(*textures)[i]);
+        }
+    });
+    errors->clear();
+    for (const QString &failure : failures)
+        errors->append(failure);
+}
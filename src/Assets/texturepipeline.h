@@ -0,0 +1,78 @@
+#ifndef TEXTUREPIPELINE_H
+#define TEXTUREPIPELINE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/memorytracker.h"
+
+enum class TextureFormat : quint32 {
+    RGBA8,
+    BC1, // 4 бита на тексель, без прозрачности
+    BC3  // 8 бит на тексель, альфа отдельным блоком
+};
+
+enum class MipFilter : quint8 {
+    Box,   // Среднее 2×2
+    Kaiser // Окно Кайзера 8×8: резче, без муара на мелких деталях
+};
+
+struct TextureLevel {
+    int width = 0;
+    int height = 0;
+    size_t offset = 0; // В storage
+    size_t size = 0;
+};
+
+// Текстура с мип-цепочкой. Для RGBA8 нулевой уровень — картинка декодера (base) без копирования,
+// остальные лежат в storage; у сжатых форматов в storage все уровни подряд
+struct TextureData {
+    TextureFormat format = TextureFormat::RGBA8;
+    QImage base;
+    std::vector<TextureLevel> levels;
+    core::TaggedVector<uint8_t, core::MemoryTag::Assets> storage;
+
+    int width() const { return levels.empty() ? 0 : levels[0].width; }
+    int height() const { return levels.empty() ? 0 : levels[0].height; }
+    const uint8_t *levelData(size_t level) const {
+        return format == TextureFormat::RGBA8 && level == 0 ? base.constBits() : storage.data() + levels[level].offset;
+    }
+};
+
+// Подготовка текстур для рантайма: декодирование в RGBA8, мип-цепочка, блочное сжатие.
+// Мипы строятся в линейном пространстве (sRGB → линейный → фильтр → sRGB); фильтр раздельный,
+// по 4 канала одного текселя за инструкцию SSE2. Строки уровня делятся на полосы для core::JobSystem;
+// каждая полоса держит кольцо уже отфильтрованных по горизонтали строк, так что промежуточный
+// уровень целиком не создаётся. Сжатие пишет блоки прямо в итоговый буфер, тоже полосами
+class TexturePipeline {
+public:
+    struct Options {
+        TextureFormat format = TextureFormat::BC3;
+        MipFilter filter = MipFilter::Kaiser;
+        bool mipmaps = true;
+        bool srgb = true;        // Цвета в sRGB: фильтровать в линейном пространстве
+        bool opaqueAsBC1 = true; // Картинки без альфы сжимать в BC1 вместо BC3 — вдвое меньше
+    };
+
+    // Декодирует в RGBA8888 (RGBX8888 для непрозрачных); файл читается декодером напрямую
+    static bool decode(const QString &path, QImage *image, QString *error = nullptr);
+    static bool decode(const QByteArray &encoded, QImage *image, QString *error = nullptr);
+    // Уровни RGBA8 над base; без mipmaps — только нулевой
+    static void buildMips(const QImage &base, const Options &options, TextureData *texture);
+    // Сжимает все уровни RGBA8-текстуры
+    static void compress(TextureData *texture, TextureFormat format);
+
+    static bool process(const QImage &image, const Options &options, TextureData *texture);
+    static bool process(const QByteArray &encoded, const Options &options, TextureData *texture, QString *error = nullptr);
+    // Каждый файл — отдельная задача JobSystem; errors[i] пуст, если файл обработан
+    static void processFiles(const QStringList &paths, const Options &options, std::vector<TextureData> *textures,
+                             QStringList *errors);
+
+    static size_t levelSize(TextureFormat format, int width, int height);
+};
+
+#endif // TEXTUREPIPELINE_H
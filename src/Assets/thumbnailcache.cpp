@@ -0,0 +1,331 @@
+#include "thumbnailcache.h"
+#include "Core/jobsystem.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+const quint32 StoreMagic = 0x53544853;  // "STHS"
+const quint32 RecordMagic = 0x53544852; // "STHR"
+const quint32 StoreVersion = 1;
+const qint64 MaxStoreSize = 512ll * 1024 * 1024;
+
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+};
+
+struct RecordHeader {
+    quint32 magic;
+    quint16 size;
+    quint16 width;
+    quint64 hash;
+    quint16 height;
+    quint16 reserved[3];
+};
+
+quint64 hashFileContents(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return 0;
+    quint64 value;
+    std::memcpy(&value, hash.result().constData(), sizeof(value));
+    return value ? value : 1;
+}
+
+} // namespace
+
+// ThumbnailStore
+
+ThumbnailStore::ThumbnailStore(const QString &directory)
+    : mapped(nullptr), mappedSize(0), pathsDirty(false) {
+    QDir().mkpath(directory);
+    pathIndexFile = directory + "/paths.bin";
+    dataFile.setFileName(directory + "/thumbnails.bin");
+    if (!dataFile.open(QIODevice::ReadWrite)) {
+        qWarning("Thumbnail cache is not writable: %s", qPrintable(dataFile.fileName()));
+        return;
+    }
+    loadEntries();
+
+    QFile indexFile(pathIndexFile);
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&indexFile);
+        quint32 magic, version, count;
+        stream >> magic >> version >> count;
+        if (magic == StoreMagic && version == StoreVersion) {
+            paths.reserve(count);
+            for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+                QString path;
+                PathEntry entry;
+                stream >> path >> entry.size >> entry.modified >> entry.hash;
+                paths.insert(path, entry);
+            }
+        }
+    }
+}
+
+ThumbnailStore::~ThumbnailStore() {
+    savePathIndex();
+    if (mapped)
+        dataFile.unmap(mapped);
+}
+
+quint64 ThumbnailStore::entryKey(quint64 contentHash, int size) {
+    return contentHash ^ (quint64(size) * 0x9E3779B97F4A7C15ull);
+}
+
+void ThumbnailStore::loadEntries() {
+    if (dataFile.size() < qint64(sizeof(FileHeader))) {
+        reset();
+        return;
+    }
+    if (!ensureMapped(dataFile.size()))
+        return;
+    FileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    if (header.magic != StoreMagic || header.version != StoreVersion) {
+        reset();
+        return;
+    }
+
+    // Проходим записи подряд; оборванная запись в конце (сбой при записи) отрезается
+    qint64 offset = sizeof(FileHeader);
+    while (offset + qint64(sizeof(RecordHeader)) <= mappedSize) {
+        RecordHeader record;
+        std::memcpy(&record, mapped + offset, sizeof(record));
+        qint64 pixels = qint64(record.width) * record.height * 4;
+        if (record.magic != RecordMagic || offset + qint64(sizeof(record)) + pixels > mappedSize)
+            break;
+        entries.insert(entryKey(record.hash, record.size), {offset + qint64(sizeof(record)), record.width, record.height});
+        offset += sizeof(record) + pixels;
+    }
+    if (offset != dataFile.size()) {
+        dataFile.unmap(mapped);
+        mapped = nullptr;
+        mappedSize = 0;
+        dataFile.resize(offset);
+    }
+}
+
+void ThumbnailStore::reset() {
+    if (mapped) {
+        dataFile.unmap(mapped);
+        mapped = nullptr;
+        mappedSize = 0;
+    }
+    entries.clear();
+    dataFile.resize(0);
+    FileHeader header{StoreMagic, StoreVersion};
+    dataFile.seek(0);
+    dataFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    dataFile.flush();
+}
+
+bool ThumbnailStore::ensureMapped(qint64 end) {
+    if (mapped && end <= mappedSize)
+        return true;
+    // Файл вырос после последнего отображения — перемапливаем целиком
+    if (mapped)
+        dataFile.unmap(mapped);
+    mappedSize = dataFile.size();
+    mapped = mappedSize > 0 ? dataFile.map(0, mappedSize) : nullptr;
+    if (!mapped)
+        mappedSize = 0;
+    return mapped && end <= mappedSize;
+}
+
+quint64 ThumbnailStore::knownHash(const QString &path, qint64 fileSize, qint64 modified) {
+    QMutexLocker locker(&mutex);
+    auto it = paths.constFind(path);
+    if (it == paths.constEnd() || it->size != fileSize || it->modified != modified)
+        return 0;
+    return it->hash;
+}
+
+void ThumbnailStore::rememberHash(const QString &path, qint64 fileSize, qint64 modified, quint64 hash) {
+    QMutexLocker locker(&mutex);
+    paths.insert(path, {fileSize, modified, hash});
+    pathsDirty = true;
+}
+
+QImage ThumbnailStore::find(quint64 contentHash, int size) {
+    QMutexLocker locker(&mutex);
+    auto it = entries.constFind(entryKey(contentHash, size));
+    if (it == entries.constEnd())
+        return QImage();
+    const qint64 bytes = qint64(it->width) * it->height * 4;
+    if (!ensureMapped(it->offset + bytes))
+        return QImage();
+    // Копия из отображения: QImage не должен ссылаться на память, которую перемапят
+    QImage image(it->width, it->height, QImage::Format_ARGB32_Premultiplied);
+    std::memcpy(image.bits(), mapped + it->offset, size_t(bytes));
+    return image;
+}
+
+void ThumbnailStore::insert(quint64 contentHash, int size, const QImage &image) {
+    QImage pixels = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QMutexLocker locker(&mutex);
+    if (!dataFile.isOpen() || entries.contains(entryKey(contentHash, size)))
+        return;
+    if (dataFile.size() > MaxStoreSize)
+        reset(); // Простейшее вытеснение: кэш пересобирается с нуля
+
+    RecordHeader record{};
+    record.magic = RecordMagic;
+    record.size = quint16(size);
+    record.width = quint16(pixels.width());
+    record.height = quint16(pixels.height());
+    record.hash = contentHash;
+
+    qint64 offset = dataFile.size();
+    dataFile.seek(offset);
+    dataFile.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    for (int y = 0; y < pixels.height(); ++y)
+        dataFile.write(reinterpret_cast<const char *>(pixels.constScanLine(y)), pixels.width() * 4);
+    dataFile.flush();
+    entries.insert(entryKey(contentHash, size), {offset + qint64(sizeof(record)), record.width, record.height});
+}
+
+void ThumbnailStore::savePathIndex() {
+    QMutexLocker locker(&mutex);
+    if (!pathsDirty)
+        return;
+    QSaveFile file(pathIndexFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream stream(&file);
+    stream << StoreMagic << StoreVersion << quint32(paths.size());
+    for (auto it = paths.cbegin(); it != paths.cend(); ++it)
+        stream << it.key() << it->size << it->modified << it->hash;
+    if (file.commit())
+        pathsDirty = false;
+}
+
+// ThumbnailService
+
+ThumbnailService *ThumbnailService::instance() {
+    static QPointer<ThumbnailService> service;
+    if (!service)
+        service = new ThumbnailService(QCoreApplication::instance());
+    return service;
+}
+
+ThumbnailService::ThumbnailService(QObject *parent)
+    : QObject(parent),
+      store(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails"),
+      memoryCache(32 * 1024) { // Стоимость в килобайтах
+    // Один поток оставляем UI, чтобы декодирование не конкурировало с отрисовкой
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+ThumbnailService::~ThumbnailService() {
+    pool.clear();
+    pool.waitForDone();
+    store.savePathIndex();
+}
+
+QString ThumbnailService::cacheKey(const QString &path, int size) {
+    return QString::number(size) + ':' + path;
+}
+
+QImage ThumbnailService::cached(const QString &path, int size) {
+    QImage *image = memoryCache.object(cacheKey(path, size));
+    return image ? *image : QImage();
+}
+
+void ThumbnailService::invalidate(const QString &path, int size) {
+    memoryCache.remove(cacheKey(path, size));
+}
+
+void ThumbnailService::request(const QString &path, int size, QObject *receiver, Callback callback) {
+    const QString key = cacheKey(path, size);
+    if (QImage *hit = memoryCache.object(key)) {
+        // Даже при попадании отвечаем через очередь событий: вызывающий может быть внутри data()
+        QImage image = *hit;
+        QPointer<QObject> guard(receiver);
+        QMetaObject::invokeMethod(this, [guard, callback, image]() {
+            if (guard)
+                callback(image);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    QVector<Pending> &waiting = pending[key];
+    waiting.append({receiver, std::move(callback)});
+    if (waiting.size() > 1)
+        return; // Этот файл уже декодируется
+
+    ThumbnailStore *storePointer = &store;
+    core::runThen(&pool, [storePointer, path, size]() { return produce(storePointer, path, size); }, this,
+                  [this, key](const QImage &image) { deliver(key, image); });
+}
+
+QImage ThumbnailService::produce(ThumbnailStore *store, const QString &path, int size) {
+    QFileInfo info(path);
+    if (!info.isFile())
+        return QImage();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    quint64 hash = store->knownHash(path, info.size(), modified);
+    if (!hash) {
+        hash = hashFileContents(path);
+        if (!hash)
+            return QImage();
+        store->rememberHash(path, info.size(), modified, hash);
+    }
+
+    QImage image = store->find(hash, size);
+    if (!image.isNull())
+        return image;
+
+    QImageReader reader(path);
+    QSize sourceSize = reader.size();
+    if (sourceSize.isValid()) {
+        // Для JPEG уменьшение при декодировании почти бесплатно; иначе масштабируем после
+        QSize target = sourceSize.scaled(size, size, Qt::KeepAspectRatio);
+        if (reader.supportsOption(QImageIOHandler::ScaledSize) && target.width() > 0 && target.height() > 0)
+            reader.setScaledSize(target * 2);
+    }
+    if (!reader.read(&image))
+        return QImage();
+    if (image.width() > size || image.height() > size)
+        image = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    store->insert(hash, size, image);
+    return image;
+}
+
+void ThumbnailService::deliver(const QString &key, const QImage &image) {
+    if (!image.isNull())
+        memoryCache.insert(key, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    const QVector<Pending> waiting = pending.take(key);
+    for (const Pending &entry : waiting) {
+        if (entry.receiver)
+            entry.callback(image);
+    }
+}
+
+QImage ThumbnailService::placeholder(int size) {
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QColor(90, 90, 90));
+    painter.setBrush(QColor(60, 60, 60));
+    painter.drawRoundedRect(QRectF(0.5, 0.5, size - 1, size - 1), 4, 4);
+    return image;
+}
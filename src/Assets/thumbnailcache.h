@@ -0,0 +1,95 @@
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QCache>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QThreadPool>
+#include <QVector>
+#include <functional>
+
+// Постоянный кэш миниатюр: один файл с записями подряд, читается через mmap.
+// Ключ записи — хэш содержимого исходного файла и запрошенный размер, поэтому переименование
+// или копирование картинки не требует повторного декодирования.
+class ThumbnailStore {
+public:
+    explicit ThumbnailStore(const QString &directory);
+    ~ThumbnailStore();
+
+    // Хэш содержимого, запомненный для пути с тем же размером и временем изменения; 0 если нет
+    quint64 knownHash(const QString &path, qint64 fileSize, qint64 modified);
+    void rememberHash(const QString &path, qint64 fileSize, qint64 modified, quint64 hash);
+
+    QImage find(quint64 contentHash, int size);
+    void insert(quint64 contentHash, int size, const QImage &image);
+    void savePathIndex();
+
+private:
+    struct Entry {
+        qint64 offset; // Начало пикселей в файле
+        quint16 width;
+        quint16 height;
+    };
+    struct PathEntry {
+        qint64 size;
+        qint64 modified;
+        quint64 hash;
+    };
+
+    static quint64 entryKey(quint64 contentHash, int size);
+    void loadEntries();
+    void reset();
+    bool ensureMapped(qint64 end);
+
+    QMutex mutex;
+    QString pathIndexFile;
+    QFile dataFile;
+    uchar *mapped;
+    qint64 mappedSize;
+    QHash<quint64, Entry> entries;
+    QHash<QString, PathEntry> paths;
+    bool pathsDirty;
+};
+
+// Общий сервис миниатюр: декодирование и уменьшение в пуле потоков, результаты — в UI-поток.
+// Пока миниатюра готовится, виджет показывает заглушку.
+class ThumbnailService : public QObject {
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const QImage &)>;
+
+    static ThumbnailService *instance();
+    ~ThumbnailService();
+
+    // Миниатюра из памяти без обращения к диску; пустой QImage, если её там нет
+    QImage cached(const QString &path, int size);
+    // callback вызывается асинхронно в UI-потоке, только если receiver ещё жив;
+    // пустой QImage — файл не удалось прочитать
+    void request(const QString &path, int size, QObject *receiver, Callback callback);
+    // Забыть миниатюру в памяти: файл изменился. Постоянный кэш сверяет размер и время изменения сам
+    void invalidate(const QString &path, int size);
+    static QImage placeholder(int size);
+
+private:
+    explicit ThumbnailService(QObject *parent = nullptr);
+    static QString cacheKey(const QString &path, int size);
+    static QImage produce(ThumbnailStore *store, const QString &path, int size);
+    void deliver(const QString &key, const QImage &image);
+
+    struct Pending {
+        QPointer<QObject> receiver;
+        Callback callback;
+    };
+
+    QThreadPool pool;
+    ThumbnailStore store;
+    QCache<QString, QImage> memoryCache;
+    QHash<QString, QVector<Pending>> pending;
+};
+
+#endif // THUMBNAILCACHE_H
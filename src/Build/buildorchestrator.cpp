@@ -0,0 +1,493 @@
+#include "buildorchestrator.h"
+#include "Core/jobsystem.h"
+#include "Core/memorytracker.h"
+#include "Core/packarchive.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+const quint32 HashCacheMagic = 0x53424843; // "SBHC"
+const quint32 HashCacheVersion = 1;
+
+struct FileHash {
+    qint64 size = 0;
+    qint64 modified = 0;
+    QByteArray hash;
+};
+
+bool isBuildInput(const QFileInfo &info) {
+    static const QSet<QString> suffixes = {"c", "cc", "cpp", "cxx", "h", "hh", "hpp", "hxx", "inl", "cmake", "in", "qrc", "ui"};
+    return info.fileName() == "CMakeLists.txt" || suffixes.contains(info.suffix().toLower());
+}
+
+// Входы сборки проекта: исходники и файлы CMake. Каталог build и скрытые каталоги пропускаются
+QStringList collectInputs(const QString &project) {
+    QStringList files;
+    QStringList pending{project};
+    while (!pending.isEmpty()) {
+        QDir dir(pending.takeLast());
+        const bool isRoot = dir.absolutePath() == QDir(project).absolutePath();
+        for (const QFileInfo &info : dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot)) {
+            if (info.isDir()) {
+                if (!info.fileName().startsWith('.') && !(isRoot && info.fileName() == "build") && !info.isSymLink())
+                    pending.append(info.absoluteFilePath());
+            } else if (isBuildInput(info)) {
+                files.append(info.absoluteFilePath());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+QHash<QString, FileHash> loadHashCache(const QString &path) {
+    QHash<QString, FileHash> cache;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return cache;
+    QDataStream stream(&file);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (magic != HashCacheMagic || version != HashCacheVersion)
+        return cache;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString relativePath;
+        FileHash entry;
+        stream >> relativePath >> entry.size >> entry.modified >> entry.hash;
+        cache.insert(relativePath, entry);
+    }
+    if (stream.status() != QDataStream::Ok)
+        cache.clear();
+    return cache;
+}
+
+// Примерный размер таблицы в памяти: запись, путь в UTF-16 и узел хэш-таблицы
+size_t hashCacheBytes(const QHash<QString, FileHash> &cache) {
+    size_t bytes = 0;
+    for (auto it = cache.constBegin(); it != cache.constEnd(); ++it)
+        bytes += sizeof(FileHash) + size_t(it.key().size()) * sizeof(QChar) + 48;
+    return bytes;
+}
+
+void saveHashCache(const QString &path, const QHash<QString, FileHash> &cache) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream stream(&file);
+    stream << HashCacheMagic << HashCacheVersion << quint32(cache.size());
+    for (auto it = cache.constBegin(); it != cache.constEnd(); ++it)
+        stream << it.key() << it.value().size << it.value().modified << it.value().hash;
+    file.commit();
+}
+
+// Общий хэш содержимого всех входов и флагов. Хэши отдельных файлов кэшируются по размеру и mtime,
+// поэтому повторная проверка читает только изменившиеся файлы
+QByteArray computeStamp(const QString &project, const QString &buildDirectory, const QString &flags) {
+    const QString cachePath = buildDirectory + "/specter-sources.bin";
+    const QHash<QString, FileHash> previous = loadHashCache(cachePath);
+    QHash<QString, FileHash> current;
+    core::TrackedBytes tracked(core::MemoryTag::Build, hashCacheBytes(previous));
+
+    QCryptographicHash stamp(QCryptographicHash::Sha1);
+    stamp.addData(flags.toUtf8());
+    const QDir root(project);
+    for (const QString &path : collectInputs(project)) {
+        const QFileInfo info(path);
+        const QString relativePath = root.relativeFilePath(path);
+        FileHash entry;
+        entry.size = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+        auto cached = previous.constFind(relativePath);
+        if (cached != previous.constEnd() && cached->size == entry.size && cached->modified == entry.modified) {
+            entry.hash = cached->hash;
+        } else {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+            QCryptographicHash content(QCryptographicHash::Sha1);
+            content.addData(&file);
+            entry.hash = content.result();
+        }
+        stamp.addData(relativePath.toUtf8());
+        stamp.addData(entry.hash);
+        current.insert(relativePath, entry);
+    }
+
+    tracked.set(hashCacheBytes(previous) + hashCacheBytes(current));
+    QDir().mkpath(buildDirectory);
+    saveHashCache(cachePath, current);
+    return stamp.result().toHex();
+}
+
+} // namespace
+
+BuildOrchestrator::BuildOrchestrator(QObject *parent)
+    : QObject(parent), process(nullptr), stage(Idle), currentConfig(Debug), lastConfig(Debug),
+      runAfterBuild(false), generation(0), errorCount(0) {
+    qRegisterMetaType<BuildDiagnostic>();
+    cmakeProgram = QStandardPaths::findExecutable("cmake");
+    if (cmakeProgram.isEmpty())
+        cmakeProgram = "cmake";
+    compilerLauncher = QStandardPaths::findExecutable("ccache");
+    if (!QStandardPaths::findExecutable("ninja").isEmpty())
+        generator = "Ninja";
+}
+
+BuildOrchestrator::~BuildOrchestrator() {
+    if (process) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void BuildOrchestrator::setProjectPath(const QString &path) {
+    if (isRunning())
+        cancel();
+    project = path;
+}
+
+QString BuildOrchestrator::configurationName(Configuration config) {
+    return config == Release ? "Release" : "Debug";
+}
+
+QString BuildOrchestrator::buildDirectory(Configuration config) const {
+    return project + "/build/" + configurationName(config);
+}
+
+QString BuildOrchestrator::stampFile(Configuration config) const {
+    return buildDirectory(config) + "/specter-build.stamp";
+}
+
+QStringList BuildOrchestrator::configureArguments(Configuration config) const {
+    QStringList arguments{"-S", project, "-B", buildDirectory(config),
+                          "-DCMAKE_BUILD_TYPE=" + configurationName(config)};
+    if (!generator.isEmpty())
+        arguments << "-G" << generator;
+    if (!compilerLauncher.isEmpty()) {
+        arguments << "-DCMAKE_C_COMPILER_LAUNCHER=" + compilerLauncher
+                  << "-DCMAKE_CXX_COMPILER_LAUNCHER=" + compilerLauncher;
+    }
+    return arguments;
+}
+
+// Всё, что влияет на результат сборки помимо исходников
+QString BuildOrchestrator::flagsKey(Configuration config) const {
+    return cmakeProgram + '\n' + configureArguments(config).join('\n');
+}
+
+void BuildOrchestrator::build(Configuration config, bool run) {
+    if (isRunning())
+        return;
+    currentConfig = config;
+    lastConfig = config;
+    runAfterBuild = run;
+    errorCount = 0;
+    partialLine.clear();
+    pendingStamp.clear();
+    emit started(config);
+
+    if (!QFileInfo::exists(project + "/CMakeLists.txt")) {
+        emit outputLine(QString("No CMakeLists.txt in %1").arg(project));
+        finish(false, false);
+        return;
+    }
+
+    stage = Hashing;
+    emit outputLine(QString("Checking sources for %1...").arg(configurationName(config)));
+    const quint64 current = generation;
+    const QString projectDir = project;
+    const QString buildDir = buildDirectory(config);
+    const QString flags = flagsKey(config);
+    core::JobSystem::instance().runThen(
+        [projectDir, buildDir, flags]() { return computeStamp(projectDir, buildDir, flags); }, this,
+        [this, current](const QByteArray &stamp) { onStampReady(current, stamp); });
+}
+
+void BuildOrchestrator::onStampReady(quint64 stampGeneration, const QByteArray &stamp) {
+    if (stampGeneration != generation || stage != Hashing)
+        return;
+
+    QFile stored(stampFile(currentConfig));
+    if (stored.open(QIODevice::ReadOnly) && stored.readAll().trimmed() == stamp
+        && QFileInfo::exists(buildDirectory(currentConfig) + "/CMakeCache.txt")) {
+        emit outputLine(QString("%1 is up to date").arg(configurationName(currentConfig)));
+        emit progressChanged(100);
+        if (currentConfig == Release)
+            startPacking(true);
+        else
+            finish(true, true);
+        return;
+    }
+    pendingStamp = stamp;
+
+    // CMake сам перезапускает конфигурацию при изменении CMakeLists.txt, поэтому явно — только в первый раз
+    if (!QFileInfo::exists(buildDirectory(currentConfig) + "/CMakeCache.txt"))
+        startProcess(Configuring, configureArguments(currentConfig));
+    else
+        startProcess(Building, {"--build", buildDirectory(currentConfig), "--parallel",
+                                QString::number(QThread::idealThreadCount())});
+}
+
+void BuildOrchestrator::startProcess(Stage next, const QStringList &arguments) {
+    stage = next;
+    retireProcess();
+    process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyReadStandardOutput, this, &BuildOrchestrator::onProcessOutput);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &BuildOrchestrator::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError processError) {
+        if (processError == QProcess::FailedToStart && stage != Idle) {
+            emit outputLine(QString("Failed to start %1: %2").arg(cmakeProgram, process->errorString()));
+            finish(false, false);
+        }
+    });
+    emit outputLine("> cmake " + arguments.join(' '));
+    process->setWorkingDirectory(project);
+    process->start(cmakeProgram, arguments);
+}
+
+// Отвязывает текущий процесс: убитый завершится сам и удалится, а его запоздалый finished
+// не попадёт в следующую сборку
+void BuildOrchestrator::retireProcess() {
+    if (!process)
+        return;
+    QProcess *old = process;
+    process = nullptr;
+    old->disconnect(this);
+    partialLine.clear();
+    if (old->state() == QProcess::NotRunning) {
+        old->deleteLater();
+        return;
+    }
+    connect(old, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), old, &QObject::deleteLater);
+    old->kill();
+}
+
+void BuildOrchestrator::onProcessOutput() {
+    partialLine.append(process->readAllStandardOutput());
+    int start = 0;
+    int end;
+    while ((end = partialLine.indexOf('\n', start)) != -1) {
+        QString line = QString::fromLocal8Bit(partialLine.constData() + start, end - start);
+        if (line.endsWith('\r'))
+            line.chop(1);
+        handleLine(line);
+        start = end + 1;
+    }
+    partialLine.remove(0, start);
+}
+
+void BuildOrchestrator::handleLine(const QString &line) {
+    emit outputLine(line);
+    const int percent = parseProgress(line);
+    if (percent >= 0)
+        emit progressChanged(percent);
+    BuildDiagnostic diagnostic;
+    if (parseDiagnostic(line, buildDirectory(currentConfig), &diagnostic)) {
+        if (diagnostic.severity == BuildDiagnostic::Error)
+            ++errorCount;
+        emit diagnosticFound(diagnostic);
+    }
+}
+
+void BuildOrchestrator::onProcessFinished(int exitCode, QProcess::ExitStatus status) {
+    if (stage == Idle)
+        return;
+    if (!partialLine.isEmpty()) {
+        handleLine(QString::fromLocal8Bit(partialLine));
+        partialLine.clear();
+    }
+    if (status != QProcess::NormalExit || exitCode != 0) {
+        emit outputLine(stage == Configuring ? "Configuration failed" : QString("Build failed (%1 errors)").arg(errorCount));
+        finish(false, false);
+        return;
+    }
+    if (stage == Configuring) {
+        startProcess(Building, {"--build", buildDirectory(currentConfig), "--parallel",
+                                QString::number(QThread::idealThreadCount())});
+        return;
+    }
+
+    QSaveFile stamp(stampFile(currentConfig));
+    if (stamp.open(QIODevice::WriteOnly)) {
+        stamp.write(pendingStamp);
+        stamp.commit();
+    }
+    emit progressChanged(100);
+    emit outputLine("Build succeeded");
+    if (currentConfig == Release)
+        startPacking(false);
+    else
+        finish(true, false);
+}
+
+// Упаковка files/ в пуле потоков; неизменившийся каталог архив не переписывает
+void BuildOrchestrator::startPacking(bool buildUpToDate) {
+    const QString filesDir = project + "/files";
+    if (!QFileInfo(filesDir).isDir()) {
+        finish(true, buildUpToDate);
+        return;
+    }
+    stage = Packing;
+    emit outputLine("Packing files...");
+    const quint64 current = generation;
+    const QString archive = packFile(currentConfig);
+    core::JobSystem::instance().runThen([filesDir, archive]() {
+        core::PackWriter::Statistics stats;
+        QString error;
+        const bool ok = core::PackWriter::pack(filesDir, archive, &stats, &error);
+        QString message;
+        if (!ok)
+            message = "Packing failed: " + error;
+        else if (stats.upToDate)
+            message = QString("%1 is up to date").arg(QFileInfo(archive).fileName());
+        else
+            message = QString("Packed %1 files (%2 MB -> %3 MB)")
+                          .arg(stats.files)
+                          .arg(stats.inputBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                          .arg(stats.archiveBytes / (1024.0 * 1024.0), 0, 'f', 1);
+        return qMakePair(ok, message);
+    }, this, [this, current, buildUpToDate](const QPair<bool, QString> &result) {
+        onPacked(current, result.first, buildUpToDate, result.second);
+    });
+}
+
+void BuildOrchestrator::onPacked(quint64 packGeneration, bool ok, bool buildUpToDate, const QString &message) {
+    if (packGeneration != generation || stage != Packing)
+        return;
+    emit outputLine(message);
+    finish(ok, buildUpToDate && ok);
+}
+
+void BuildOrchestrator::cancel() {
+    if (!isRunning())
+        return;
+    ++generation;
+    runAfterBuild = false;
+    stage = Idle;
+    retireProcess();
+    emit outputLine("Build cancelled");
+    finish(false, false);
+}
+
+void BuildOrchestrator::finish(bool ok, bool upToDate) {
+    stage = Idle;
+    const bool run = ok && runAfterBuild;
+    runAfterBuild = false;
+    emit finished(ok, upToDate);
+    if (run)
+        launch();
+}
+
+void BuildOrchestrator::launch() {
+    const QString executable = executablePath(currentConfig);
+    if (executable.isEmpty()) {
+        emit outputLine(QString("No executable found in %1").arg(buildDirectory(currentConfig)));
+        return;
+    }
+    // Игра, собранная с движком, сама включает профилировщик по этой переменной
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("SPECTER_TRACE_FILE", traceFile(currentConfig));
+    if (QFileInfo::exists(packFile(currentConfig)))
+        environment.insert("SPECTER_PACK_FILE", packFile(currentConfig));
+    for (auto it = gameEnvironment.cbegin(); it != gameEnvironment.cend(); ++it)
+        environment.insert(it.key(), it.value());
+    QProcess game;
+    game.setProgram(executable);
+    game.setWorkingDirectory(project);
+    game.setProcessEnvironment(environment);
+    if (game.startDetached())
+        emit outputLine("Running " + executable);
+    else
+        emit outputLine("Failed to start " + executable);
+}
+
+QString BuildOrchestrator::traceFile(Configuration config) const {
+    return buildDirectory(config) + "/specter-trace.json";
+}
+
+void BuildOrchestrator::setGameEnvironment(const QString &name, const QString &value) {
+    if (value.isEmpty())
+        gameEnvironment.remove(name);
+    else
+        gameEnvironment.insert(name, value);
+}
+
+QString BuildOrchestrator::packFile(Configuration config) const {
+    return buildDirectory(config) + "/game.pak";
+}
+
+QString BuildOrchestrator::executablePath(Configuration config) const {
+    QFileInfo newest;
+    const QString root = buildDirectory(config);
+    for (const QString &directory : {root, root + "/bin", root + "/" + configurationName(config)}) {
+        for (const QFileInfo &info : QDir(directory).entryInfoList(QDir::Files | QDir::Executable)) {
+#ifdef Q_OS_WIN
+            if (info.suffix().compare("exe", Qt::CaseInsensitive) != 0)
+                continue;
+#else
+            if (info.suffix() == "so" || info.suffix() == "dylib" || info.suffix() == "sh")
+                continue;
+#endif
+            if (!newest.exists() || info.lastModified() > newest.lastModified())
+                newest = info;
+        }
+    }
+    return newest.exists() ? newest.absoluteFilePath() : QString();
+}
+
+bool BuildOrchestrator::parseDiagnostic(const QString &line, const QString &baseDirectory, BuildDiagnostic *diagnostic) {
+    // GCC/Clang: file:line:col: error: message
+    static const QRegularExpression gnuPattern(
+        "^(.+?):(\\d+):(?:(\\d+):)?\\s*(fatal error|error|warning|note):\\s*(.*)$");
+    // MSVC: file(line[,col]): error C1234: message
+    static const QRegularExpression msvcPattern(
+        "^\\s*(.+?)\\((\\d+)(?:,(\\d+))?\\)\\s*:\\s*(fatal error|error|warning)\\s*(?:[A-Z]+\\d+)?\\s*:\\s*(.*)$");
+
+    QRegularExpressionMatch match = gnuPattern.match(line);
+    if (!match.hasMatch())
+        match = msvcPattern.match(line);
+    if (!match.hasMatch())
+        return false;
+
+    const QString kind = match.captured(4);
+    diagnostic->severity = kind == "warning" ? BuildDiagnostic::Warning
+                         : kind == "note"    ? BuildDiagnostic::Note
+                                             : BuildDiagnostic::Error;
+    const QString file = match.captured(1).trimmed();
+    diagnostic->file = QFileInfo(file).isRelative() ? QDir(baseDirectory).absoluteFilePath(file) : file;
+    diagnostic->file = QDir::cleanPath(diagnostic->file);
+    diagnostic->line = match.captured(2).toInt();
+    diagnostic->column = match.captured(3).toInt();
+    diagnostic->message = match.captured(5);
+    return true;
+}
+
+int BuildOrchestrator::parseProgress(const QString &line) {
+    static const QRegularExpression makePattern("^\\[\\s*(\\d+)%\\]");
+    static const QRegularExpression ninjaPattern("^\\[(\\d+)/(\\d+)\\]");
+    QRegularExpressionMatch match = makePattern.match(line);
+    if (match.hasMatch())
+        return qBound(0, match.captured(1).toInt(), 100);
+    match = ninjaPattern.match(line);
+    if (match.hasMatch()) {
+        const int total = match.captured(2).toInt();
+        return total > 0 ? qBound(0, match.captured(1).toInt() * 100 / total, 100) : -1;
+    }
+    return -1;
+}
@@ -0,0 +1,111 @@
+#ifndef BUILDORCHESTRATOR_H
+#define BUILDORCHESTRATOR_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+// Сообщение компилятора, разобранное из вывода сборки
+struct BuildDiagnostic {
+    enum Severity { Error, Warning, Note };
+
+    Severity severity = Error;
+    QString file; // Абсолютный путь
+    int line = 0;
+    int column = 0; // 0 — не указан
+    QString message;
+};
+
+Q_DECLARE_METATYPE(BuildDiagnostic)
+
+// Сборка игры проекта через CMake в отдельном процессе, без блокировки UI.
+// У каждой конфигурации свой каталог (build/Debug, build/Release), поэтому переключение
+// между ними не пересобирает всё заново. Перед сборкой в пуле потоков считается хэш
+// содержимого исходников и флагов; если он совпадает с записанным после прошлой удачной
+// сборки, процесс не запускается вовсе. При наличии ccache он подключается как лаунчер
+// компилятора и кэширует объектные файлы по содержимому.
+// Вывод отдаётся построчно, ошибки и прогресс разбираются из него же.
+// После сборки Release каталог files/ проекта упаковывается в packFile() (см. core::PackArchive).
+class BuildOrchestrator : public QObject {
+    Q_OBJECT
+
+public:
+    enum Configuration { Debug, Release };
+    Q_ENUM(Configuration)
+
+    explicit BuildOrchestrator(QObject *parent = nullptr);
+    ~BuildOrchestrator();
+
+    void setProjectPath(const QString &path);
+    QString projectPath() const { return project; }
+
+    static QString configurationName(Configuration config);
+    QString buildDirectory(Configuration config) const;
+    Configuration lastConfiguration() const { return lastConfig; }
+
+    bool isRunning() const { return stage != Idle; }
+    // Собирает конфигурацию; при run — запускает собранный исполняемый файл. Итог — finished()
+    void build(Configuration config, bool run = false);
+    void cancel();
+
+    // Самый свежий исполняемый файл в каталоге конфигурации (пусто — не найден)
+    QString executablePath(Configuration config) const;
+    // Куда запущенная игра пишет снимок профилировщика (через SPECTER_TRACE_FILE)
+    QString traceFile(Configuration config) const;
+    // Архив ресурсов из files/; игра находит его через SPECTER_PACK_FILE
+    QString packFile(Configuration config) const;
+    // Дополнительная переменная окружения запускаемой игры; пустое value убирает её
+    void setGameEnvironment(const QString &name, const QString &value);
+
+    // Разбор строк вывода. Относительные пути в диагностике считаются от baseDirectory
+    static bool parseDiagnostic(const QString &line, const QString &baseDirectory, BuildDiagnostic *diagnostic);
+    // Процент из "[ 42%]" (Make) или "[12/80]" (Ninja); -1 — строка без прогресса
+    static int parseProgress(const QString &line);
+
+signals:
+    void started(BuildOrchestrator::Configuration config);
+    void outputLine(const QString &line);
+    void diagnosticFound(const BuildDiagnostic &diagnostic);
+    void progressChanged(int percent);
+    // upToDate — сборка пропущена, так как исходники и флаги не менялись
+    void finished(bool ok, bool upToDate);
+
+private:
+    enum Stage { Idle, Hashing, Configuring, Building, Packing };
+
+    QStringList configureArguments(Configuration config) const;
+    QString flagsKey(Configuration config) const;
+    QString stampFile(Configuration config) const;
+
+    void onStampReady(quint64 stampGeneration, const QByteArray &stamp);
+    void startProcess(Stage next, const QStringList &arguments);
+    void retireProcess();
+    void onProcessOutput();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus status);
+    void handleLine(const QString &line);
+    void startPacking(bool buildUpToDate);
+    void onPacked(quint64 packGeneration, bool ok, bool buildUpToDate, const QString &message);
+    void finish(bool ok, bool upToDate);
+    void launch();
+
+    QString project;
+    QString cmakeProgram;
+    QString compilerLauncher; // ccache, если найден
+    QString generator;        // Ninja, если найден, иначе генератор CMake по умолчанию
+    QProcess *process; // Свой на каждый запуск cmake: сигналы прошлого запуска сюда не доходят
+    QByteArray partialLine; // Незавершённая строка между readyRead
+    Stage stage;
+    Configuration currentConfig;
+    Configuration lastConfig;
+    bool runAfterBuild;
+    QHash<QString, QString> gameEnvironment;
+    QByteArray pendingStamp; // Записывается в stampFile после удачной сборки
+    quint64 generation;     // Меняется при отмене, чтобы не принять устаревший хэш
+    int errorCount;
+};
+
+#endif // BUILDORCHESTRATOR_H
@@ -0,0 +1,270 @@
+#include "jobsystem.h"
+#include "profiler.h"
+#include <QThread>
+
+namespace core {
+
+namespace {
+
+const int SpinRounds = 64; // Попыток найти задачу перед тем, как уснуть
+
+struct ThreadContext {
+    JobSystem *system = nullptr;
+    int workerIndex = -1; // -1 — поток вне планировщика
+    Job *current = nullptr;
+};
+
+thread_local ThreadContext context;
+
+// Освобождённые задачи кэшируются в рабочем потоке, который их отпустил. Посторонние потоки
+// не кэшируют: у главного thread_local разрушается раньше статического планировщика, а
+// ~JobSystem ещё отпускает задачи
+struct JobCache {
+    static constexpr size_t Limit = 1024;
+    std::vector<Job *> jobs;
+
+    ~JobCache() {
+        for (Job *job : jobs)
+            delete job;
+    }
+};
+
+thread_local JobCache jobCache;
+
+} // namespace
+
+JobHandle::JobHandle(Job *job) : job(job) {}
+
+JobHandle::JobHandle(const JobHandle &other) : job(other.job) {
+    if (job)
+        job->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+JobHandle &JobHandle::operator=(JobHandle other) noexcept {
+    std::swap(job, other.job);
+    return *this;
+}
+
+JobHandle::~JobHandle() {
+    if (job && job->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        job->destroy(job);
+        if (context.workerIndex >= 0 && jobCache.jobs.size() < JobCache::Limit)
+            jobCache.jobs.push_back(job);
+        else
+            delete job;
+    }
+}
+
+JobSystem::JobSystem(int workerCount)
+    : injectionSize(0), epoch(0), sleepers(0), running(true) {
+    if (workerCount < 0)
+        workerCount = std::max(0, QThread::idealThreadCount() - 1);
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(new Worker);
+        workers.back()->random = uint32_t(i) * 2654435761u + 1;
+    }
+    // Потоки стартуют после того, как все деки созданы: воры обходят весь массив
+    for (int i = 0; i < workerCount; ++i)
+        workers[size_t(i)]->thread = std::thread(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running.store(false);
+    }
+    sleepCondition.notify_all();
+    for (std::unique_ptr<Worker> &worker : workers)
+        worker->thread.join();
+    // Невыполненные задачи не запускаются, но ссылки на них отпускаются
+    for (std::unique_ptr<Worker> &worker : workers) {
+        while (Job *job = worker->deque.pop())
+            release(job);
+    }
+    for (Job *job : injection)
+        release(job);
+}
+
+JobSystem &JobSystem::instance() {
+    static JobSystem system;
+    return system;
+}
+
+JobHandle JobSystem::currentJob() {
+    if (context.current)
+        retain(context.current);
+    return JobHandle(context.current);
+}
+
+Job *JobSystem::allocateJob() {
+    Job *job;
+    if (context.workerIndex >= 0 && !jobCache.jobs.empty()) {
+        job = jobCache.jobs.back();
+        jobCache.jobs.pop_back();
+    } else {
+        job = new Job;
+    }
+    job->parent = nullptr;
+    return job;
+}
+
+void JobSystem::release(Job *job) {
+    JobHandle handle(job); // Деструктор дескриптора отпускает ссылку и при нуле освобождает задачу
+}
+
+void JobSystem::finish(Job *job) {
+    if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    Job *parent = job->parent;
+    release(job); // Ссылка планировщика
+    if (parent) {
+        // Ссылку на родителя держала дочерняя задача; отпускаем её после того, как отчитались
+        finish(parent);
+        release(parent);
+    }
+}
+
+void JobSystem::submit(Job *job) {
+    if (context.system == this && context.workerIndex >= 0) {
+        if (!workers[size_t(context.workerIndex)]->deque.push(job)) {
+            execute(job); // Дек переполнен — выполняем на месте
+            return;
+        }
+    } else if (workers.empty()) {
+        execute(job); // Без рабочих потоков выполняем на месте
+        return;
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injection.push_back(job);
+        injectionSize.fetch_add(1, std::memory_order_release);
+    }
+    wake();
+}
+
+void JobSystem::wake() {
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_one();
+    }
+}
+
+void JobSystem::execute(Job *job) {
+    SPECTER_PROFILE_SCOPE("Job");
+    Job *previous = context.current;
+    context.current = job;
+    job->invoke(job);
+    context.current = previous;
+    finish(job);
+}
+
+Job *JobSystem::findJob(int workerIndex) {
+    if (workerIndex >= 0) {
+        if (Job *job = workers[size_t(workerIndex)]->deque.pop())
+            return job;
+    }
+    if (injectionSize.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injection.empty()) {
+            Job *job = injection.front();
+            injection.pop_front();
+            injectionSize.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    // Кража у случайной жертвы, затем по кругу
+    const size_t count = workers.size();
+    if (count == 0)
+        return nullptr;
+    uint32_t seed = workerIndex >= 0 ? workers[size_t(workerIndex)]->random : uint32_t(reinterpret_cast<uintptr_t>(&context));
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    if (workerIndex >= 0)
+        workers[size_t(workerIndex)]->random = seed;
+    const size_t start = seed % count;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t victim = (start + i) % count;
+        if (int(victim) == workerIndex)
+            continue;
+        if (Job *job = workers[victim]->deque.steal())
+            return job;
+    }
+    return nullptr;
+}
+
+Job *JobSystem::findSubtreeJob(Job *root) {
+    if (injectionSize.load(std::memory_order_acquire) == 0)
+        return nullptr;
+    std::lock_guard<std::mutex> lock(injectionMutex);
+    for (auto it = injection.begin(); it != injection.end(); ++it) {
+        // Цепочка родителей безопасна: каждая дочерняя задача держит ссылку на родителя
+        for (Job *ancestor = *it; ancestor; ancestor = ancestor->parent) {
+            if (ancestor != root)
+                continue;
+            Job *job = *it;
+            injection.erase(it);
+            injectionSize.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::workerLoop(int workerIndex) {
+    context.system = this;
+    context.workerIndex = workerIndex;
+    Profiler::setThreadName(QString("Job Worker %1").arg(workerIndex));
+    while (running.load(std::memory_order_relaxed)) {
+        Job *job = nullptr;
+        for (int spin = 0; spin < SpinRounds && !job; ++spin) {
+            job = findJob(workerIndex);
+            if (!job)
+                std::this_thread::yield();
+        }
+        if (job) {
+            execute(job);
+            continue;
+        }
+
+        // Засыпаем до следующей отправки. sleepers увеличивается до повторной проверки epoch,
+        // а отправитель меняет epoch до чтения sleepers, поэтому пробуждение не теряется
+        const uint64_t seen = epoch.load(std::memory_order_seq_cst);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        job = findJob(workerIndex);
+        if (!job) {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this, seen]() {
+                return !running.load() || epoch.load(std::memory_order_seq_cst) != seen;
+            });
+        }
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        if (job)
+            execute(job);
+    }
+    context = ThreadContext();
+}
+
+void JobSystem::wait(const JobHandle &handle) {
+    if (!handle.job)
+        return;
+    const int workerIndex = context.system == this ? context.workerIndex : -1;
+    int idleRounds = 0;
+    while (!handle.isFinished()) {
+        // Посторонний поток (UI) помогает только с ожидаемым деревом: чужая долгая задача
+        // (декодирование текстуры, открытие модулей) задержала бы кадр. Дочерние задачи,
+        // отправленные им самим, лежат в общей очереди, остальное доделают рабочие потоки
+        Job *job = workerIndex >= 0 ? findJob(workerIndex) : findSubtreeJob(handle.job);
+        if (job) {
+            execute(job);
+            idleRounds = 0;
+        } else if (++idleRounds < SpinRounds) {
+            std::this_thread::yield();
+        } else {
+            // Оставшиеся задачи выполняются другими потоками — не жжём ядро
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+} // namespace core
@@ -0,0 +1,261 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include "workstealingdeque.h"
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QObject>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+class JobSystem;
+
+// Задача планировщика. Живёт, пока на неё есть ссылки: дескрипторы JobHandle, сам планировщик
+// до завершения и незавершённые дочерние задачи
+struct Job {
+    static constexpr size_t InlineSize = 64; // Лямбды до этого размера хранятся без выделения памяти
+
+    void (*invoke)(Job *job) = nullptr;
+    void (*destroy)(Job *job) = nullptr;
+    Job *parent = nullptr;
+    std::atomic<int> unfinished{0}; // 1 за саму задачу + по одному за каждую дочернюю
+    std::atomic<int> references{0};
+    alignas(std::max_align_t) unsigned char storage[InlineSize];
+};
+
+// Дескриптор для ожидания задачи и привязки к ней дочерних
+class JobHandle {
+public:
+    JobHandle() : job(nullptr) {}
+    JobHandle(const JobHandle &other);
+    JobHandle(JobHandle &&other) noexcept : job(other.job) { other.job = nullptr; }
+    JobHandle &operator=(JobHandle other) noexcept;
+    ~JobHandle();
+
+    bool isNull() const { return !job; }
+    bool isFinished() const { return !job || job->unfinished.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    explicit JobHandle(Job *job); // Забирает ссылку вызывающего
+
+    Job *job;
+};
+
+// Планировщик с перехватом работы: у каждого рабочего потока свой дек (WorkStealingDeque),
+// из которого он берёт задачи с нижнего конца, а простаивающие потоки крадут с верхнего.
+// Задачи из посторонних потоков (в т.ч. UI) попадают в общую очередь.
+// Задача, запущенная с parent, задерживает его завершение: wait(parent) ждёт всё дерево.
+// Поток, вызвавший wait(), не простаивает, а выполняет задачи сам: рабочий — любые,
+// посторонний — только из ожидаемого дерева.
+// Результаты в UI возвращаются через postToMainThread()/runThen() — очередью событий Qt.
+class JobSystem {
+public:
+    // workerCount — число рабочих потоков помимо вызывающего; -1 — по числу ядер минус один
+    explicit JobSystem(int workerCount = -1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Общий планировщик редактора и движка
+    static JobSystem &instance();
+
+    int workerCount() const { return int(workers.size()); }
+    // Вместе с потоком, который ждёт результата
+    int concurrency() const { return workerCount() + 1; }
+
+    template<typename F>
+    JobHandle run(F &&function, const JobHandle &parent = JobHandle());
+    // Дочерняя задача той, что выполняется сейчас в этом потоке (без неё — обычный run)
+    template<typename F>
+    JobHandle runChild(F &&function);
+    // Задача, выполняемая сейчас в вызывающем потоке (пустой дескриптор — вне задачи)
+    static JobHandle currentJob();
+
+    // Ждёт завершения задачи и всех её дочерних, выполняя тем временем другие задачи
+    void wait(const JobHandle &job);
+
+    // body(first, last) для поддиапазонов [begin, end) не длиннее grain; возвращается после всех
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, const F &body);
+
+    // Выполняет function в главном потоке (через цикл событий)
+    template<typename F>
+    static void postToMainThread(F &&function);
+    // work() в пуле, затем done(результат) в потоке receiver; если receiver удалён — done не вызывается
+    template<typename Work, typename Done>
+    JobHandle runThen(Work &&work, QObject *receiver, Done &&done);
+
+private:
+    struct Worker {
+        WorkStealingDeque<Job *> deque;
+        std::thread thread;
+        uint32_t random = 0;
+    };
+
+    template<typename F>
+    static Job *createJob(F &&function);
+    static Job *allocateJob();
+    static void retain(Job *job) { job->references.fetch_add(1, std::memory_order_relaxed); }
+    static void release(Job *job);
+    static void finish(Job *job);
+    template<typename F>
+    static void splitRange(JobSystem &system, size_t begin, size_t end, size_t grain, const F &body);
+
+    void submit(Job *job);
+    void execute(Job *job);
+    Job *findJob(int workerIndex);
+    // Задача из общей очереди, входящая в дерево root
+    Job *findSubtreeJob(Job *root);
+    void workerLoop(int workerIndex);
+    void wake();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex injectionMutex;
+    std::deque<Job *> injection; // Задачи из потоков вне планировщика
+    std::atomic<int> injectionSize;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<uint64_t> epoch; // Меняется при каждой отправке задачи
+    std::atomic<int> sleepers;
+    std::atomic<bool> running;
+};
+
+// Для задач, которым нужен свой QThreadPool, а не планировщик: блокирующий ввод-вывод, способный
+// повиснуть (потоки планировщика присоединяются при выходе), отмена ещё не начатых через clear(),
+// ограничение числа одновременных задач
+template<typename F>
+void startInPool(QThreadPool *pool, F &&function);
+// Как JobSystem::runThen, но work() выполняется в pool
+template<typename Work, typename Done>
+void runThen(QThreadPool *pool, Work &&work, QObject *receiver, Done &&done);
+
+template<typename F>
+Job *JobSystem::createJob(F &&function) {
+    using Function = typename std::decay<F>::type;
+    Job *job = allocateJob();
+    if (sizeof(Function) <= Job::InlineSize && alignof(Function) <= alignof(std::max_align_t)) {
+        new (job->storage) Function(std::forward<F>(function));
+        job->invoke = [](Job *self) { (*reinterpret_cast<Function *>(self->storage))(); };
+        job->destroy = [](Job *self) { reinterpret_cast<Function *>(self->storage)->~Function(); };
+    } else {
+        *reinterpret_cast<Function **>(job->storage) = new Function(std::forward<F>(function));
+        job->invoke = [](Job *self) { (**reinterpret_cast<Function **>(self->storage))(); };
+        job->destroy = [](Job *self) { delete *reinterpret_cast<Function **>(self->storage); };
+    }
+    return job;
+}
+
+template<typename F>
+JobHandle JobSystem::run(F &&function, const JobHandle &parent) {
+    Job *job = createJob(std::forward<F>(function));
+    job->unfinished.store(1, std::memory_order_relaxed);
+    job->references.store(2, std::memory_order_relaxed); // Дескриптор + планировщик до завершения
+    if (parent.job) {
+        parent.job->unfinished.fetch_add(1, std::memory_order_relaxed);
+        retain(parent.job); // Отпускается, когда дочерняя задача отчитается родителю
+        job->parent = parent.job;
+    }
+    submit(job);
+    return JobHandle(job);
+}
+
+template<typename F>
+JobHandle JobSystem::runChild(F &&function) {
+    return run(std::forward<F>(function), currentJob());
+}
+
+template<typename F>
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, const F &body) {
+    if (begin >= end)
+        return;
+    grain = std::max<size_t>(1, grain);
+    if (end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+    // Корневая задача делит диапазон пополам, отдавая правые половины в дек: воры забирают крупные куски
+    JobHandle root = run([this, begin, end, grain, &body]() { splitRange(*this, begin, end, grain, body); });
+    wait(root);
+}
+
+template<typename F>
+void JobSystem::splitRange(JobSystem &system, size_t begin, size_t end, size_t grain, const F &body) {
+    while (end - begin > grain) {
+        const size_t middle = begin + (end - begin) / 2;
+        system.runChild([&system, middle, end, grain, &body]() { splitRange(system, middle, end, grain, body); });
+        end = middle;
+    }
+    body(begin, end);
+}
+
+template<typename F>
+void JobSystem::postToMainThread(F &&function) {
+    QCoreApplication *application = QCoreApplication::instance();
+    if (!application) {
+        function(); // Без цикла событий (утилиты, бенчмарки) выполнять больше негде
+        return;
+    }
+    QMetaObject::invokeMethod(application, std::forward<F>(function), Qt::QueuedConnection);
+}
+
+template<typename Work, typename Done>
+JobHandle JobSystem::runThen(Work &&work, QObject *receiver, Done &&done) {
+    QPointer<QObject> target(receiver);
+    return run([work = std::forward<Work>(work), target, done = std::forward<Done>(done)]() mutable {
+        auto result = work();
+        if (!target)
+            return;
+        // Контекст receiver: если он удалится до обработки события, done не вызовется
+        QMetaObject::invokeMethod(target, [done = std::move(done), result = std::move(result)]() mutable {
+            done(std::move(result));
+        }, Qt::QueuedConnection);
+    });
+}
+
+template<typename F>
+void startInPool(QThreadPool *pool, F &&function) {
+    class FunctionRunnable : public QRunnable {
+    public:
+        explicit FunctionRunnable(F &&function) : function(std::forward<F>(function)) {}
+        void run() override { function(); }
+
+    private:
+        typename std::decay<F>::type function;
+    };
+    pool->start(new FunctionRunnable(std::forward<F>(function)));
+}
+
+template<typename Work, typename Done>
+void runThen(QThreadPool *pool, Work &&work, QObject *receiver, Done &&done) {
+    QPointer<QObject> target(receiver);
+    startInPool(pool, [work = std::forward<Work>(work), target, done = std::forward<Done>(done)]() mutable {
+        auto result = work();
+        if (!target)
+            return;
+        QMetaObject::invokeMethod(target, [done = std::move(done), result = std::move(result)]() mutable {
+            done(std::move(result));
+        }, Qt::QueuedConnection);
+    });
+}
+
+} // namespace core
+
+#endif // JOBSYSTEM_H
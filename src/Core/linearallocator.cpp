@@ -0,0 +1,55 @@
+#include "linearallocator.h"
+#include <algorithm>
+
+namespace core {
+
+LinearArena::LinearArena(MemoryTag tag, size_t blockSize)
+    : tag(tag), blockSize(blockSize), blocks(nullptr), cursor(nullptr), limit(nullptr), used(0), totalCapacity(0) {}
+
+LinearArena::~LinearArena() {
+    release();
+}
+
+void LinearArena::pushBlock(size_t size) {
+    Block *block = static_cast<Block *>(::operator new(size));
+    MemoryTracker::allocated(tag, size);
+    block->next = blocks;
+    block->size = size;
+    blocks = block;
+    cursor = reinterpret_cast<char *>(block) + HeaderSize;
+    limit = reinterpret_cast<char *>(block) + size;
+    totalCapacity += size - HeaderSize;
+}
+
+void *LinearArena::allocateSlow(size_t size, size_t alignment) {
+    // Остаток текущего блока пропадает до reset(); крупный запрос получает блок по размеру
+    pushBlock(HeaderSize + std::max(blockSize, size + alignment));
+    return allocate(size, alignment);
+}
+
+void LinearArena::reset() {
+    if (blocks && blocks->next) {
+        // Несколько блоков — заменяем одним на всю ёмкость, чтобы следующий кадр уместился в нём
+        const size_t capacity = totalCapacity;
+        release();
+        pushBlock(HeaderSize + capacity);
+    } else if (blocks) {
+        cursor = reinterpret_cast<char *>(blocks) + HeaderSize;
+    }
+    used = 0;
+}
+
+void LinearArena::release() {
+    while (blocks) {
+        Block *next = blocks->next;
+        MemoryTracker::freed(tag, blocks->size);
+        ::operator delete(blocks);
+        blocks = next;
+    }
+    cursor = nullptr;
+    limit = nullptr;
+    used = 0;
+    totalCapacity = 0;
+}
+
+} // namespace core
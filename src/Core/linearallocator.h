@@ -0,0 +1,101 @@
+#ifndef LINEARALLOCATOR_H
+#define LINEARALLOCATOR_H
+
+#include "memorytracker.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core {
+
+// Линейная арена: выделение — сдвиг указателя, освобождение — только всей арены сразу (reset).
+// Память берётся у кучи блоками blockSize; после reset() блоки сливаются в один, так что при
+// одинаковой нагрузке от кадра к кадру арена вообще не обращается к куче.
+// Объекты в арене не разрушаются, поэтому в ней живут только тривиально разрушаемые типы.
+// Не потокобезопасна: у каждого потока своя арена
+class LinearArena {
+public:
+    explicit LinearArena(MemoryTag tag = MemoryTag::General, size_t blockSize = 64 * 1024);
+    ~LinearArena();
+
+    LinearArena(const LinearArena &) = delete;
+    LinearArena &operator=(const LinearArena &) = delete;
+
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~uintptr_t(alignment - 1);
+        if (aligned + size > reinterpret_cast<uintptr_t>(limit))
+            return allocateSlow(size, alignment);
+        used += aligned + size - reinterpret_cast<uintptr_t>(cursor);
+        cursor = reinterpret_cast<char *>(aligned + size);
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    // Неинициализированный массив
+    template<typename T>
+    T *allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Арена не вызывает деструкторы");
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    template<typename T, typename... Args>
+    T *create(Args &&...args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Арена не вызывает деструкторы");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Освобождает всё выделенное; память остаётся у арены
+    void reset();
+    // Возвращает память куче
+    void release();
+
+    size_t bytesUsed() const { return used; }
+    size_t capacity() const { return totalCapacity; }
+
+private:
+    struct Block {
+        Block *next;
+        size_t size; // Вместе с заголовком
+    };
+    static constexpr size_t HeaderSize = (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    void *allocateSlow(size_t size, size_t alignment);
+    void pushBlock(size_t size);
+
+    MemoryTag tag;
+    size_t blockSize;
+    Block *blocks; // Текущий блок — первый в списке
+    char *cursor;
+    char *limit;
+    size_t used;
+    size_t totalCapacity;
+};
+
+// Арены кадра: в начале кадра сбрасывается арена позапрошлого кадра, поэтому данные,
+// выделенные в прошлом кадре, остаются действительны ещё один кадр (например, для потоков,
+// дочитывающих его результаты)
+class FrameArena {
+public:
+    explicit FrameArena(MemoryTag tag = MemoryTag::General, size_t blockSize = 256 * 1024)
+        : arenas{LinearArena(tag, blockSize), LinearArena(tag, blockSize)}, index(0) {}
+
+    void beginFrame() {
+        index ^= 1;
+        arenas[index].reset();
+    }
+
+    LinearArena &current() { return arenas[index]; }
+    LinearArena &previous() { return arenas[index ^ 1]; }
+
+    template<typename T>
+    T *allocateArray(size_t count) { return current().allocateArray<T>(count); }
+
+private:
+    LinearArena arenas[2];
+    int index;
+};
+
+} // namespace core
+
+#endif // LINEARALLOCATOR_H
@@ -0,0 +1,66 @@
+#include "memorytracker.h"
+#include <QtGlobal>
+#include <cstdio>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace core {
+
+// Инициализация константная, поэтому учёт работает и для статических объектов, созданных до main
+MemoryTracker::Counters MemoryTracker::tagCounters[size_t(MemoryTag::Count)];
+
+MemoryTracker::TagStatistics MemoryTracker::statistics(MemoryTag tag) {
+    const Counters &counters = tagCounters[size_t(tag)];
+    TagStatistics result;
+    result.bytes = counters.bytes.load(std::memory_order_relaxed);
+    result.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    result.liveBlocks = counters.liveBlocks.load(std::memory_order_relaxed);
+    result.allocations = counters.allocations.load(std::memory_order_relaxed);
+    return result;
+}
+
+int64_t MemoryTracker::totalBytes() {
+    int64_t total = 0;
+    for (const Counters &counters : tagCounters)
+        total += counters.bytes.load(std::memory_order_relaxed);
+    return total;
+}
+
+const char *MemoryTracker::tagName(MemoryTag tag) {
+    switch (tag) {
+    case MemoryTag::General:
+        return "General";
+    case MemoryTag::Scene:
+        return "Scene";
+    case MemoryTag::Assets:
+        return "Assets";
+    case MemoryTag::Render:
+        return "Render";
+    case MemoryTag::UI:
+        return "UI";
+    case MemoryTag::Build:
+        return "Build";
+    case MemoryTag::Count:
+        break;
+    }
+    return "?";
+}
+
+int64_t MemoryTracker::processResidentBytes() {
+#ifdef Q_OS_LINUX
+    FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1;
+    long long size = 0;
+    long long resident = 0;
+    const int read = std::fscanf(statm, "%lld %lld", &size, &resident);
+    std::fclose(statm);
+    return read == 2 ? resident * int64_t(sysconf(_SC_PAGESIZE)) : -1;
+#else
+    return -1;
+#endif
+}
+
+} // namespace core
@@ -0,0 +1,130 @@
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace core {
+
+// Подсистема, которой принадлежит память
+enum class MemoryTag : uint8_t {
+    General,
+    Scene,
+    Assets,
+    Render,
+    UI,
+    Build,
+    Count
+};
+
+// Учёт памяти по подсистемам. Счётчики атомарные и лежат на отдельных кэш-линиях;
+// аллокаторы движка сообщают о каждом блоке, взятом из общей кучи (пулы и арены — о страницах,
+// а не о каждом объекте, поэтому учёт не стоит ничего на их быстром пути)
+class MemoryTracker {
+public:
+    struct TagStatistics {
+        int64_t bytes = 0;       // Занято сейчас
+        int64_t peakBytes = 0;
+        int64_t liveBlocks = 0;  // Невозвращённых блоков
+        int64_t allocations = 0; // Всего выделений за сессию
+    };
+
+    static void allocated(MemoryTag tag, size_t bytes) {
+        Counters &counters = tagCounters[size_t(tag)];
+        const int64_t now = counters.bytes.fetch_add(int64_t(bytes), std::memory_order_relaxed) + int64_t(bytes);
+        counters.liveBlocks.fetch_add(1, std::memory_order_relaxed);
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+        while (now > peak && !counters.peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void freed(MemoryTag tag, size_t bytes) {
+        Counters &counters = tagCounters[size_t(tag)];
+        counters.bytes.fetch_sub(int64_t(bytes), std::memory_order_relaxed);
+        counters.liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static TagStatistics statistics(MemoryTag tag);
+    static int64_t totalBytes();
+    static const char *tagName(MemoryTag tag);
+    // Резидентная память процесса целиком; -1, если платформа не сообщает
+    static int64_t processResidentBytes();
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<int64_t> bytes{0};
+        std::atomic<int64_t> peakBytes{0};
+        std::atomic<int64_t> liveBlocks{0};
+        std::atomic<int64_t> allocations{0};
+    };
+
+    static Counters tagCounters[size_t(MemoryTag::Count)];
+};
+
+// Аллокатор для контейнеров STL с учётом памяти под тегом:
+//   std::vector<float, core::TaggedAllocator<float, core::MemoryTag::Render>>
+template<typename T, MemoryTag Tag>
+class TaggedAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() noexcept = default;
+    template<typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag> &) noexcept {}
+
+    T *allocate(size_t count) {
+        T *pointer = static_cast<T *>(::operator new(count * sizeof(T)));
+        MemoryTracker::allocated(Tag, count * sizeof(T));
+        return pointer;
+    }
+
+    void deallocate(T *pointer, size_t count) noexcept {
+        MemoryTracker::freed(Tag, count * sizeof(T));
+        ::operator delete(pointer);
+    }
+
+    template<typename U>
+    bool operator==(const TaggedAllocator<U, Tag> &) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const TaggedAllocator<U, Tag> &) const noexcept { return false; }
+};
+
+// Учёт памяти, которую держат контейнеры Qt и прочие не-движковые структуры: владелец
+// сообщает оценку своего размера, и она числится за тегом, пока жив этот объект
+class TrackedBytes {
+public:
+    explicit TrackedBytes(MemoryTag tag, size_t bytes = 0) : tag(tag), bytes(0) { set(bytes); }
+    ~TrackedBytes() { set(0); }
+
+    TrackedBytes(const TrackedBytes &) = delete;
+    TrackedBytes &operator=(const TrackedBytes &) = delete;
+
+    void set(size_t newBytes) {
+        if (bytes)
+            MemoryTracker::freed(tag, bytes);
+        bytes = newBytes;
+        if (bytes)
+            MemoryTracker::allocated(tag, bytes);
+    }
+    size_t value() const { return bytes; }
+
+private:
+    MemoryTag tag;
+    size_t bytes;
+};
+
+template<typename T, MemoryTag Tag>
+using TaggedVector = std::vector<T, TaggedAllocator<T, Tag>>;
+
+} // namespace core
+
+#endif // MEMORYTRACKER_H
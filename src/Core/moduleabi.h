@@ -0,0 +1,59 @@
+#ifndef MODULEABI_H
+#define MODULEABI_H
+
+/* Двоичный интерфейс модулей движка. Заголовок на чистом C: модуль можно собрать любым
+ * компилятором, не завися от Qt и C++ ABI редактора.
+ *
+ * Модуль — разделяемая библиотека, экспортирующая функцию SPECTER_MODULE_ENTRY_NAME типа
+ * SpecterModuleEntry. Рядом лежит .cfg библиотеки: его [Library] Module, Depends и Order
+ * нужны, чтобы спланировать загрузку, не открывая файлы. Модуль повторяет свои зависимости
+ * в SpecterModuleInfo, и загрузчик сверяет их с .cfg.
+ *
+ * Совместимость: abiVersion меняется при несовместимых изменениях. Новые поля дописываются
+ * в конец структур, а size говорит, сколько их знает другая сторона. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPECTER_MODULE_ABI_VERSION 1u
+#define SPECTER_MODULE_ENTRY_NAME "specter_module_info"
+
+typedef struct SpecterHost {
+    uint32_t abiVersion;
+    uint32_t size; /* sizeof(SpecterHost) редактора */
+    void (*log)(const char *module, const char *message);
+    /* Таблица api уже инициализированного модуля; NULL, если такого нет.
+     * Зависимости инициализируются раньше зависимых, поэтому в initialize они доступны */
+    const void *(*moduleApi)(const char *name);
+} SpecterHost;
+
+typedef struct SpecterModuleInfo {
+    uint32_t abiVersion;
+    uint32_t size; /* sizeof(SpecterModuleInfo) модуля */
+    const char *name;
+    const char *version;
+    const char *const *dependencies; /* Имена, список завершается NULL; NULL — зависимостей нет */
+    int32_t (*initialize)(const SpecterHost *host); /* 0 — успех */
+    void (*shutdown)(void); /* Вызывается в порядке, обратном инициализации; может быть NULL */
+    const void *api; /* Интерфейс модуля для зависимых от него */
+} SpecterModuleInfo;
+
+typedef const SpecterModuleInfo *(*SpecterModuleEntry)(void);
+
+#if defined(_WIN32)
+#define SPECTER_MODULE_EXPORT __declspec(dllexport)
+#else
+#define SPECTER_MODULE_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* В модуле (в C++ — внутри extern "C"):
+ *   SPECTER_MODULE_EXPORT const SpecterModuleInfo *specter_module_info(void) { return &info; } */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODULEABI_H */
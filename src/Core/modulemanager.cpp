@@ -0,0 +1,374 @@
+#include "modulemanager.h"
+#include "jobsystem.h"
+#include "profiler.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QPointer>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <dlfcn.h>
+#else
+#include <QLibrary>
+#endif
+
+namespace core {
+
+namespace {
+
+void *openLibrary(const QString &path, QString *error) {
+#ifdef Q_OS_UNIX
+    // RTLD_LOCAL: модули обращаются друг к другу только через таблицы api, общих символов нет
+    void *handle = dlopen(QFile::encodeName(path).constData(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle)
+        *error = QString::fromLocal8Bit(dlerror());
+    return handle;
+#else
+    QLibrary *library = new QLibrary(path);
+    if (!library->load()) {
+        *error = library->errorString();
+        delete library;
+        return nullptr;
+    }
+    return library;
+#endif
+}
+
+void *findSymbol(void *handle, const char *name) {
+#ifdef Q_OS_UNIX
+    return dlsym(handle, name);
+#else
+    return reinterpret_cast<void *>(static_cast<QLibrary *>(handle)->resolve(name));
+#endif
+}
+
+void closeLibrary(void *handle) {
+    if (!handle)
+        return;
+#ifdef Q_OS_UNIX
+    dlclose(handle);
+#else
+    QLibrary *library = static_cast<QLibrary *>(handle);
+    library->unload();
+    delete library;
+#endif
+}
+
+} // namespace
+
+ModuleManager *ModuleManager::instance() {
+    static QPointer<ModuleManager> manager;
+    if (!manager)
+        manager = new ModuleManager(QCoreApplication::instance());
+    return manager;
+}
+
+ModuleManager::ModuleManager(QObject *parent) : QObject(parent), loading(false), generation(0) {
+    host.abiVersion = SPECTER_MODULE_ABI_VERSION;
+    host.size = sizeof(SpecterHost);
+    host.log = &ModuleManager::log;
+    host.moduleApi = &ModuleManager::moduleApi;
+}
+
+ModuleManager::~ModuleManager() {
+    unloadAll();
+}
+
+const char *ModuleManager::stateName(State state) {
+    switch (state) {
+    case State::Available:
+        return "Not loaded";
+    case State::Queued:
+        return "Queued";
+    case State::Loading:
+        return "Loading";
+    case State::Loaded:
+        return "Loaded";
+    case State::Failed:
+        return "Failed";
+    }
+    return "?";
+}
+
+int ModuleManager::indexOf(const QString &name) const {
+    for (int i = 0; i < statuses.size(); ++i) {
+        if (statuses[i].descriptor.name == name)
+            return i;
+    }
+    return -1;
+}
+
+const ModuleManager::Status *ModuleManager::status(const QString &name) const {
+    const int index = indexOf(name);
+    return index < 0 ? nullptr : &statuses[index];
+}
+
+void ModuleManager::setState(int index, State state, const QString &error) {
+    statuses[index].state = state;
+    statuses[index].error = error;
+    emit stateChanged(statuses[index].descriptor.name);
+}
+
+void ModuleManager::setModules(const QVector<ModuleDescriptor> &modules) {
+    unloadAll();
+    statuses.clear();
+    for (const ModuleDescriptor &descriptor : modules) {
+        Status status;
+        status.descriptor = descriptor;
+        statuses.append(status);
+    }
+    emit stateChanged(QString());
+}
+
+QVector<ModuleDescriptor> ModuleManager::plan(const QVector<ModuleDescriptor> &modules, const QStringList &required,
+                                              QHash<QString, QString> *errors) {
+    QHash<QString, int> byName;
+    for (int i = 0; i < modules.size(); ++i)
+        byName.insert(modules[i].name, i);
+
+    // Замыкание по зависимостям
+    std::vector<char> needed(size_t(modules.size()), 0);
+    std::vector<int> stack;
+    for (const QString &name : required) {
+        const int index = byName.value(name, -1);
+        if (index < 0)
+            errors->insert(name, "Module is not installed");
+        else
+            stack.push_back(index);
+    }
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+        if (needed[size_t(index)])
+            continue;
+        needed[size_t(index)] = 1;
+        for (const QString &dependency : modules[index].dependencies) {
+            const int found = byName.value(dependency, -1);
+            if (found < 0)
+                errors->insert(modules[index].name, "Missing dependency " + dependency);
+            else
+                stack.push_back(found);
+        }
+    }
+
+    // Зависимый от неисправного модуля тоже не загрузится
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int i = 0; i < modules.size(); ++i) {
+            if (!needed[size_t(i)] || errors->contains(modules[i].name))
+                continue;
+            for (const QString &dependency : modules[i].dependencies) {
+                if (errors->contains(dependency)) {
+                    errors->insert(modules[i].name, "Dependency " + dependency + " cannot be loaded");
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Топологическая сортировка; из готовых первым идёт меньший order, затем имя — порядок
+    // одинаков от запуска к запуску. Модулей единицы-десятки, квадратичный выбор не заметен
+    std::vector<int> pending(size_t(modules.size()), 0);
+    std::vector<int> candidates;
+    for (int i = 0; i < modules.size(); ++i) {
+        if (!needed[size_t(i)] || errors->contains(modules[i].name))
+            continue;
+        candidates.push_back(i);
+        QStringList dependencies = modules[i].dependencies;
+        dependencies.removeDuplicates();
+        pending[size_t(i)] = dependencies.size();
+    }
+    QVector<ModuleDescriptor> order;
+    std::vector<char> placed(size_t(modules.size()), 0);
+    for (size_t step = 0; step < candidates.size(); ++step) {
+        int best = -1;
+        for (int i : candidates) {
+            if (placed[size_t(i)] || pending[size_t(i)] != 0)
+                continue;
+            if (best < 0 || modules[i].order < modules[best].order
+                    || (modules[i].order == modules[best].order && modules[i].name < modules[best].name))
+                best = i;
+        }
+        if (best < 0)
+            break;
+        placed[size_t(best)] = 1;
+        order.append(modules[best]);
+        for (int i : candidates) {
+            if (!placed[size_t(i)] && modules[i].dependencies.contains(modules[best].name))
+                --pending[size_t(i)];
+        }
+    }
+    for (int i : candidates) {
+        if (!placed[size_t(i)])
+            errors->insert(modules[i].name, "Dependency cycle");
+    }
+    return order;
+}
+
+void ModuleManager::require(const QStringList &names) {
+    QVector<ModuleDescriptor> descriptors;
+    descriptors.reserve(statuses.size());
+    for (const Status &status : statuses)
+        descriptors.append(status.descriptor);
+    QHash<QString, QString> errors;
+    const QVector<ModuleDescriptor> order = plan(descriptors, names, &errors);
+
+    for (auto it = errors.cbegin(); it != errors.cend(); ++it) {
+        const int index = indexOf(it.key());
+        if (index >= 0 && statuses[index].state != State::Loaded)
+            setState(index, State::Failed, it.value());
+    }
+    for (const ModuleDescriptor &descriptor : order) {
+        const int index = indexOf(descriptor.name);
+        const State state = statuses[index].state;
+        // Неудавшийся модуль можно запросить снова — например, после исправления файла
+        if (state == State::Available || state == State::Failed) {
+            queue.append(descriptor.name);
+            setState(index, State::Queued);
+        }
+    }
+    startLoading();
+}
+
+void ModuleManager::startLoading() {
+    if (loading || queue.isEmpty())
+        return;
+    loading = true;
+    QVector<QPair<QString, QString>> batch;
+    for (const QString &name : queue) {
+        const int index = indexOf(name);
+        batch.append({name, statuses[index].descriptor.path});
+        setState(index, State::Loading);
+    }
+    queue.clear();
+
+    // Открытие библиотек (чтение с диска, связывание) — в пуле; initialize — здесь, по порядку
+    const quint64 current = generation;
+    JobSystem::instance().runThen([batch]() {
+        QVector<Opened> opened;
+        for (const QPair<QString, QString> &module : batch) {
+            SPECTER_PROFILE_SCOPE("ModuleManager::open");
+            Opened result;
+            result.name = module.first;
+            QElapsedTimer timer;
+            timer.start();
+            result.handle = openLibrary(module.second, &result.error);
+            if (result.handle) {
+                auto entry = reinterpret_cast<SpecterModuleEntry>(findSymbol(result.handle, SPECTER_MODULE_ENTRY_NAME));
+                result.info = entry ? entry() : nullptr;
+                if (!entry)
+                    result.error = QString("No %1 entry point").arg(SPECTER_MODULE_ENTRY_NAME);
+                else if (!result.info || result.info->abiVersion != SPECTER_MODULE_ABI_VERSION
+                         || result.info->size < sizeof(SpecterModuleInfo))
+                    result.error = QString("Module ABI %1 is not supported, the editor uses %2")
+                                       .arg(result.info ? result.info->abiVersion : 0).arg(SPECTER_MODULE_ABI_VERSION);
+                if (!result.error.isEmpty()) {
+                    closeLibrary(result.handle);
+                    result.handle = nullptr;
+                    result.info = nullptr;
+                }
+            }
+            result.nanoseconds = timer.nsecsElapsed();
+            opened.append(result);
+        }
+        return opened;
+    }, this, [this, current](const QVector<Opened> &opened) {
+        loading = false;
+        if (current != generation) {
+            for (const Opened &module : opened)
+                closeLibrary(module.handle);
+        } else {
+            finishLoading(opened);
+        }
+        startLoading();
+    });
+}
+
+void ModuleManager::finishLoading(const QVector<Opened> &opened) {
+    for (const Opened &module : opened) {
+        const int index = indexOf(module.name);
+        if (index < 0) {
+            closeLibrary(module.handle);
+            continue;
+        }
+        if (!module.handle) {
+            setState(index, State::Failed, module.error);
+            continue;
+        }
+        initialize(index, module);
+    }
+}
+
+void ModuleManager::initialize(int index, const Opened &opened) {
+    SPECTER_PROFILE_SCOPE("ModuleManager::initialize");
+    Status &status = statuses[index];
+    const SpecterModuleInfo *info = opened.info;
+    QString error;
+    if (!info->name || status.descriptor.name != QString::fromUtf8(info->name))
+        error = QString("Library declares itself as %1").arg(info->name ? info->name : "<unnamed>");
+    for (const char *const *dependency = info->dependencies; error.isEmpty() && dependency && *dependency; ++dependency) {
+        if (!status.descriptor.dependencies.contains(QString::fromUtf8(*dependency)))
+            error = QString("Dependency %1 is not listed in the library config").arg(*dependency);
+    }
+    for (const QString &dependency : status.descriptor.dependencies) {
+        const Status *required = this->status(dependency);
+        if (error.isEmpty() && (!required || required->state != State::Loaded))
+            error = "Dependency " + dependency + " is not loaded";
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (error.isEmpty() && info->initialize) {
+        const int32_t result = info->initialize(&host);
+        if (result != 0)
+            error = QString("initialize() returned %1").arg(result);
+    }
+    if (!error.isEmpty()) {
+        closeLibrary(opened.handle);
+        setState(index, State::Failed, error);
+        return;
+    }
+    status.handle = opened.handle;
+    status.info = info;
+    status.version = QString::fromUtf8(info->version ? info->version : "");
+    status.loadNanoseconds = opened.nanoseconds + timer.nsecsElapsed();
+    initOrder.append(status.descriptor.name);
+    setState(index, State::Loaded);
+}
+
+void ModuleManager::unloadAll() {
+    ++generation;
+    queue.clear();
+    for (int i = initOrder.size() - 1; i >= 0; --i) {
+        const int index = indexOf(initOrder[i]);
+        if (index < 0)
+            continue;
+        Status &status = statuses[index];
+        if (status.info && status.info->shutdown)
+            status.info->shutdown();
+        closeLibrary(status.handle);
+        status.handle = nullptr;
+        status.info = nullptr;
+        status.loadNanoseconds = 0;
+    }
+    initOrder.clear();
+    for (int i = 0; i < statuses.size(); ++i) {
+        if (statuses[i].state != State::Available)
+            setState(i, State::Available);
+    }
+}
+
+const void *ModuleManager::moduleApi(const char *name) {
+    const Status *status = instance()->status(QString::fromUtf8(name));
+    return status && status->info ? status->info->api : nullptr;
+}
+
+void ModuleManager::log(const char *module, const char *message) {
+    qInfo("[%s] %s", module ? module : "module", message ? message : "");
+}
+
+} // namespace core
@@ -0,0 +1,101 @@
+#ifndef MODULEMANAGER_H
+#define MODULEMANAGER_H
+
+#include "moduleabi.h"
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <cstdint>
+
+namespace core {
+
+// Модуль, как его описывает .cfg библиотеки
+struct ModuleDescriptor {
+    QString name;
+    QString path; // Абсолютный путь к разделяемой библиотеке
+    QStringList dependencies;
+    int order = 0; // Среди модулей без зависимостей между собой меньший инициализируется раньше
+};
+
+// Загрузчик модулей (moduleabi.h). Модули только регистрируются в setModules и открываются,
+// когда их запросят через require — вместе с зависимостями. Порядок строится по .cfg,
+// без открытия файлов. Сами библиотеки открываются в пуле задач, а initialize модулей
+// вызывается в главном потоке по порядку: зависимости раньше зависимых
+class ModuleManager : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State {
+        Available, // Известен, не запрошен
+        Queued,
+        Loading,
+        Loaded,
+        Failed
+    };
+
+    struct Status {
+        ModuleDescriptor descriptor;
+        State state = State::Available;
+        QString version; // Из SpecterModuleInfo
+        QString error;
+        qint64 loadNanoseconds = 0; // Открытие библиотеки + initialize
+        void *handle = nullptr;
+        const SpecterModuleInfo *info = nullptr;
+    };
+
+    static ModuleManager *instance();
+    ~ModuleManager();
+
+    static const char *stateName(State state);
+
+    // Заменяет набор известных модулей; загруженные выгружаются
+    void setModules(const QVector<ModuleDescriptor> &modules);
+    // Загружает модули с их зависимостями; уже загруженные и загружаемые пропускаются
+    void require(const QStringList &names);
+    // shutdown в порядке, обратном инициализации
+    void unloadAll();
+
+    const QVector<Status> &modules() const { return statuses; }
+    const Status *status(const QString &name) const;
+
+    // Порядок инициализации required и их зависимостей. Модули с отсутствующей зависимостью
+    // или в цикле не попадают в порядок, а описываются в errors (имя → причина)
+    static QVector<ModuleDescriptor> plan(const QVector<ModuleDescriptor> &modules, const QStringList &required,
+                                          QHash<QString, QString> *errors);
+
+signals:
+    void stateChanged(const QString &name);
+
+private:
+    struct Opened {
+        QString name;
+        void *handle = nullptr;
+        const SpecterModuleInfo *info = nullptr;
+        QString error;
+        qint64 nanoseconds = 0;
+    };
+
+    explicit ModuleManager(QObject *parent = nullptr);
+
+    int indexOf(const QString &name) const;
+    void setState(int index, State state, const QString &error = QString());
+    void startLoading();
+    void finishLoading(const QVector<Opened> &opened);
+    void initialize(int index, const Opened &opened);
+
+    static const void *moduleApi(const char *name);
+    static void log(const char *module, const char *message);
+
+    QVector<Status> statuses;
+    QStringList queue;     // Ждут открытия, в порядке инициализации
+    QStringList initOrder; // Загруженные, в порядке инициализации
+    bool loading;
+    quint64 generation; // Меняется при setModules/unloadAll, чтобы отбросить открытое по старому набору
+    SpecterHost host;
+};
+
+} // namespace core
+
+#endif // MODULEMANAGER_H
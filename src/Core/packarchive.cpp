@@ -0,0 +1,337 @@
+#include "packarchive.h"
+#include "jobsystem.h"
+#include "profiler.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QtGlobal>
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+namespace {
+
+static_assert(sizeof(PackArchive::Header) == 64, "Заголовок архива — 64 байта");
+static_assert(sizeof(PackArchive::Entry) == 56, "Запись оглавления — 56 байт");
+
+// QByteArray адресуется int, поэтому запись не может быть больше
+const quint64 MaxEntrySize = quint64(INT_MAX);
+
+// Пачка упаковщика: столько данных одновременно держится в памяти
+const qint64 BatchBytes = 64 * 1024 * 1024;
+const int BatchFiles = 1024;
+
+struct PackedFile {
+    QString path;     // Абсолютный
+    QByteArray name;  // Относительный, UTF-8
+    qint64 size = 0;
+    qint64 modified = 0;
+    QByteArray payload;
+    PackArchive::Compression compression = PackArchive::Stored;
+    QString error;
+};
+
+bool writePadding(QSaveFile &out, qint64 alignment) {
+    static const char zeros[PackArchive::Alignment] = {};
+    const qint64 padding = (alignment - out.pos() % alignment) % alignment;
+    return out.write(zeros, padding) == padding;
+}
+
+void setError(QString *error, const QString &message) {
+    if (error)
+        *error = message;
+}
+
+} // namespace
+
+PackArchive::PackArchive() : mapped(nullptr), mappedSize(0), entries(nullptr), names(nullptr), entryCount(0) {}
+
+PackArchive::~PackArchive() {
+    close();
+}
+
+bool PackArchive::open(const QString &path, QString *error) {
+    close();
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    setError(error, "Pack archives are little-endian only");
+    return false;
+#endif
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+    mappedSize = file.size();
+    mapped = mappedSize >= qint64(sizeof(Header)) ? file.map(0, mappedSize) : nullptr;
+    if (!mapped) {
+        setError(error, "Not a pack archive: " + path);
+        close();
+        return false;
+    }
+    const Header *header = reinterpret_cast<const Header *>(mapped);
+    // Каждая граница проверяется как x > size || y > size - x, чтобы сумма не переполнилась
+    const quint64 size = quint64(mappedSize);
+    if (header->magic != Magic || header->version != Version || header->tocOffset % alignof(Entry) != 0
+        || header->tocOffset > size || quint64(header->entryCount) > (size - header->tocOffset) / sizeof(Entry)
+        || header->namesOffset > size || header->namesSize > size - header->namesOffset) {
+        setError(error, "Corrupt or unsupported pack archive: " + path);
+        close();
+        return false;
+    }
+    entries = reinterpret_cast<const Entry *>(mapped + header->tocOffset);
+    names = reinterpret_cast<const char *>(mapped + header->namesOffset);
+    entryCount = header->entryCount;
+    for (quint32 i = 0; i < entryCount; ++i) {
+        const Entry &e = entries[i];
+        if (e.offset > size || e.storedSize > size - e.offset || e.storedSize > MaxEntrySize || e.size > MaxEntrySize
+            || e.nameOffset > header->namesSize || e.nameLength > header->namesSize - e.nameOffset) {
+            setError(error, "Corrupt pack archive entry in " + path);
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void PackArchive::close() {
+    if (mapped)
+        file.unmap(const_cast<uchar *>(mapped));
+    file.close();
+    mapped = nullptr;
+    mappedSize = 0;
+    entries = nullptr;
+    names = nullptr;
+    entryCount = 0;
+}
+
+QString PackArchive::name(int index) const {
+    const Entry &e = entries[index];
+    return QString::fromUtf8(names + e.nameOffset, int(e.nameLength));
+}
+
+quint64 PackArchive::hashPath(const QByteArray &utf8Path) {
+    // FNV-1a
+    quint64 hash = 14695981039346656037ull;
+    for (char c : utf8Path) {
+        hash ^= quint8(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int PackArchive::indexOf(const QString &path) const {
+    const QByteArray utf8 = path.toUtf8();
+    const quint64 hash = hashPath(utf8);
+    const Entry *end = entries + entryCount;
+    const Entry *it = std::lower_bound(entries, end, hash, [](const Entry &e, quint64 value) { return e.pathHash < value; });
+    for (; it != end && it->pathHash == hash; ++it) {
+        if (it->nameLength == quint32(utf8.size()) && std::equal(utf8.begin(), utf8.end(), names + it->nameOffset))
+            return int(it - entries);
+    }
+    return -1;
+}
+
+const uchar *PackArchive::mappedData(int index) const {
+    const Entry &e = entries[index];
+    return e.compression == Stored ? mapped + e.offset : nullptr;
+}
+
+QByteArray PackArchive::read(int index) const {
+    const Entry &e = entries[index];
+    const char *data = reinterpret_cast<const char *>(mapped + e.offset);
+    if (e.compression == Stored)
+        return QByteArray::fromRawData(data, int(e.storedSize));
+    return qUncompress(reinterpret_cast<const uchar *>(data), int(e.storedSize));
+}
+
+QByteArray PackArchive::read(const QString &path) const {
+    const int index = indexOf(path);
+    return index >= 0 ? read(index) : QByteArray();
+}
+
+void PackArchive::prefetch(int index) const {
+#ifdef Q_OS_UNIX
+    static const quintptr pageSize = quintptr(sysconf(_SC_PAGESIZE));
+    const Entry &e = entries[index];
+    const quintptr begin = quintptr(mapped + e.offset) & ~(pageSize - 1);
+    const quintptr end = quintptr(mapped + e.offset + e.storedSize);
+    madvise(reinterpret_cast<void *>(begin), size_t(end - begin), MADV_WILLNEED);
+#else
+    Q_UNUSED(index);
+#endif
+}
+
+QVector<QByteArray> PackArchive::readMany(const QVector<int> &indices) const {
+    SPECTER_PROFILE_SCOPE("PackArchive::readMany");
+    // Подсказки идут вперёд: ОС читает страницы, пока потоки распаковывают уже прочитанное
+    for (int index : indices)
+        prefetch(index);
+    QVector<QByteArray> results(indices.size());
+    QByteArray *out = results.data();
+    JobSystem::instance().parallelFor(0, size_t(indices.size()), 16, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            out[i] = read(indices[int(i)]);
+    });
+    return results;
+}
+
+PackArchive::Compression PackArchive::compressionFor(const QString &path) {
+    static const QSet<QString> compressed = {"png", "jpg",  "jpeg", "gif", "webp", "ogg", "mp3",
+                                             "flac", "opus", "zip", "gz", "pak", "ktx2", "basis"};
+    return compressed.contains(QFileInfo(path).suffix().toLower()) ? Stored : Deflate;
+}
+
+bool PackWriter::pack(const QString &directory, const QString &archivePath, Statistics *statistics, QString *error) {
+    SPECTER_PROFILE_SCOPE("PackWriter::pack");
+    Statistics local;
+    Statistics &stats = statistics ? *statistics : local;
+    stats = Statistics();
+
+    const QDir root(directory);
+    std::vector<PackedFile> files;
+    QDirIterator it(directory, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        PackedFile packed;
+        packed.path = info.absoluteFilePath();
+        packed.name = root.relativeFilePath(packed.path).toUtf8();
+        packed.size = info.size();
+        packed.modified = info.lastModified().toMSecsSinceEpoch();
+        if (quint64(packed.size) > MaxEntrySize) {
+            setError(error, "File is too large for a pack archive: " + packed.path);
+            return false;
+        }
+        files.push_back(std::move(packed));
+    }
+    std::sort(files.begin(), files.end(), [](const PackedFile &a, const PackedFile &b) { return a.name < b.name; });
+    stats.files = int(files.size());
+    for (const PackedFile &packed : files)
+        stats.inputBytes += packed.size;
+
+    // Каждый файл сверяется со своей записью: файл, заменённый более старым, отличается временем изменения
+    const QFileInfo archiveInfo(archivePath);
+    if (archiveInfo.exists()) {
+        PackArchive existing;
+        if (existing.open(archivePath) && existing.count() == int(files.size())) {
+            bool same = true;
+            for (size_t i = 0; same && i < files.size(); ++i) {
+                const PackedFile &packed = files[i];
+                const int index = existing.indexOf(QString::fromUtf8(packed.name));
+                same = index >= 0 && existing.entry(index).size == quint64(packed.size)
+                       && existing.entry(index).modified == packed.modified;
+            }
+            if (same) {
+                stats.upToDate = true;
+                stats.archiveBytes = archiveInfo.size();
+                return true;
+            }
+        }
+    }
+
+    QDir().mkpath(archiveInfo.absolutePath());
+    QSaveFile out(archivePath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        setError(error, out.errorString());
+        return false;
+    }
+    PackArchive::Header header = {};
+    header.magic = PackArchive::Magic;
+    header.version = PackArchive::Version;
+    header.alignment = PackArchive::Alignment;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<PackArchive::Entry> entries;
+    entries.reserve(files.size());
+    QByteArray names;
+    for (size_t first = 0; first < files.size();) {
+        size_t last = first;
+        qint64 batchBytes = 0;
+        while (last < files.size() && (last == first || (batchBytes < BatchBytes && last - first < size_t(BatchFiles))))
+            batchBytes += files[last++].size;
+
+        JobSystem::instance().parallelFor(first, last, 8, [&files](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                PackedFile &packed = files[i];
+                QFile input(packed.path);
+                if (!input.open(QIODevice::ReadOnly)) {
+                    packed.error = input.errorString();
+                    continue;
+                }
+                packed.payload = input.readAll();
+                packed.size = packed.payload.size();
+                if (PackArchive::compressionFor(packed.path) == PackArchive::Deflate) {
+                    QByteArray deflated = qCompress(packed.payload, 6);
+                    if (deflated.size() < packed.payload.size() * 9 / 10) {
+                        packed.payload = std::move(deflated);
+                        packed.compression = PackArchive::Deflate;
+                    }
+                }
+            }
+        });
+
+        for (size_t i = first; i < last; ++i) {
+            PackedFile &packed = files[i];
+            if (!packed.error.isEmpty()) {
+                setError(error, QString("Cannot read %1: %2").arg(packed.path, packed.error));
+                return false;
+            }
+            if (!writePadding(out, PackArchive::Alignment)) {
+                setError(error, out.errorString());
+                return false;
+            }
+            PackArchive::Entry entry = {};
+            entry.pathHash = PackArchive::hashPath(packed.name);
+            entry.offset = quint64(out.pos());
+            entry.storedSize = quint64(packed.payload.size());
+            entry.size = quint64(packed.size);
+            entry.modified = packed.modified;
+            entry.nameOffset = quint32(names.size());
+            entry.nameLength = quint32(packed.name.size());
+            entry.compression = packed.compression;
+            entries.push_back(entry);
+            names.append(packed.name);
+            if (out.write(packed.payload) != packed.payload.size()) {
+                setError(error, out.errorString());
+                return false;
+            }
+            packed.payload = QByteArray(); // Пачка не копится в памяти
+        }
+        first = last;
+    }
+
+    std::sort(entries.begin(), entries.end(), [&names](const PackArchive::Entry &a, const PackArchive::Entry &b) {
+        if (a.pathHash != b.pathHash)
+            return a.pathHash < b.pathHash;
+        return std::lexicographical_compare(names.constData() + a.nameOffset, names.constData() + a.nameOffset + a.nameLength,
+                                            names.constData() + b.nameOffset, names.constData() + b.nameOffset + b.nameLength);
+    });
+    writePadding(out, PackArchive::Alignment);
+    header.entryCount = quint32(entries.size());
+    header.tocOffset = quint64(out.pos());
+    out.write(reinterpret_cast<const char *>(entries.data()), qint64(entries.size() * sizeof(PackArchive::Entry)));
+    header.namesOffset = quint64(out.pos());
+    header.namesSize = quint64(names.size());
+    out.write(names);
+    stats.archiveBytes = out.pos();
+
+    out.seek(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!out.commit()) {
+        setError(error, out.errorString());
+        return false;
+    }
+    return true;
+}
+
+} // namespace core
@@ -0,0 +1,110 @@
+#ifndef PACKARCHIVE_H
+#define PACKARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+namespace core {
+
+// Архив ресурсов игры (.pak): один файл вместо тысяч мелких.
+// Раскладка: заголовок 64 байта, данные записей (каждая выровнена по Alignment), оглавление
+// из записей Entry, отсортированных по хэшу пути, и имена подряд в UTF-8.
+// Архив читается через отображение в память: оглавление используется прямо из него,
+// несжатые записи отдаются указателем без копирования. Сжатие выбирается по типу данных:
+// уже сжатые форматы (PNG, JPEG, OGG…) хранятся как есть, остальное — zlib, если это даёт выигрыш.
+// Числа в little-endian; открытый архив можно читать из нескольких потоков
+class PackArchive {
+public:
+    enum Compression : quint32 {
+        Stored,
+        Deflate // qCompress
+    };
+
+    static constexpr quint32 Magic = 0x4B415053; // "SPAK"
+    static constexpr quint32 Version = 2;
+    static constexpr quint32 Alignment = 64;
+
+    struct Header {
+        quint32 magic;
+        quint32 version;
+        quint32 entryCount;
+        quint32 alignment;
+        quint64 tocOffset;
+        quint64 namesOffset;
+        quint64 namesSize;
+        quint64 reserved[3];
+    };
+
+    struct Entry {
+        quint64 pathHash;
+        quint64 offset;     // От начала архива
+        quint64 storedSize; // В архиве
+        quint64 size;       // После распаковки
+        qint64 modified;    // Время изменения исходного файла, мс от эпохи
+        quint32 nameOffset;
+        quint32 nameLength;
+        quint32 compression;
+        quint32 reserved;
+    };
+
+    PackArchive();
+    ~PackArchive();
+
+    PackArchive(const PackArchive &) = delete;
+    PackArchive &operator=(const PackArchive &) = delete;
+
+    bool open(const QString &path, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return mapped != nullptr; }
+
+    int count() const { return int(entryCount); }
+    const Entry &entry(int index) const { return entries[index]; }
+    QString name(int index) const;
+    // Номер записи по пути относительно упакованного каталога; -1 — нет
+    int indexOf(const QString &path) const;
+
+    // Данные несжатой записи прямо в отображённом файле; nullptr для сжатых
+    const uchar *mappedData(int index) const;
+    // Содержимое записи. Несжатые отдаются без копии и действительны, пока архив открыт
+    QByteArray read(int index) const;
+    QByteArray read(const QString &path) const;
+    // Просит ОС заранее дочитать записи и распаковывает их параллельно; результат — в порядке indices
+    QVector<QByteArray> readMany(const QVector<int> &indices) const;
+
+    static quint64 hashPath(const QByteArray &utf8Path);
+    // Способ хранения по расширению; итог всё равно Stored, если zlib не сжал хотя бы на 10%
+    static Compression compressionFor(const QString &path);
+
+private:
+    void prefetch(int index) const;
+
+    QFile file;
+    const uchar *mapped;
+    qint64 mappedSize;
+    const Entry *entries;
+    const char *names;
+    quint32 entryCount;
+};
+
+// Упаковщик каталога в PackArchive. Файлы читаются и сжимаются параллельно пачками,
+// записываются по порядку путей через QSaveFile
+class PackWriter {
+public:
+    struct Statistics {
+        int files = 0;
+        qint64 inputBytes = 0;
+        qint64 archiveBytes = 0;
+        bool upToDate = false; // У всех файлов те же пути, размеры и время изменения — архив не переписывался
+    };
+
+    // Все файлы directory, кроме скрытых, с путями относительно него
+    static bool pack(const QString &directory, const QString &archivePath, Statistics *statistics = nullptr,
+                     QString *error = nullptr);
+};
+
+} // namespace core
+
+#endif // PACKARCHIVE_H
@@ -0,0 +1,42 @@
+#include "poolallocator.h"
+#include <algorithm>
+
+namespace core {
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t alignment, size_t blocksPerPage, MemoryTag tag)
+    : alignment(std::max(alignment, alignof(FreeBlock))), blocksPerPage(std::max<size_t>(1, blocksPerPage)), tag(tag),
+      freeList(nullptr), live(0) {
+    // Шаг кратен выравниванию, чтобы каждый блок страницы был выровнен
+    const size_t size = std::max(blockSize, sizeof(FreeBlock));
+    stride = (size + this->alignment - 1) / this->alignment * this->alignment;
+}
+
+PoolAllocator::~PoolAllocator() {
+    release();
+}
+
+void PoolAllocator::addPage() {
+    const size_t pageSize = stride * blocksPerPage;
+    char *page = static_cast<char *>(::operator new(pageSize, std::align_val_t(alignment)));
+    MemoryTracker::allocated(tag, pageSize);
+    pages.push_back(page);
+    // Нанизываем блоки в порядке адресов: первые выделения идут подряд по памяти
+    for (size_t i = blocksPerPage; i-- > 0;) {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(page + i * stride);
+        block->next = freeList;
+        freeList = block;
+    }
+}
+
+void PoolAllocator::release() {
+    const size_t pageSize = stride * blocksPerPage;
+    for (void *page : pages) {
+        MemoryTracker::freed(tag, pageSize);
+        ::operator delete(page, std::align_val_t(alignment));
+    }
+    pages.clear();
+    freeList = nullptr;
+    live = 0;
+}
+
+} // namespace core
@@ -0,0 +1,94 @@
+#ifndef POOLALLOCATOR_H
+#define POOLALLOCATOR_H
+
+#include "memorytracker.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+// Пул блоков одного размера: выделение и возврат — снятие и возврат в список свободных.
+// Блоки нарезаются из страниц по blocksPerPage штук; страницы возвращаются куче только
+// в release() или деструкторе. Свободный блок хранит указатель на следующий прямо в себе.
+// Не потокобезопасен
+class PoolAllocator {
+public:
+    PoolAllocator(size_t blockSize, size_t alignment, size_t blocksPerPage, MemoryTag tag = MemoryTag::General);
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator &) = delete;
+    PoolAllocator &operator=(const PoolAllocator &) = delete;
+
+    void *allocate() {
+        if (!freeList)
+            addPage();
+        FreeBlock *block = freeList;
+        freeList = block->next;
+        ++live;
+        return block;
+    }
+
+    void deallocate(void *pointer) {
+        FreeBlock *block = static_cast<FreeBlock *>(pointer);
+        block->next = freeList;
+        freeList = block;
+        --live;
+    }
+
+    // Возвращает страницы куче; все блоки должны быть уже возвращены
+    void release();
+
+    size_t blockSize() const { return stride; }
+    size_t liveBlocks() const { return live; }
+    size_t pageCount() const { return pages.size(); }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    void addPage();
+
+    size_t stride;
+    size_t alignment;
+    size_t blocksPerPage;
+    MemoryTag tag;
+    FreeBlock *freeList;
+    std::vector<void *> pages;
+    size_t live;
+};
+
+// Типизированная обёртка над пулом
+template<typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t objectsPerPage = 256, MemoryTag tag = MemoryTag::General)
+        : pool(sizeof(T), alignof(T), objectsPerPage, tag) {}
+
+    template<typename... Args>
+    T *create(Args &&...args) {
+        void *memory = pool.allocate();
+        try {
+            return new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    void destroy(T *object) {
+        object->~T();
+        pool.deallocate(object);
+    }
+
+    size_t liveObjects() const { return pool.liveBlocks(); }
+
+private:
+    PoolAllocator pool;
+};
+
+} // namespace core
+
+#endif // POOLALLOCATOR_H
@@ -0,0 +1,405 @@
+#include "profiler.h"
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+namespace core {
+
+namespace {
+
+// Ячейка кольца. Поля атомарные, чтобы чтение снимка параллельно с записью было законным;
+// relaxed-запись на x86/ARM — обычная запись
+struct Slot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint32_t> depth{0};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+};
+
+// Кольцо одного потока: пишет только владелец, читает endCapture().
+// head — число записанных событий за всё время; событие i лежит в slots[i % RingCapacity]
+struct ThreadBuffer {
+    std::atomic<uint64_t> head{0};
+    std::atomic<Slot *> slots{nullptr}; // Выделяется при первой записи
+    // Поля ниже — под registryMutex
+    uint64_t id = 0;
+    uint64_t captureMark = 0; // head на момент beginCapture()
+    QString name;
+    bool alive = true;
+};
+
+std::mutex registryMutex;
+std::vector<ThreadBuffer *> registry; // Не освобождаются: буферы завершённых потоков переиспользуются
+uint64_t nextThreadId = 1;
+uint64_t captureStartTime = 0; // нс
+uint64_t captureStartTicks = 0;
+QString environmentTraceFile;
+
+ThreadBuffer *acquireBuffer() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ThreadBuffer *buffer = nullptr;
+    // Во время снимка старые события освободившегося буфера ещё нужны — берём новый
+    if (!Profiler::isEnabled()) {
+        for (ThreadBuffer *candidate : registry) {
+            if (!candidate->alive) {
+                buffer = candidate;
+                break;
+            }
+        }
+    }
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        registry.push_back(buffer);
+    }
+    buffer->alive = true;
+    buffer->id = nextThreadId++;
+    buffer->captureMark = buffer->head.load(std::memory_order_relaxed);
+    buffer->name = QString("Thread %1").arg(buffer->id);
+    return buffer;
+}
+
+// Указатель без деструктора — быстрый доступ из record(); буфер отпускает BufferRelease
+thread_local ThreadBuffer *localBuffer = nullptr;
+
+struct BufferRelease {
+    ~BufferRelease() {
+        if (localBuffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            localBuffer->alive = false;
+        }
+    }
+};
+
+thread_local BufferRelease bufferRelease;
+
+ThreadBuffer *currentBuffer() {
+    if (!localBuffer) {
+        (void)&bufferRelease; // Регистрирует деструктор в этом потоке
+        localBuffer = acquireBuffer();
+    }
+    return localBuffer;
+}
+
+QByteArray escapeJson(const QString &text) {
+    QByteArray result;
+    const QByteArray utf8 = text.toUtf8();
+    result.reserve(utf8.size());
+    for (char c : utf8) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (uchar(c) < 0x20) {
+            result += "\\u00";
+            result += QByteArray::number(uchar(c), 16).rightJustified(2, '0');
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+bool Profiler::Capture::isEmpty() const {
+    return eventCount() == 0;
+}
+
+size_t Profiler::Capture::eventCount() const {
+    size_t count = 0;
+    for (const Thread &thread : threads)
+        count += thread.events.size();
+    return count;
+}
+
+uint64_t Profiler::now() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end, uint32_t depth) {
+    ThreadBuffer *buffer = currentBuffer();
+    Slot *slots = buffer->slots.load(std::memory_order_relaxed);
+    if (!slots) {
+        slots = new Slot[RingCapacity];
+        buffer->slots.store(slots, std::memory_order_release);
+    }
+    const uint64_t index = buffer->head.load(std::memory_order_relaxed);
+    Slot &slot = slots[index & (RingCapacity - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const QString &name) {
+    ThreadBuffer *buffer = currentBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->name = name;
+}
+
+void Profiler::beginCapture() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (ThreadBuffer *buffer : registry)
+        buffer->captureMark = buffer->head.load(std::memory_order_acquire);
+    captureStartTime = now();
+    captureStartTicks = ticks();
+    enabledFlag.store(true, std::memory_order_relaxed);
+}
+
+Profiler::Capture Profiler::endCapture() {
+    enabledFlag.store(false, std::memory_order_relaxed);
+    Capture capture;
+    capture.end = now();
+    const uint64_t endTicks = ticks();
+
+    struct RawEvent {
+        const char *name;
+        uint32_t depth;
+        uint64_t start;
+        uint64_t end;
+    };
+    std::vector<RawEvent> raw;
+    QHash<const char *, int> nameIndex;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    capture.start = captureStartTime;
+    // Такты в наносекунды по двум опорным точкам — началу и концу снимка (TSC постоянной частоты)
+    const double nsPerTick = endTicks > captureStartTicks
+                                 ? double(capture.end - captureStartTime) / double(endTicks - captureStartTicks)
+                                 : 1.0;
+    auto toNs = [&](uint64_t tick) {
+        const double offset = double(int64_t(tick - captureStartTicks)) * nsPerTick;
+        return uint64_t(std::max(0.0, double(captureStartTime) + offset));
+    };
+    for (ThreadBuffer *buffer : registry) {
+        const Slot *slots = buffer->slots.load(std::memory_order_acquire);
+        if (!slots)
+            continue;
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = std::max(buffer->captureMark, head > RingCapacity ? head - RingCapacity : 0);
+        raw.clear();
+        raw.reserve(size_t(head - first));
+        for (uint64_t i = first; i < head; ++i) {
+            const Slot &slot = slots[i & (RingCapacity - 1)];
+            raw.push_back({slot.name.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed),
+                           slot.start.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed)});
+        }
+        // Замер, закончившийся после выключения, мог перезаписать начало прочитанного — отбрасываем его
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = buffer->head.load(std::memory_order_relaxed);
+        const uint64_t overwritten = after > RingCapacity ? after - RingCapacity : 0;
+        const size_t skip = overwritten > first ? size_t(std::min(overwritten - first, head - first)) : 0;
+        if (skip == raw.size())
+            continue;
+
+        Thread thread;
+        thread.id = buffer->id;
+        thread.name = buffer->name;
+        thread.events.reserve(raw.size() - skip);
+        for (size_t i = skip; i < raw.size(); ++i) {
+            const RawEvent &event = raw[i];
+            auto found = nameIndex.constFind(event.name);
+            int index;
+            if (found == nameIndex.constEnd()) {
+                index = capture.names.size();
+                capture.names.append(QString::fromUtf8(event.name));
+                nameIndex.insert(event.name, index);
+            } else {
+                index = found.value();
+            }
+            thread.events.push_back({index, event.depth, toNs(event.start), toNs(event.end)});
+            thread.maxDepth = std::max(thread.maxDepth, event.depth);
+        }
+        // События пишутся по завершении, внешние — позже вложенных
+        std::sort(thread.events.begin(), thread.events.end(), [](const Event &a, const Event &b) {
+            return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+        });
+        capture.start = std::min(capture.start, thread.events.front().start);
+        capture.threads.push_back(std::move(thread));
+    }
+    return capture;
+}
+
+void Profiler::startFromEnvironment() {
+    environmentTraceFile = qEnvironmentVariable("SPECTER_TRACE_FILE");
+    if (environmentTraceFile.isEmpty())
+        return;
+    beginCapture();
+    std::atexit([]() {
+        writeChromeTrace(endCapture(), environmentTraceFile);
+    });
+}
+
+bool Profiler::writeChromeTrace(const Capture &capture, const QString &path, QString *error) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    QVector<QByteArray> names;
+    names.reserve(capture.names.size());
+    for (const QString &name : capture.names)
+        names.append(escapeJson(name));
+
+    // Пишем вручную и кусками: QJsonDocument на миллионе событий требует гигабайты
+    QByteArray chunk;
+    chunk.reserve(1 << 20);
+    chunk += "{\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&chunk, &first]() {
+        if (!first)
+            chunk += ",\n";
+        first = false;
+    };
+    for (const Thread &thread : capture.threads) {
+        const QByteArray tid = QByteArray::number(qulonglong(thread.id));
+        separator();
+        chunk += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid +
+                 ",\"args\":{\"name\":\"" + escapeJson(thread.name) + "\"}}";
+        for (const Event &event : thread.events) {
+            separator();
+            // Время в микросекундах от начала снимка, с точностью до наносекунды
+            const uint64_t start = event.start > capture.start ? event.start - capture.start : 0;
+            chunk += "{\"name\":\"";
+            chunk += names[event.name];
+            chunk += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            chunk += tid;
+            chunk += ",\"ts\":";
+            chunk += QByteArray::number(double(start) / 1000.0, 'f', 3);
+            chunk += ",\"dur\":";
+            chunk += QByteArray::number(double(event.end - event.start) / 1000.0, 'f', 3);
+            chunk += '}';
+            if (chunk.size() > (1 << 20) - 512) {
+                file.write(chunk);
+                chunk.clear();
+            }
+        }
+    }
+    chunk += "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"durationUs\":";
+    chunk += QByteArray::number(double(capture.end - capture.start) / 1000.0, 'f', 3);
+    chunk += "}}\n";
+    file.write(chunk);
+    if (!file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool Profiler::readChromeTrace(const QString &path, Capture *capture, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull()) {
+        if (error)
+            *error = parseError.errorString();
+        return false;
+    }
+    // Допустимы оба варианта формата: объект с traceEvents и просто массив событий
+    const QJsonArray events = document.isArray() ? document.array() : document.object().value("traceEvents").toArray();
+
+    Capture result;
+    QHash<QString, int> nameIndex;
+    QHash<qint64, size_t> threadIndex;
+    QHash<qint64, std::vector<Event>> openEvents; // Незакрытые "B" по потокам
+    auto threadFor = [&result, &threadIndex](qint64 tid) -> Thread & {
+        auto found = threadIndex.constFind(tid);
+        if (found != threadIndex.constEnd())
+            return result.threads[found.value()];
+        threadIndex.insert(tid, result.threads.size());
+        Thread thread;
+        thread.id = uint64_t(tid);
+        thread.name = QString("Thread %1").arg(tid);
+        result.threads.push_back(thread);
+        return result.threads.back();
+    };
+    auto internName = [&result, &nameIndex](const QString &name) {
+        auto found = nameIndex.constFind(name);
+        if (found != nameIndex.constEnd())
+            return found.value();
+        const int index = result.names.size();
+        result.names.append(name);
+        nameIndex.insert(name, index);
+        return index;
+    };
+
+    double minimum = 0.0;
+    bool haveMinimum = false;
+    for (const QJsonValue &value : events) {
+        const QJsonObject object = value.toObject();
+        const QString phase = object.value("ph").toString();
+        if (phase == "X" || phase == "B") {
+            const double ts = object.value("ts").toDouble();
+            if (!haveMinimum || ts < minimum)
+                minimum = ts;
+            haveMinimum = true;
+        }
+    }
+    for (const QJsonValue &value : events) {
+        const QJsonObject object = value.toObject();
+        const QString phase = object.value("ph").toString();
+        const qint64 tid = qint64(object.value("tid").toDouble());
+        // Микросекунды с плавающей точкой в наносекунды от начала записи
+        const uint64_t ts = uint64_t(std::llround((object.value("ts").toDouble() - minimum) * 1000.0));
+        if (phase == "X") {
+            const uint64_t duration = uint64_t(std::llround(object.value("dur").toDouble() * 1000.0));
+            threadFor(tid).events.push_back({internName(object.value("name").toString()), 0, ts, ts + duration});
+        } else if (phase == "B") {
+            openEvents[tid].push_back({internName(object.value("name").toString()), 0, ts, ts});
+        } else if (phase == "E") {
+            std::vector<Event> &stack = openEvents[tid];
+            if (!stack.empty()) {
+                Event event = stack.back();
+                stack.pop_back();
+                event.end = ts;
+                threadFor(tid).events.push_back(event);
+            }
+        } else if (phase == "M" && object.value("name").toString() == "thread_name") {
+            threadFor(tid).name = object.value("args").toObject().value("name").toString();
+        }
+    }
+
+    // Вложенность восстанавливается по интервалам: событие лежит внутри всех ещё не закончившихся
+    for (Thread &thread : result.threads) {
+        std::sort(thread.events.begin(), thread.events.end(), [](const Event &a, const Event &b) {
+            return a.start != b.start ? a.start < b.start : a.end > b.end;
+        });
+        std::vector<uint64_t> ends;
+        for (Event &event : thread.events) {
+            while (!ends.empty() && ends.back() <= event.start)
+                ends.pop_back();
+            event.depth = uint32_t(ends.size());
+            thread.maxDepth = std::max(thread.maxDepth, event.depth);
+            ends.push_back(event.end);
+            result.end = std::max(result.end, event.end);
+        }
+    }
+    result.threads.erase(std::remove_if(result.threads.begin(), result.threads.end(),
+                                        [](const Thread &thread) { return thread.events.empty(); }),
+                         result.threads.end());
+    result.start = 0;
+    const double duration = document.object().value("otherData").toObject().value("durationUs").toDouble();
+    result.end = std::max(result.end, uint64_t(duration * 1000.0));
+    *capture = std::move(result);
+    return true;
+}
+
+} // namespace core
@@ -0,0 +1,132 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SPECTER_PROFILER_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SPECTER_PROFILER_TSC
+#else
+#include <chrono>
+#endif
+
+// Замеры участков кода:
+//   SPECTER_PROFILE_SCOPE("Имя");  — от этой строки до конца блока
+//   SPECTER_PROFILE_FUNCTION();     — вся функция
+// Имя — строковый литерал (хранится указатель). Без SPECTER_PROFILING макросы пустые;
+// со сборкой, но выключенным профилировщиком замер — одна relaxed-загрузка и переход.
+// Включённый замер пишет в кольцевой буфер своего потока без блокировок: два чтения счётчика
+// тактов и одна запись; в наносекунды такты переводятся при сборе снимка. Снимок (Capture) собирается из всех буферов и сохраняется в формате
+// Chrome Trace (chrome://tracing, Perfetto).
+#ifdef SPECTER_PROFILING
+#define SPECTER_PROFILE_CONCAT_(a, b) a##b
+#define SPECTER_PROFILE_CONCAT(a, b) SPECTER_PROFILE_CONCAT_(a, b)
+#define SPECTER_PROFILE_SCOPE(name) ::core::ProfileScope SPECTER_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define SPECTER_PROFILE_FUNCTION() SPECTER_PROFILE_SCOPE(__func__)
+#else
+#define SPECTER_PROFILE_SCOPE(name) do {} while (false)
+#define SPECTER_PROFILE_FUNCTION() do {} while (false)
+#endif
+
+namespace core {
+
+class Profiler {
+public:
+    // Событий в буфере одного потока; старые перезаписываются
+    static constexpr size_t RingCapacity = size_t(1) << 15;
+
+    struct Event {
+        int name;       // Индекс в Capture::names
+        uint32_t depth; // Вложенность в своём потоке
+        uint64_t start; // нс
+        uint64_t end;
+    };
+
+    struct Thread {
+        uint64_t id = 0;
+        QString name;
+        std::vector<Event> events; // По возрастанию start
+        uint32_t maxDepth = 0;
+    };
+
+    struct Capture {
+        uint64_t start = 0; // нс, общая шкала всех потоков
+        uint64_t end = 0;
+        QVector<QString> names;
+        std::vector<Thread> threads;
+
+        bool isEmpty() const;
+        size_t eventCount() const;
+    };
+
+    static bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+
+    // Начинает снимок: включает запись и запоминает текущие позиции буферов
+    static void beginCapture();
+    // Выключает запись и собирает события с начала снимка
+    static Capture endCapture();
+
+    // Имя потока в снимках; вызывается из самого потока
+    static void setThreadName(const QString &name);
+
+    // Если задана переменная окружения SPECTER_TRACE_FILE, запись включается сразу,
+    // а при выходе из программы снимок сохраняется в этот файл (так профилируется игра из Run)
+    static void startFromEnvironment();
+
+    static bool writeChromeTrace(const Capture &capture, const QString &path, QString *error = nullptr);
+    static bool readChromeTrace(const QString &path, Capture *capture, QString *error = nullptr);
+
+    // Наносекунды steady_clock — общая шкала снимков
+    static uint64_t now();
+    // Метка замера: такты TSC на x86 (в несколько раз дешевле steady_clock), иначе наносекунды
+    static uint64_t ticks() {
+#ifdef SPECTER_PROFILER_TSC
+        return __rdtsc();
+#else
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+    static void record(const char *name, uint64_t start, uint64_t end, uint32_t depth);
+
+private:
+    friend class ProfileScope;
+
+    static inline std::atomic<bool> enabledFlag{false};
+    static inline thread_local uint32_t threadDepth = 0;
+};
+
+// Замер одного участка. Время берётся только если профилировщик включён в момент входа
+class ProfileScope {
+public:
+    explicit ProfileScope(const char *name) : name(name), start(0) {
+        if (Profiler::isEnabled()) {
+            start = Profiler::ticks();
+            ++Profiler::threadDepth;
+        }
+    }
+    ~ProfileScope() {
+        if (start) {
+            const uint32_t depth = --Profiler::threadDepth;
+            Profiler::record(name, start, Profiler::ticks(), depth);
+        }
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char *name;
+    uint64_t start;
+};
+
+} // namespace core
+
+#endif // PROFILER_H
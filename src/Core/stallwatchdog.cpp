@@ -0,0 +1,287 @@
+#include "stallwatchdog.h"
+#include "profiler.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QUuid>
+#include <algorithm>
+#include <chrono>
+
+namespace core {
+
+namespace {
+
+uint64_t nowNs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+QString eventName(int type) {
+    const char *key = QMetaEnum::fromType<QEvent::Type>().valueToKey(type);
+    return key ? QString(key) : QString("Event %1").arg(type);
+}
+
+int histogramBucket(double ms) {
+    if (ms < 50.0)
+        return 0;
+    if (ms < 100.0)
+        return 1;
+    if (ms < 250.0)
+        return 2;
+    if (ms < 1000.0)
+        return 3;
+    return 4;
+}
+
+QByteArray toLine(const QJsonObject &object) {
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+} // namespace
+
+StallWatchdog::StallWatchdog(int budget)
+    : budgetMs(budget), session(QUuid::createUuid().toString(QUuid::WithoutBraces)), sessionStart(0), blockStart(0), blockedNs(0),
+      outerStart(0), outerSerial(0), blockedTotal(0), depth(0), blocked(false), topClass(nullptr), topEvent(0), logPath(defaultLogFile()),
+      running(false) {
+    frames.reserve(64);
+}
+
+StallWatchdog::~StallWatchdog() {
+    stop();
+}
+
+void StallWatchdog::setBudget(int budget) {
+    budgetMs.store(std::max(1, budget), std::memory_order_relaxed);
+    wakeup.notify_all();
+}
+
+void StallWatchdog::setLogFile(const QString &path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    logPath = path;
+}
+
+QString StallWatchdog::logFile() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return logPath;
+}
+
+QString StallWatchdog::defaultLogFile() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/stalls.jsonl";
+}
+
+void StallWatchdog::start() {
+    if (watcher.joinable())
+        return;
+    sessionStart = nowNs();
+    startedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = true;
+    }
+    watcher = std::thread(&StallWatchdog::watchLoop, this);
+}
+
+void StallWatchdog::stop() {
+    if (!watcher.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeup.notify_all();
+    watcher.join();
+
+    QJsonObject summary;
+    summary.insert("session", session);
+    summary.insert("type", "session");
+    summary.insert("host", QSysInfo::machineHostName());
+    summary.insert("os", QSysInfo::prettyProductName());
+    summary.insert("version", QCoreApplication::applicationVersion());
+    summary.insert("start", startedAt);
+    summary.insert("end", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs));
+    summary.insert("uptimeS", double(nowNs() - sessionStart) / 1e9);
+    summary.insert("budgetMs", budget());
+    summary.insert("stalls", stats.stalls);
+    summary.insert("totalStallMs", stats.totalMs);
+    summary.insert("maxStallMs", stats.maxMs);
+    QJsonObject histogram;
+    const char *bucketNames[5] = {"<50", "50-100", "100-250", "250-1000", ">=1000"};
+    for (int i = 0; i < 5; ++i)
+        histogram.insert(bucketNames[i], stats.histogram[i]);
+    summary.insert("histogram", histogram);
+
+    // Десять самых дорогих по сумме мест
+    std::vector<std::pair<QString, ContextStatistics>> contexts;
+    for (auto it = stats.contexts.constBegin(); it != stats.contexts.constEnd(); ++it)
+        contexts.emplace_back(it.key(), it.value());
+    std::sort(contexts.begin(), contexts.end(), [](const auto &a, const auto &b) {
+        return a.second.totalMs > b.second.totalMs;
+    });
+    QJsonArray top;
+    for (size_t i = 0; i < std::min<size_t>(10, contexts.size()); ++i) {
+        QJsonObject entry;
+        entry.insert("context", contexts[i].first);
+        entry.insert("count", contexts[i].second.count);
+        entry.insert("totalMs", contexts[i].second.totalMs);
+        entry.insert("maxMs", contexts[i].second.maxMs);
+        top.append(entry);
+    }
+    summary.insert("top", top);
+
+    std::vector<QByteArray> lines;
+    lines.swap(pending);
+    lines.push_back(toLine(summary));
+    writeLines(lines);
+}
+
+void StallWatchdog::enter(const char *receiverClass, int eventType, const QString &detail) {
+    if (frames.empty()) {
+        // Отсчёт идёт от начала самого внешнего события: вложенные синхронные события
+        // (ChildAdded, Polish при создании виджетов) его не сбрасывают
+        blockedNs = 0;
+        blockedTotal.store(0, std::memory_order_relaxed);
+        outerStart.store(nowNs(), std::memory_order_relaxed);
+        outerSerial.fetch_add(1, std::memory_order_release);
+    }
+    frames.push_back({receiverClass, eventType, detail});
+    topClass.store(receiverClass, std::memory_order_relaxed);
+    topEvent.store(eventType, std::memory_order_relaxed);
+    depth.store(int(frames.size()), std::memory_order_release);
+}
+
+void StallWatchdog::leave() {
+    if (frames.size() == 1)
+        finishOuter(nowNs());
+    frames.pop_back();
+    topClass.store(frames.empty() ? nullptr : frames.back().receiverClass, std::memory_order_relaxed);
+    topEvent.store(frames.empty() ? 0 : frames.back().eventType, std::memory_order_relaxed);
+    depth.store(int(frames.size()), std::memory_order_release);
+}
+
+void StallWatchdog::aboutToBlock() {
+    // Вне событий главный поток и так ждёт — считать нечего
+    if (frames.empty() || blocked.load(std::memory_order_relaxed))
+        return;
+    blockStart = nowNs();
+    blocked.store(true, std::memory_order_release);
+}
+
+void StallWatchdog::awake() {
+    // awake приходит и в начале каждого processEvents, а не только после сна: учитываем
+    // только интервалы, начатые aboutToBlock
+    if (!blocked.load(std::memory_order_relaxed))
+        return;
+    blockedNs += nowNs() - blockStart;
+    blockedTotal.store(blockedNs, std::memory_order_relaxed);
+    blocked.store(false, std::memory_order_release);
+}
+
+void StallWatchdog::finishOuter(uint64_t now) {
+    if (blocked.load(std::memory_order_relaxed))
+        awake();
+    const uint64_t busy = now - outerStart.load(std::memory_order_relaxed) - blockedNs;
+    const double ms = double(busy) / 1e6;
+    if (ms < budget())
+        return;
+
+    const Frame &frame = frames.front();
+    const QString context = describe(frame.receiverClass, frame.eventType, frame.detail);
+    ++stats.stalls;
+    stats.totalMs += ms;
+    stats.maxMs = std::max(stats.maxMs, ms);
+    ++stats.histogram[histogramBucket(ms)];
+    ContextStatistics &entry = stats.contexts[context];
+    ++entry.count;
+    entry.totalMs += ms;
+    entry.maxMs = std::max(entry.maxMs, ms);
+
+    QJsonObject record;
+    record.insert("session", session);
+    record.insert("type", "stall");
+    record.insert("host", QSysInfo::machineHostName());
+    record.insert("time", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs));
+    record.insert("durationMs", ms);
+    record.insert("budgetMs", budget());
+    record.insert("receiver", QString(frame.receiverClass));
+    record.insert("event", eventName(frame.eventType));
+    if (!frame.detail.isEmpty())
+        record.insert("detail", frame.detail);
+
+    // В файл пишет поток-сторож: запись на диск сама по себе задержала бы главный
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(toLine(record));
+    }
+    wakeup.notify_one();
+}
+
+QString StallWatchdog::describe(const char *receiverClass, int eventType, const QString &detail) {
+    QString context = QString("%1 %2").arg(receiverClass, eventName(eventType));
+    if (!detail.isEmpty())
+        context += " \"" + detail + '"';
+    return context;
+}
+
+void StallWatchdog::watchLoop() {
+    Profiler::setThreadName("Stall Watchdog");
+    uint64_t reportedSerial = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        const int interval = std::max(1, budget() / 2);
+        wakeup.wait_for(lock, std::chrono::milliseconds(interval));
+
+        if (!pending.empty()) {
+            std::vector<QByteArray> lines;
+            lines.swap(pending);
+            lock.unlock();
+            writeLines(lines);
+            lock.lock();
+        }
+
+        // Главный поток висит прямо сейчас: пишем о нём, не дожидаясь конца внешнего события.
+        // Вложенный цикл событий, ждущий пользователя, не висит
+        if (depth.load(std::memory_order_acquire) == 0 || blocked.load(std::memory_order_acquire))
+            continue;
+        const uint64_t serial = outerSerial.load(std::memory_order_acquire);
+        const uint64_t since = outerStart.load(std::memory_order_relaxed) + blockedTotal.load(std::memory_order_relaxed);
+        const uint64_t now = nowNs();
+        if (serial == reportedSerial || now < since || now - since < uint64_t(HangReportDelay) * 1000000u)
+            continue;
+        reportedSerial = serial;
+        const char *receiver = topClass.load(std::memory_order_relaxed);
+        QJsonObject record;
+        record.insert("session", session);
+        record.insert("type", "hang");
+        record.insert("host", QSysInfo::machineHostName());
+        record.insert("time", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs));
+        record.insert("elapsedMs", double(now - since) / 1e6);
+        record.insert("receiver", QString(receiver ? receiver : "?"));
+        record.insert("event", eventName(topEvent.load(std::memory_order_relaxed)));
+        lock.unlock();
+        writeLines({toLine(record)});
+        lock.lock();
+    }
+}
+
+void StallWatchdog::writeLines(const std::vector<QByteArray> &lines) {
+    if (lines.empty())
+        return;
+    const QString path = logFile();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
+    for (const QByteArray &line : lines)
+        file.write(line);
+}
+
+} // namespace core
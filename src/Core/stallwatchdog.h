@@ -0,0 +1,119 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core {
+
+// Сторож главного потока. Главный поток отмечает начало и конец обработки каждого события
+// (enter/leave из QApplication::notify); самое внешнее событие, обрабатывавшееся дольше
+// бюджета, — зависание, и оно приписывается этому событию (обычно вводу пользователя).
+// Вложенные синхронные события (ChildAdded, Polish при создании виджетов) отсчёт не сбрасывают.
+// Ожидание во вложенном цикле событий (модальный диалог, QFileDialog) отмечается
+// aboutToBlock/awake диспетчера и из длительности вычитается, а работа до и после — нет.
+// Отдельный поток раз в полбюджета проверяет, не висит ли главный прямо сейчас, и пишет
+// запись "hang" с самым вложенным событием сразу, не дожидаясь конца.
+// Журнал — JSON Lines, по строке на зависание и сводка за сессию при stop(); в каждой строке
+// сессия и машина, чтобы журналы разных машин можно было просто склеить и агрегировать.
+class StallWatchdog {
+public:
+    static constexpr int DefaultBudget = 100;   // мс
+    static constexpr int HangReportDelay = 1000; // мс до записи "hang" о ещё идущем зависании
+
+    struct ContextStatistics {
+        int count = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    struct Statistics {
+        int stalls = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        int histogram[5] = {}; // <50, 50–100, 100–250, 250–1000, >=1000 мс
+        QHash<QString, ContextStatistics> contexts;
+    };
+
+    explicit StallWatchdog(int budgetMs = DefaultBudget);
+    ~StallWatchdog();
+
+    StallWatchdog(const StallWatchdog &) = delete;
+    StallWatchdog &operator=(const StallWatchdog &) = delete;
+
+    void setBudget(int budgetMs);
+    int budget() const { return budgetMs.load(std::memory_order_relaxed); }
+
+    // По умолчанию — stalls.jsonl в каталоге данных приложения
+    void setLogFile(const QString &path);
+    QString logFile() const;
+    static QString defaultLogFile();
+    QString sessionId() const { return session; }
+
+    void start();
+    // Останавливает поток и дописывает сводку за сессию
+    void stop();
+    bool isRunning() const { return watcher.joinable(); }
+
+    // Только из главного потока. receiverClass — статическая строка (className() метаобъекта),
+    // detail — подпись для пользовательского ввода (текст кнопки, пункт меню), обычно пустая
+    void enter(const char *receiverClass, int eventType, const QString &detail = QString());
+    void leave();
+    // Из QAbstractEventDispatcher::aboutToBlock/awake главного потока: пока цикл событий спит,
+    // ни промежуток, ни проверка "hang" не идут
+    void aboutToBlock();
+    void awake();
+
+    // Статистика текущей сессии; только из главного потока
+    const Statistics &statistics() const { return stats; }
+
+private:
+    struct Frame {
+        const char *receiverClass;
+        int eventType;
+        QString detail;
+    };
+
+    void finishOuter(uint64_t now);
+    void watchLoop();
+    void writeLines(const std::vector<QByteArray> &lines);
+    static QString describe(const char *receiverClass, int eventType, const QString &detail);
+
+    std::atomic<int> budgetMs;
+    QString session;
+    QString startedAt;
+
+    // Главный поток
+    std::vector<Frame> frames;
+    Statistics stats;
+    uint64_t sessionStart;
+    uint64_t blockStart; // нс начала текущего сна цикла событий
+    uint64_t blockedNs;  // Сон внутри текущего внешнего события
+
+    // Общие с потоком-сторожем
+    std::atomic<uint64_t> outerStart;   // нс входа в текущее внешнее событие
+    std::atomic<uint64_t> outerSerial;  // Номер внешнего события, чтобы "hang" писался раз
+    std::atomic<uint64_t> blockedTotal; // Копия blockedNs для потока-сторожа
+    std::atomic<int> depth;
+    std::atomic<bool> blocked; // Главный поток ждёт событий
+    std::atomic<const char *> topClass;
+    std::atomic<int> topEvent;
+
+    mutable std::mutex mutex; // pending, logPath, running
+    std::condition_variable wakeup;
+    std::vector<QByteArray> pending; // Строки журнала от главного потока
+    QString logPath;
+    bool running;
+    std::thread watcher;
+};
+
+} // namespace core
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,78 @@
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace core {
+
+// Дек Чейза — Лева фиксированной ёмкости (степень двойки).
+// push/pop вызывает только поток-владелец (с нижнего конца), steal — любой поток (с верхнего).
+// Порядок операций с памятью — по Lê, Pop, Cohen, Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (PPoPP 2013)
+template<typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 4096) : mask(capacity - 1), items(capacity), top(0), bottom(0) {
+        static_assert(std::is_pointer<T>::value, "В деке хранятся указатели");
+    }
+
+    // false — дек полон, вызывающий выполняет задачу сам
+    bool push(T item) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > int64_t(mask))
+            return false;
+        items[size_t(b) & mask].store(item, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release); // Публикует элемент и сам объект для steal()
+        return true;
+    }
+
+    T pop() {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T item = items[size_t(b) & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Последний элемент: соревнуемся с ворами
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        T item = items[size_t(t) & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    bool isEmpty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    const size_t mask;
+    std::vector<std::atomic<T>> items;
+    alignas(64) std::atomic<int64_t> top;    // Воры и владелец на разных кэш-линиях
+    alignas(64) std::atomic<int64_t> bottom;
+};
+
+} // namespace core
+
+#endif // WORKSTEALINGDEQUE_H
@@ -0,0 +1,52 @@
+#include "mesh.h"
+
+namespace render {
+
+Mesh Mesh::cube() {
+    Mesh mesh;
+    mesh.positions = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f},  {0.5f, -0.5f, 0.5f},  {0.5f, 0.5f, 0.5f},  {-0.5f, 0.5f, 0.5f},
+    };
+    mesh.indices = {
+        4, 5, 6, 4, 6, 7, // +Z
+        1, 0, 3, 1, 3, 2, // -Z
+        5, 1, 2, 5, 2, 6, // +X
+        0, 4, 7, 0, 7, 3, // -X
+        7, 6, 2, 7, 2, 3, // +Y
+        0, 1, 5, 0, 5, 4, // -Y
+    };
+    return mesh;
+}
+
+Mesh Mesh::sphere(int rings, int segments) {
+    Mesh mesh;
+    const float pi = 3.14159265f;
+    mesh.positions.reserve(size_t(rings + 1) * size_t(segments + 1));
+    for (int ring = 0; ring <= rings; ++ring) {
+        const float theta = pi * ring / rings;
+        for (int segment = 0; segment <= segments; ++segment) {
+            const float phi = 2.0f * pi * segment / segments;
+            mesh.positions.push_back({0.5f * std::sin(theta) * std::cos(phi), 0.5f * std::cos(theta),
+                                      -0.5f * std::sin(theta) * std::sin(phi)});
+        }
+    }
+    mesh.indices.reserve(size_t(rings) * size_t(segments) * 6);
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            const uint32_t a = uint32_t(ring * (segments + 1) + segment);
+            const uint32_t b = a + uint32_t(segments + 1);
+            mesh.indices.insert(mesh.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+    return mesh;
+}
+
+Mesh Mesh::quad() {
+    Mesh mesh;
+    mesh.positions = {{-0.5f, -0.5f, 0.0f}, {0.5f, -0.5f, 0.0f}, {0.5f, 0.5f, 0.0f}, {-0.5f, 0.5f, 0.0f}};
+    mesh.indices = {0, 1, 2, 0, 2, 3};
+    return mesh;
+}
+
+} // namespace render
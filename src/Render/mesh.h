@@ -0,0 +1,27 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include "rendermath.h"
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+// Индексированная треугольная сетка; лицевая сторона — обход против часовой стрелки
+struct Mesh {
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> indices;
+
+    size_t triangleCount() const { return indices.size() / 3; }
+
+    // Куб с ребром 1 вокруг начала координат
+    static Mesh cube();
+    // Сфера радиуса 0.5: rings поясов по segments сегментов
+    static Mesh sphere(int rings, int segments);
+    // Квадрат 1x1 в плоскости XY, лицом к +Z
+    static Mesh quad();
+};
+
+} // namespace render
+
+#endif // MESH_H
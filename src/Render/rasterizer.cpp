@@ -0,0 +1,376 @@
+#include "rasterizer.h"
+#include "Core/jobsystem.h"
+#include "Core/profiler.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPECTER_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace render {
+
+namespace {
+
+const float FarDepth = 1.0f;
+
+// Плоское освещение: направленный свет + постоянная подсветка, чтобы теневые стороны не были чёрными
+uint32_t shade(uint32_t color, const Vec3 &normal) {
+    static const Vec3 light = normalize(Vec3(0.35f, 0.8f, 0.5f));
+    const float intensity = 0.3f + 0.7f * std::max(0.0f, dot(normalize(normal), light));
+    const uint32_t r = uint32_t(((color >> 16) & 0xFF) * intensity);
+    const uint32_t g = uint32_t(((color >> 8) & 0xFF) * intensity);
+    const uint32_t b = uint32_t((color & 0xFF) * intensity);
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+
+Vec4 lerp(const Vec4 &a, const Vec4 &b, float t) {
+    return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+}
+
+} // namespace
+
+Rasterizer::Rasterizer(int threadCount)
+    : frameWidth(0), frameHeight(0), frameStride(0), tilesX(0), tilesY(0), clearColor(0xFF000000u),
+      totalTriangles(0), nextTile(0) {
+    setThreadCount(threadCount);
+}
+
+void Rasterizer::setThreadCount(int threadCount) {
+    if (threadCount <= 0)
+        threadCount = core::JobSystem::instance().concurrency();
+    workers.resize(size_t(std::max(1, threadCount)));
+    for (Worker &worker : workers)
+        worker.bins.resize(size_t(tilesX) * size_t(tilesY));
+}
+
+void Rasterizer::resize(int width, int height) {
+    width = std::max(0, width);
+    height = std::max(0, height);
+    if (width == frameWidth && height == frameHeight)
+        return;
+    frameWidth = width;
+    frameHeight = height;
+    frameStride = (width + 3) & ~3; // Строка кратна 4 пикселям, чтобы четвёрки не выходили за буфер
+    color.assign(size_t(frameStride) * size_t(height), clearColor);
+    depth.assign(size_t(frameStride) * size_t(height), FarDepth);
+    tilesX = (width + TileSize - 1) / TileSize;
+    tilesY = (height + TileSize - 1) / TileSize;
+    for (Worker &worker : workers)
+        worker.bins.resize(size_t(tilesX) * size_t(tilesY));
+}
+
+void Rasterizer::beginFrame(const Mat4 &viewProjectionMatrix, uint32_t background) {
+    viewProjection = viewProjectionMatrix;
+    clearColor = 0xFF000000u | background;
+    draws.clear();
+    totalTriangles = 0;
+}
+
+void Rasterizer::draw(const Mesh &mesh, const Mat4 &model, uint32_t meshColor) {
+    if (mesh.triangleCount() == 0)
+        return;
+    draws.push_back({&mesh, model, meshColor, totalTriangles});
+    totalTriangles += mesh.triangleCount();
+}
+
+void Rasterizer::render() {
+    SPECTER_PROFILE_SCOPE("Rasterizer::render");
+    if (frameWidth == 0 || frameHeight == 0)
+        return;
+    runParallel(GeometryPhase);
+    nextTile.store(0, std::memory_order_relaxed);
+    runParallel(RasterPhase);
+}
+
+QImage Rasterizer::image() const {
+    if (color.empty())
+        return QImage();
+    return QImage(reinterpret_cast<const uchar *>(color.data()), frameWidth, frameHeight, frameStride * 4,
+                  QImage::Format_RGB32);
+}
+
+size_t Rasterizer::visibleTriangles() const {
+    size_t count = 0;
+    for (const Worker &worker : workers)
+        count += worker.triangles.size();
+    return count;
+}
+
+void Rasterizer::runParallel(Phase phase) {
+    // По задаче на часть; вызывающий поток выполняет задачи вместе с рабочими
+    core::JobSystem::instance().parallelFor(0, workers.size(), 1, [this, phase](size_t first, size_t last) {
+        for (size_t part = first; part < last; ++part) {
+            if (phase == GeometryPhase)
+                processGeometry(int(part));
+            else
+                rasterizeTiles();
+        }
+    });
+}
+
+void Rasterizer::processGeometry(int workerIndex) {
+    SPECTER_PROFILE_SCOPE("Rasterizer::geometry");
+    Worker &worker = workers[size_t(workerIndex)];
+    worker.triangles.clear();
+    for (Array<uint32_t> &bin : worker.bins)
+        bin.clear();
+
+    // Очистка своей полосы строк: сплошное заполнение заметно быстрее построчного по тайлам
+    const size_t count = workers.size();
+    const size_t firstPixel = size_t(frameHeight) * size_t(workerIndex) / count * size_t(frameStride);
+    const size_t lastPixel = size_t(frameHeight) * size_t(workerIndex + 1) / count * size_t(frameStride);
+    std::fill(color.begin() + firstPixel, color.begin() + lastPixel, clearColor);
+    std::fill(depth.begin() + firstPixel, depth.begin() + lastPixel, FarDepth);
+
+    const size_t begin = totalTriangles * size_t(workerIndex) / count;
+    const size_t end = totalTriangles * size_t(workerIndex + 1) / count;
+    if (begin >= end)
+        return;
+
+    // Вызов, которому принадлежит первый треугольник диапазона
+    size_t drawIndex = size_t(std::upper_bound(draws.begin(), draws.end(), begin,
+                                               [](size_t triangle, const DrawCall &call) {
+                                                   return triangle < call.firstTriangle;
+                                               }) - draws.begin()) - 1;
+    size_t mvpIndex = draws.size();
+    Mat4 modelViewProjection;
+    for (size_t triangle = begin; triangle < end; ++triangle) {
+        while (triangle >= draws[drawIndex].firstTriangle + draws[drawIndex].mesh->triangleCount())
+            ++drawIndex;
+        const DrawCall &call = draws[drawIndex];
+        if (mvpIndex != drawIndex) {
+            modelViewProjection = viewProjection * call.model;
+            mvpIndex = drawIndex;
+        }
+        const uint32_t *index = call.mesh->indices.data() + (triangle - call.firstTriangle) * 3;
+        const Vec3 &p0 = call.mesh->positions[index[0]];
+        const Vec3 &p1 = call.mesh->positions[index[1]];
+        const Vec3 &p2 = call.mesh->positions[index[2]];
+        Vec4 clip[3] = {modelViewProjection.transform(p0), modelViewProjection.transform(p1),
+                        modelViewProjection.transform(p2)};
+
+        // Целиком за одной из плоскостей пирамиды видимости
+        if ((clip[0].x > clip[0].w && clip[1].x > clip[1].w && clip[2].x > clip[2].w)
+            || (clip[0].x < -clip[0].w && clip[1].x < -clip[1].w && clip[2].x < -clip[2].w)
+            || (clip[0].y > clip[0].w && clip[1].y > clip[1].w && clip[2].y > clip[2].w)
+            || (clip[0].y < -clip[0].w && clip[1].y < -clip[1].w && clip[2].y < -clip[2].w)
+            || (clip[0].z > clip[0].w && clip[1].z > clip[1].w && clip[2].z > clip[2].w))
+            continue;
+
+        // Нормаль в мировых координатах (точна при равномерном масштабе)
+        const uint32_t shaded = shade(call.color, call.model.transformVector(cross(p1 - p0, p2 - p0)));
+        const float distance[3] = {clip[0].z + clip[0].w, clip[1].z + clip[1].w, clip[2].z + clip[2].w};
+        if (distance[0] >= 0.0f && distance[1] >= 0.0f && distance[2] >= 0.0f) {
+            setupTriangle(worker, clip, shaded);
+            continue;
+        }
+        if (distance[0] < 0.0f && distance[1] < 0.0f && distance[2] < 0.0f)
+            continue;
+
+        // Отсечение ближней плоскостью: остаётся многоугольник из 3-4 вершин, режем его веером
+        Vec4 polygon[4];
+        int vertexCount = 0;
+        for (int i = 0; i < 3; ++i) {
+            const int next = (i + 1) % 3;
+            if (distance[i] >= 0.0f)
+                polygon[vertexCount++] = clip[i];
+            if ((distance[i] >= 0.0f) != (distance[next] >= 0.0f))
+                polygon[vertexCount++] = lerp(clip[i], clip[next], distance[i] / (distance[i] - distance[next]));
+        }
+        for (int i = 1; i + 1 < vertexCount; ++i) {
+            const Vec4 fan[3] = {polygon[0], polygon[i], polygon[i + 1]};
+            setupTriangle(worker, fan, shaded);
+        }
+    }
+}
+
+void Rasterizer::setupTriangle(Worker &worker, const Vec4 clip[3], uint32_t triangleColor) {
+    float x[3], y[3], z[3];
+    for (int i = 0; i < 3; ++i) {
+        if (clip[i].w <= 1e-6f)
+            return;
+        const float invW = 1.0f / clip[i].w;
+        x[i] = (clip[i].x * invW * 0.5f + 0.5f) * frameWidth;
+        y[i] = (0.5f - clip[i].y * invW * 0.5f) * frameHeight;
+        z[i] = clip[i].z * invW * 0.5f + 0.5f;
+    }
+
+    // Лицевые грани (против часовой в NDC) на экране с осью Y вниз дают отрицательную площадь
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area >= 0.0f)
+        return;
+    std::swap(x[1], x[2]);
+    std::swap(y[1], y[2]);
+    std::swap(z[1], z[2]);
+    area = -area;
+
+    Triangle triangle;
+    triangle.minX = std::max(0, int(std::floor(std::min({x[0], x[1], x[2]}))));
+    triangle.minY = std::max(0, int(std::floor(std::min({y[0], y[1], y[2]}))));
+    triangle.maxX = std::min(frameWidth - 1, int(std::ceil(std::max({x[0], x[1], x[2]}))));
+    triangle.maxY = std::min(frameHeight - 1, int(std::ceil(std::max({y[0], y[1], y[2]}))));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+        return;
+
+    // Ребро i лежит напротив вершины i. Сдвиг на 0.5 переносит выборку в центр пикселя
+    triangle.topLeft = 0;
+    const float invArea = 1.0f / area;
+    triangle.za = triangle.zb = triangle.zc = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        const int from = (i + 1) % 3;
+        const int to = (i + 2) % 3;
+        const float a = y[from] - y[to];
+        const float b = x[to] - x[from];
+        triangle.a[i] = a;
+        triangle.b[i] = b;
+        triangle.c[i] = -(a * x[from] + b * y[from]) + 0.5f * (a + b);
+        if (a > 0.0f || (a == 0.0f && b > 0.0f))
+            triangle.topLeft |= uint8_t(1u << i);
+        triangle.za += a * z[i] * invArea;
+        triangle.zb += b * z[i] * invArea;
+        triangle.zc += triangle.c[i] * z[i] * invArea;
+    }
+    triangle.color = triangleColor;
+
+    const uint32_t index = uint32_t(worker.triangles.size());
+    worker.triangles.push_back(triangle);
+    for (int tileY = triangle.minY / TileSize; tileY <= triangle.maxY / TileSize; ++tileY) {
+        for (int tileX = triangle.minX / TileSize; tileX <= triangle.maxX / TileSize; ++tileX)
+            worker.bins[size_t(tileY) * size_t(tilesX) + size_t(tileX)].push_back(index);
+    }
+}
+
+void Rasterizer::rasterizeTiles() {
+    SPECTER_PROFILE_SCOPE("Rasterizer::tiles");
+    const int tileCount = tilesX * tilesY;
+    int tile;
+    while ((tile = nextTile.fetch_add(1, std::memory_order_relaxed)) < tileCount)
+        rasterizeTile(tile % tilesX, tile / tilesX);
+}
+
+void Rasterizer::rasterizeTile(int tileX, int tileY) {
+    const int x0 = tileX * TileSize;
+    const int y0 = tileY * TileSize;
+    const int x1 = std::min(x0 + TileSize, frameStride);
+    const int y1 = std::min(y0 + TileSize, frameHeight);
+
+    const size_t tile = size_t(tileY) * size_t(tilesX) + size_t(tileX);
+    for (const Worker &worker : workers) {
+        for (uint32_t index : worker.bins[tile])
+            rasterizeTriangle(worker.triangles[index], x0, y0, x1, y1);
+    }
+}
+
+void Rasterizer::rasterizeTriangle(const Triangle &triangle, int tileX0, int tileY0, int tileX1, int tileY1) {
+    const int startX = std::max(tileX0, triangle.minX) & ~3;
+    const int endX = std::min(tileX1 - 1, triangle.maxX);
+    const int startY = std::max(tileY0, triangle.minY);
+    const int endY = std::min(tileY1 - 1, triangle.maxY);
+
+    // Углы обрабатываемого прямоугольника: целиком вне одного из рёбер — треугольник пропускается,
+    // целиком внутри всех рёбер — пиксели проверяются только по глубине (большие треугольники)
+    const int lastX = endX | 3;
+    bool covered = true;
+    for (int i = 0; i < 3; ++i) {
+        const float a = triangle.a[i];
+        const float b = triangle.b[i];
+        const float maxEdge = a * (a > 0.0f ? lastX : startX) + b * (b > 0.0f ? endY : startY) + triangle.c[i];
+        const float minEdge = a * (a > 0.0f ? startX : lastX) + b * (b > 0.0f ? startY : endY) + triangle.c[i];
+        if (maxEdge < 0.0f)
+            return;
+        if (minEdge <= 0.0f)
+            covered = false;
+    }
+
+#ifdef SPECTER_RASTER_SSE2
+    const __m128 offsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 a[3], step[3], topLeft[3];
+    for (int i = 0; i < 3; ++i) {
+        a[i] = _mm_mul_ps(_mm_set1_ps(triangle.a[i]), offsets);
+        step[i] = _mm_set1_ps(triangle.a[i] * 4.0f);
+        topLeft[i] = _mm_castsi128_ps(_mm_set1_epi32((triangle.topLeft >> i) & 1 ? -1 : 0));
+    }
+    const __m128 zOffsets = _mm_mul_ps(_mm_set1_ps(triangle.za), offsets);
+    const __m128 zStep = _mm_set1_ps(triangle.za * 4.0f);
+    const __m128i colorValue = _mm_set1_epi32(int(triangle.color));
+
+    if (covered) {
+        for (int y = startY; y <= endY; ++y) {
+            __m128 z = _mm_add_ps(_mm_set1_ps(triangle.za * startX + triangle.zb * y + triangle.zc), zOffsets);
+            float *depthRow = depth.data() + size_t(y) * size_t(frameStride);
+            uint32_t *colorRow = color.data() + size_t(y) * size_t(frameStride);
+            for (int x = startX; x <= endX; x += 4) {
+                const __m128 stored = _mm_loadu_ps(depthRow + x);
+                const __m128 pass = _mm_cmplt_ps(z, stored);
+                if (_mm_movemask_ps(pass)) {
+                    _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, stored)));
+                    const __m128i mask = _mm_castps_si128(pass);
+                    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(colorRow + x));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(colorRow + x),
+                                     _mm_or_si128(_mm_and_si128(mask, colorValue), _mm_andnot_si128(mask, pixels)));
+                }
+                z = _mm_add_ps(z, zStep);
+            }
+        }
+        return;
+    }
+
+    for (int y = startY; y <= endY; ++y) {
+        __m128 edge[3];
+        for (int i = 0; i < 3; ++i) {
+            const float row = triangle.a[i] * startX + triangle.b[i] * y + triangle.c[i];
+            edge[i] = _mm_add_ps(_mm_set1_ps(row), a[i]);
+        }
+        __m128 z = _mm_add_ps(_mm_set1_ps(triangle.za * startX + triangle.zb * y + triangle.zc), zOffsets);
+        float *depthRow = depth.data() + size_t(y) * size_t(frameStride);
+        uint32_t *colorRow = color.data() + size_t(y) * size_t(frameStride);
+
+        for (int x = startX; x <= endX; x += 4) {
+            // Внутри: E > 0, либо E == 0 на верхнем/левом ребре
+            __m128 inside = _mm_or_ps(_mm_cmpgt_ps(edge[0], zero), _mm_and_ps(_mm_cmpeq_ps(edge[0], zero), topLeft[0]));
+            inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(edge[1], zero),
+                                                  _mm_and_ps(_mm_cmpeq_ps(edge[1], zero), topLeft[1])));
+            inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(edge[2], zero),
+                                                  _mm_and_ps(_mm_cmpeq_ps(edge[2], zero), topLeft[2])));
+            if (_mm_movemask_ps(inside)) {
+                const __m128 stored = _mm_loadu_ps(depthRow + x);
+                const __m128 pass = _mm_and_ps(inside, _mm_cmplt_ps(z, stored));
+                if (_mm_movemask_ps(pass)) {
+                    _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, stored)));
+                    const __m128i mask = _mm_castps_si128(pass);
+                    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(colorRow + x));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(colorRow + x),
+                                     _mm_or_si128(_mm_and_si128(mask, colorValue), _mm_andnot_si128(mask, pixels)));
+                }
+            }
+            for (int i = 0; i < 3; ++i)
+                edge[i] = _mm_add_ps(edge[i], step[i]);
+            z = _mm_add_ps(z, zStep);
+        }
+    }
+#else
+    for (int y = startY; y <= endY; ++y) {
+        float *depthRow = depth.data() + size_t(y) * size_t(frameStride);
+        uint32_t *colorRow = color.data() + size_t(y) * size_t(frameStride);
+        for (int x = startX; x <= endX; ++x) {
+            bool inside = true;
+            for (int i = 0; i < 3 && inside && !covered; ++i) {
+                const float edge = triangle.a[i] * x + triangle.b[i] * y + triangle.c[i];
+                inside = edge > 0.0f || (edge == 0.0f && ((triangle.topLeft >> i) & 1));
+            }
+            if (!inside)
+                continue;
+            const float z = triangle.za * x + triangle.zb * y + triangle.zc;
+            if (z < depthRow[x]) {
+                depthRow[x] = z;
+                colorRow[x] = triangle.color;
+            }
+        }
+    }
+#endif
+}
+
+} // namespace render
@@ -0,0 +1,105 @@
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+#include "mesh.h"
+#include "rendermath.h"
+#include "Core/memorytracker.h"
+#include <QImage>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+// Программный растеризатор для машин без GPU.
+// Кадр проходит две параллельные фазы в общем планировщике core::JobSystem:
+//  1. Геометрия: треугольники всех вызовов draw() делятся поровну между потоками; каждый поток
+//     трансформирует их, отсекает по ближней плоскости и задним граням, готовит функции рёбер
+//     и раскладывает треугольники по своим корзинам тайлов TileSize x TileSize.
+//  2. Растеризация: потоки разбирают тайлы по атомарному счётчику; в тайле треугольники всех
+//     потоков обходятся в порядке отправки. Функции рёбер и глубина считаются по 4 пикселя (SSE2).
+// Буферы цвета, глубины и корзины переиспользуются: после первого кадра того же размера
+// и сложности рендер не выделяет память.
+class Rasterizer {
+public:
+    static constexpr int TileSize = 64;
+
+    // threadCount — на сколько частей делится работа фазы; 0 — по числу потоков планировщика
+    explicit Rasterizer(int threadCount = 0);
+
+    void setThreadCount(int threadCount);
+    int threadCount() const { return int(workers.size()); }
+
+    void resize(int width, int height);
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+
+    void beginFrame(const Mat4 &viewProjection, uint32_t clearColor);
+    // mesh должен жить до конца render()
+    void draw(const Mesh &mesh, const Mat4 &model, uint32_t color);
+    void render();
+
+    // Кадр без копирования; действителен до следующего resize()/render()
+    QImage image() const;
+    const uint32_t *colorBuffer() const { return color.data(); }
+    const float *depthBuffer() const { return depth.data(); }
+    int stride() const { return frameStride; } // В пикселях
+
+    size_t submittedTriangles() const { return totalTriangles; }
+    size_t visibleTriangles() const; // Прошедшие отсечение в последнем кадре
+
+private:
+    struct DrawCall {
+        const Mesh *mesh;
+        Mat4 model;
+        uint32_t color;
+        size_t firstTriangle; // Номер первого треугольника среди всех вызовов кадра
+    };
+
+    // Подготовленный треугольник: E_i(x, y) = a[i] * x + b[i] * y + c[i] > 0 внутри,
+    // глубина z(x, y) = za * x + zb * y + zc
+    struct Triangle {
+        float a[3], b[3], c[3];
+        float za, zb, zc;
+        int minX, minY, maxX, maxY;
+        uint32_t color;
+        uint8_t topLeft; // Бит i — ребро i верхнее или левое (точки на нём принадлежат треугольнику)
+    };
+
+    template<typename T>
+    using Array = core::TaggedVector<T, core::MemoryTag::Render>;
+
+    struct Worker {
+        Array<Triangle> triangles;
+        std::vector<Array<uint32_t>> bins; // Индексы в triangles по тайлам
+    };
+
+    enum Phase { GeometryPhase, RasterPhase };
+
+    void runParallel(Phase phase);
+    void processGeometry(int workerIndex);
+    void setupTriangle(Worker &worker, const Vec4 clip[3], uint32_t color);
+    void rasterizeTiles();
+    void rasterizeTile(int tileX, int tileY);
+    void rasterizeTriangle(const Triangle &triangle, int x0, int y0, int x1, int y1);
+
+    int frameWidth;
+    int frameHeight;
+    int frameStride;
+    int tilesX;
+    int tilesY;
+    Array<uint32_t> color;
+    Array<float> depth;
+    uint32_t clearColor;
+
+    Mat4 viewProjection;
+    Array<DrawCall> draws;
+    size_t totalTriangles;
+
+    std::vector<Worker> workers;
+    std::atomic<int> nextTile;
+};
+
+} // namespace render
+
+#endif // RASTERIZER_H
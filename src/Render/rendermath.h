@@ -0,0 +1,117 @@
+#ifndef RENDERMATH_H
+#define RENDERMATH_H
+
+#include <cmath>
+
+// Минимальная математика для растеризатора. Матрицы хранятся по столбцам (как в OpenGL),
+// клип-пространство: -w <= x, y, z <= w
+namespace render {
+
+struct Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+
+    Vec3() = default;
+    Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+    Vec3 operator+(const Vec3 &o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator-(const Vec3 &o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator*(float s) const { return {x * s, y * s, z * s}; }
+};
+
+inline float dot(const Vec3 &a, const Vec3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3 cross(const Vec3 &a, const Vec3 &b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+inline Vec3 normalize(const Vec3 &v) {
+    const float length = std::sqrt(dot(v, v));
+    return length > 0.0f ? v * (1.0f / length) : v;
+}
+
+struct Vec4 {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+};
+
+struct Mat4 {
+    float m[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}; // m[column * 4 + row]
+
+    Mat4 operator*(const Mat4 &o) const {
+        Mat4 r;
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                r.m[column * 4 + row] = m[row] * o.m[column * 4] + m[4 + row] * o.m[column * 4 + 1]
+                                      + m[8 + row] * o.m[column * 4 + 2] + m[12 + row] * o.m[column * 4 + 3];
+            }
+        }
+        return r;
+    }
+
+    Vec4 transform(const Vec3 &p) const {
+        return {m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+                m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+                m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14],
+                m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15]};
+    }
+    Vec3 transformPoint(const Vec3 &p) const {
+        return {m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+                m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+                m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]};
+    }
+    // Без переноса — для направлений
+    Vec3 transformVector(const Vec3 &v) const {
+        return {m[0] * v.x + m[4] * v.y + m[8] * v.z,
+                m[1] * v.x + m[5] * v.y + m[9] * v.z,
+                m[2] * v.x + m[6] * v.y + m[10] * v.z};
+    }
+
+    static Mat4 perspective(float fovYDegrees, float aspect, float nearPlane, float farPlane) {
+        const float f = 1.0f / std::tan(fovYDegrees * 3.14159265f / 360.0f);
+        Mat4 r;
+        r.m[0] = f / aspect;
+        r.m[5] = f;
+        r.m[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+        r.m[11] = -1.0f;
+        r.m[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+        r.m[15] = 0.0f;
+        return r;
+    }
+
+    static Mat4 lookAt(const Vec3 &eye, const Vec3 &target, const Vec3 &up) {
+        const Vec3 f = normalize(target - eye);
+        const Vec3 s = normalize(cross(f, up));
+        const Vec3 u = cross(s, f);
+        Mat4 r;
+        r.m[0] = s.x; r.m[4] = s.y; r.m[8] = s.z;
+        r.m[1] = u.x; r.m[5] = u.y; r.m[9] = u.z;
+        r.m[2] = -f.x; r.m[6] = -f.y; r.m[10] = -f.z;
+        r.m[12] = -dot(s, eye);
+        r.m[13] = -dot(u, eye);
+        r.m[14] = dot(f, eye);
+        return r;
+    }
+
+    // Перенос * поворот (Эйлер в градусах, порядок Z * Y * X) * масштаб — как у компонента Transform
+    static Mat4 fromTransform(const float position[3], const float rotation[3], const float scale[3]) {
+        const float toRadians = 3.14159265f / 180.0f;
+        const float cx = std::cos(rotation[0] * toRadians), sx = std::sin(rotation[0] * toRadians);
+        const float cy = std::cos(rotation[1] * toRadians), sy = std::sin(rotation[1] * toRadians);
+        const float cz = std::cos(rotation[2] * toRadians), sz = std::sin(rotation[2] * toRadians);
+        Mat4 r;
+        r.m[0] = (cz * cy) * scale[0];
+        r.m[1] = (sz * cy) * scale[0];
+        r.m[2] = (-sy) * scale[0];
+        r.m[4] = (cz * sy * sx - sz * cx) * scale[1];
+        r.m[5] = (sz * sy * sx + cz * cx) * scale[1];
+        r.m[6] = (cy * sx) * scale[1];
+        r.m[8] = (cz * sy * cx + sz * sx) * scale[2];
+        r.m[9] = (sz * sy * cx - cz * sx) * scale[2];
+        r.m[10] = (cy * cx) * scale[2];
+        r.m[12] = position[0];
+        r.m[13] = position[1];
+        r.m[14] = position[2];
+        return r;
+    }
+};
+
+} // namespace render
+
+#endif // RENDERMATH_H
@@ -0,0 +1,201 @@
+#include "commandhistory.h"
+#include "Core/profiler.h"
+#include <QDir>
+#include <algorithm>
+
+CommandHistory::CommandHistory(QObject *parent)
+    : QObject(parent), cursor(0), budget(DefaultMemoryBudget), residentBytes(0),
+      spill(QDir::tempPath() + "/specter-undo-XXXXXX"), spillGarbage(0), replaying(false), tracked(core::MemoryTag::Scene) {
+}
+
+void CommandHistory::setMemoryBudget(qint64 bytes) {
+    budget = std::max<qint64>(bytes, 0);
+    enforceBudget();
+}
+
+qint64 CommandHistory::spilledBytes() const {
+    return spill.isOpen() ? spill.size() : 0;
+}
+
+void CommandHistory::setResident(qint64 bytes) {
+    residentBytes = bytes;
+    tracked.set(size_t(bytes));
+}
+
+void CommandHistory::push(const SceneCommand &command) {
+    if (replaying)
+        return;
+    truncate(cursor);
+    // Слияние только с последней правкой, пока она в памяти и не отменялась
+    if (!entries.empty() && !entries.back().data.isEmpty() && lastPush.isValid() && lastPush.elapsed() < MergeWindowMs) {
+        SceneCommand last;
+        if (load(entries.back(), &last) && last.merge(command)) {
+            store(entries.back(), last);
+            lastPush.start();
+            emit changed();
+            return;
+        }
+    }
+    entries.emplace_back();
+    store(entries.back(), command);
+    cursor = entries.size();
+    lastPush.start();
+    enforceBudget();
+    emit changed();
+}
+
+bool CommandHistory::undo(const std::function<bool(SceneCommand &)> &revert) {
+    if (!canUndo() || !step(cursor - 1, revert))
+        return false;
+    --cursor;
+    emit changed();
+    return true;
+}
+
+bool CommandHistory::redo(const std::function<bool(SceneCommand &)> &apply) {
+    if (!canRedo() || !step(cursor, apply))
+        return false;
+    ++cursor;
+    emit changed();
+    return true;
+}
+
+bool CommandHistory::step(size_t index, const std::function<bool(SceneCommand &)> &run) {
+    SPECTER_PROFILE_SCOPE("CommandHistory::step");
+    SceneCommand command;
+    if (!load(entries[index], &command))
+        return false;
+    lastPush.invalidate();
+    replaying = true;
+    const bool ok = run(command);
+    replaying = false;
+    if (ok) {
+        store(entries[index], command);
+        enforceBudget();
+    }
+    return ok;
+}
+
+void CommandHistory::clear() {
+    entries.clear();
+    cursor = 0;
+    setResident(0);
+    lastPush.invalidate();
+    if (spill.isOpen())
+        spill.resize(0);
+    spillGarbage = 0;
+    emit changed();
+}
+
+bool CommandHistory::load(const Entry &entry, SceneCommand *command) {
+    if (!entry.data.isEmpty())
+        return SceneCommand::decode(entry.data, command);
+    if (!spill.seek(entry.spillOffset))
+        return false;
+    const QByteArray data = spill.read(entry.spillSize);
+    return data.size() == entry.spillSize && SceneCommand::decode(data, command);
+}
+
+void CommandHistory::store(Entry &entry, const SceneCommand &command) {
+    const QByteArray data = command.encode();
+    entry.text = command.text();
+    if (entry.data.isEmpty() && entry.spillOffset >= 0) {
+        // Запись уже во временном файле. Того же размера — переписываем на месте (undo/redo
+        // обычно не меняют команду), иначе дописываем в конец, а старое место становится мусором
+        if (data.size() == entry.spillSize) {
+            if (spill.seek(entry.spillOffset) && spill.write(data) == data.size())
+                return;
+        } else if (spill.seek(spill.size()) && spill.write(data) == data.size()) {
+            spillGarbage += entry.spillSize;
+            entry.spillOffset = spill.size() - data.size();
+            entry.spillSize = data.size();
+            if (spillGarbage > spill.size() / 2)
+                compactSpill();
+            return;
+        }
+    }
+    setResident(residentBytes - entry.data.size() + data.size());
+    entry.data = data;
+    entry.spillOffset = -1;
+}
+
+void CommandHistory::truncate(size_t count) {
+    if (count >= entries.size())
+        return;
+    qint64 resident = residentBytes;
+    for (size_t i = count; i < entries.size(); ++i)
+        resident -= entries[i].data.size();
+    entries.resize(count);
+    setResident(resident);
+    // Обрезаем временный файл по концу последней оставшейся в нём записи
+    if (spill.isOpen()) {
+        qint64 end = 0;
+        qint64 live = 0;
+        for (const Entry &entry : entries) {
+            if (entry.data.isEmpty() && entry.spillOffset >= 0) {
+                end = std::max(end, entry.spillOffset + entry.spillSize);
+                live += entry.spillSize;
+            }
+        }
+        spill.resize(end);
+        spillGarbage = end - live;
+    }
+}
+
+void CommandHistory::compactSpill() {
+    SPECTER_PROFILE_SCOPE("CommandHistory::compactSpill");
+    std::vector<Entry *> spilled;
+    for (Entry &entry : entries) {
+        if (entry.data.isEmpty() && entry.spillOffset >= 0)
+            spilled.push_back(&entry);
+    }
+    std::sort(spilled.begin(), spilled.end(), [](const Entry *a, const Entry *b) {
+        return a->spillOffset < b->spillOffset;
+    });
+    // Записи идут по возрастанию смещения, поэтому новое место никогда не правее старого
+    qint64 end = 0;
+    for (Entry *entry : spilled) {
+        if (entry->spillOffset != end) {
+            if (!spill.seek(entry->spillOffset))
+                return;
+            const QByteArray data = spill.read(entry->spillSize);
+            if (data.size() != entry->spillSize || !spill.seek(end) || spill.write(data) != data.size()) {
+                qWarning("Undo history: spill file compaction failed: %s", qPrintable(spill.errorString()));
+                return;
+            }
+            entry->spillOffset = end;
+        }
+        end += entry->spillSize;
+    }
+    spill.resize(end);
+    spill.flush();
+    spillGarbage = 0;
+}
+
+void CommandHistory::enforceBudget() {
+    if (residentBytes <= budget)
+        return;
+    if (!spill.isOpen() && !spill.open()) {
+        qWarning("Undo history: cannot open a spill file, keeping %lld bytes in memory",
+                 static_cast<long long>(residentBytes));
+        return;
+    }
+    // Старые записи уходят первыми; последняя остаётся в памяти для слияния и быстрой отмены
+    qint64 resident = residentBytes;
+    for (size_t i = 0; i + 1 < entries.size() && resident > budget; ++i) {
+        Entry &entry = entries[i];
+        if (entry.data.isEmpty())
+            continue;
+        const qint64 offset = spill.size();
+        if (!spill.seek(offset) || spill.write(entry.data) != entry.data.size()) {
+            qWarning("Undo history: spill file write failed: %s", qPrintable(spill.errorString()));
+            break;
+        }
+        entry.spillOffset = offset;
+        entry.spillSize = entry.data.size();
+        resident -= entry.data.size();
+        entry.data = QByteArray();
+    }
+    spill.flush();
+    setResident(resident);
+}
@@ -0,0 +1,78 @@
+#ifndef COMMANDHISTORY_H
+#define COMMANDHISTORY_H
+
+#include "scenecommand.h"
+#include "Core/memorytracker.h"
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTemporaryFile>
+#include <functional>
+#include <vector>
+
+// История правок сцены. Команды хранятся закодированными (SceneCommand::encode); если история
+// занимает больше бюджета памяти, самые старые записи уходят во временный файл и читаются
+// оттуда при отмене. Правки одного поля, пришедшие подряд быстрее MergeWindowMs, сливаются
+// в одну команду. Память истории учитывается под тегом Scene
+class CommandHistory : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 DefaultMemoryBudget = 64 * 1024 * 1024;
+    static constexpr qint64 MergeWindowMs = 1000;
+
+    explicit CommandHistory(QObject *parent = nullptr);
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return budget; }
+    qint64 memoryUsage() const { return residentBytes; }
+    qint64 spilledBytes() const;
+
+    // Запоминает уже выполненное изменение; отменённые правки после курсора пропадают.
+    // Во время undo/redo не записывает ничего: сцена меняется самой историей
+    void push(const SceneCommand &command);
+
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor < entries.size(); }
+    QString undoText() const { return canUndo() ? entries[cursor - 1].text : QString(); }
+    QString redoText() const { return canRedo() ? entries[cursor].text : QString(); }
+
+    // revert/apply выполняют команду в обратную или прямую сторону и могут дописать в неё снятое
+    // по ходу (поддеревья при отмене создания). false — команду выполнить нельзя, курсор не двигается
+    bool undo(const std::function<bool(SceneCommand &)> &revert);
+    bool redo(const std::function<bool(SceneCommand &)> &apply);
+    bool isReplaying() const { return replaying; }
+
+    void clear();
+
+signals:
+    void changed();
+
+private:
+    struct Entry {
+        QByteArray data;         // Пусто, если запись во временном файле
+        qint64 spillOffset = -1;
+        qint64 spillSize = 0;
+        QString text;
+    };
+
+    bool load(const Entry &entry, SceneCommand *command);
+    void store(Entry &entry, const SceneCommand &command);
+    bool step(size_t index, const std::function<bool(SceneCommand &)> &run);
+    void truncate(size_t count);
+    void enforceBudget();
+    // Сдвигает живые записи временного файла к началу, убирая устаревшие версии
+    void compactSpill();
+    void setResident(qint64 bytes);
+
+    std::vector<Entry> entries;
+    size_t cursor; // Записи до курсора выполнены, после — отменены
+    qint64 budget;
+    qint64 residentBytes;
+    QTemporaryFile spill;
+    qint64 spillGarbage; // Байты временного файла, не принадлежащие ни одной записи
+    QElapsedTimer lastPush; // Для слияния; сбрасывается undo/redo
+    bool replaying;
+    core::TrackedBytes tracked;
+};
+
+#endif // COMMANDHISTORY_H
@@ -0,0 +1,28 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "reflection.h"
+#include <cstdint>
+
+// Базовые компоненты сцены. Все компоненты — POD: ECS копирует их побайтно
+
+struct Transform {
+    float position[3] = {0.0f, 0.0f, 0.0f};
+    float rotation[3] = {0.0f, 0.0f, 0.0f}; // Градусы
+    float scale[3] = {1.0f, 1.0f, 1.0f};
+};
+
+SPECTER_REFLECT(Transform,
+                SPECTER_FIELD(Transform, position, "Position"),
+                SPECTER_FIELD(Transform, rotation, "Rotation", -360.0f, 360.0f, 1.0f),
+                SPECTER_FIELD(Transform, scale, "Scale", -1000.0f, 1000.0f, 0.01f))
+
+// Обратная ссылка с сущности на узел иерархии
+struct SceneNodeRef {
+    uint32_t node = 0;
+};
+
+// Компоненты, которые показывает инспектор, в порядке показа. SceneNodeRef — служебный и не отражается
+using InspectableComponents = reflect::TypeList<Transform>;
+
+#endif // COMPONENTS_H
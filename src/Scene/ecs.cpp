@@ -0,0 +1,471 @@
+#include "ecs.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+namespace ecs {
+
+namespace {
+
+std::mutex &registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Память резервируется сразу под все типы: info() читает без блокировки,
+// и регистрация нового типа не должна переносить уже выданные записи
+std::vector<ComponentInfo> &registryInfos() {
+    static std::vector<ComponentInfo> infos = [] {
+        std::vector<ComponentInfo> reserved;
+        reserved.reserve(MaxComponents);
+        return reserved;
+    }();
+    return infos;
+}
+
+uint32_t alignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Сущности пакета одного архетипа и сквозные позиции их строк
+struct BatchGroup {
+    std::unordered_map<const Chunk *, size_t> chunkIndex;
+    std::vector<Entity> entities;
+    std::vector<size_t> positions;
+};
+
+BatchGroup &batchGroup(std::unordered_map<Archetype *, BatchGroup> &groups, Archetype *archetype) {
+    auto it = groups.find(archetype);
+    if (it != groups.end())
+        return it->second;
+    BatchGroup &group = groups[archetype];
+    const std::vector<Chunk *> &chunks = archetype->chunks();
+    group.chunkIndex.reserve(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+        group.chunkIndex.emplace(chunks[i], i);
+    return group;
+}
+
+} // namespace
+
+ComponentId ComponentRegistry::registerType(uint32_t size, uint32_t alignment) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<ComponentInfo> &infos = registryInfos();
+    // Маска архетипа — 64 бита, лишний тип молча испортил бы все маски
+    if (infos.size() >= static_cast<size_t>(MaxComponents)) {
+        std::fprintf(stderr, "ecs: more than %d component types registered\n", MaxComponents);
+        std::abort();
+    }
+    infos.push_back({size, alignment});
+    return static_cast<ComponentId>(infos.size() - 1);
+}
+
+const ComponentInfo &ComponentRegistry::info(ComponentId id) {
+    return registryInfos()[id];
+}
+
+int ComponentRegistry::count() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    return static_cast<int>(registryInfos().size());
+}
+
+// Archetype
+
+Archetype::Archetype(ComponentMask mask)
+    : componentMask(mask), chunkCapacity(0), entities(0) {
+    std::fill(std::begin(columnOffsets), std::end(columnOffsets), 0u);
+    uint32_t rowBytes = sizeof(Entity);
+    for (ComponentId id = 0; id < MaxComponents; ++id) {
+        if ((mask >> id) & 1) {
+            components.push_back(id);
+            rowBytes += ComponentRegistry::info(id).size;
+        }
+    }
+
+    // Подбираем вместимость так, чтобы все выровненные столбцы поместились в чанк
+    uint32_t capacity = static_cast<uint32_t>(Chunk::DataSize / rowBytes);
+    for (; capacity > 0; --capacity) {
+        uint32_t offset = alignUp(sizeof(Entity) * capacity, 64);
+        bool fits = true;
+        for (ComponentId id : components) {
+            const ComponentInfo &info = ComponentRegistry::info(id);
+            offset = alignUp(offset, std::max<uint32_t>(info.alignment, 16));
+            columnOffsets[id] = offset;
+            offset += info.size * capacity;
+            if (offset > Chunk::DataSize) {
+                fits = false;
+                break;
+            }
+        }
+        if (fits)
+            break;
+    }
+    assert(capacity > 0 && "Набор компонентов не помещается в чанк");
+    chunkCapacity = capacity;
+}
+
+// World
+
+World::World() : chunkPool(sizeof(Chunk), alignof(Chunk), ChunksPerPage, core::MemoryTag::Scene), aliveCount(0) {
+    archetypeFor(0);
+}
+
+World::~World() = default; // Страницы с чанками освобождает пул
+
+void World::clear() {
+    for (auto &archetype : archetypes) {
+        for (Chunk *chunk : archetype->chunkList)
+            releaseChunk(chunk);
+        archetype->chunkList.clear();
+        archetype->entities = 0;
+    }
+    // Архетипы и кэши запросов сохраняются: набор типов в сцене обычно тот же.
+    // Записи тоже остаются: поколение живых увеличивается, чтобы старые ссылки не указали на новые сущности
+    freeIndices.clear();
+    for (size_t i = records.size(); i-- > 0;) {
+        EntityRecord &record = records[i];
+        if (record.archetype) {
+            record.archetype = nullptr;
+            record.chunk = nullptr;
+            ++record.generation;
+        }
+        freeIndices.push_back(static_cast<uint32_t>(i)); // С конца: новые сущности снова займут индексы с нуля
+    }
+    aliveCount = 0;
+}
+
+Entity World::allocateEntity() {
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(records.size());
+        records.emplace_back();
+    }
+    ++aliveCount;
+    return Entity{index, records[index].generation};
+}
+
+bool World::isAlive(Entity entity) const {
+    return entity.index < records.size()
+            && records[entity.index].generation == entity.generation
+            && records[entity.index].archetype != nullptr;
+}
+
+Archetype *World::archetypeFor(ComponentMask mask) {
+    auto it = archetypeByMask.find(mask);
+    if (it != archetypeByMask.end())
+        return it->second;
+    archetypes.push_back(std::make_unique<Archetype>(mask));
+    Archetype *archetype = archetypes.back().get();
+    archetypeByMask.emplace(mask, archetype);
+    return archetype;
+}
+
+Archetype *World::archetypeWith(Archetype *source, ComponentId id) {
+    auto it = source->addEdges.find(id);
+    if (it != source->addEdges.end())
+        return it->second;
+    Archetype *target = archetypeFor(source->mask() | (ComponentMask(1) << id));
+    source->addEdges.emplace(id, target);
+    target->removeEdges.emplace(id, source);
+    return target;
+}
+
+Archetype *World::archetypeWithout(Archetype *source, ComponentId id) {
+    auto it = source->removeEdges.find(id);
+    if (it != source->removeEdges.end())
+        return it->second;
+    Archetype *target = archetypeFor(source->mask() & ~(ComponentMask(1) << id));
+    source->removeEdges.emplace(id, target);
+    target->addEdges.emplace(id, source);
+    return target;
+}
+
+Chunk *World::chunkWithSpace(Archetype *archetype) {
+    if (archetype->chunkList.empty() || archetype->chunkList.back()->count == archetype->chunkCapacity) {
+        archetype->chunkList.push_back(allocateChunk(archetype));
+    }
+    return archetype->chunkList.back();
+}
+
+Chunk *World::allocateChunk(Archetype *archetype) {
+    Chunk *chunk = new (chunkPool.allocate()) Chunk;
+    chunk->archetype = archetype;
+    return chunk;
+}
+
+void World::removeRow(Archetype *archetype, Chunk *chunk, uint32_t row) {
+    // Дыру закрываем последней сущностью архетипа, так чанки остаются плотными
+    Chunk *lastChunk = archetype->chunkList.back();
+    uint32_t lastRow = lastChunk->count - 1;
+    if (lastChunk != chunk || lastRow != row) {
+        Entity moved = archetype->entityColumn(lastChunk)[lastRow];
+        archetype->entityColumn(chunk)[row] = moved;
+        for (ComponentId id : archetype->components) {
+            uint32_t size = ComponentRegistry::info(id).size;
+            std::memcpy(archetype->column(chunk, id) + size_t(row) * size,
+                        archetype->column(lastChunk, id) + size_t(lastRow) * size, size);
+        }
+        records[moved.index].chunk = chunk;
+        records[moved.index].row = row;
+    }
+    --lastChunk->count;
+    --archetype->entities;
+    if (lastChunk->count == 0) {
+        archetype->chunkList.pop_back();
+        releaseChunk(lastChunk);
+    }
+}
+
+void World::copyRow(Archetype *archetype, Chunk *from, uint32_t fromRow, Chunk *to, uint32_t toRow) {
+    const Entity moved = archetype->entityColumn(from)[fromRow];
+    archetype->entityColumn(to)[toRow] = moved;
+    for (ComponentId id : archetype->components) {
+        uint32_t size = ComponentRegistry::info(id).size;
+        std::memcpy(archetype->column(to, id) + size_t(toRow) * size,
+                    archetype->column(from, id) + size_t(fromRow) * size, size);
+    }
+    records[moved.index].chunk = to;
+    records[moved.index].row = toRow;
+}
+
+void World::removeRows(Archetype *archetype, std::vector<size_t> &positions) {
+    if (positions.empty())
+        return;
+    std::sort(positions.begin(), positions.end());
+    const size_t capacity = archetype->chunkCapacity;
+    const size_t total = archetype->entities;
+    const size_t remaining = total - positions.size();
+
+    // Дыры до remaining закрываем живыми строками из [remaining, total), пропуская удаляемые
+    size_t tail = size_t(std::lower_bound(positions.begin(), positions.end(), remaining) - positions.begin());
+    size_t source = remaining;
+    for (size_t hole = 0; hole < positions.size() && positions[hole] < remaining; ++hole) {
+        while (tail < positions.size() && positions[tail] == source) {
+            ++tail;
+            ++source;
+        }
+        copyRow(archetype, archetype->chunkList[source / capacity], uint32_t(source % capacity),
+                archetype->chunkList[positions[hole] / capacity], uint32_t(positions[hole] % capacity));
+        ++source;
+    }
+
+    const size_t chunksNeeded = (remaining + capacity - 1) / capacity;
+    for (size_t i = chunksNeeded; i < archetype->chunkList.size(); ++i)
+        releaseChunk(archetype->chunkList[i]);
+    archetype->chunkList.resize(chunksNeeded);
+    if (chunksNeeded > 0)
+        archetype->chunkList.back()->count = uint32_t(remaining - (chunksNeeded - 1) * capacity);
+    archetype->entities = remaining;
+}
+
+Entity World::createRaw(ComponentMask mask, const ComponentId *ids, const void *const *values, size_t valueCount) {
+    Archetype *archetype = archetypeFor(mask);
+    Entity entity = allocateEntity();
+    Chunk *chunk = chunkWithSpace(archetype);
+    uint32_t row = chunk->count++;
+    ++archetype->entities;
+
+    archetype->entityColumn(chunk)[row] = entity;
+    for (size_t i = 0; i < valueCount; ++i) {
+        uint32_t size = ComponentRegistry::info(ids[i]).size;
+        std::memcpy(archetype->column(chunk, ids[i]) + size_t(row) * size, values[i], size);
+    }
+
+    EntityRecord &record = records[entity.index];
+    record.archetype = archetype;
+    record.chunk = chunk;
+    record.row = row;
+    return entity;
+}
+
+void World::createBatchRaw(ComponentMask mask, size_t count, std::vector<Entity> &out,
+                           const ComponentId *ids, const void *const *values, size_t valueCount) {
+    Archetype *archetype = archetypeFor(mask);
+    out.reserve(out.size() + count);
+    records.reserve(records.size() + (count > freeIndices.size() ? count - freeIndices.size() : 0));
+
+    while (count > 0) {
+        Chunk *chunk = chunkWithSpace(archetype);
+        uint32_t first = chunk->count;
+        uint32_t batch = static_cast<uint32_t>(std::min<size_t>(count, archetype->chunkCapacity - first));
+
+        Entity *entityColumn = archetype->entityColumn(chunk);
+        for (uint32_t row = first; row < first + batch; ++row) {
+            Entity entity = allocateEntity();
+            entityColumn[row] = entity;
+            EntityRecord &record = records[entity.index];
+            record.archetype = archetype;
+            record.chunk = chunk;
+            record.row = row;
+            out.push_back(entity);
+        }
+        // Значения по умолчанию раскладываем по столбцам целиком
+        for (size_t i = 0; i < valueCount; ++i) {
+            uint32_t size = ComponentRegistry::info(ids[i]).size;
+            unsigned char *column = archetype->column(chunk, ids[i]) + size_t(first) * size;
+            for (uint32_t row = 0; row < batch; ++row)
+                std::memcpy(column + size_t(row) * size, values[i], size);
+        }
+
+        chunk->count += batch;
+        archetype->entities += batch;
+        count -= batch;
+    }
+}
+
+void World::destroy(Entity entity) {
+    if (!isAlive(entity))
+        return;
+    EntityRecord &record = records[entity.index];
+    removeRow(record.archetype, record.chunk, record.row);
+    record.archetype = nullptr;
+    record.chunk = nullptr;
+    ++record.generation;
+    freeIndices.push_back(entity.index);
+    --aliveCount;
+}
+
+void World::destroyBatch(const std::vector<Entity> &entities) {
+    std::unordered_map<Archetype *, BatchGroup> groups;
+    for (Entity entity : entities) {
+        if (!isAlive(entity))
+            continue; // В том числе повтор во входном списке
+        EntityRecord &record = records[entity.index];
+        BatchGroup &group = batchGroup(groups, record.archetype);
+        group.positions.push_back(group.chunkIndex[record.chunk] * record.archetype->chunkCapacity + record.row);
+        record.archetype = nullptr;
+        record.chunk = nullptr;
+        ++record.generation;
+        freeIndices.push_back(entity.index);
+        --aliveCount;
+    }
+    for (auto &group : groups)
+        removeRows(group.first, group.second.positions);
+}
+
+void World::moveEntity(Entity entity, Archetype *target) {
+    EntityRecord &record = records[entity.index];
+    Archetype *source = record.archetype;
+    Chunk *sourceChunk = record.chunk;
+    uint32_t sourceRow = record.row;
+
+    Chunk *targetChunk = chunkWithSpace(target);
+    uint32_t targetRow = targetChunk->count++;
+    ++target->entities;
+    target->entityColumn(targetChunk)[targetRow] = entity;
+    for (ComponentId id : target->components) {
+        if (!source->has(id))
+            continue;
+        uint32_t size = ComponentRegistry::info(id).size;
+        std::memcpy(target->column(targetChunk, id) + size_t(targetRow) * size,
+                    source->column(sourceChunk, id) + size_t(sourceRow) * size, size);
+    }
+
+    removeRow(source, sourceChunk, sourceRow);
+    record.archetype = target;
+    record.chunk = targetChunk;
+    record.row = targetRow;
+}
+
+void World::addRaw(Entity entity, ComponentId id, const void *value) {
+    if (!isAlive(entity))
+        return;
+    Archetype *source = records[entity.index].archetype;
+    if (!source->has(id))
+        moveEntity(entity, archetypeWith(source, id));
+    const EntityRecord &record = records[entity.index];
+    uint32_t size = ComponentRegistry::info(id).size;
+    std::memcpy(record.archetype->column(record.chunk, id) + size_t(record.row) * size, value, size);
+}
+
+void World::removeRaw(Entity entity, ComponentId id) {
+    if (!isAlive(entity))
+        return;
+    Archetype *source = records[entity.index].archetype;
+    if (source->has(id))
+        moveEntity(entity, archetypeWithout(source, id));
+}
+
+void World::changeBatchRaw(const std::vector<Entity> &entities, ComponentId id, const void *value) {
+    const uint32_t size = ComponentRegistry::info(id).size;
+    std::unordered_map<Archetype *, BatchGroup> groups;
+    for (Entity entity : entities) {
+        if (!isAlive(entity))
+            continue;
+        const EntityRecord &record = records[entity.index];
+        if (record.archetype->has(id) == (value != nullptr)) {
+            // Переход не нужен: компонент уже есть (перезаписываем значение) или его и не было
+            if (value)
+                std::memcpy(record.archetype->column(record.chunk, id) + size_t(record.row) * size, value, size);
+            continue;
+        }
+        batchGroup(groups, record.archetype).entities.push_back(entity);
+    }
+
+    for (auto &entry : groups) {
+        Archetype *source = entry.first;
+        BatchGroup &group = entry.second;
+        Archetype *target = value ? archetypeWith(source, id) : archetypeWithout(source, id);
+        group.positions.reserve(group.entities.size());
+        for (Entity entity : group.entities) {
+            EntityRecord &record = records[entity.index];
+            if (record.archetype != source)
+                continue; // Повтор во входном списке: сущность уже перенесена
+            group.positions.push_back(group.chunkIndex[record.chunk] * source->chunkCapacity + record.row);
+
+            // Строки дописываются в конец целевого архетипа; исходный уплотняется один раз в конце
+            Chunk *targetChunk = chunkWithSpace(target);
+            const uint32_t targetRow = targetChunk->count++;
+            ++target->entities;
+            target->entityColumn(targetChunk)[targetRow] = entity;
+            for (ComponentId component : target->components) {
+                const uint32_t componentSize = ComponentRegistry::info(component).size;
+                unsigned char *destination = target->column(targetChunk, component) + size_t(targetRow) * componentSize;
+                if (component == id)
+                    std::memcpy(destination, value, componentSize);
+                else
+                    std::memcpy(destination, source->column(record.chunk, component) + size_t(record.row) * componentSize,
+                                componentSize);
+            }
+            record.archetype = target;
+            record.chunk = targetChunk;
+            record.row = targetRow;
+        }
+        removeRows(source, group.positions);
+    }
+}
+
+void World::apply(CommandBuffer &buffer) {
+    for (const CommandBuffer::Command &command : buffer.commands) {
+        switch (command.type) {
+        case CommandBuffer::Command::Add:
+            addRaw(command.entity, command.component, buffer.payload.data() + command.payloadOffset);
+            break;
+        case CommandBuffer::Command::Remove:
+            removeRaw(command.entity, command.component);
+            break;
+        case CommandBuffer::Command::Destroy:
+            destroy(command.entity);
+            break;
+        }
+    }
+    buffer.clear();
+}
+
+const std::vector<Archetype *> &World::matchingArchetypes(ComponentMask mask) {
+    QueryCache &cache = queryCache[mask];
+    for (; cache.scannedArchetypes < archetypes.size(); ++cache.scannedArchetypes) {
+        Archetype *archetype = archetypes[cache.scannedArchetypes].get();
+        if ((archetype->mask() & mask) == mask)
+            cache.archetypes.push_back(archetype);
+    }
+    return cache.archetypes;
+}
+
+} // namespace ecs
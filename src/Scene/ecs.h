@@ -0,0 +1,282 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include "Core/poolallocator.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Хранилище сущностей и компонентов на архетипах.
+// Сущности с одинаковым набором компонентов лежат в одном архетипе, архетип делится на чанки
+// фиксированного размера, внутри чанка каждый компонент хранится отдельным массивом (SoA).
+// Чанки берутся из пула мира, поэтому частое создание и удаление сущностей не ходит в кучу.
+namespace ecs {
+
+using ComponentId = uint32_t;
+using ComponentMask = uint64_t;
+constexpr int MaxComponents = 64;
+
+// Стабильный дескриптор сущности: индекс записи + поколение, чтобы старые дескрипторы не оживали
+struct Entity {
+    uint32_t index = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == 0xFFFFFFFFu; }
+    bool operator==(const Entity &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity &other) const { return !(*this == other); }
+};
+
+struct ComponentInfo {
+    uint32_t size;
+    uint32_t alignment;
+};
+
+// Глобальный реестр типов компонентов; идентификаторы выдаются при первом обращении
+class ComponentRegistry {
+public:
+    static ComponentId registerType(uint32_t size, uint32_t alignment);
+    static const ComponentInfo &info(ComponentId id);
+    static int count();
+};
+
+template<typename T>
+ComponentId componentId() {
+    static_assert(std::is_trivially_copyable<T>::value, "Компоненты перемещаются memcpy и должны быть trivially copyable");
+    static const ComponentId id = ComponentRegistry::registerType(sizeof(T), alignof(T));
+    return id;
+}
+
+template<typename... Ts>
+ComponentMask componentMask() {
+    ComponentMask mask = 0;
+    using Expand = int[];
+    (void)Expand{0, (mask |= ComponentMask(1) << componentId<Ts>(), 0)...};
+    return mask;
+}
+
+class Archetype;
+
+struct Chunk {
+    static constexpr size_t DataSize = 16 * 1024 - 64;
+
+    Archetype *archetype = nullptr;
+    uint32_t count = 0;
+    alignas(64) unsigned char data[DataSize];
+};
+
+class Archetype {
+public:
+    explicit Archetype(ComponentMask mask);
+
+    ComponentMask mask() const { return componentMask; }
+    uint32_t capacity() const { return chunkCapacity; }
+    const std::vector<Chunk *> &chunks() const { return chunkList; }
+    size_t entityCount() const { return entities; }
+    bool has(ComponentId id) const { return (componentMask >> id) & 1; }
+
+    Entity *entityColumn(Chunk *chunk) const { return reinterpret_cast<Entity *>(chunk->data); }
+    unsigned char *column(Chunk *chunk, ComponentId id) const { return chunk->data + columnOffsets[id]; }
+    template<typename T>
+    T *column(Chunk *chunk) const { return reinterpret_cast<T *>(column(chunk, componentId<T>())); }
+
+private:
+    friend class World;
+
+    ComponentMask componentMask;
+    std::vector<ComponentId> components;
+    uint32_t columnOffsets[MaxComponents];
+    uint32_t chunkCapacity;
+    std::vector<Chunk *> chunkList; // Все чанки, кроме последнего, заполнены полностью
+    size_t entities;
+    std::unordered_map<ComponentId, Archetype *> addEdges;
+    std::unordered_map<ComponentId, Archetype *> removeEdges;
+};
+
+// Отложенные структурные изменения: безопасно записывать во время обхода, применяются пакетом
+class CommandBuffer {
+public:
+    void destroy(Entity entity) { commands.push_back({Command::Destroy, 0, entity, 0}); }
+
+    template<typename T>
+    void add(Entity entity, const T &value = T()) {
+        uint32_t offset = static_cast<uint32_t>(payload.size());
+        payload.resize(payload.size() + sizeof(T));
+        std::memcpy(payload.data() + offset, &value, sizeof(T));
+        commands.push_back({Command::Add, componentId<T>(), entity, offset});
+    }
+
+    template<typename T>
+    void remove(Entity entity) { commands.push_back({Command::Remove, componentId<T>(), entity, 0}); }
+
+    bool isEmpty() const { return commands.empty(); }
+    void clear() { commands.clear(); payload.clear(); }
+
+private:
+    friend class World;
+
+    struct Command {
+        enum Type : uint8_t { Add, Remove, Destroy } type;
+        ComponentId component;
+        Entity entity;
+        uint32_t payloadOffset;
+    };
+    std::vector<Command> commands;
+    std::vector<unsigned char> payload;
+};
+
+class World {
+public:
+    World();
+    ~World();
+    World(const World &) = delete;
+    World &operator=(const World &) = delete;
+
+    void clear();
+
+    Entity create() { return createRaw(0, nullptr, nullptr); }
+
+    template<typename... Ts>
+    Entity create(const Ts &...components) {
+        const std::array<ComponentId, sizeof...(Ts)> ids{{componentId<Ts>()...}};
+        const std::array<const void *, sizeof...(Ts)> values{{&components...}};
+        return createRaw(componentMask<Ts...>(), ids.data(), values.data(), sizeof...(Ts));
+    }
+
+    // Пакетное создание: чанки заполняются подряд, без промежуточных переходов между архетипами
+    template<typename... Ts>
+    void createBatch(size_t count, std::vector<Entity> &out, const Ts &...defaults) {
+        const std::array<ComponentId, sizeof...(Ts)> ids{{componentId<Ts>()...}};
+        const std::array<const void *, sizeof...(Ts)> values{{&defaults...}};
+        createBatchRaw(componentMask<Ts...>(), count, out, ids.data(), values.data(), sizeof...(Ts));
+    }
+
+    void destroy(Entity entity);
+    // Пакетные изменения группируют сущности по архетипу: каждый исходный архетип уплотняется
+    // один раз за вызов, а не на каждую сущность
+    void destroyBatch(const std::vector<Entity> &entities);
+    bool isAlive(Entity entity) const;
+    size_t entityCount() const { return aliveCount; }
+
+    template<typename T>
+    void add(Entity entity, const T &value = T()) { addRaw(entity, componentId<T>(), &value); }
+
+    template<typename T>
+    void remove(Entity entity) { removeRaw(entity, componentId<T>()); }
+
+    template<typename T>
+    void addBatch(const std::vector<Entity> &entities, const T &value = T()) {
+        changeBatchRaw(entities, componentId<T>(), &value);
+    }
+
+    template<typename T>
+    void removeBatch(const std::vector<Entity> &entities) {
+        changeBatchRaw(entities, componentId<T>(), nullptr);
+    }
+
+    template<typename T>
+    bool has(Entity entity) const {
+        return isAlive(entity) && records[entity.index].archetype->has(componentId<T>());
+    }
+
+    template<typename T>
+    T *get(Entity entity) {
+        if (!has<T>(entity))
+            return nullptr;
+        const EntityRecord &record = records[entity.index];
+        return record.archetype->column<T>(record.chunk) + record.row;
+    }
+
+    // Компонент по идентификатору — для кода, работающего с описаниями полей, а не с типами
+    unsigned char *get(Entity entity, ComponentId id) {
+        if (!isAlive(entity) || !records[entity.index].archetype->has(id))
+            return nullptr;
+        const EntityRecord &record = records[entity.index];
+        return record.archetype->column(record.chunk, id) + size_t(record.row) * ComponentRegistry::info(id).size;
+    }
+
+    void apply(CommandBuffer &buffer);
+
+    // Обход по чанкам: f(count, entities, columns...) получает непрерывные массивы компонентов
+    template<typename... Ts, typename F>
+    void eachChunk(F &&f) {
+        for (Archetype *archetype : matchingArchetypes(componentMask<Ts...>())) {
+            for (Chunk *chunk : archetype->chunks())
+                f(static_cast<size_t>(chunk->count), archetype->entityColumn(chunk), archetype->column<Ts>(chunk)...);
+        }
+    }
+
+    // Поэлементный обход: f(Ts&...). Структурные изменения внутри — только через CommandBuffer
+    template<typename... Ts, typename F>
+    void each(F &&f) {
+        eachChunk<Ts...>([&f](size_t count, Entity *, Ts *...columns) {
+            for (size_t i = 0; i < count; ++i)
+                f(columns[i]...);
+        });
+    }
+
+    template<typename... Ts, typename F>
+    void eachEntity(F &&f) {
+        eachChunk<Ts...>([&f](size_t count, Entity *entities, Ts *...columns) {
+            for (size_t i = 0; i < count; ++i)
+                f(entities[i], columns[i]...);
+        });
+    }
+
+    const std::vector<Archetype *> &matchingArchetypes(ComponentMask mask);
+
+private:
+    struct EntityRecord {
+        Archetype *archetype = nullptr;
+        Chunk *chunk = nullptr;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    struct QueryCache {
+        std::vector<Archetype *> archetypes;
+        size_t scannedArchetypes = 0; // Новые архетипы только добавляются, досматриваем хвост
+    };
+
+    Entity createRaw(ComponentMask mask, const ComponentId *ids, const void *const *values, size_t valueCount = 0);
+    void createBatchRaw(ComponentMask mask, size_t count, std::vector<Entity> &out,
+                        const ComponentId *ids, const void *const *values, size_t valueCount);
+    void addRaw(Entity entity, ComponentId id, const void *value);
+    void removeRaw(Entity entity, ComponentId id);
+    // value == nullptr — снять компонент, иначе добавить (или перезаписать) со значением value
+    void changeBatchRaw(const std::vector<Entity> &entities, ComponentId id, const void *value);
+
+    Entity allocateEntity();
+    Archetype *archetypeFor(ComponentMask mask);
+    Archetype *archetypeWith(Archetype *source, ComponentId id);
+    Archetype *archetypeWithout(Archetype *source, ComponentId id);
+    Chunk *chunkWithSpace(Archetype *archetype);
+    void removeRow(Archetype *archetype, Chunk *chunk, uint32_t row);
+    // Удаляет строки по сквозным позициям (чанк * вместимость + строка) за один проход:
+    // дыры заполняются живыми строками с хвоста, лишние чанки возвращаются в пул.
+    // Записи удаляемых сущностей вызывающий уже обновил
+    void removeRows(Archetype *archetype, std::vector<size_t> &positions);
+    void copyRow(Archetype *archetype, Chunk *from, uint32_t fromRow, Chunk *to, uint32_t toRow);
+    void moveEntity(Entity entity, Archetype *target);
+
+    static constexpr size_t ChunksPerPage = 16; // Страница пула — 256 КБ
+
+    Chunk *allocateChunk(Archetype *archetype);
+    void releaseChunk(Chunk *chunk) { chunkPool.deallocate(chunk); }
+
+    core::PoolAllocator chunkPool;
+    core::TaggedVector<EntityRecord, core::MemoryTag::Scene> records;
+    core::TaggedVector<uint32_t, core::MemoryTag::Scene> freeIndices;
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<ComponentMask, Archetype *> archetypeByMask;
+    std::unordered_map<ComponentMask, QueryCache> queryCache;
+    size_t aliveCount;
+};
+
+} // namespace ecs
+
+#endif // ECS_H
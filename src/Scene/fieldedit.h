@@ -0,0 +1,29 @@
+#ifndef FIELDEDIT_H
+#define FIELDEDIT_H
+
+#include "ecs.h"
+#include "reflection.h"
+#include "scenegraph.h"
+#include <vector>
+
+// Одна правка поля компонента сразу у набора объектов: инспектор создаёт её из ввода,
+// Scene::applyFieldEdit применяет одним проходом, запоминая прежние значения, а
+// Scene::revertFieldEdit возвращает их. Поле адресуется описанием из reflect, а не типом
+struct FieldEdit {
+    const reflect::ComponentDescriptor *component = nullptr;
+    ecs::ComponentId componentId = 0;
+    uint32_t field = 0;
+    int element = -1; // -1 — поле целиком, иначе один элемент массива
+    std::vector<SceneGraph::NodeId> nodes;
+    std::vector<unsigned char> value;    // size() байт
+    std::vector<unsigned char> previous; // size() байт на каждый узел, в порядке nodes
+
+    const reflect::FieldDescriptor &descriptor() const { return component->fields[field]; }
+    uint32_t offset() const {
+        const reflect::FieldDescriptor &f = descriptor();
+        return f.offset + (element < 0 ? 0 : uint32_t(element) * f.elementSize());
+    }
+    uint32_t size() const { return element < 0 ? descriptor().size() : descriptor().elementSize(); }
+};
+
+#endif // FIELDEDIT_H
@@ -0,0 +1,48 @@
+#include "reflection.h"
+#include <cstring>
+
+namespace reflect {
+
+void writeSchema(const ComponentDescriptor &component, FieldRecord *records) {
+    for (uint32_t i = 0; i < component.fieldCount; ++i) {
+        const FieldDescriptor &field = component.fields[i];
+        FieldRecord &record = records[i];
+        std::memset(&record, 0, sizeof(record));
+        std::strncpy(record.name, field.name, sizeof(record.name) - 1);
+        record.type = uint8_t(field.type);
+        record.count = field.count;
+        record.offset = field.offset;
+    }
+}
+
+bool sameSchema(const ComponentDescriptor &component, uint32_t storedSize, const FieldRecord *records, uint32_t recordCount) {
+    if (storedSize != component.size || recordCount != component.fieldCount)
+        return false;
+    for (uint32_t i = 0; i < recordCount; ++i) {
+        const FieldDescriptor &field = component.fields[i];
+        const FieldRecord &record = records[i];
+        if (std::strncmp(record.name, field.name, sizeof(record.name)) != 0 || record.type != uint8_t(field.type)
+            || record.count != field.count || record.offset != field.offset)
+            return false;
+    }
+    return true;
+}
+
+void convert(const FieldRecord *records, uint32_t recordCount, uint32_t storedSize, const unsigned char *source,
+             const ComponentDescriptor &component, unsigned char *target) {
+    for (uint32_t i = 0; i < component.fieldCount; ++i) {
+        const FieldDescriptor &field = component.fields[i];
+        for (uint32_t j = 0; j < recordCount; ++j) {
+            const FieldRecord &record = records[j];
+            if (std::strncmp(record.name, field.name, sizeof(record.name)) != 0 || record.type != uint8_t(field.type))
+                continue;
+            // Массив мог вырасти или сократиться: переносится общая часть
+            const uint32_t bytes = field.elementSize() * (record.count < field.count ? record.count : field.count);
+            if (uint32_t(record.offset) + bytes <= storedSize)
+                std::memcpy(target + field.offset, source + record.offset, bytes);
+            break;
+        }
+    }
+}
+
+} // namespace reflect
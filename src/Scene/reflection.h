@@ -0,0 +1,161 @@
+#ifndef REFLECTION_H
+#define REFLECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Описание полей компонентов на этапе компиляции. SPECTER_REFLECT строит для типа constexpr-таблицу
+// полей (имя, тип, число элементов, смещение, диапазон для редактора) и хэш раскладки — без
+// регистрации при запуске. По этим описаниям инспектор строит редакторы, пакетная правка
+// (FieldEdit) пишет значения, а SceneFile сохраняет схему и переносит поля при смене раскладки
+namespace reflect {
+
+enum class FieldType : uint8_t {
+    Float,
+    Int32,
+    Bool
+};
+
+struct FieldDescriptor {
+    const char *name;  // Имя члена структуры, ключ при переносе между раскладками
+    const char *label; // Для инспектора
+    FieldType type;
+    uint8_t count;     // Элементов: 3 для float[3]
+    uint16_t offset;   // От начала компонента
+    float minimum;
+    float maximum;
+    float step;
+
+    constexpr uint32_t elementSize() const { return type == FieldType::Bool ? 1 : 4; }
+    constexpr uint32_t size() const { return elementSize() * count; }
+};
+
+struct ComponentDescriptor {
+    const char *name;
+    uint32_t size;
+    const FieldDescriptor *fields;
+    uint32_t fieldCount;
+    uint64_t schemaHash; // Меняется вместе с раскладкой: именами, типами и смещениями полей
+};
+
+template<typename M>
+struct FieldTraits;
+
+template<>
+struct FieldTraits<float> {
+    static constexpr FieldType type = FieldType::Float;
+    static constexpr uint8_t count = 1;
+};
+
+template<>
+struct FieldTraits<int32_t> {
+    static constexpr FieldType type = FieldType::Int32;
+    static constexpr uint8_t count = 1;
+};
+
+template<>
+struct FieldTraits<bool> {
+    static constexpr FieldType type = FieldType::Bool;
+    static constexpr uint8_t count = 1;
+};
+
+template<typename M, size_t N>
+struct FieldTraits<M[N]> {
+    static_assert(N <= 16, "Поле-массив показывается в инспекторе строкой редакторов");
+    static constexpr FieldType type = FieldTraits<M>::type;
+    static constexpr uint8_t count = uint8_t(N);
+};
+
+template<typename M>
+constexpr FieldDescriptor field(const char *name, size_t offset, const char *label, float minimum = -1.0e6f,
+                                float maximum = 1.0e6f, float step = 0.1f) {
+    return {name, label, FieldTraits<M>::type, FieldTraits<M>::count, uint16_t(offset), minimum, maximum, step};
+}
+
+// FNV-1a: считается компилятором
+constexpr uint64_t hashBytes(const char *text, uint64_t hash = 14695981039346656037ull) {
+    return *text ? hashBytes(text + 1, (hash ^ uint8_t(*text)) * 1099511628211ull) : hash;
+}
+
+constexpr uint64_t hashValue(uint64_t value, uint64_t hash) {
+    return (hash ^ value) * 1099511628211ull;
+}
+
+template<size_t N>
+constexpr uint64_t schemaHash(const char *name, uint32_t size, const FieldDescriptor (&fields)[N]) {
+    uint64_t hash = hashValue(size, hashBytes(name));
+    for (size_t i = 0; i < N; ++i) {
+        hash = hashBytes(fields[i].name, hash);
+        hash = hashValue(uint64_t(fields[i].type) | uint64_t(fields[i].count) << 8 | uint64_t(fields[i].offset) << 16, hash);
+    }
+    return hash;
+}
+
+constexpr size_t nameLength(const char *text) {
+    return *text ? 1 + nameLength(text + 1) : 0;
+}
+
+// Поля внутри компонента, имена помещаются в FieldRecord
+template<size_t N>
+constexpr bool fieldsFit(const FieldDescriptor (&fields)[N], size_t size) {
+    for (size_t i = 0; i < N; ++i) {
+        if (fields[i].offset + fields[i].size() > size || nameLength(fields[i].name) >= 24)
+            return false;
+    }
+    return true;
+}
+
+// Специализации создаёт SPECTER_REFLECT
+template<typename T>
+struct Reflect;
+
+template<typename T>
+constexpr const ComponentDescriptor &descriptor() {
+    return Reflect<T>::descriptor;
+}
+
+template<typename... Ts>
+struct TypeList {};
+
+// Поле в файле: схема, записанная рядом с данными компонентов
+struct FieldRecord {
+    char name[24]; // С нулём в конце
+    uint8_t type;
+    uint8_t count;
+    uint16_t offset;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FieldRecord) == 32, "Запись схемы — часть формата сцены");
+
+// Схема компонента для записи в файл
+void writeSchema(const ComponentDescriptor &component, FieldRecord *records);
+// Раскладка в файле совпадает с текущей: данные можно использовать без преобразования
+bool sameSchema(const ComponentDescriptor &component, uint32_t storedSize, const FieldRecord *records, uint32_t recordCount);
+// Переносит поля из записи старой раскладки в target по именам; поля, которых в файле нет
+// или у которых сменился тип, остаются как были (значения по умолчанию)
+void convert(const FieldRecord *records, uint32_t recordCount, uint32_t storedSize, const unsigned char *source,
+             const ComponentDescriptor &component, unsigned char *target);
+
+} // namespace reflect
+
+// SPECTER_FIELD(Тип, член, "Подпись"[, минимум, максимум, шаг])
+#define SPECTER_FIELD(Type, member, ...) reflect::field<decltype(Type::member)>(#member, offsetof(Type, member), __VA_ARGS__)
+
+// SPECTER_REFLECT(Transform, SPECTER_FIELD(Transform, position, "Position"), ...) — в глобальном пространстве имён
+#define SPECTER_REFLECT(Type, ...)                                                                                 \
+    namespace reflect {                                                                                            \
+    template<>                                                                                                     \
+    struct Reflect<Type> {                                                                                         \
+        static_assert(std::is_trivially_copyable<Type>::value && std::is_standard_layout<Type>::value,            \
+                      "Отражаемые компоненты копируются побайтно");                                               \
+        static constexpr FieldDescriptor fields[] = {__VA_ARGS__};                                                 \
+        static_assert(fieldsFit(fields, sizeof(Type)), "Поле выходит за компонент или имя длиннее 23 символов");   \
+        static constexpr ComponentDescriptor descriptor = {#Type, uint32_t(sizeof(Type)), fields,                  \
+                                                           uint32_t(sizeof(fields) / sizeof(fields[0])),          \
+                                                           schemaHash(#Type, uint32_t(sizeof(Type)), fields)};     \
+    };                                                                                                             \
+    }
+
+#endif // REFLECTION_H
@@ -0,0 +1,270 @@
+#include "scene.h"
+#include "components.h"
+#include "fieldedit.h"
+#include "scenefragment.h"
+#include "scenejournal.h"
+#include "Core/jobsystem.h"
+#include "Core/profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+Scene::Scene() : nextObject(1), changeJournal(nullptr), removalDepth(0) {
+    nodeEntities.resize(1);
+    nodeObjects.resize(1, RootObject);
+}
+
+void Scene::clear() {
+    sceneGraph.clear();
+    entityWorld.clear();
+    releasedEntities.clear();
+    nodeEntities.assign(1, ecs::Entity());
+    nodeObjects.assign(1, RootObject);
+    nextObject = 1;
+}
+
+std::vector<SceneGraph::NodeId> Scene::createObjects(SceneGraph::NodeId parent, int count, const QString &baseName,
+                                                     ObjectId firstObject) {
+    std::vector<SceneGraph::NodeId> nodes = sceneGraph.createNodes(parent, count, baseName);
+    if (nodes.empty())
+        return nodes;
+    if (firstObject == RootObject)
+        firstObject = nextObject;
+    nextObject = std::max(nextObject, firstObject + nodes.size());
+    if (changeJournal)
+        changeJournal->objectsCreated(objectId(parent), firstObject, count, baseName);
+
+    std::vector<ecs::Entity> entities;
+    entityWorld.createBatch(nodes.size(), entities, Transform(), SceneNodeRef());
+    nodeEntities.resize(sceneGraph.capacity());
+    nodeObjects.resize(sceneGraph.capacity(), RootObject);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodeEntities[nodes[i]] = entities[i];
+        nodeObjects[nodes[i]] = firstObject + i;
+        entityWorld.get<SceneNodeRef>(entities[i])->node = nodes[i];
+    }
+    return nodes;
+}
+
+void Scene::removeChildren(SceneGraph::NodeId parent, int firstRow, int count, SceneFragment *removed) {
+    if (removed)
+        capture(parent, firstRow, count, *removed);
+    if (changeJournal)
+        changeJournal->childrenRemoved(objectId(parent), firstRow, count);
+    releasedNodes.clear();
+    sceneGraph.removeChildren(parent, firstRow, count, &releasedNodes);
+    for (SceneGraph::NodeId node : releasedNodes) {
+        releasedEntities.push_back(nodeEntities[node]);
+        nodeEntities[node] = ecs::Entity();
+        nodeObjects[node] = RootObject;
+    }
+    if (removalDepth == 0) {
+        entityWorld.destroyBatch(releasedEntities);
+        releasedEntities.clear();
+    }
+}
+
+Scene::RemovalBatch::~RemovalBatch() {
+    if (--scene.removalDepth == 0) {
+        scene.entityWorld.destroyBatch(scene.releasedEntities);
+        scene.releasedEntities.clear();
+    }
+}
+
+void Scene::capture(SceneGraph::NodeId parent, int firstRow, int count, SceneFragment &fragment) {
+    fragment = SceneFragment();
+    fragment.parent = objectId(parent);
+    fragment.firstRow = firstRow;
+    if (!sceneGraph.isValid(parent) || firstRow < 0 || count <= 0 || firstRow + count > sceneGraph.childCount(parent))
+        return;
+    fragment.count = count;
+
+    // Прямой обход без рекурсии; у каждого узла запоминаем индекс родителя во фрагменте
+    std::vector<std::pair<SceneGraph::NodeId, uint32_t>> stack;
+    for (int row = firstRow + count - 1; row >= firstRow; --row)
+        stack.push_back({sceneGraph.child(parent, row), SceneGraph::InvalidNode});
+    while (!stack.empty()) {
+        const std::pair<SceneGraph::NodeId, uint32_t> current = stack.back();
+        stack.pop_back();
+        const uint32_t index = uint32_t(fragment.objects.size());
+        fragment.parents.push_back(current.second);
+        fragment.objects.push_back(objectId(current.first));
+        fragment.names.push_back(sceneGraph.name(current.first));
+        const Transform *transform = entityWorld.get<Transform>(entity(current.first));
+        fragment.transforms.push_back(transform ? *transform : Transform());
+        for (int row = sceneGraph.childCount(current.first) - 1; row >= 0; --row)
+            stack.push_back({sceneGraph.child(current.first, row), index});
+    }
+}
+
+std::vector<SceneGraph::NodeId> Scene::restoreChildren(const SceneFragment &fragment, SceneGraph::NodeId parentHint) {
+    SPECTER_PROFILE_SCOPE("Scene::restoreChildren");
+    std::vector<SceneGraph::NodeId> nodes;
+    const SceneGraph::NodeId parent = node(fragment.parent, parentHint);
+    if (!fragment.isCaptured() || parent == SceneGraph::InvalidNode || fragment.firstRow > sceneGraph.childCount(parent))
+        return nodes;
+    if (changeJournal)
+        changeJournal->childrenRestored(fragment);
+
+    // Верхние узлы вставляются одним сдвигом соседей, потомки дописываются к ним в порядке обхода
+    const std::vector<SceneGraph::NodeId> top = sceneGraph.insertNodes(parent, fragment.firstRow, fragment.count);
+    nodes.resize(fragment.size());
+    size_t nextTop = 0;
+    for (size_t i = 0; i < fragment.size(); ++i) {
+        if (fragment.parents[i] == SceneGraph::InvalidNode) {
+            nodes[i] = top[nextTop++];
+            sceneGraph.setName(nodes[i], fragment.names[i]);
+        } else {
+            nodes[i] = sceneGraph.createNode(nodes[fragment.parents[i]], fragment.names[i]);
+        }
+    }
+
+    std::vector<ecs::Entity> entities;
+    entityWorld.createBatch(nodes.size(), entities, Transform(), SceneNodeRef());
+    nodeEntities.resize(sceneGraph.capacity());
+    nodeObjects.resize(sceneGraph.capacity(), RootObject);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodeEntities[nodes[i]] = entities[i];
+        nodeObjects[nodes[i]] = fragment.objects[i];
+        nextObject = std::max(nextObject, fragment.objects[i] + 1);
+        *entityWorld.get<Transform>(entities[i]) = fragment.transforms[i];
+        entityWorld.get<SceneNodeRef>(entities[i])->node = nodes[i];
+    }
+    return nodes;
+}
+
+void Scene::setName(SceneGraph::NodeId node, const QString &name) {
+    if (!sceneGraph.isValid(node) || node == SceneGraph::RootNode)
+        return;
+    sceneGraph.setName(node, name);
+    if (changeJournal)
+        changeJournal->nameChanged(objectId(node), name);
+}
+
+Transform *Scene::editTransform(SceneGraph::NodeId node) {
+    Transform *transform = entityWorld.get<Transform>(entity(node));
+    if (transform && changeJournal)
+        changeJournal->transformChanged(node);
+    return transform;
+}
+
+size_t Scene::applyFieldEdit(FieldEdit &edit) {
+    SPECTER_PROFILE_SCOPE("Scene::applyFieldEdit");
+    writeField(edit, false, &edit.previous);
+    size_t changed = 0;
+    for (SceneGraph::NodeId node : edit.nodes) {
+        if (entityWorld.get(entity(node), edit.componentId)) {
+            markChanged(node, edit.componentId);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+void Scene::revertFieldEdit(const FieldEdit &edit) {
+    writeField(edit, true, nullptr);
+    for (SceneGraph::NodeId node : edit.nodes) {
+        if (entityWorld.get(entity(node), edit.componentId))
+            markChanged(node, edit.componentId);
+    }
+}
+
+// Правка тысяч объектов — один проход по узлам без обращений к журналу и UI; узлы
+// без компонента пропускаются, их слот в previous остаётся нулевым
+void Scene::writeField(const FieldEdit &edit, bool restore, std::vector<unsigned char> *previous) {
+    const size_t size = edit.size();
+    const size_t offset = edit.offset();
+    const size_t count = edit.nodes.size();
+    if (previous)
+        previous->assign(count * size, 0);
+    if (restore && edit.previous.size() != count * size)
+        return;
+    const unsigned char *value = edit.value.data();
+    auto body = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            unsigned char *component = entityWorld.get(entity(edit.nodes[i]), edit.componentId);
+            if (!component)
+                continue;
+            if (previous)
+                std::memcpy(previous->data() + i * size, component + offset, size);
+            std::memcpy(component + offset, restore ? edit.previous.data() + i * size : value, size);
+        }
+    };
+    // Мелкие правки не стоят раздачи по потокам
+    const size_t Grain = 4096;
+    if (count <= Grain)
+        body(0, count);
+    else
+        core::JobSystem::instance().parallelFor(0, count, Grain, body);
+}
+
+void Scene::markChanged(SceneGraph::NodeId node, ecs::ComponentId component) {
+    // Журнал пока хранит только Transform
+    if (changeJournal && component == ecs::componentId<Transform>())
+        changeJournal->transformChanged(node);
+}
+
+void Scene::load(uint32_t count, const uint32_t *parents, const Transform *transforms, const ObjectId *objectIds,
+                 const std::function<QString(uint32_t)> &name) {
+    clear();
+    sceneGraph.reserve(static_cast<int>(count));
+    std::vector<SceneGraph::NodeId> nodes(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        SceneGraph::NodeId parent = parents[i] == SceneGraph::InvalidNode ? SceneGraph::RootNode : nodes[parents[i]];
+        nodes[i] = sceneGraph.createNode(parent, name(i));
+    }
+
+    std::vector<ecs::Entity> entities;
+    entityWorld.createBatch(count, entities, Transform(), SceneNodeRef());
+    nodeEntities.resize(sceneGraph.capacity());
+    nodeObjects.resize(sceneGraph.capacity(), RootObject);
+    for (uint32_t i = 0; i < count; ++i) {
+        const ObjectId object = objectIds ? objectIds[i] : ObjectId(i) + 1;
+        nodeEntities[nodes[i]] = entities[i];
+        nodeObjects[nodes[i]] = object;
+        nextObject = std::max(nextObject, object + 1);
+        *entityWorld.get<Transform>(entities[i]) = transforms[i];
+        entityWorld.get<SceneNodeRef>(entities[i])->node = nodes[i];
+    }
+}
+
+ecs::Entity Scene::entity(SceneGraph::NodeId node) const {
+    return node < nodeEntities.size() ? nodeEntities[node] : ecs::Entity();
+}
+
+Scene::ObjectId Scene::objectId(SceneGraph::NodeId node) const {
+    return node < nodeObjects.size() ? nodeObjects[node] : RootObject;
+}
+
+SceneGraph::NodeId Scene::node(ObjectId object, SceneGraph::NodeId hint) const {
+    if (object == RootObject)
+        return SceneGraph::RootNode;
+    if (hint < nodeObjects.size() && nodeObjects[hint] == object)
+        return hint;
+    // Освобождённые узлы хранят RootObject, поэтому совпасть может только живой
+    for (size_t node = 1; node < nodeObjects.size(); ++node) {
+        if (nodeObjects[node] == object)
+            return SceneGraph::NodeId(node);
+    }
+    return SceneGraph::InvalidNode;
+}
+
+void Scene::resolve(const std::vector<ObjectId> &objects, std::vector<SceneGraph::NodeId> &nodes) const {
+    nodes.resize(objects.size(), SceneGraph::InvalidNode);
+    std::unordered_map<ObjectId, size_t> missing;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i] == RootObject) {
+            nodes[i] = SceneGraph::RootNode;
+        } else if (nodes[i] >= nodeObjects.size() || nodeObjects[nodes[i]] != objects[i]) {
+            nodes[i] = SceneGraph::InvalidNode;
+            missing.emplace(objects[i], i);
+        }
+    }
+    for (size_t node = 1; node < nodeObjects.size() && !missing.empty(); ++node) {
+        auto it = missing.find(nodeObjects[node]);
+        if (it != missing.end()) {
+            nodes[it->second] = SceneGraph::NodeId(node);
+            missing.erase(it);
+        }
+    }
+}
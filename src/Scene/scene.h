@@ -0,0 +1,100 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "scenegraph.h"
+#include "ecs.h"
+#include <functional>
+
+struct Transform;
+struct FieldEdit;
+struct SceneFragment;
+class SceneJournal;
+
+// Сцена: иерархия объектов (SceneGraph) + их компоненты (ecs::World).
+// Каждому узлу иерархии соответствует сущность; структурные изменения идут только через Scene,
+// чтобы граф и мир не расходились.
+// У каждого объекта есть постоянный ObjectId: в отличие от NodeId он не переиспользуется
+// и одинаков до и после сохранения, поэтому на него ссылается журнал изменений.
+class Scene {
+public:
+    using ObjectId = uint64_t;
+    static constexpr ObjectId RootObject = 0;
+
+    Scene();
+
+    SceneGraph &graph() { return sceneGraph; }
+    const SceneGraph &graph() const { return sceneGraph; }
+    ecs::World &world() { return entityWorld; }
+
+    void clear();
+
+    // Журнал, в который пишутся все изменения сцены; nullptr — не записывать
+    void setJournal(SceneJournal *journal) { changeJournal = journal; }
+    SceneJournal *journal() const { return changeJournal; }
+
+    // Создаёт count объектов с Transform в конце списка детей parent.
+    // firstObject задаётся только при воспроизведении журнала, иначе ObjectId выдаются по порядку
+    std::vector<SceneGraph::NodeId> createObjects(SceneGraph::NodeId parent, int count, const QString &baseName,
+                                                  ObjectId firstObject = RootObject);
+    // Удаляет детей parent [firstRow, firstRow + count) с поддеревьями и их сущностями.
+    // Если removed задан, удаляемое сначала снимается в него — для отмены
+    void removeChildren(SceneGraph::NodeId parent, int firstRow, int count, SceneFragment *removed = nullptr);
+    // Пока объект жив, removeChildren только копит сущности удалённых узлов,
+    // а уничтожаются они одним destroyBatch в деструкторе — для удаления многих диапазонов разом
+    class RemovalBatch {
+    public:
+        explicit RemovalBatch(Scene &scene) : scene(scene) { ++scene.removalDepth; }
+        ~RemovalBatch();
+        RemovalBatch(const RemovalBatch &) = delete;
+        RemovalBatch &operator=(const RemovalBatch &) = delete;
+
+    private:
+        Scene &scene;
+    };
+    // Возвращает снятые removeChildren поддеревья на прежнее место. Возвращает узлы в порядке
+    // фрагмента, пусто — родителя нет или позиция вне его детей. parentHint — узел родителя,
+    // найденный заранее (resolve): без него родитель ищется проходом по сцене
+    std::vector<SceneGraph::NodeId> restoreChildren(const SceneFragment &fragment,
+                                                    SceneGraph::NodeId parentHint = SceneGraph::InvalidNode);
+
+    void setName(SceneGraph::NodeId node, const QString &name);
+    // Transform для изменения; объект помечается изменённым для журнала
+    Transform *editTransform(SceneGraph::NodeId node);
+    // Пишет edit.value в поле у всех edit.nodes, у которых есть компонент, и сохраняет прежние
+    // значения в edit.previous. Большие наборы обрабатываются параллельно. Возвращает число изменённых
+    size_t applyFieldEdit(FieldEdit &edit);
+    // Возвращает значения из edit.previous
+    void revertFieldEdit(const FieldEdit &edit);
+
+    // Заменяет сцену count узлами. parents[i] — индекс родителя среди загружаемых узлов (меньше i)
+    // или InvalidNode для объектов верхнего уровня; transforms копируются в чанки пакетом.
+    // objectIds может быть nullptr — тогда объекты нумеруются с 1
+    void load(uint32_t count, const uint32_t *parents, const Transform *transforms, const ObjectId *objectIds,
+              const std::function<QString(uint32_t)> &name);
+
+    ecs::Entity entity(SceneGraph::NodeId node) const;
+    ObjectId objectId(SceneGraph::NodeId node) const;
+    // Узел объекта; hint — узел, где объект был раньше: если он не сменился, поиска нет
+    SceneGraph::NodeId node(ObjectId object, SceneGraph::NodeId hint = SceneGraph::InvalidNode) const;
+    // То же для набора: nodes — подсказки на входе, найденные узлы на выходе (InvalidNode — объекта нет).
+    // Промахи ищутся одним проходом по сцене
+    void resolve(const std::vector<ObjectId> &objects, std::vector<SceneGraph::NodeId> &nodes) const;
+    ObjectId nextObjectId() const { return nextObject; }
+
+private:
+    void writeField(const FieldEdit &edit, bool restore, std::vector<unsigned char> *previous);
+    void markChanged(SceneGraph::NodeId node, ecs::ComponentId component);
+    void capture(SceneGraph::NodeId parent, int firstRow, int count, SceneFragment &fragment);
+
+    SceneGraph sceneGraph;
+    ecs::World entityWorld;
+    core::TaggedVector<ecs::Entity, core::MemoryTag::Scene> nodeEntities; // Индексируется NodeId
+    core::TaggedVector<ObjectId, core::MemoryTag::Scene> nodeObjects;     // Индексируется NodeId
+    ObjectId nextObject;
+    SceneJournal *changeJournal;
+    std::vector<SceneGraph::NodeId> releasedNodes; // Буфер, переиспользуемый между удалениями
+    std::vector<ecs::Entity> releasedEntities;     // Ждут destroyBatch
+    int removalDepth;                              // Вложенность RemovalBatch
+};
+
+#endif // SCENE_H
@@ -0,0 +1,317 @@
+#include "scenecommand.h"
+#include "components.h"
+#include <cstring>
+
+namespace {
+
+const int CompressThreshold = 4096;
+const quint8 CompressedFlag = 1;
+
+class DeltaWriter {
+public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes.append(char(value | 0x80));
+            value >>= 7;
+        }
+        bytes.append(char(value));
+    }
+    void signedVarint(int64_t value) { varint((uint64_t(value) << 1) ^ uint64_t(value >> 63)); }
+    void raw(const void *data, size_t size) {
+        varint(size);
+        bytes.append(static_cast<const char *>(data), int(size));
+    }
+    void string(const QString &text) {
+        const QByteArray utf8 = text.toUtf8();
+        raw(utf8.constData(), size_t(utf8.size()));
+    }
+    // Идущие подряд ObjectId и NodeId кодируются одним байтом на значение
+    template<typename T>
+    void sequence(const std::vector<T> &values) {
+        varint(values.size());
+        uint64_t previous = 0;
+        for (T value : values) {
+            signedVarint(int64_t(uint64_t(value) - previous));
+            previous = uint64_t(value);
+        }
+    }
+
+    QByteArray bytes;
+};
+
+class DeltaReader {
+public:
+    explicit DeltaReader(const QByteArray &bytes) : data(bytes.constData()), end(bytes.constData() + bytes.size()) {}
+
+    bool ok() const { return valid; }
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (data >= end)
+                break;
+            const quint8 byte = quint8(*data++);
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        valid = false;
+        return 0;
+    }
+    int64_t signedVarint() {
+        const uint64_t value = varint();
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+    const char *raw(size_t *size) {
+        *size = size_t(varint());
+        if (!valid || *size > size_t(end - data)) {
+            valid = false;
+            *size = 0;
+            return nullptr;
+        }
+        const char *result = data;
+        data += *size;
+        return result;
+    }
+    std::vector<unsigned char> bytes() {
+        size_t size;
+        const char *source = raw(&size);
+        return std::vector<unsigned char>(source, source + size);
+    }
+    QString string() {
+        size_t size;
+        const char *source = raw(&size);
+        return QString::fromUtf8(source, int(size));
+    }
+    // Число элементов, которое ещё может поместиться в остаток записи: защита от порченого размера
+    size_t count() {
+        const size_t value = size_t(varint());
+        if (value > size_t(end - data)) {
+            valid = false;
+            return 0;
+        }
+        return value;
+    }
+    template<typename T>
+    void sequence(std::vector<T> &values) {
+        values.resize(count());
+        uint64_t previous = 0;
+        for (T &value : values) {
+            previous += uint64_t(signedVarint());
+            value = T(previous);
+        }
+    }
+
+private:
+    const char *data;
+    const char *end;
+    bool valid = true;
+};
+
+template<typename... Ts>
+bool findComponent(reflect::TypeList<Ts...>, const QString &name, SceneCommand *command) {
+    bool found = false;
+    auto check = [&](const reflect::ComponentDescriptor &descriptor, ecs::ComponentId id) {
+        if (!found && name == descriptor.name) {
+            command->component = &descriptor;
+            command->componentId = id;
+            found = true;
+        }
+    };
+    (check(reflect::descriptor<Ts>(), ecs::componentId<Ts>()), ...);
+    return found;
+}
+
+void encodeFragment(DeltaWriter &writer, const SceneFragment &fragment) {
+    writer.varint(fragment.parent);
+    writer.varint(uint64_t(fragment.firstRow));
+    writer.varint(uint64_t(fragment.count));
+    writer.varint(fragment.size());
+    // Родитель в прямом обходе всегда раньше узла: храним расстояние до него, 0 — верхний узел
+    for (size_t i = 0; i < fragment.size(); ++i)
+        writer.varint(fragment.parents[i] == SceneGraph::InvalidNode ? 0 : i - fragment.parents[i]);
+    uint64_t previous = 0;
+    for (uint64_t object : fragment.objects) {
+        writer.signedVarint(int64_t(object - previous));
+        previous = object;
+    }
+    for (const QString &name : fragment.names)
+        writer.string(name);
+    writer.raw(fragment.transforms.data(), fragment.transforms.size() * sizeof(Transform));
+}
+
+bool decodeFragment(DeltaReader &reader, SceneFragment &fragment) {
+    fragment.parent = reader.varint();
+    fragment.firstRow = int(reader.varint());
+    fragment.count = int(reader.varint());
+    const size_t size = reader.count();
+    fragment.parents.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        const uint64_t distance = reader.varint();
+        if (distance > i)
+            return false;
+        fragment.parents[i] = distance == 0 ? SceneGraph::InvalidNode : uint32_t(i - distance);
+    }
+    fragment.objects.resize(size);
+    uint64_t previous = 0;
+    for (uint64_t &object : fragment.objects) {
+        previous += uint64_t(reader.signedVarint());
+        object = previous;
+    }
+    fragment.names.resize(size);
+    for (QString &name : fragment.names)
+        name = reader.string();
+    size_t bytes;
+    const char *transforms = reader.raw(&bytes);
+    if (!reader.ok() || bytes != size * sizeof(Transform))
+        return false;
+    fragment.transforms.resize(size);
+    if (size)
+        std::memcpy(fragment.transforms.data(), transforms, bytes);
+    return true;
+}
+
+} // namespace
+
+SceneCommand SceneCommand::fieldChange(const Scene &scene, const FieldEdit &edit) {
+    SceneCommand command;
+    command.type = FieldChange;
+    command.nodes = edit.nodes;
+    command.objects.reserve(edit.nodes.size());
+    for (SceneGraph::NodeId node : edit.nodes)
+        command.objects.push_back(scene.objectId(node));
+    command.component = edit.component;
+    command.componentId = edit.componentId;
+    command.field = edit.field;
+    command.element = edit.element;
+    command.value = edit.value;
+    command.previous = edit.previous;
+    return command;
+}
+
+SceneCommand SceneCommand::rename(const Scene &scene, SceneGraph::NodeId node, const QString &oldName,
+                                  const QString &newName) {
+    SceneCommand command;
+    command.type = Rename;
+    command.nodes = {node};
+    command.objects = {scene.objectId(node)};
+    command.oldName = oldName;
+    command.newName = newName;
+    return command;
+}
+
+FieldEdit SceneCommand::toFieldEdit() const {
+    FieldEdit edit;
+    edit.component = component;
+    edit.componentId = componentId;
+    edit.field = field;
+    edit.element = element;
+    edit.nodes = nodes;
+    edit.value = value;
+    edit.previous = previous;
+    return edit;
+}
+
+QString SceneCommand::text() const {
+    switch (type) {
+    case FieldChange:
+        return QString("Change %1").arg(component ? component->fields[field].label : "Field");
+    case Rename:
+        return "Rename";
+    case Create:
+    case Remove: {
+        int count = 0;
+        for (const SceneFragment &fragment : fragments)
+            count += fragment.count;
+        const QString action = type == Create ? "Create" : "Delete";
+        return count == 1 ? action + " Object" : QString("%1 %2 Objects").arg(action).arg(count);
+    }
+    }
+    return QString();
+}
+
+bool SceneCommand::merge(const SceneCommand &next) {
+    if (next.type != type)
+        return false;
+    if (type == FieldChange) {
+        if (next.component != component || next.field != field || next.element != element || next.objects != objects)
+            return false;
+        value = next.value; // previous остаётся от первой правки серии
+        return true;
+    }
+    if (type == Rename) {
+        if (next.objects != objects)
+            return false;
+        newName = next.newName;
+        return true;
+    }
+    return false;
+}
+
+QByteArray SceneCommand::encode() const {
+    DeltaWriter writer;
+    writer.varint(type);
+    writer.sequence(objects);
+    writer.sequence(nodes);
+    switch (type) {
+    case FieldChange:
+        writer.string(component ? QString(component->name) : QString());
+        writer.varint(field);
+        writer.signedVarint(element);
+        writer.raw(value.data(), value.size());
+        writer.raw(previous.data(), previous.size());
+        break;
+    case Rename:
+        writer.string(oldName);
+        writer.string(newName);
+        break;
+    case Create:
+    case Remove:
+        writer.varint(fragments.size());
+        for (const SceneFragment &fragment : fragments)
+            encodeFragment(writer, fragment);
+        break;
+    }
+
+    if (writer.bytes.size() < CompressThreshold)
+        return char(0) + writer.bytes;
+    // Имена и Transform соседних объектов похожи, быстрого уровня сжатия хватает
+    return char(CompressedFlag) + qCompress(writer.bytes, 1);
+}
+
+bool SceneCommand::decode(const QByteArray &data, SceneCommand *command) {
+    if (data.isEmpty())
+        return false;
+    const QByteArray payload = quint8(data[0]) & CompressedFlag ? qUncompress(data.mid(1)) : data.mid(1);
+    DeltaReader reader(payload);
+    *command = SceneCommand();
+    command->type = Type(reader.varint());
+    reader.sequence(command->objects);
+    reader.sequence(command->nodes);
+    switch (command->type) {
+    case FieldChange: {
+        const QString name = reader.string();
+        command->field = uint32_t(reader.varint());
+        command->element = int(reader.signedVarint());
+        command->value = reader.bytes();
+        command->previous = reader.bytes();
+        if (!findComponent(InspectableComponents(), name, command) || command->field >= command->component->fieldCount)
+            return false;
+        break;
+    }
+    case Rename:
+        command->oldName = reader.string();
+        command->newName = reader.string();
+        break;
+    case Create:
+    case Remove:
+        command->fragments.resize(reader.count());
+        for (SceneFragment &fragment : command->fragments) {
+            if (!decodeFragment(reader, fragment))
+                return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    return reader.ok();
+}
@@ -0,0 +1,59 @@
+#ifndef SCENECOMMAND_H
+#define SCENECOMMAND_H
+
+#include "fieldedit.h"
+#include "scene.h"
+#include "scenefragment.h"
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+// Одно изменение сцены в истории правок. Хранит только разницу, нужную, чтобы пройти его в обе
+// стороны: у правки поля — байты поля до и после, у переименования — два имени, у создания и
+// удаления — снятые поддеревья. Объекты адресуются ObjectId: NodeId после удаления и отмены
+// меняются, узлы в nodes — только подсказка для Scene::resolve
+struct SceneCommand {
+    enum Type : uint8_t {
+        FieldChange = 1,
+        Rename = 2,
+        Create = 3, // Отмена снимает созданное во fragments, повтор возвращает
+        Remove = 4
+    };
+
+    Type type = FieldChange;
+    std::vector<Scene::ObjectId> objects;
+    std::vector<SceneGraph::NodeId> nodes;
+
+    // FieldChange
+    const reflect::ComponentDescriptor *component = nullptr;
+    ecs::ComponentId componentId = 0;
+    uint32_t field = 0;
+    int element = -1;
+    std::vector<unsigned char> value;
+    std::vector<unsigned char> previous; // FieldEdit::previous: по size() байт на объект
+
+    // Rename
+    QString oldName;
+    QString newName;
+
+    // Create, Remove: в порядке выполнения, отмена идёт с конца
+    std::vector<SceneFragment> fragments;
+
+    static SceneCommand fieldChange(const Scene &scene, const FieldEdit &edit);
+    static SceneCommand rename(const Scene &scene, SceneGraph::NodeId node, const QString &oldName, const QString &newName);
+
+    // Правка поля для Scene::applyFieldEdit/revertFieldEdit; nodes должны быть уже разрешены
+    FieldEdit toFieldEdit() const;
+    // Для пунктов меню: "Rename", "Delete 3 Objects"
+    QString text() const;
+    // Поглощает следующую правку того же поля тех же объектов или переименование того же объекта:
+    // серия мелких правок отменяется одним шагом
+    bool merge(const SceneCommand &next);
+
+    // Компактная двоичная форма: числа — varint, ObjectId и индексы родителей — разностями
+    // с предыдущими, крупные записи дополнительно сжаты
+    QByteArray encode() const;
+    static bool decode(const QByteArray &data, SceneCommand *command);
+};
+
+#endif // SCENECOMMAND_H
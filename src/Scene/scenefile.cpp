@@ -0,0 +1,327 @@
+#include "scenefile.h"
+#include "scene.h"
+#include <QSaveFile>
+#include <climits>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 nodeCount;
+    quint32 sectionCount;
+    quint64 sectionTableOffset;
+    quint64 fileSize;
+};
+
+struct SectionEntry {
+    quint32 type;
+    quint32 elementSize;
+    quint64 offset;
+    quint64 count;
+};
+
+static_assert(sizeof(FileHeader) == 32, "Заголовок — часть формата");
+static_assert(sizeof(SectionEntry) == 24, "Запись секции — часть формата");
+static_assert(std::is_trivially_copyable<Transform>::value, "Transform пишется в файл побайтно");
+
+const quint64 SectionAlignment = 64;
+
+quint64 alignUp(quint64 value) {
+    return (value + SectionAlignment - 1) & ~(SectionAlignment - 1);
+}
+
+// Раскладка секций при записи
+struct PendingSection {
+    SectionEntry entry;
+    const void *data;
+};
+
+} // namespace
+
+SceneFile::SceneFile()
+    : mapped(nullptr), mappedSize(0), nodes(0), parentData(nullptr), transformData(nullptr),
+      objectData(nullptr), journalSeq(0), nameOffsets(nullptr), nameData(nullptr), nameDataSize(0) {
+}
+
+SceneFile::~SceneFile() {
+    close();
+}
+
+bool SceneFile::write(Scene &scene, const QString &path, QString *error, quint64 journalSequence) {
+    const SceneGraph &graph = scene.graph();
+    const uint32_t count = static_cast<uint32_t>(graph.nodeCount());
+
+    // Прямой обход без рекурсии; fileIndex переводит NodeId в индекс узла в файле
+    std::vector<uint32_t> parents;
+    std::vector<Transform> transforms;
+    std::vector<uint64_t> objectIds;
+    std::vector<uint32_t> nameOffsets;
+    std::vector<char16_t> names;
+    parents.reserve(count);
+    transforms.reserve(count);
+    objectIds.reserve(count);
+    nameOffsets.reserve(size_t(count) + 1);
+    std::vector<uint32_t> fileIndex(graph.capacity(), SceneFile::NoParent);
+
+    std::vector<SceneGraph::NodeId> stack;
+    for (int row = graph.childCount(SceneGraph::RootNode) - 1; row >= 0; --row)
+        stack.push_back(graph.child(SceneGraph::RootNode, row));
+    while (!stack.empty()) {
+        const SceneGraph::NodeId node = stack.back();
+        stack.pop_back();
+        const SceneGraph::NodeId parent = graph.parent(node);
+        fileIndex[node] = static_cast<uint32_t>(parents.size());
+        parents.push_back(parent == SceneGraph::RootNode ? SceneFile::NoParent : fileIndex[parent]);
+
+        const Transform *transform = scene.world().get<Transform>(scene.entity(node));
+        transforms.push_back(transform ? *transform : Transform());
+        objectIds.push_back(scene.objectId(node));
+
+        const QString &name = graph.name(node);
+        nameOffsets.push_back(static_cast<uint32_t>(names.size()));
+        const char16_t *utf16 = reinterpret_cast<const char16_t *>(name.utf16());
+        names.insert(names.end(), utf16, utf16 + name.size());
+
+        for (int row = graph.childCount(node) - 1; row >= 0; --row)
+            stack.push_back(graph.child(node, row));
+    }
+    nameOffsets.push_back(static_cast<uint32_t>(names.size()));
+    const reflect::ComponentDescriptor &transformType = reflect::descriptor<Transform>();
+    std::vector<reflect::FieldRecord> schema(transformType.fieldCount);
+    reflect::writeSchema(transformType, schema.data());
+
+    PendingSection sections[] = {
+        {{ParentsSection, sizeof(uint32_t), 0, parents.size()}, parents.data()},
+        {{TransformsSection, sizeof(Transform), 0, transforms.size()}, transforms.data()},
+        {{NameOffsetsSection, sizeof(uint32_t), 0, nameOffsets.size()}, nameOffsets.data()},
+        {{NameDataSection, sizeof(char16_t), 0, names.size()}, names.data()},
+        {{ObjectIdsSection, sizeof(uint64_t), 0, objectIds.size()}, objectIds.data()},
+        {{JournalSection, sizeof(quint64), 0, 1}, &journalSequence},
+        {{SchemaSection, sizeof(reflect::FieldRecord), 0, schema.size()}, schema.data()},
+    };
+    const quint32 sectionCount = sizeof(sections) / sizeof(sections[0]);
+
+    FileHeader header{};
+    header.magic = Magic;
+    header.version = Version;
+    header.nodeCount = static_cast<quint32>(parents.size());
+    header.sectionCount = sectionCount;
+    header.sectionTableOffset = sizeof(FileHeader);
+    quint64 offset = alignUp(sizeof(FileHeader) + sectionCount * sizeof(SectionEntry));
+    for (PendingSection &section : sections) {
+        section.entry.offset = offset;
+        offset = alignUp(offset + section.entry.elementSize * section.entry.count);
+    }
+    header.fileSize = offset;
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = out.errorString();
+        return false;
+    }
+    static const char padding[SectionAlignment] = {};
+    auto writeBytes = [&out](const void *data, qint64 size) {
+        return size == 0 || out.write(static_cast<const char *>(data), size) == size;
+    };
+    auto padTo = [&out, &writeBytes](quint64 target) {
+        const qint64 gap = qint64(target) - out.pos();
+        return gap <= 0 || writeBytes(padding, gap);
+    };
+
+    bool ok = writeBytes(&header, sizeof(header));
+    for (const PendingSection &section : sections)
+        ok = ok && writeBytes(&section.entry, sizeof(section.entry));
+    for (const PendingSection &section : sections) {
+        ok = ok && padTo(section.entry.offset);
+        ok = ok && writeBytes(section.data, qint64(section.entry.elementSize * section.entry.count));
+    }
+    ok = ok && padTo(header.fileSize);
+    if (!ok || !out.commit()) {
+        if (error)
+            *error = out.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SceneFile::fail(const QString &message) {
+    close();
+    error = message;
+    return false;
+}
+
+bool SceneFile::open(const QString &path) {
+    close();
+    error.clear();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+    mappedSize = file.size();
+    if (mappedSize < qint64(sizeof(FileHeader)))
+        return fail("File is too small to be a scene");
+    mapped = file.map(0, mappedSize);
+    if (!mapped)
+        return fail(file.errorString());
+
+    FileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    if (header.magic != Magic)
+        return fail("Not a Specter scene file");
+    if (header.version != Version)
+        return fail(QString("Unsupported scene version %1").arg(header.version));
+    if (header.fileSize != quint64(mappedSize))
+        return fail("Scene file is truncated");
+    if (header.sectionTableOffset > quint64(mappedSize)
+            || quint64(header.sectionCount) * sizeof(SectionEntry) > quint64(mappedSize) - header.sectionTableOffset)
+        return fail("Scene section table is corrupted");
+    nodes = header.nodeCount;
+
+    const unsigned char *parentsBytes = section(ParentsSection, sizeof(uint32_t), nodes);
+    uint32_t transformSize = 0;
+    const unsigned char *transformBytes = section(TransformsSection, 0, nodes, &transformSize);
+    const unsigned char *offsetBytes = section(NameOffsetsSection, sizeof(uint32_t), uint64_t(nodes) + 1);
+    if (!error.isEmpty())
+        return fail(error);
+    if (!parentsBytes || !transformBytes || !offsetBytes)
+        return fail("Scene file is missing required sections");
+    parentData = reinterpret_cast<const uint32_t *>(parentsBytes);
+    if (!readTransforms(transformBytes, transformSize))
+        return fail(error);
+    nameOffsets = reinterpret_cast<const uint32_t *>(offsetBytes);
+    // Необязательные секции
+    objectData = reinterpret_cast<const uint64_t *>(section(ObjectIdsSection, sizeof(uint64_t), nodes));
+    if (const unsigned char *journalBytes = section(JournalSection, sizeof(quint64), 1))
+        std::memcpy(&journalSeq, journalBytes, sizeof(journalSeq));
+
+    // Длина секции имён заранее неизвестна, поэтому читаем её размер из таблицы
+    const unsigned char *table = mapped + header.sectionTableOffset;
+    for (quint32 i = 0; i < header.sectionCount; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, table + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.type == NameDataSection) {
+            // Смещения имён — uint32_t, а длина имени уходит в QString как int
+            if (entry.count > quint64(INT_MAX)) {
+                error = "Scene name data is too large";
+                break;
+            }
+            nameData = reinterpret_cast<const char16_t *>(section(NameDataSection, sizeof(char16_t), entry.count));
+            nameDataSize = nameData ? entry.count : 0;
+        }
+    }
+    if (!error.isEmpty())
+        return fail(error);
+    if (nameOffsets[nodes] > nameDataSize)
+        return fail("Scene name table is corrupted");
+    return true;
+}
+
+bool SceneFile::readTransforms(const unsigned char *data, uint32_t storedSize) {
+    const reflect::ComponentDescriptor &transformType = reflect::descriptor<Transform>();
+    const reflect::FieldRecord *schema = nullptr;
+    uint64_t fieldCount = 0;
+    FileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    const unsigned char *table = mapped + header.sectionTableOffset;
+    for (quint32 i = 0; i < header.sectionCount; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, table + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.type == SchemaSection) {
+            fieldCount = entry.count;
+            schema = reinterpret_cast<const reflect::FieldRecord *>(
+                section(SchemaSection, sizeof(reflect::FieldRecord), entry.count));
+        }
+    }
+    if (!error.isEmpty())
+        return false;
+
+    if (!schema) {
+        if (storedSize != sizeof(Transform)) {
+            error = "Scene transforms have an unknown layout";
+            return false;
+        }
+        transformData = reinterpret_cast<const Transform *>(data);
+        return true;
+    }
+    if (reflect::sameSchema(transformType, storedSize, schema, uint32_t(fieldCount))) {
+        transformData = reinterpret_cast<const Transform *>(data);
+        return true;
+    }
+    // Раскладка сменилась после сохранения: переносим поля по именам
+    convertedTransforms.assign(nodes, Transform());
+    for (uint32_t i = 0; i < nodes; ++i) {
+        reflect::convert(schema, uint32_t(fieldCount), storedSize, data + size_t(i) * storedSize, transformType,
+                         reinterpret_cast<unsigned char *>(&convertedTransforms[i]));
+    }
+    transformData = convertedTransforms.data();
+    return true;
+}
+
+const unsigned char *SceneFile::section(SectionType type, uint32_t elementSize, uint64_t count,
+                                        uint32_t *storedElementSize) {
+    // Границы таблицы секций уже проверены в open()
+    FileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    for (quint32 i = 0; i < header.sectionCount; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, mapped + header.sectionTableOffset + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.type != quint32(type))
+            continue; // Неизвестные секции пропускаются — место для расширения формата
+        if (storedElementSize)
+            elementSize = *storedElementSize = entry.elementSize;
+        if (elementSize == 0 || entry.elementSize != elementSize || entry.count != count || entry.offset % SectionAlignment != 0
+                || entry.offset > quint64(mappedSize) || entry.count > (quint64(mappedSize) - entry.offset) / elementSize) {
+            error = QString("Scene section %1 is corrupted").arg(quint32(type));
+            return nullptr;
+        }
+        return mapped + entry.offset;
+    }
+    return nullptr;
+}
+
+void SceneFile::close() {
+    if (mapped)
+        file.unmap(mapped);
+    file.close();
+    mapped = nullptr;
+    mappedSize = 0;
+    nodes = 0;
+    parentData = nullptr;
+    transformData = nullptr;
+    convertedTransforms.clear();
+    convertedTransforms.shrink_to_fit();
+    objectData = nullptr;
+    journalSeq = 0;
+    nameOffsets = nullptr;
+    nameData = nullptr;
+    nameDataSize = 0;
+}
+
+QString SceneFile::name(uint32_t index) const {
+    if (index >= nodes || !nameData)
+        return QString();
+    const uint32_t begin = nameOffsets[index];
+    const uint32_t end = nameOffsets[index + 1];
+    if (begin > end || end > nameDataSize)
+        return QString();
+    return QString(reinterpret_cast<const QChar *>(nameData + begin), int(end - begin));
+}
+
+bool SceneFile::instantiate(Scene &scene) {
+    if (!isOpen()) {
+        error = "Scene file is not open";
+        return false;
+    }
+    for (uint32_t i = 0; i < nodes; ++i) {
+        if (parentData[i] != NoParent && parentData[i] >= i) {
+            error = "Scene hierarchy is corrupted";
+            return false;
+        }
+    }
+    scene.load(nodes, parentData, transformData, objectData, [this](uint32_t index) { return name(index); });
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef SCENEFILE_H
+#define SCENEFILE_H
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include "components.h"
+#include "scenegraph.h"
+
+class Scene;
+
+// Двоичный формат сцены (.sscene), little-endian.
+// Заголовок, таблица секций, затем секции, каждая выровнена на 64 байта. Секция — плотный массив
+// элементов фиксированного размера, поэтому после mmap её можно читать как обычный массив, без разбора.
+// Узлы лежат в прямом порядке обхода дерева: родитель всегда раньше детей, дети идут в порядке строк.
+// Рядом с Transform записана его схема из reflect: файл со старой раскладкой читается с переносом
+// полей по именам, с текущей — прямо из отображения. Файлы без схемы считаются текущей раскладки.
+class SceneFile {
+public:
+    static constexpr quint32 Magic = 0x43535053; // "SPSC"
+    static constexpr quint32 Version = 1;
+    static constexpr uint32_t NoParent = SceneGraph::InvalidNode; // Объект верхнего уровня
+
+    enum SectionType : quint32 {
+        ParentsSection = 1,     // uint32_t[nodeCount] — индекс родителя в файле
+        TransformsSection = 2,  // Transform[nodeCount]
+        NameOffsetsSection = 3, // uint32_t[nodeCount + 1] — начала имён в NameDataSection, в символах
+        NameDataSection = 4,    // UTF-16 символы всех имён подряд
+        ObjectIdsSection = 5,   // uint64_t[nodeCount] — постоянные ObjectId (нет секции — 1, 2, 3...)
+        JournalSection = 6,     // uint64_t[1] — номер последней записи журнала, уже включённой в файл
+        SchemaSection = 7       // reflect::FieldRecord[] — раскладка Transform в TransformsSection
+    };
+
+    SceneFile();
+    ~SceneFile();
+    SceneFile(const SceneFile &) = delete;
+    SceneFile &operator=(const SceneFile &) = delete;
+
+    static bool write(Scene &scene, const QString &path, QString *error = nullptr, quint64 journalSequence = 0);
+
+    // Отображает файл в память и проверяет заголовок и границы секций; данные не копируются
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return mapped != nullptr; }
+    QString errorString() const { return error; }
+
+    uint32_t nodeCount() const { return nodes; }
+    const uint32_t *parents() const { return parentData; }
+    const Transform *transforms() const { return transformData; }
+    const uint64_t *objectIds() const { return objectData; }
+    quint64 journalSequence() const { return journalSeq; }
+    QString name(uint32_t index) const;
+
+    // Заменяет содержимое scene данными файла. Ссылки на родителей проверяются здесь,
+    // поскольку узлы всё равно перебираются по одному
+    bool instantiate(Scene &scene);
+
+private:
+    // storedElementSize задан — размер элемента берётся из таблицы секций, а не проверяется
+    const unsigned char *section(SectionType type, uint32_t elementSize, uint64_t count,
+                                 uint32_t *storedElementSize = nullptr);
+    bool readTransforms(const unsigned char *data, uint32_t storedSize);
+    bool fail(const QString &message);
+
+    QFile file;
+    uchar *mapped;
+    qint64 mappedSize;
+    uint32_t nodes;
+    const uint32_t *parentData;
+    const Transform *transformData;
+    std::vector<Transform> convertedTransforms; // Если раскладка в файле устарела
+    const uint64_t *objectData;
+    quint64 journalSeq;
+    const uint32_t *nameOffsets;
+    const char16_t *nameData;
+    uint64_t nameDataSize;
+    QString error;
+};
+
+#endif // SCENEFILE_H
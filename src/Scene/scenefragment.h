@@ -0,0 +1,26 @@
+#ifndef SCENEFRAGMENT_H
+#define SCENEFRAGMENT_H
+
+#include "components.h"
+#include "scenegraph.h"
+#include <QString>
+#include <vector>
+
+// Дети parent [firstRow, firstRow + count) со всеми потомками, снятые со сцены. Узлы лежат в прямом
+// порядке обхода, поэтому Scene::restoreChildren возвращает их на те же места с теми же ObjectId,
+// именами и Transform. Пустой фрагмент (только parent/firstRow/count) описывает диапазон, который
+// ещё на сцене — например, только что созданные объекты
+struct SceneFragment {
+    uint64_t parent = 0; // ObjectId родителя
+    int firstRow = 0;
+    int count = 0;
+    std::vector<uint32_t> parents; // Индекс родителя во фрагменте, InvalidNode — ребёнок parent
+    std::vector<uint64_t> objects;
+    std::vector<QString> names;
+    std::vector<Transform> transforms;
+
+    size_t size() const { return objects.size(); }
+    bool isCaptured() const { return !objects.empty(); }
+};
+
+#endif // SCENEFRAGMENT_H
@@ -0,0 +1,125 @@
+#include "scenegraph.h"
+
+SceneGraph::SceneGraph() : liveCount(0) {
+    clear();
+}
+
+void SceneGraph::clear() {
+    parents.assign(1, InvalidNode);
+    rows.assign(1, 0);
+    children.clear();
+    children.resize(1);
+    names.assign(1, QString());
+    freeList.clear();
+    liveCount = 0;
+}
+
+void SceneGraph::reserve(int nodeCount) {
+    const size_t total = static_cast<size_t>(nodeCount) + 1;
+    parents.reserve(total);
+    rows.reserve(total);
+    children.reserve(total);
+    names.reserve(total);
+}
+
+SceneGraph::NodeId SceneGraph::allocateNode() {
+    if (!freeList.empty()) {
+        NodeId node = freeList.back();
+        freeList.pop_back();
+        return node;
+    }
+    parents.push_back(InvalidNode);
+    rows.push_back(0);
+    children.emplace_back();
+    names.emplace_back();
+    return static_cast<NodeId>(parents.size() - 1);
+}
+
+std::vector<SceneGraph::NodeId> SceneGraph::createNodes(NodeId parent, int count, const QString &baseName) {
+    std::vector<NodeId> created;
+    if (!isValid(parent) || count <= 0)
+        return created;
+    created.reserve(count);
+
+    // Сначала выделяем узлы: allocateNode может перераспределить children, ссылку на соседей берём после
+    for (int i = 0; i < count; ++i)
+        created.push_back(allocateNode());
+    ChildList &siblings = children[parent];
+    siblings.reserve(siblings.size() + count);
+    for (int i = 0; i < count; ++i) {
+        NodeId node = created[i];
+        parents[node] = parent;
+        rows[node] = static_cast<uint32_t>(siblings.size());
+        names[node] = baseName + QString::number(i + 1);
+        siblings.push_back(node);
+    }
+    liveCount += count;
+    return created;
+}
+
+SceneGraph::NodeId SceneGraph::createNode(NodeId parent, const QString &name) {
+    if (!isValid(parent))
+        return InvalidNode;
+    NodeId node = allocateNode();
+    parents[node] = parent;
+    rows[node] = static_cast<uint32_t>(children[parent].size());
+    names[node] = name;
+    children[parent].push_back(node);
+    ++liveCount;
+    return node;
+}
+
+std::vector<SceneGraph::NodeId> SceneGraph::insertNodes(NodeId parent, int row, int count) {
+    std::vector<NodeId> created;
+    if (!isValid(parent) || count <= 0 || row < 0 || row > childCount(parent))
+        return created;
+    created.reserve(count);
+    for (int i = 0; i < count; ++i)
+        created.push_back(allocateNode());
+    ChildList &siblings = children[parent];
+    siblings.insert(siblings.begin() + row, created.begin(), created.end());
+    for (NodeId node : created)
+        parents[node] = parent;
+    for (size_t i = row; i < siblings.size(); ++i)
+        rows[siblings[i]] = static_cast<uint32_t>(i);
+    liveCount += count;
+    return created;
+}
+
+void SceneGraph::removeChildren(NodeId parent, int firstRow, int count, std::vector<NodeId> *released) {
+    ChildList &siblings = children[parent];
+    if (firstRow < 0 || count <= 0 || firstRow + count > static_cast<int>(siblings.size()))
+        return;
+
+    for (int i = firstRow; i < firstRow + count; ++i)
+        releaseSubtree(siblings[i], released);
+    siblings.erase(siblings.begin() + firstRow, siblings.begin() + firstRow + count);
+
+    // Сдвигаем позиции оставшихся соседей один раз на весь диапазон
+    for (size_t i = firstRow; i < siblings.size(); ++i)
+        rows[siblings[i]] = static_cast<uint32_t>(i);
+}
+
+void SceneGraph::releaseSubtree(NodeId node, std::vector<NodeId> *released) {
+    // Обход без рекурсии: глубокие иерархии не должны переполнять стек
+    std::vector<NodeId> stack{node};
+    while (!stack.empty()) {
+        NodeId current = stack.back();
+        stack.pop_back();
+        for (NodeId childNode : children[current])
+            stack.push_back(childNode);
+        ChildList().swap(children[current]);
+        names[current] = QString();
+        parents[current] = InvalidNode;
+        freeList.push_back(current);
+        if (released)
+            released->push_back(current);
+        --liveCount;
+    }
+}
+
+bool SceneGraph::isValid(NodeId node) const {
+    if (node >= parents.size())
+        return false;
+    return node == RootNode || parents[node] != InvalidNode;
+}
@@ -0,0 +1,62 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include "Core/memorytracker.h"
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+// Компактный граф сцены: узлы адресуются индексами, данные узлов лежат в параллельных массивах.
+// Удалённые индексы переиспользуются через список свободных.
+// Массивы узлов учитываются в памяти подсистемы Scene.
+class SceneGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId InvalidNode = 0xFFFFFFFFu;
+    static constexpr NodeId RootNode = 0; // Невидимый корень, объекты верхнего уровня — его дети
+
+    SceneGraph();
+
+    void clear();
+    void reserve(int nodeCount);
+
+    // Создаёт count узлов в конце списка детей parent (имена baseName1, baseName2, ...)
+    std::vector<NodeId> createNodes(NodeId parent, int count, const QString &baseName);
+    NodeId createNode(NodeId parent, const QString &name);
+    // Вставляет count безымянных узлов в список детей parent начиная с row
+    std::vector<NodeId> insertNodes(NodeId parent, int row, int count);
+
+    // Удаляет count детей parent начиная с firstRow вместе с их поддеревьями.
+    // Если released задан, в него дописываются индексы всех освобождённых узлов
+    void removeChildren(NodeId parent, int firstRow, int count, std::vector<NodeId> *released = nullptr);
+
+    bool isValid(NodeId node) const;
+    NodeId parent(NodeId node) const { return parents[node]; }
+    int row(NodeId node) const { return static_cast<int>(rows[node]); }
+    int childCount(NodeId node) const { return static_cast<int>(children[node].size()); }
+    NodeId child(NodeId node, int row) const { return children[node][row]; }
+    const QString &name(NodeId node) const { return names[node]; }
+    void setName(NodeId node, const QString &name) { names[node] = name; }
+
+    // Число живых узлов без учёта корня
+    int nodeCount() const { return liveCount; }
+    // Верхняя граница индексов (для массивов, индексируемых NodeId)
+    int capacity() const { return static_cast<int>(parents.size()); }
+
+private:
+    NodeId allocateNode();
+    void releaseSubtree(NodeId node, std::vector<NodeId> *released);
+
+    template<typename T>
+    using Array = core::TaggedVector<T, core::MemoryTag::Scene>;
+    using ChildList = Array<NodeId>;
+
+    Array<NodeId> parents;
+    Array<uint32_t> rows; // Позиция узла в списке детей родителя
+    Array<ChildList> children;
+    Array<QString> names;
+    Array<NodeId> freeList;
+    int liveCount;
+};
+
+#endif // SCENEGRAPH_H
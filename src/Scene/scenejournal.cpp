@@ -0,0 +1,398 @@
+#include "scenejournal.h"
+#include "components.h"
+#include "scenefile.h"
+#include "scenefragment.h"
+#include "Core/jobsystem.h"
+#include <QDataStream>
+#include <QPair>
+#include <QSaveFile>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace {
+
+const quint32 JournalMagic = 0x4C4A5053; // "SPJL"
+const quint32 JournalVersion = 1;
+const qint64 HeaderSize = 8;
+const qint64 FrameSize = 8; // Длина тела + CRC32 тела
+
+quint32 crc32(const char *data, qint64 size) {
+    static quint32 table[256];
+    static const bool initialized = [] {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 value = i;
+            for (int bit = 0; bit < 8; ++bit)
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+            table[i] = value;
+        }
+        return true;
+    }();
+    Q_UNUSED(initialized);
+    quint32 crc = 0xFFFFFFFFu;
+    for (qint64 i = 0; i < size; ++i)
+        crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Обходит целые записи с верной CRC; возвращает смещение конца последней из них
+qint64 forEachRecord(const uchar *data, qint64 size, const std::function<void(const QByteArray &)> &visit) {
+    qint64 offset = HeaderSize;
+    while (offset + FrameSize <= size) {
+        quint32 length, crc;
+        std::memcpy(&length, data + offset, sizeof(length));
+        std::memcpy(&crc, data + offset + 4, sizeof(crc));
+        if (qint64(length) > size - offset - FrameSize)
+            break;
+        const char *body = reinterpret_cast<const char *>(data + offset + FrameSize);
+        if (crc32(body, length) != crc)
+            break;
+        visit(QByteArray::fromRawData(body, int(length)));
+        offset += FrameSize + length;
+    }
+    return offset;
+}
+
+bool validHeader(const uchar *data, qint64 size) {
+    if (size < HeaderSize)
+        return false;
+    quint32 header[2];
+    std::memcpy(header, data, sizeof(header));
+    return header[0] == JournalMagic && header[1] == JournalVersion;
+}
+
+QByteArray headerBytes() {
+    const quint32 header[2] = {JournalMagic, JournalVersion};
+    return QByteArray(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+} // namespace
+
+SceneJournal::SceneJournal(QObject *parent)
+    : QObject(parent), scene(nullptr), lastSequence(0), compacting(false), generation(0) {
+}
+
+SceneJournal::~SceneJournal() {
+    close();
+}
+
+bool SceneJournal::open(const QString &path, Scene *targetScene, quint64 baseSequence) {
+    close();
+    error.clear();
+    scene = targetScene;
+    lastSequence = baseSequence;
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        error = file.errorString();
+        return false;
+    }
+
+    // Находим конец последней целой записи: всё после него — след прерванной записи
+    qint64 validEnd = 0;
+    if (file.size() > 0) {
+        uchar *data = file.map(0, file.size());
+        if (data && validHeader(data, file.size())) {
+            validEnd = forEachRecord(data, file.size(), [this](const QByteArray &body) {
+                QDataStream stream(body);
+                quint8 type;
+                quint64 sequence;
+                stream >> type >> sequence;
+                lastSequence = qMax(lastSequence, sequence);
+            });
+        }
+        if (data)
+            file.unmap(data);
+    }
+    if (validEnd == 0) {
+        file.resize(0);
+        file.write(headerBytes());
+        validEnd = HeaderSize;
+    } else if (validEnd != file.size()) {
+        qWarning("Scene journal %s: dropping %lld bytes of an incomplete record",
+                 qPrintable(path), static_cast<long long>(file.size() - validEnd));
+        file.resize(validEnd);
+    }
+    file.seek(validEnd);
+    file.flush();
+    return true;
+}
+
+void SceneJournal::close() {
+    if (file.isOpen())
+        file.close();
+    pending.clear();
+    dirtyNodes.clear();
+    dirtyMarks.clear();
+    scene = nullptr;
+    ++generation;
+}
+
+void SceneJournal::append(const QByteArray &body) {
+    const quint32 frame[2] = {quint32(body.size()), crc32(body.constData(), body.size())};
+    pending.append(reinterpret_cast<const char *>(frame), sizeof(frame));
+    pending.append(body);
+}
+
+void SceneJournal::objectsCreated(Scene::ObjectId parent, Scene::ObjectId first, int count, const QString &baseName) {
+    if (!isOpen())
+        return;
+    // Отложенные Transform пишутся раньше структурных изменений, иначе порядок при воспроизведении нарушится
+    writeDirtyTransforms();
+    QByteArray body;
+    QDataStream stream(&body, QIODevice::WriteOnly);
+    stream << quint8(CreateRecord) << ++lastSequence << quint64(parent) << quint64(first) << qint32(count) << baseName;
+    append(body);
+}
+
+void SceneJournal::childrenRemoved(Scene::ObjectId parent, int firstRow, int count) {
+    if (!isOpen())
+        return;
+    writeDirtyTransforms();
+    QByteArray body;
+    QDataStream stream(&body, QIODevice::WriteOnly);
+    stream << quint8(RemoveRecord) << ++lastSequence << quint64(parent) << qint32(firstRow) << qint32(count);
+    append(body);
+}
+
+void SceneJournal::childrenRestored(const SceneFragment &fragment) {
+    if (!isOpen())
+        return;
+    writeDirtyTransforms();
+    QByteArray body;
+    QDataStream stream(&body, QIODevice::WriteOnly);
+    stream << quint8(RestoreRecord) << ++lastSequence << quint64(fragment.parent) << qint32(fragment.firstRow)
+           << qint32(fragment.count) << quint32(fragment.size());
+    for (size_t i = 0; i < fragment.size(); ++i) {
+        stream << quint32(fragment.parents[i]) << quint64(fragment.objects[i]) << fragment.names[i];
+        stream.writeRawData(reinterpret_cast<const char *>(&fragment.transforms[i]), sizeof(Transform));
+    }
+    append(body);
+}
+
+void SceneJournal::nameChanged(Scene::ObjectId object, const QString &name) {
+    if (!isOpen())
+        return;
+    QByteArray body;
+    QDataStream stream(&body, QIODevice::WriteOnly);
+    stream << quint8(RenameRecord) << ++lastSequence << quint64(object) << name;
+    append(body);
+}
+
+void SceneJournal::transformChanged(SceneGraph::NodeId node) {
+    if (!isOpen())
+        return;
+    if (dirtyMarks.size() <= node)
+        dirtyMarks.resize(size_t(node) + 1, 0);
+    if (!dirtyMarks[node]) {
+        dirtyMarks[node] = 1;
+        dirtyNodes.push_back(node);
+    }
+}
+
+void SceneJournal::writeDirtyTransforms() {
+    for (SceneGraph::NodeId node : dirtyNodes) {
+        dirtyMarks[node] = 0;
+        const Transform *transform = scene->world().get<Transform>(scene->entity(node));
+        if (!transform)
+            continue;
+        QByteArray body;
+        QDataStream stream(&body, QIODevice::WriteOnly);
+        stream << quint8(TransformRecord) << ++lastSequence << quint64(scene->objectId(node));
+        stream.writeRawData(reinterpret_cast<const char *>(transform), sizeof(Transform));
+        append(body);
+    }
+    dirtyNodes.clear();
+}
+
+bool SceneJournal::flush() {
+    if (!isOpen()) {
+        error = "Scene journal is not open";
+        return false;
+    }
+    writeDirtyTransforms();
+    if (pending.isEmpty())
+        return true;
+    if (file.write(pending) != pending.size() || !file.flush()) {
+        error = file.errorString();
+        return false;
+    }
+    pending.clear();
+    return true;
+}
+
+int SceneJournal::replay(const QString &path, Scene &scene, quint64 baseSequence,
+                         qint64 endOffset, quint64 *appliedSequence) {
+    if (appliedSequence)
+        *appliedSequence = baseSequence;
+    QFile input(path);
+    if (!input.exists())
+        return 0;
+    if (!input.open(QIODevice::ReadOnly))
+        return -1;
+    const qint64 size = endOffset < 0 ? input.size() : qMin(endOffset, input.size());
+    if (size <= HeaderSize)
+        return 0;
+    uchar *data = input.map(0, size);
+    if (!data || !validHeader(data, size))
+        return -1;
+
+    // ObjectId → узел для объектов базового файла; созданные журналом добавляются по ходу
+    std::unordered_map<Scene::ObjectId, SceneGraph::NodeId> nodes;
+    nodes.reserve(size_t(scene.graph().nodeCount()) + 1);
+    nodes[Scene::RootObject] = SceneGraph::RootNode;
+    for (int node = 1; node < scene.graph().capacity(); ++node) {
+        if (scene.graph().isValid(SceneGraph::NodeId(node)))
+            nodes[scene.objectId(SceneGraph::NodeId(node))] = SceneGraph::NodeId(node);
+    }
+    auto nodeFor = [&nodes](quint64 object) {
+        auto it = nodes.find(object);
+        return it == nodes.end() ? SceneGraph::InvalidNode : it->second;
+    };
+
+    SceneJournal *journal = scene.journal();
+    scene.setJournal(nullptr); // Воспроизведение не должно записываться заново
+    int applied = 0;
+    forEachRecord(data, size, [&](const QByteArray &body) {
+        QDataStream stream(body);
+        quint8 type;
+        quint64 sequence;
+        stream >> type >> sequence;
+        if (sequence <= baseSequence)
+            return; // Уже вложено в базовый файл при сжатии
+        switch (type) {
+        case CreateRecord: {
+            quint64 parent, first;
+            qint32 count;
+            QString baseName;
+            stream >> parent >> first >> count >> baseName;
+            const SceneGraph::NodeId parentNode = nodeFor(parent);
+            if (parentNode == SceneGraph::InvalidNode)
+                return;
+            std::vector<SceneGraph::NodeId> created = scene.createObjects(parentNode, count, baseName, first);
+            for (size_t i = 0; i < created.size(); ++i)
+                nodes[first + i] = created[i];
+            break;
+        }
+        case RemoveRecord: {
+            quint64 parent;
+            qint32 firstRow, count;
+            stream >> parent >> firstRow >> count;
+            const SceneGraph::NodeId parentNode = nodeFor(parent);
+            if (parentNode == SceneGraph::InvalidNode)
+                return;
+            scene.removeChildren(parentNode, firstRow, count);
+            break;
+        }
+        case RestoreRecord: {
+            SceneFragment fragment;
+            quint64 parent;
+            qint32 firstRow, count;
+            quint32 size;
+            stream >> parent >> firstRow >> count >> size;
+            fragment.parent = parent;
+            fragment.firstRow = firstRow;
+            fragment.count = count;
+            fragment.parents.resize(size);
+            fragment.objects.resize(size);
+            fragment.names.resize(size);
+            fragment.transforms.resize(size);
+            for (quint32 i = 0; i < size; ++i) {
+                quint32 parentIndex;
+                quint64 object;
+                stream >> parentIndex >> object >> fragment.names[i];
+                fragment.parents[i] = parentIndex;
+                fragment.objects[i] = object;
+                stream.readRawData(reinterpret_cast<char *>(&fragment.transforms[i]), sizeof(Transform));
+            }
+            if (stream.status() != QDataStream::Ok)
+                return;
+            const std::vector<SceneGraph::NodeId> restored = scene.restoreChildren(fragment);
+            if (restored.empty())
+                return;
+            for (size_t i = 0; i < restored.size(); ++i)
+                nodes[fragment.objects[i]] = restored[i];
+            break;
+        }
+        case RenameRecord: {
+            quint64 object;
+            QString name;
+            stream >> object >> name;
+            scene.setName(nodeFor(object), name);
+            break;
+        }
+        case TransformRecord: {
+            quint64 object;
+            Transform value;
+            stream >> object;
+            if (stream.readRawData(reinterpret_cast<char *>(&value), sizeof(value)) != int(sizeof(value)))
+                return;
+            if (Transform *transform = scene.editTransform(nodeFor(object)))
+                *transform = value;
+            break;
+        }
+        default:
+            return; // Неизвестный тип записи из более новой версии
+        }
+        ++applied;
+        if (appliedSequence)
+            *appliedSequence = qMax(*appliedSequence, sequence);
+    });
+    scene.setJournal(journal);
+    input.unmap(data);
+    return applied;
+}
+
+void SceneJournal::compact(const QString &basePath) {
+    if (compacting || !flush())
+        return;
+    compacting = true;
+    const QString journalPath = file.fileName();
+    const qint64 foldedOffset = file.size();
+    const quint64 startGeneration = generation;
+
+    // Рабочий поток строит сцену из базового файла и журнала независимо от сцены редактора
+    core::JobSystem::instance().runThen([basePath, journalPath, foldedOffset]() {
+        QString message;
+        bool ok = false;
+        {
+            SceneFile base;
+            Scene merged;
+            quint64 folded = 0;
+            if (!base.open(basePath) || !base.instantiate(merged)) {
+                message = base.errorString();
+            } else if (replay(journalPath, merged, base.journalSequence(), foldedOffset, &folded) < 0) {
+                message = "Scene journal is unreadable";
+            } else {
+                base.close();
+                ok = SceneFile::write(merged, basePath, &message, folded);
+            }
+        }
+        return qMakePair(ok, message);
+    }, this, [this, startGeneration, foldedOffset](const QPair<bool, QString> &result) {
+        finishCompaction(startGeneration, foldedOffset, result.first, result.second);
+    });
+}
+
+void SceneJournal::finishCompaction(quint64 startGeneration, qint64 foldedOffset, bool ok, const QString &message) {
+    compacting = false;
+    if (ok && startGeneration == generation && isOpen()) {
+        // Вложенные записи больше не нужны: оставляем заголовок и то, что дописано во время сжатия.
+        // Если сбой случится до замены журнала, старые записи отсеются по номеру из базового файла
+        file.flush();
+        file.seek(foldedOffset);
+        QByteArray tail = file.readAll();
+        const QString path = file.fileName();
+        QSaveFile rewritten(path);
+        if (rewritten.open(QIODevice::WriteOnly) && rewritten.write(headerBytes()) == HeaderSize
+                && rewritten.write(tail) == tail.size() && rewritten.commit()) {
+            file.close();
+            file.setFileName(path);
+            if (file.open(QIODevice::ReadWrite))
+                file.seek(file.size());
+            else
+                error = file.errorString();
+        }
+    }
+    emit compactionFinished(ok, message);
+}
@@ -0,0 +1,86 @@
+#ifndef SCENEJOURNAL_H
+#define SCENEJOURNAL_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <vector>
+#include "scene.h"
+
+// Журнал изменений сцены рядом с базовым файлом (<scene>.sscene.journal).
+// Сохранение дописывает в конец только накопленные записи, а не переписывает сцену целиком.
+// Каждая запись несёт возрастающий номер и CRC32: при загрузке к базовому файлу применяются
+// записи новее номера, сохранённого в нём, а оборванный хвост после сбоя отбрасывается.
+// Фоновое сжатие вкладывает журнал в новый базовый файл и оставляет в журнале только хвост.
+class SceneJournal : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 CompactionThreshold = 8 * 1024 * 1024;
+
+    explicit SceneJournal(QObject *parent = nullptr);
+    ~SceneJournal();
+
+    static QString pathFor(const QString &scenePath) { return scenePath + ".journal"; }
+
+    // Открывает журнал для дозаписи (создаёт при отсутствии). baseSequence — номер из базового файла
+    bool open(const QString &path, Scene *scene, quint64 baseSequence);
+    // Закрывает без записи накопленного
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    QString errorString() const { return error; }
+
+    // Вызываются сценой
+    void objectsCreated(Scene::ObjectId parent, Scene::ObjectId first, int count, const QString &baseName);
+    void childrenRemoved(Scene::ObjectId parent, int firstRow, int count);
+    void childrenRestored(const SceneFragment &fragment);
+    void nameChanged(Scene::ObjectId object, const QString &name);
+    // Изменённые Transform запоминаются по узлу и пишутся один раз при flush
+    void transformChanged(SceneGraph::NodeId node);
+
+    bool hasUnsavedChanges() const { return !pending.isEmpty() || !dirtyNodes.empty(); }
+    // Дописывает накопленные записи в файл
+    bool flush();
+    quint64 sequence() const { return lastSequence; }
+    qint64 size() const { return file.isOpen() ? file.size() : 0; }
+
+    bool needsCompaction() const { return size() > CompactionThreshold; }
+    bool isCompacting() const { return compacting; }
+    // Строит новый базовый файл из basePath и журнала в пуле потоков; итог — compactionFinished()
+    void compact(const QString &basePath);
+
+    // Применяет к scene записи с номером больше baseSequence, не дальше endOffset (-1 — до конца).
+    // Возвращает число применённых записей или -1, если журнал не читается
+    static int replay(const QString &path, Scene &scene, quint64 baseSequence,
+                      qint64 endOffset = -1, quint64 *appliedSequence = nullptr);
+
+signals:
+    void compactionFinished(bool ok, const QString &error);
+
+private:
+    enum RecordType : quint8 {
+        CreateRecord = 1,
+        RemoveRecord = 2,
+        RenameRecord = 3,
+        TransformRecord = 4,
+        RestoreRecord = 5
+    };
+
+    void append(const QByteArray &body);
+    QByteArray beginRecord(RecordType type);
+    void writeDirtyTransforms();
+    void finishCompaction(quint64 generation, qint64 foldedOffset, bool ok, const QString &message);
+
+    QFile file;
+    Scene *scene;
+    QString error;
+    QByteArray pending; // Готовые записи, ещё не записанные в файл
+    quint64 lastSequence;
+    std::vector<SceneGraph::NodeId> dirtyNodes;
+    std::vector<quint8> dirtyMarks; // Индексируется NodeId
+    bool compacting;
+    quint64 generation; // Меняется при open/close, чтобы не применить устаревший итог сжатия
+};
+
+#endif // SCENEJOURNAL_H
@@ -0,0 +1,163 @@
+#include "assetlistmodel.h"
+#include "Assets/thumbnailcache.h"
+#include <QApplication>
+#include <QLocale>
+#include <QStyle>
+
+AssetListModel::AssetListModel(AssetDatabase *database, QObject *parent)
+    : QAbstractListModel(parent), database(database), refilterTimer(new QTimer(this)),
+      thumbnails(2000) {
+    // Иконки создаются один раз, а не на каждую строку
+    QStyle *style = QApplication::style();
+    fileIcon = style->standardIcon(QStyle::SP_FileIcon);
+    imageIcon = style->standardIcon(QStyle::SP_FileDialogContentsView);
+    modelIcon = style->standardIcon(QStyle::SP_FileDialogDetailedView);
+
+    refilterTimer->setSingleShot(true);
+    refilterTimer->setInterval(200);
+    connect(refilterTimer, &QTimer::timeout, this, &AssetListModel::refreshFilter);
+
+    // В режиме фильтра строки модели не совпадают со строками базы, поэтому пересчитываем выдачу
+    connect(database, &AssetDatabase::aboutToAppend, this, [this](int first, int last) {
+        if (!isFiltered())
+            beginInsertRows(QModelIndex(), first, last);
+    });
+    connect(database, &AssetDatabase::appended, this, [this]() {
+        if (isFiltered())
+            refilterTimer->start();
+        else
+            endInsertRows();
+    });
+    connect(database, &AssetDatabase::aboutToRemove, this, [this](int first, int last) {
+        if (!isFiltered()) {
+            beginRemoveRows(QModelIndex(), first, last);
+            return;
+        }
+        // Выдачу не пересчитываем на каждый диапазон: убираем удалённые строки и сдвигаем
+        // остальные, а полный поиск выполнит refilterTimer один раз на всю пачку
+        beginResetModel();
+        const int count = last - first + 1;
+        QVector<int> remaining;
+        remaining.reserve(filteredRows.size());
+        for (int row : filteredRows) {
+            if (row < first)
+                remaining.append(row);
+            else if (row > last)
+                remaining.append(row - count);
+        }
+        filteredRows = remaining;
+    });
+    connect(database, &AssetDatabase::removed, this, [this]() {
+        if (isFiltered()) {
+            endResetModel();
+            refilterTimer->start();
+        } else {
+            endRemoveRows();
+        }
+    });
+    connect(database, &AssetDatabase::recordChanged, this, [this](int row) {
+        if (isFiltered())
+            row = filteredRows.indexOf(row);
+        if (row < 0)
+            return;
+        QModelIndex changed = index(row);
+        emit dataChanged(changed, changed);
+    });
+}
+
+int AssetListModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid())
+        return 0;
+    return isFiltered() ? filteredRows.size() : database->count();
+}
+
+void AssetListModel::setFilter(const QString &filter) {
+    QString trimmed = filter.trimmed();
+    if (trimmed == filterText)
+        return;
+    beginResetModel();
+    filterText = trimmed;
+    filteredRows.clear();
+    if (isFiltered())
+        filteredRows = database->search(filterText, MaxSearchResults);
+    endResetModel();
+}
+
+void AssetListModel::refreshFilter() {
+    if (!isFiltered())
+        return;
+    beginResetModel();
+    filteredRows = database->search(filterText, MaxSearchResults);
+    endResetModel();
+}
+
+QVariant AssetListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+    const int row = isFiltered() ? filteredRows[index.row()] : index.row();
+    if (row < 0 || row >= database->count())
+        return QVariant();
+    const AssetRecord &record = database->record(row);
+    switch (role) {
+    case Qt::DisplayRole:
+        return record.path.mid(record.path.lastIndexOf('/') + 1);
+    case Qt::ToolTipRole:
+        return record.path + "\n" + QLocale().formattedDataSize(record.size);
+    case Qt::DecorationRole:
+        return record.type == AssetType::Texture ? thumbnail(record) : QVariant(iconForType(record.type));
+    case PathRole:
+        return record.path;
+    case TypeRole:
+        return int(record.type);
+    default:
+        return QVariant();
+    }
+}
+
+void AssetListModel::refreshAsset(const QString &path) {
+    thumbnails.remove(path);
+    ThumbnailService::instance()->invalidate(database->projectRoot() + '/' + path, ThumbnailSize);
+    int row = database->indexOf(path);
+    if (isFiltered())
+        row = filteredRows.indexOf(row);
+    if (row >= 0) {
+        QModelIndex changed = index(row);
+        emit dataChanged(changed, changed, {Qt::DecorationRole});
+    }
+}
+
+QVariant AssetListModel::thumbnail(const AssetRecord &record) const {
+    if (QPixmap *cached = thumbnails.object(record.path))
+        return *cached;
+    if (!pendingThumbnails.contains(record.path)) {
+        pendingThumbnails.insert(record.path);
+        const QString path = record.path;
+        AssetListModel *self = const_cast<AssetListModel *>(this);
+        ThumbnailService::instance()->request(database->projectRoot() + '/' + path, ThumbnailSize, self,
+                                              [self, path](const QImage &image) {
+            self->pendingThumbnails.remove(path);
+            QPixmap pixmap = image.isNull() ? self->imageIcon.pixmap(ThumbnailSize) : QPixmap::fromImage(image);
+            self->thumbnails.insert(path, new QPixmap(pixmap));
+            // Строка могла сместиться, пока миниатюра готовилась
+            int row = self->database->indexOf(path);
+            if (self->isFiltered())
+                row = self->filteredRows.indexOf(row);
+            if (row >= 0) {
+                QModelIndex changed = self->index(row);
+                emit self->dataChanged(changed, changed, {Qt::DecorationRole});
+            }
+        });
+    }
+    return imageIcon;
+}
+
+QIcon AssetListModel::iconForType(AssetType type) const {
+    switch (type) {
+    case AssetType::Texture:
+        return imageIcon;
+    case AssetType::Model:
+        return modelIcon;
+    default:
+        return fileIcon;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef ASSETLISTMODEL_H
+#define ASSETLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QIcon>
+#include <QPixmap>
+#include <QSet>
+#include <QTimer>
+#include "Assets/assetdatabase.h"
+
+// Плоский список ассетов поверх AssetDatabase. Модель не копирует записи,
+// а представление (QListView с uniformItemSizes) запрашивает только видимые строки.
+// При активном фильтре показываются только лучшие совпадения поиска.
+class AssetListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    static constexpr int MaxSearchResults = 500;
+    static constexpr int ThumbnailSize = 32;
+
+    enum Roles {
+        PathRole = Qt::UserRole + 1,
+        TypeRole
+    };
+
+    explicit AssetListModel(AssetDatabase *database, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+public slots:
+    void setFilter(const QString &filter);
+    // Ассет переимпортирован: миниатюра строится заново
+    void refreshAsset(const QString &path);
+
+private:
+    QIcon iconForType(AssetType type) const;
+    void refreshFilter();
+    QVariant thumbnail(const AssetRecord &record) const;
+    bool isFiltered() const { return !filterText.isEmpty(); }
+
+    AssetDatabase *database;
+    QIcon fileIcon;
+    QIcon imageIcon;
+    QIcon modelIcon;
+
+    QString filterText;
+    QVector<int> filteredRows; // Строки базы, совпавшие с фильтром
+    QTimer *refilterTimer;     // Пересчёт фильтра при пополнении базы во время индексации
+
+    // Миниатюры запрашиваются из data() только для видимых строк
+    mutable QCache<QString, QPixmap> thumbnails;
+    mutable QSet<QString> pendingThumbnails;
+};
+
+#endif // ASSETLISTMODEL_H
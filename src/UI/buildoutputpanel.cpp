@@ -0,0 +1,104 @@
+#include "buildoutputpanel.h"
+#include <QColor>
+#include <QDir>
+#include <QFont>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QTabWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+enum ProblemRole {
+    FileRole = Qt::UserRole + 1,
+    LineRole,
+    ColumnRole
+};
+
+} // namespace
+
+BuildOutputPanel::BuildOutputPanel(QWidget *parent)
+    : QWidget(parent), errors(0), warnings(0) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    tabs = new QTabWidget(this);
+    layout->addWidget(tabs);
+
+    output = new QPlainTextEdit(this);
+    output->setReadOnly(true);
+    output->setLineWrapMode(QPlainTextEdit::NoWrap);
+    output->setMaximumBlockCount(MaxOutputLines);
+    output->setFont(QFont("Monospace"));
+    tabs->addTab(output, "Output");
+
+    problems = new QListWidget(this);
+    problems->setUniformItemSizes(true);
+    connect(problems, &QListWidget::itemActivated, this, &BuildOutputPanel::onItemActivated);
+    tabs->addTab(problems, "Problems");
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(FlushInterval);
+    connect(&flushTimer, &QTimer::timeout, this, &BuildOutputPanel::flush);
+}
+
+void BuildOutputPanel::clear() {
+    flushTimer.stop();
+    pendingLines.clear();
+    output->clear();
+    problems->clear();
+    errors = 0;
+    warnings = 0;
+    updateProblemsTitle();
+    tabs->setCurrentWidget(output);
+}
+
+void BuildOutputPanel::appendLine(const QString &line) {
+    pendingLines.append(line);
+    if (!flushTimer.isActive())
+        flushTimer.start();
+}
+
+void BuildOutputPanel::flush() {
+    if (pendingLines.isEmpty())
+        return;
+    output->appendPlainText(pendingLines.join('\n'));
+    pendingLines.clear();
+}
+
+void BuildOutputPanel::addDiagnostic(const BuildDiagnostic &diagnostic) {
+    // Заметки относятся к предыдущей ошибке и в список не идут
+    if (diagnostic.severity == BuildDiagnostic::Note)
+        return;
+    const bool isError = diagnostic.severity == BuildDiagnostic::Error;
+    if (isError)
+        ++errors;
+    else
+        ++warnings;
+
+    QString location = QDir::toNativeSeparators(diagnostic.file) + ':' + QString::number(diagnostic.line);
+    if (diagnostic.column > 0)
+        location += ':' + QString::number(diagnostic.column);
+    QListWidgetItem *item = new QListWidgetItem(QString("%1  %2").arg(diagnostic.message, location), problems);
+    item->setForeground(isError ? QColor(241, 76, 76) : QColor(204, 167, 0));
+    item->setToolTip(location);
+    item->setData(FileRole, diagnostic.file);
+    item->setData(LineRole, diagnostic.line);
+    item->setData(ColumnRole, diagnostic.column);
+    updateProblemsTitle();
+}
+
+void BuildOutputPanel::showProblems() {
+    flush();
+    if (problems->count() > 0)
+        tabs->setCurrentWidget(problems);
+}
+
+void BuildOutputPanel::onItemActivated(QListWidgetItem *item) {
+    emit locationActivated(item->data(FileRole).toString(), item->data(LineRole).toInt(),
+                           item->data(ColumnRole).toInt());
+}
+
+void BuildOutputPanel::updateProblemsTitle() {
+    tabs->setTabText(tabs->indexOf(problems),
+                     errors + warnings > 0 ? QString("Problems (%1)").arg(errors + warnings) : QString("Problems"));
+}
@@ -0,0 +1,50 @@
+#ifndef BUILDOUTPUTPANEL_H
+#define BUILDOUTPUTPANEL_H
+
+#include <QStringList>
+#include <QTimer>
+#include <QWidget>
+#include "Build/buildorchestrator.h"
+
+class QListWidget;
+class QListWidgetItem;
+class QPlainTextEdit;
+class QTabWidget;
+
+// Содержимое дока сборки: вкладка с выводом и вкладка со списком ошибок.
+// Строки вывода копятся и добавляются пачкой раз в FlushInterval, чтобы тысячи строк
+// от параллельной сборки не перерисовывали редактор по одной
+class BuildOutputPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    static constexpr int FlushInterval = 50; // мс
+    static constexpr int MaxOutputLines = 20000;
+
+    explicit BuildOutputPanel(QWidget *parent = nullptr);
+
+    void clear();
+    void appendLine(const QString &line);
+    void addDiagnostic(const BuildDiagnostic &diagnostic);
+    int errorCount() const { return errors; }
+    // Переключает на список ошибок, если он не пуст
+    void showProblems();
+
+signals:
+    void locationActivated(const QString &file, int line, int column);
+
+private:
+    void flush();
+    void onItemActivated(QListWidgetItem *item);
+    void updateProblemsTitle();
+
+    QTabWidget *tabs;
+    QPlainTextEdit *output;
+    QListWidget *problems;
+    QStringList pendingLines;
+    QTimer flushTimer;
+    int errors;
+    int warnings;
+};
+
+#endif // BUILDOUTPUTPANEL_H
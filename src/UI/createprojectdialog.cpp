@@ -1,5 +1,8 @@
 // createprojectdialog.cpp
 #include "createprojectdialog.h"
+#include "librarylistview.h"
+#include "Assets/thumbnailcache.h"
+#include "Core/jobsystem.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
@@ -11,6 +14,7 @@
 #include <QFile>
 #include <QFileDialog>
 #include <QPixmap>
+#include <QImageReader>
 #include <QScrollArea>
 #include <QLabel>
 #include <QFontMetrics>
@@ -25,18 +29,23 @@ LibraryItemWidget::LibraryItemWidget(const QString &name, const QString &descrip
     mainLayout->setContentsMargins(5,5,5,5);
 
     selectBox = new QCheckBox(this);
+    connect(selectBox, &QCheckBox::toggled, this, &LibraryItemWidget::selectionChanged);
     mainLayout->addWidget(selectBox);
 
     avatarLabel = new QLabel(this);
     avatarLabel->setFixedSize(50,50);
-    QPixmap avatarPix(avatarPath);
-    if (!avatarPix.isNull()) {
-        avatarLabel->setPixmap(avatarPix.scaled(50,50, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    } else {
-        avatarLabel->setText("No Img");
-        avatarLabel->setAlignment(Qt::AlignCenter);
-        avatarLabel->setStyleSheet("border: 1px solid gray;");
-    }
+    avatarLabel->setAlignment(Qt::AlignCenter);
+    // Аватар декодируется в фоне, до готовности показываем заглушку
+    QImage cachedAvatar = ThumbnailService::instance()->cached(avatarPath, 50);
+    avatarLabel->setPixmap(QPixmap::fromImage(cachedAvatar.isNull() ? ThumbnailService::placeholder(50) : cachedAvatar));
+    if (cachedAvatar.isNull()) ThumbnailService::instance()->request(avatarPath, 50, avatarLabel, [label = avatarLabel](const QImage &image) {
+        if (!image.isNull()) {
+            label->setPixmap(QPixmap::fromImage(image));
+        } else {
+            label->setText("No Img");
+            label->setStyleSheet("border: 1px solid gray;");
+        }
+    });
     mainLayout->addWidget(avatarLabel);
 
     QVBoxLayout* textLayout = new QVBoxLayout();
@@ -183,56 +192,55 @@ void CreateProjectDialog::setupUI() {
     QVBoxLayout* rightLayout = new QVBoxLayout(rightWidget);
     QLabel* libsLabel = new QLabel("Select Libraries:", this);
     rightLayout->addWidget(libsLabel);
-    libsScrollArea = new QScrollArea(this);
-    libsScrollArea->setWidgetResizable(true);
-    libsContainer = new QWidget();
-    libsLayout = new QVBoxLayout(libsContainer);
-    libsContainer->setLayout(libsLayout);
-    libsScrollArea->setWidget(libsContainer);
-    rightLayout->addWidget(libsScrollArea);
+    libsStatusLabel = new QLabel(this);
+    libsStatusLabel->setStyleSheet("color: gray;");
+    rightLayout->addWidget(libsStatusLabel);
+    libsModel = new LibraryListModel(this);
+    libsView = new LibraryListView(this);
+    libsView->setModel(libsModel);
+    rightLayout->addWidget(libsView);
     rightWidget->setMinimumHeight(370);
     rightWidget->setMaximumHeight(370); 
     mainLayout->addWidget(rightWidget, 3); // правая панель – 1/3 ширины
 }
 
 void CreateProjectDialog::loadLibraries() {
-    // Каталоги для поиска библиотек
-    QStringList libDirs = {"libs/standart", "libs/custom"};
-    for (const QString &libDirPath : libDirs) {
-        QDir libDir(libDirPath);
-        if (!libDir.exists())
-            continue;
-        // Ищем файлы .cfg
-        QStringList cfgFiles = libDir.entryList(QStringList() << "*.cfg", QDir::Files);
-        for (const QString &cfgFile : cfgFiles) {
-            QString cfgFilePath = libDir.absoluteFilePath(cfgFile);
-            QSettings libSettings(cfgFilePath, QSettings::IniFormat);
-            libSettings.beginGroup("Library");
-            QString libName = libSettings.value("Name").toString();
-            QString libDesc = libSettings.value("Description").toString();
-            QString avatarRelPath = libSettings.value("Avatar").toString();
-            libSettings.endGroup();
-            // Формируем полный путь к аватарке
-            QString avatarPath = libDir.absoluteFilePath(avatarRelPath);
-            // Создаём виджет библиотеки и добавляем в layout
-            LibraryItemWidget* item = new LibraryItemWidget(libName, libDesc, avatarPath, this);
-            libsLayout->addWidget(item);
-            libraryItems.append(item);
-        }
-    }
-    libsLayout->addStretch();
+    // Каталоги для поиска библиотек. Разбор .cfg идёт в фоне через кэш каталога,
+    // а до его окончания показываем результат прошлого сканирования
+    const QStringList libDirs = {"libs/standart", "libs/custom"};
+    LibraryCatalog* catalog = LibraryCatalog::instance();
+    libsModel->setLibraries(catalog->libraries());
+    connect(catalog, &LibraryCatalog::loaded, this, [this](const QVector<LibraryInfo> &libraries) {
+        libsModel->setLibraries(libraries);
+        libsStatusLabel->setVisible(libraries.isEmpty());
+        libsStatusLabel->setText("No libraries found");
+    });
+    libsStatusLabel->setText("Loading libraries...");
+    libsStatusLabel->setVisible(catalog->libraries().isEmpty());
+    catalog->refresh(libDirs);
 }
 
 void CreateProjectDialog::onLogoSelected() {
     logoPath = QFileDialog::getOpenFileName(this, "Select Logo", "", "Images (*.png *.jpg *.bmp)");
-    if (!logoPath.isEmpty()) {
-        QPixmap pixmap(logoPath);
-        if (!pixmap.isNull()) {
-            logoPreview->setPixmap(pixmap.scaled(100, 100, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        } else {
+    if (logoPath.isEmpty())
+        return;
+    // Декодируем в пуле и сразу в размер превью: JPEG декодер умеет уменьшать при чтении
+    const QString path = logoPath;
+    core::JobSystem::instance().runThen([path]() {
+        QImageReader reader(path);
+        reader.setAutoTransform(true);
+        const QSize size = reader.size();
+        if (size.isValid())
+            reader.setScaledSize(size.scaled(100, 100, Qt::KeepAspectRatio));
+        return reader.read();
+    }, this, [this, path](const QImage &image) {
+        if (path != logoPath)
+            return; // Пока декодировали, выбрали другой файл
+        if (image.isNull())
             logoPreview->setText("Invalid Image");
-        }
-    }
+        else
+            logoPreview->setPixmap(QPixmap::fromImage(image));
+    });
 }
 
 void CreateProjectDialog::onSelectProjectDirectory() {
@@ -255,14 +263,8 @@ QList<QString> CreateProjectDialog::getRenderAPIs() const {
     return apis;
 }
 
-QList<LibraryItemWidget*> CreateProjectDialog::getSelectedLibraries() const {
-    QList<LibraryItemWidget*> selected;
-    for (LibraryItemWidget* item : libraryItems) {
-        if (item->isSelected()) {
-            selected.append(item);
-        }
-    }
-    return selected;
+QList<LibraryInfo> CreateProjectDialog::getSelectedLibraries() const {
+    return libsModel->selectedLibraries();
 }
 
 void CreateProjectDialog::onRenderOptionClicked(RenderOptionWidget* option) {
@@ -351,10 +353,8 @@ void CreateProjectDialog::saveConfigFile() {
 
     // Сохраняем выбранные библиотеки (их названия)
     QStringList selectedLibs;
-    for (LibraryItemWidget* item : libraryItems) {
-        if (item->isSelected()) {
-            selectedLibs.append(item->getLibraryName());
-        }
+    for (const LibraryInfo &library : getSelectedLibraries()) {
+        selectedLibs.append(library.name);
     }
     config.beginGroup("Libraries");
     config.setValue("Selected", selectedLibs);
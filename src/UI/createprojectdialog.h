@@ -17,6 +17,10 @@
 #include <QMouseEvent>
 #include <QHBoxLayout>
 #include <QTimer>
+#include "Assets/librarycatalog.h"
+
+class LibraryListModel;
+class LibraryListView;
 
 // Кликабельная иконка для выбора изображения
 class ClickableLabel : public QLabel {
@@ -54,6 +58,8 @@ public:
     bool isSelected() const;
     void setSelected(bool selected);
     QString getLibraryName() const;
+signals:
+    void selectionChanged(bool selected);
 private:
     QCheckBox* selectBox;
     QLabel* avatarLabel;
@@ -147,7 +153,7 @@ public:
     bool is3DEnabled() const;
     // Возвращает список выбранных API в порядке выбора
     QList<QString> getRenderAPIs() const;
-    QList<LibraryItemWidget*> getSelectedLibraries() const;
+    QList<LibraryInfo> getSelectedLibraries() const;
 
 private slots:
     void onLogoSelected();
@@ -171,11 +177,10 @@ private:
 
     QPushButton* createButton;
 
-    // Правая панель – выбор библиотек
-    QScrollArea* libsScrollArea;
-    QWidget* libsContainer;
-    QVBoxLayout* libsLayout;
-    QList<LibraryItemWidget*> libraryItems;
+    // Правая панель – выбор библиотек (виджеты создаются только для видимых строк)
+    LibraryListView* libsView;
+    LibraryListModel* libsModel;
+    QLabel* libsStatusLabel;
 
     // Список выбранных рендер-виджетов (в порядке выбора)
     QList<RenderOptionWidget*> selectedRenderOptions;
@@ -0,0 +1,66 @@
+#include "editorapplication.h"
+#include "editorresources.h"
+#include <QAbstractButton>
+#include <QAbstractEventDispatcher>
+#include <QAction>
+#include <QEvent>
+#include <QMenu>
+#include <QThread>
+
+EditorApplication::EditorApplication(int &argc, char **argv) : QApplication(argc, argv) {
+    EditorResources::applyApplicationTheme();
+    const int budget = qEnvironmentVariableIntValue("SPECTER_STALL_BUDGET_MS");
+    if (budget > 0)
+        watchdog.setBudget(budget);
+    const QString log = qEnvironmentVariable("SPECTER_STALL_LOG");
+    if (!log.isEmpty())
+        watchdog.setLogFile(log);
+    // Сон главного цикла событий (в том числе вложенного, модального) — не зависание
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(thread());
+    connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, [this]() {
+        if (watchdog.isRunning())
+            watchdog.aboutToBlock();
+    }, Qt::DirectConnection);
+    connect(dispatcher, &QAbstractEventDispatcher::awake, this, [this]() {
+        if (watchdog.isRunning())
+            watchdog.awake();
+    }, Qt::DirectConnection);
+    watchdog.start();
+}
+
+EditorApplication::~EditorApplication() {
+    watchdog.stop();
+}
+
+bool EditorApplication::notify(QObject *receiver, QEvent *event) {
+    // События объектов других потоков тоже идут через notify — их не считаем
+    if (!watchdog.isRunning() || QThread::currentThread() != thread())
+        return QApplication::notify(receiver, event);
+    watchdog.enter(receiver->metaObject()->className(), event->type(), describeInput(receiver, event));
+    const bool handled = QApplication::notify(receiver, event);
+    watchdog.leave();
+    return handled;
+}
+
+QString EditorApplication::describeInput(QObject *receiver, QEvent *event) {
+    // Слот, вызванный по сигналу кнопки или пункта меню, выполняется внутри события ввода:
+    // подпись элемента показывает, что именно нажали. Остальные события обходятся без строк
+    switch (event->type()) {
+    case QEvent::MouseButtonRelease:
+    case QEvent::KeyPress:
+    case QEvent::Shortcut:
+        break;
+    default:
+        return QString();
+    }
+    QString text;
+    if (QAction *action = qobject_cast<QAction *>(receiver))
+        text = action->text();
+    else if (QMenu *menu = qobject_cast<QMenu *>(receiver))
+        text = menu->activeAction() ? menu->activeAction()->text() : menu->title();
+    else if (QAbstractButton *button = qobject_cast<QAbstractButton *>(receiver))
+        text = button->text();
+    else
+        text = receiver->objectName();
+    return text.remove('&');
+}
@@ -0,0 +1,27 @@
+#ifndef EDITORAPPLICATION_H
+#define EDITORAPPLICATION_H
+
+#include <QApplication>
+#include "Core/stallwatchdog.h"
+
+// Приложение редактора: каждое событие главного потока проходит через сторож зависаний.
+// Бюджет — SPECTER_STALL_BUDGET_MS (по умолчанию 100 мс), журнал — SPECTER_STALL_LOG
+// (по умолчанию stalls.jsonl в каталоге данных приложения)
+class EditorApplication : public QApplication {
+    Q_OBJECT
+
+public:
+    EditorApplication(int &argc, char **argv);
+    ~EditorApplication() override;
+
+    core::StallWatchdog &stallWatchdog() { return watchdog; }
+
+    bool notify(QObject *receiver, QEvent *event) override;
+
+private:
+    static QString describeInput(QObject *receiver, QEvent *event);
+
+    core::StallWatchdog watchdog;
+};
+
+#endif // EDITORAPPLICATION_H
@@ -0,0 +1,52 @@
+#include "editorresources.h"
+#include <QApplication>
+#include <QDebug>
+#include <QPalette>
+#include <QPixmapCache>
+#include <QStyleFactory>
+
+namespace EditorResources {
+
+QPixmap pixmap(const QString &path, int size) {
+    const QString key = QString("specter:%1@%2").arg(path).arg(size);
+    QPixmap result;
+    if (QPixmapCache::find(key, &result))
+        return result;
+    QPixmap source(path);
+    if (source.isNull())
+        return QPixmap();
+    result = source.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPixmapCache::insert(key, result);
+    return result;
+}
+
+QIcon windowIcon() {
+    static const QIcon icon = [] {
+        QIcon loaded(":/resources/SpecterEngineLogo.png");
+        if (loaded.isNull())
+            qWarning() << "Window icon not found! Check path: /resources/SpecterEngineLogo.png";
+        return loaded;
+    }();
+    return icon;
+}
+
+void applyApplicationTheme() {
+    qApp->setStyle(QStyleFactory::create("Fusion"));
+    QPalette darkPalette;
+    darkPalette.setColor(QPalette::Window, QColor(53, 53, 53));
+    darkPalette.setColor(QPalette::WindowText, Qt::white);
+    darkPalette.setColor(QPalette::Base, QColor(35, 35, 35));
+    darkPalette.setColor(QPalette::AlternateBase, QColor(53, 53, 53));
+    darkPalette.setColor(QPalette::ToolTipBase, Qt::white);
+    darkPalette.setColor(QPalette::ToolTipText, Qt::white);
+    darkPalette.setColor(QPalette::Text, Qt::white);
+    darkPalette.setColor(QPalette::Button, QColor(53, 53, 53));
+    darkPalette.setColor(QPalette::ButtonText, Qt::white);
+    darkPalette.setColor(QPalette::BrightText, Qt::red);
+    darkPalette.setColor(QPalette::Link, QColor(42, 130, 218));
+    darkPalette.setColor(QPalette::Highlight, QColor(42, 130, 218));
+    darkPalette.setColor(QPalette::HighlightedText, Qt::black);
+    qApp->setPalette(darkPalette);
+}
+
+} // namespace EditorResources
@@ -0,0 +1,22 @@
+#ifndef EDITORRESOURCES_H
+#define EDITORRESOURCES_H
+
+#include <QIcon>
+#include <QPixmap>
+#include <QString>
+
+// Общие ресурсы интерфейса. Картинки из ресурсов декодируются и масштабируются один раз
+// на процесс (QPixmapCache), а не в каждом окне и каждой строке списка
+namespace EditorResources {
+
+// Картинка, вписанная в квадрат size x size; пустая, если ресурса нет
+QPixmap pixmap(const QString &path, int size);
+QIcon windowIcon();
+
+// Тёмная тема Fusion для всего приложения. Вызывается до создания первого окна:
+// смена стиля у существующих виджетов заставляет заново полировать каждый из них
+void applyApplicationTheme();
+
+} // namespace EditorResources
+
+#endif // EDITORRESOURCES_H
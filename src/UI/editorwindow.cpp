@@ -1,4 +1,19 @@
 #include "editorwindow.h"
+#include "scenehierarchymodel.h"
+#include "assetlistmodel.h"
+#include "buildoutputpanel.h"
+#include "profilerpanel.h"
+#include "memorypanel.h"
+#include "sceneviewport.h"
+#include "editorresources.h"
+#include "startupsequence.h"
+#include "recentprojects.h"
+#include "projectloader.h"
+#include "inspectorpanel.h"
+#include "Scene/components.h"
+#include "Scene/scenefile.h"
+#include "Core/memorytracker.h"
+#include "Core/modulemanager.h"
 #include <QVBoxLayout>
 #include <QSettings>
 #include <QPushButton>
@@ -12,27 +27,26 @@
 #include <QInputDialog>
 #include <QToolButton>
 #include <QHBoxLayout>
-#include <QTreeWidgetItem>
 #include <QProcess>
 #include <QDockWidget>
+#include <QListView>
+#include <QElapsedTimer>
+#include <QProgressBar>
+#include <QDesktopServices>
+#include <QFileInfo>
+#include <QUrl>
+#include <QTimer>
 
 EditorWindow::EditorWindow(const QString &projectPath, QWidget *parent)
-    : QMainWindow(parent), projectPath(projectPath), codeEditorProcess(nullptr), placeholderVisible(false) {
-    // Загружаем имя проекта из config.cfg
-    QSettings config(projectPath + "/config.cfg", QSettings::IniFormat);
-    config.beginGroup("Project");
-    QString projectName = config.value("Name", "Unnamed Project").toString();
-    config.endGroup();
-    setWindowTitle(projectName + " - Specter Engine Editor");
+    : QMainWindow(parent), projectPath(projectPath), codeEditorProcess(nullptr), startup(nullptr),
+      hierarchyModel(nullptr), hierarchyView(nullptr), undoAction(nullptr), redoAction(nullptr),
+      assetModel(nullptr), projectLoader(nullptr), buildOutput(nullptr), profilerPanel(nullptr), memoryPanel(nullptr), buildProgress(nullptr), inspector(nullptr), placeholderVisible(false) {
+    // Имя проекта из config.cfg подставит ProjectLoader, пока — имя каталога
+    setWindowTitle(QFileInfo(projectPath).fileName() + " - Specter Engine Editor");
     resize(1200, 800);
 
     // Устанавливаем логотип окна
-    QIcon windowIcon(":/resources/SpecterEngineLogo.png");
-    if (!windowIcon.isNull()) {
-        setWindowIcon(windowIcon);
-    } else {
-        qWarning() << "Window icon not found! Check path: /resources/SpecterEngineLogo.png";
-    }
+    setWindowIcon(EditorResources::windowIcon());
 
     // Тёмная тема, как в VSCode
     QPalette palette;
@@ -50,10 +64,15 @@ EditorWindow::EditorWindow(const QString &projectPath, QWidget *parent)
     palette.setColor(QPalette::HighlightedText, Qt::white);
     setPalette(palette);
 
+    scene.setJournal(&sceneJournal);
+    connect(&sceneJournal, &SceneJournal::compactionFinished, this, &EditorWindow::onSceneCompacted);
     setupUI();
 }
 
 void EditorWindow::setupUI() {
+    // Видимое в первом кадре строится сразу, скрытые панели и данные — после него
+    startup = new StartupSequence(this);
+
     // Меню
     setupMenuBar();
 
@@ -65,6 +84,9 @@ void EditorWindow::setupUI() {
     setupInspectorPanel();
     setupAssetBrowser();
     setupModulesPanel();
+    setupBuildPanel();
+    setupProfilerPanel();
+    setupMemoryPanel();
 
     // Статус-бар
     setupStatusBar();
@@ -87,9 +109,9 @@ void EditorWindow::setupMenuBar() {
     QHBoxLayout *logoLayout = new QHBoxLayout(logoWidget);
     logoLayout->setContentsMargins(5, 0, 5, 0); // Минимальные отступы
     QLabel *logoLabel = new QLabel(logoWidget);
-    QPixmap logo(":/resources/SpecterEngineLogo.png");
+    const QPixmap logo = EditorResources::pixmap(":/resources/SpecterEngineLogo.png", 20);
     if (!logo.isNull()) {
-        logoLabel->setPixmap(logo.scaled(20, 20, Qt::KeepAspectRatio));
+        logoLabel->setPixmap(logo);
     } else {
         logoLabel->setText("L");
     }
@@ -108,12 +130,20 @@ void EditorWindow::setupMenuBar() {
 
     // Scene Menu
     QMenu *sceneMenu = menuBar->addMenu("Scene");
-    sceneMenu->addAction("New Scene");
-    sceneMenu->addAction("Load Scene");
-    sceneMenu->addAction("Save Scene");
+    sceneMenu->addAction("New Scene", this, &EditorWindow::newScene);
+    sceneMenu->addAction("Load Scene", this, &EditorWindow::loadScene);
+    sceneMenu->addAction("Save Scene", this, &EditorWindow::saveScene)->setShortcut(QKeySequence::Save);
+    sceneMenu->addAction("Save Scene As...", this, &EditorWindow::saveSceneAs);
 
     // Edit Menu
     QMenu *editMenu = menuBar->addMenu("Edit");
+    undoAction = editMenu->addAction("Undo", this, &EditorWindow::undo);
+    undoAction->setShortcut(QKeySequence::Undo);
+    redoAction = editMenu->addAction("Redo", this, &EditorWindow::redo);
+    redoAction->setShortcut(QKeySequence::Redo);
+    connect(&history, &CommandHistory::changed, this, &EditorWindow::updateUndoActions);
+    updateUndoActions();
+    editMenu->addSeparator();
     editMenu->addAction("Open Code Editor", this, &EditorWindow::openCodeEditor);
     // Добавляем действие для переключения Placeholder
     placeholderAction = editMenu->addAction("Activate Placeholder", this, &EditorWindow::togglePlaceholder);
@@ -123,6 +153,8 @@ void EditorWindow::setupMenuBar() {
     buildMenu->addAction("Build Debug", this, &EditorWindow::buildDebug);
     buildMenu->addAction("Build Release", this, &EditorWindow::buildRelease);
     buildMenu->addAction("Run", this, &EditorWindow::runProject);
+    buildMenu->addSeparator();
+    buildMenu->addAction("Cancel Build", this, &EditorWindow::cancelBuild);
 
     // Settings Action
     QAction *settingsAction = new QAction("Settings", this);
@@ -140,9 +172,9 @@ void EditorWindow::setupSceneView() {
     setCentralWidget(sceneViewWidget);
 
     sceneLayout = new QVBoxLayout(sceneViewWidget);
-    sceneLabel = new QLabel("Scene View (Viewport)", this);
-    sceneLabel->setAlignment(Qt::AlignCenter);
-    sceneLayout->addWidget(sceneLabel);
+    sceneLayout->setContentsMargins(0, 0, 0, 0);
+    sceneViewport = new SceneViewport(&scene, this);
+    sceneLayout->addWidget(sceneViewport);
 
     // Создаём Placeholder без родителя, чтобы он не отображался автоматически
     placeholderWidget = new QLabel("3D/2D Scene Placeholder", nullptr);
@@ -155,14 +187,14 @@ void EditorWindow::togglePlaceholder() {
         // Деактивируем Placeholder
         sceneLayout->removeWidget(placeholderWidget);
         placeholderWidget->hide(); // Явно скрываем
-        sceneLayout->addWidget(sceneLabel);
-        sceneLabel->show(); // Явно показываем
+        sceneLayout->addWidget(sceneViewport);
+        sceneViewport->show(); // Явно показываем
         placeholderVisible = false;
         placeholderAction->setText("Activate Placeholder");
     } else {
         // Активируем Placeholder
-        sceneLayout->removeWidget(sceneLabel);
-        sceneLabel->hide(); // Явно скрываем
+        sceneLayout->removeWidget(sceneViewport);
+        sceneViewport->hide(); // Явно скрываем
         sceneLayout->addWidget(placeholderWidget);
         placeholderWidget->show(); // Явно показываем
         placeholderVisible = true;
@@ -172,65 +204,188 @@ void EditorWindow::togglePlaceholder() {
 
 void EditorWindow::setupHierarchyPanel() {
     hierarchyDock = new QDockWidget("Scene Hierarchy", this);
-    QTreeWidget *hierarchyTree = new QTreeWidget(this);
-    hierarchyTree->setHeaderHidden(true);
-    QStringList headers;
-    headers << "Objects";
-    hierarchyTree->setHeaderLabels(headers);
-    hierarchyTree->addTopLevelItem(new QTreeWidgetItem(QStringList() << "Object1"));
-    hierarchyTree->addTopLevelItem(new QTreeWidgetItem(QStringList() << "Object2"));
+
+    hierarchyModel = new SceneHierarchyModel(&scene, this);
+
+    hierarchyView = new QTreeView(this);
+    hierarchyView->setHeaderHidden(true);
+    hierarchyView->setUniformRowHeights(true); // Без этого представление меряет каждую строку
+    hierarchyView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    hierarchyView->setEditTriggers(QAbstractItemView::EditKeyPressed);
+    hierarchyView->setModel(hierarchyModel);
+    connect(hierarchyView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &EditorWindow::updateInspector);
+    connect(hierarchyModel, &QAbstractItemModel::dataChanged, this, &EditorWindow::updateInspector);
+    connect(hierarchyModel, &QAbstractItemModel::rowsRemoved, this, &EditorWindow::updateInspector);
+    connect(hierarchyModel, &SceneHierarchyModel::nodeRenamed, this,
+            [this](SceneGraph::NodeId node, const QString &oldName, const QString &newName) {
+        history.push(SceneCommand::rename(scene, node, oldName, newName));
+    });
+    // Окно сцены перерисовывается только при изменениях
+    connect(hierarchyModel, &QAbstractItemModel::rowsInserted, sceneViewport, [this]() { sceneViewport->update(); });
+    connect(hierarchyModel, &QAbstractItemModel::rowsRemoved, sceneViewport, [this]() { sceneViewport->update(); });
+    connect(hierarchyModel, &QAbstractItemModel::modelReset, sceneViewport, [this]() { sceneViewport->update(); });
 
     // Контекстное меню для объектов
-    hierarchyTree->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(hierarchyTree, &QTreeWidget::customContextMenuRequested, this, [this, hierarchyTree](const QPoint &pos) {
-        QTreeWidgetItem *item = hierarchyTree->itemAt(pos);
-        if (item) {
-            QMenu contextMenu(this);
-            contextMenu.addAction("Rename", this, [item]() {
+    hierarchyView->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(hierarchyView, &QTreeView::customContextMenuRequested, this, [this](const QPoint &pos) {
+        QModelIndex index = hierarchyView->indexAt(pos);
+        QMenu contextMenu(this);
+        if (index.isValid()) {
+            contextMenu.addAction("Rename", this, [this, index]() {
                 bool ok;
-                QString newName = QInputDialog::getText(nullptr, "Rename Object", "Enter new name:", QLineEdit::Normal, item->text(0), &ok);
+                QString newName = QInputDialog::getText(this, "Rename Object", "Enter new name:", QLineEdit::Normal,
+                                                        index.data().toString(), &ok);
                 if (ok && !newName.isEmpty()) {
-                    item->setText(0, newName);
+                    hierarchyModel->setData(index, newName);
                 }
             });
-            contextMenu.addAction("Delete", this, [item]() {
-                delete item;
+            contextMenu.addAction("Delete", this, [this, index]() {
+                // Удаляем всё выделение одним пакетом
+                std::vector<SceneGraph::NodeId> nodes;
+                for (const QModelIndex &selected : hierarchyView->selectionModel()->selectedRows()) {
+                    nodes.push_back(hierarchyModel->nodeForIndex(selected));
+                }
+                if (nodes.empty()) {
+                    nodes.push_back(hierarchyModel->nodeForIndex(index));
+                }
+                SceneCommand command;
+                command.type = SceneCommand::Remove;
+                hierarchyModel->removeNodes(nodes, &command.fragments);
+                if (!command.fragments.empty())
+                    history.push(command);
+            });
+        } else {
+            contextMenu.addAction("Create Object", this, [this]() {
+                // Созданное снимется во фрагмент при отмене
+                SceneCommand command;
+                command.type = SceneCommand::Create;
+                command.fragments.emplace_back();
+                command.fragments.back().parent = scene.objectId(SceneGraph::RootNode);
+                command.fragments.back().firstRow = scene.graph().childCount(SceneGraph::RootNode);
+                command.fragments.back().count = int(hierarchyModel->addObjects(SceneGraph::RootNode, 1, "Object").size());
+                if (command.fragments.back().count > 0)
+                    history.push(command);
             });
-            contextMenu.exec(QCursor::pos());
         }
+        contextMenu.exec(hierarchyView->viewport()->mapToGlobal(pos));
     });
 
-    hierarchyDock->setWidget(hierarchyTree);
+    hierarchyDock->setWidget(hierarchyView);
     addDockWidget(Qt::LeftDockWidgetArea, hierarchyDock);
 }
 
 void EditorWindow::setupInspectorPanel() {
     inspectorDock = new QDockWidget("Inspector", this);
-    QWidget *inspectorWidget = new QWidget(this);
-    QVBoxLayout *layout = new QVBoxLayout(inspectorWidget);
-
-    QLabel *objectName = new QLabel("Selected Object: None", this);
-    layout->addWidget(objectName);
+    // Редакторы полей строятся по описаниям компонентов, правка применяется ко всему выделению
+    inspector = new InspectorPanel(&scene, this);
+    connect(inspector, &InspectorPanel::fieldEdited, this, [this](const FieldEdit &edit) {
+        history.push(SceneCommand::fieldChange(scene, edit));
+        sceneViewport->update();
+    });
+    inspectorDock->setWidget(inspector);
+    addDockWidget(Qt::RightDockWidgetArea, inspectorDock);
+    updateInspector();
+}
 
-    // Пример редактируемых свойств
-    QLineEdit *positionX = new QLineEdit("0.0", this);
-    positionX->setPlaceholderText("Position X");
-    layout->addWidget(positionX);
+void EditorWindow::updateInspector() {
+    std::vector<SceneGraph::NodeId> nodes;
+    for (const QModelIndex &selected : hierarchyView->selectionModel()->selectedRows())
+        nodes.push_back(hierarchyModel->nodeForIndex(selected));
+    inspector->setSelection(std::move(nodes));
+}
 
-    QLineEdit *positionY = new QLineEdit("0.0", this);
-    positionY->setPlaceholderText("Position Y");
-    layout->addWidget(positionY);
+void EditorWindow::undo() {
+    QElapsedTimer timer;
+    timer.start();
+    const QString text = history.undoText();
+    if (!history.undo([this](SceneCommand &command) { return runCommand(command, false); })) {
+        if (!text.isEmpty())
+            statusBar->showMessage("Cannot undo " + text + ": the scene no longer matches", 5000);
+        return;
+    }
+    statusBar->showMessage(QString("Undo %1 (%2 ms)").arg(text).arg(timer.elapsed()), 3000);
+}
 
-    QLineEdit *positionZ = new QLineEdit("0.0", this);
-    positionZ->setPlaceholderText("Position Z");
-    layout->addWidget(positionZ);
+void EditorWindow::redo() {
+    QElapsedTimer timer;
+    timer.start();
+    const QString text = history.redoText();
+    if (!history.redo([this](SceneCommand &command) { return runCommand(command, true); })) {
+        if (!text.isEmpty())
+            statusBar->showMessage("Cannot redo " + text + ": the scene no longer matches", 5000);
+        return;
+    }
+    statusBar->showMessage(QString("Redo %1 (%2 ms)").arg(text).arg(timer.elapsed()), 3000);
+}
 
-    QPushButton *addComponent = new QPushButton("Add Component", this);
-    layout->addWidget(addComponent);
+void EditorWindow::updateUndoActions() {
+    undoAction->setEnabled(history.canUndo());
+    undoAction->setText(history.canUndo() ? "Undo " + history.undoText() : QString("Undo"));
+    redoAction->setEnabled(history.canRedo());
+    redoAction->setText(history.canRedo() ? "Redo " + history.redoText() : QString("Redo"));
+}
 
-    layout->addStretch();
-    inspectorDock->setWidget(inspectorWidget);
-    addDockWidget(Qt::RightDockWidgetArea, inspectorDock);
+bool EditorWindow::runCommand(SceneCommand &command, bool forward) {
+    switch (command.type) {
+    case SceneCommand::FieldChange: {
+        scene.resolve(command.objects, command.nodes);
+        FieldEdit edit = command.toFieldEdit();
+        if (forward) {
+            scene.applyFieldEdit(edit);
+            command.previous = edit.previous;
+        } else {
+            scene.revertFieldEdit(edit);
+        }
+        inspector->refresh();
+        break;
+    }
+    case SceneCommand::Rename: {
+        const SceneGraph::NodeId node = scene.node(command.objects.front(), command.nodes.front());
+        if (node == SceneGraph::InvalidNode)
+            return false;
+        command.nodes.front() = node;
+        const QString &name = forward ? command.newName : command.oldName;
+        const QModelIndex index = hierarchyModel->indexForNode(node);
+        if (index.isValid())
+            hierarchyModel->setData(index, name);
+        else
+            scene.setName(node, name);
+        break;
+    }
+    case SceneCommand::Create:
+    case SceneCommand::Remove: {
+        // Фрагменты идут в порядке выполнения; отмена проходит их с конца, чтобы позиции строк
+        // совпали с тогдашними
+        const bool insert = (command.type == SceneCommand::Create) == forward;
+        const int count = int(command.fragments.size());
+        // Родители всех фрагментов находятся одним проходом по сцене, а не проходом на каждый
+        std::vector<Scene::ObjectId> parentObjects;
+        parentObjects.reserve(size_t(count));
+        for (const SceneFragment &fragment : command.fragments)
+            parentObjects.push_back(fragment.parent);
+        std::vector<SceneGraph::NodeId> parents;
+        scene.resolve(parentObjects, parents);
+        // Снятые фрагменты уничтожают свои сущности одним пакетом
+        Scene::RemovalBatch batch(scene);
+        for (int i = 0; i < count; ++i) {
+            const int index = forward ? i : count - 1 - i;
+            SceneFragment &fragment = command.fragments[index];
+            if (insert) {
+                if (!hierarchyModel->restoreChildren(fragment, parents[index]))
+                    return false;
+                continue;
+            }
+            const SceneGraph::NodeId parent = scene.node(fragment.parent, parents[index]);
+            if (parent == SceneGraph::InvalidNode || fragment.firstRow + fragment.count > scene.graph().childCount(parent))
+                return false;
+            hierarchyModel->removeChildren(parent, fragment.firstRow, fragment.count, &fragment);
+        }
+        updateInspector();
+        break;
+    }
+    }
+    sceneViewport->update();
+    return true;
 }
 
 void EditorWindow::setupAssetBrowser() {
@@ -243,23 +398,143 @@ void EditorWindow::setupAssetBrowser() {
     searchBar->setPlaceholderText("Search assets...");
     layout->addWidget(searchBar);
 
-    // Список ресурсов с иконками
-    QListWidget *assetList = new QListWidget(this);
-    assetList->addItem(new QListWidgetItem(QIcon(":/resources/texture_icon.png"), "Texture1.png"));
-    assetList->addItem(new QListWidgetItem(QIcon(":/resources/model_icon.png"), "Model1.obj"));
+    // Список ресурсов: строки создаются только для видимой области
+    // Модель принадлежит базе, чтобы не пережить её при закрытии окна
+    assetModel = new AssetListModel(&assetDatabase, &assetDatabase);
+    QListView *assetList = new QListView(this);
+    assetList->setUniformItemSizes(true);
+    assetList->setLayoutMode(QListView::Batched);
+    assetList->setModel(assetModel);
+    connect(searchBar, &QLineEdit::textChanged, assetModel, &AssetListModel::setFilter);
 
     layout->addWidget(assetList);
     assetBrowserDock->setWidget(assetBrowserWidget);
     addDockWidget(Qt::LeftDockWidgetArea, assetBrowserDock);
+
+    connect(&importPipeline, &AssetImportPipeline::progress, this, [this](int done, int total) {
+        statusBar->showMessage(QString("Importing assets: %1/%2").arg(done).arg(total));
+    });
+    connect(&importPipeline, &AssetImportPipeline::finished, this, &EditorWindow::onImportFinished);
+    connect(&hotReload, &AssetHotReload::reloadStarted, this, [this](const QStringList &assets) {
+        statusBar->showMessage(QString("Reloading %1...").arg(assets.size() == 1 ? assets.first()
+                                                                                : QString("%1 assets").arg(assets.size())));
+    });
+    connect(&hotReload, &AssetHotReload::reloaded, this, &EditorWindow::onAssetsReloaded);
 }
 
 void EditorWindow::setupModulesPanel() {
+    // Заполняется библиотеками проекта, когда ProjectLoader их найдёт
     modulesDock = new QDockWidget("Modules", this);
-    QListWidget *modulesList = new QListWidget(this);
-    modulesList->addItem(new QListWidgetItem("Rendering Module"));
-    modulesList->addItem(new QListWidgetItem("Physics Module"));
+    modulesList = new QTreeWidget(this);
+    modulesList->setColumnCount(3);
+    modulesList->setHeaderLabels({"Module", "State", "Load time"});
+    modulesList->setRootIsDecorated(false);
     modulesDock->setWidget(modulesList);
     addDockWidget(Qt::LeftDockWidgetArea, modulesDock);
+    connect(core::ModuleManager::instance(), &core::ModuleManager::stateChanged, this, &EditorWindow::refreshModulesPanel);
+
+    // Модули с Load=OnDemand и не загрузившиеся можно открыть вручную
+    modulesList->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(modulesList, &QTreeWidget::customContextMenuRequested, this, [this](const QPoint &pos) {
+        QTreeWidgetItem *item = modulesList->itemAt(pos);
+        if (!item)
+            return;
+        const QString name = item->text(0);
+        const core::ModuleManager::Status *status = core::ModuleManager::instance()->status(name);
+        if (!status || (status->state != core::ModuleManager::State::Available
+                        && status->state != core::ModuleManager::State::Failed))
+            return;
+        QMenu contextMenu(this);
+        contextMenu.addAction(status->state == core::ModuleManager::State::Failed ? "Retry" : "Load", this, [name]() {
+            core::ModuleManager::instance()->require({name});
+        });
+        contextMenu.exec(modulesList->viewport()->mapToGlobal(pos));
+    });
+}
+
+void EditorWindow::refreshModulesPanel() {
+    // Модулей единицы-десятки, проще пересобрать список целиком
+    modulesList->clear();
+    for (const LibraryInfo &library : projectModules) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(modulesList);
+        item->setText(0, library.name);
+        item->setToolTip(0, library.description);
+        const core::ModuleManager::Status *status = core::ModuleManager::instance()->status(library.name);
+        if (!status) {
+            item->setText(1, "No module");
+            continue;
+        }
+        item->setText(1, core::ModuleManager::stateName(status->state));
+        if (status->state == core::ModuleManager::State::Loaded) {
+            item->setText(2, QString("%1 ms").arg(status->loadNanoseconds / 1e6, 0, 'f', 1));
+            item->setToolTip(1, status->version.isEmpty() ? status->descriptor.path
+                                                          : status->version + "\n" + status->descriptor.path);
+        } else if (status->state == core::ModuleManager::State::Failed) {
+            item->setToolTip(1, status->error);
+        } else if (library.onDemand && status->state == core::ModuleManager::State::Available) {
+            item->setToolTip(1, "Loaded on demand");
+        }
+    }
+    modulesList->resizeColumnToContents(0);
+}
+
+void EditorWindow::setupBuildPanel() {
+    buildOrchestrator.setProjectPath(projectPath);
+    buildDock = new QDockWidget("Build Output", this);
+    buildOutput = new BuildOutputPanel(buildDock);
+    buildDock->setWidget(buildOutput);
+    addDockWidget(Qt::BottomDockWidgetArea, buildDock);
+
+    connect(&buildOrchestrator, &BuildOrchestrator::started, this, &EditorWindow::onBuildStarted);
+    connect(&buildOrchestrator, &BuildOrchestrator::finished, this, &EditorWindow::onBuildFinished);
+    connect(&buildOrchestrator, &BuildOrchestrator::outputLine, buildOutput, &BuildOutputPanel::appendLine);
+    connect(&buildOrchestrator, &BuildOrchestrator::diagnosticFound, buildOutput, &BuildOutputPanel::addDiagnostic);
+    connect(&buildOrchestrator, &BuildOrchestrator::progressChanged, this, [this](int percent) {
+        buildProgress->setValue(percent);
+    });
+    connect(buildOutput, &BuildOutputPanel::locationActivated, this, &EditorWindow::openSourceLocation);
+}
+
+void EditorWindow::setupProfilerPanel() {
+    // Док за вкладкой сборки: содержимое создаётся при первом показе или в простое после первого кадра
+    profilerDock = new QDockWidget("Profiler", this);
+    addDockWidget(Qt::BottomDockWidgetArea, profilerDock);
+    tabifyDockWidget(buildDock, profilerDock);
+    buildDock->raise();
+    connect(profilerDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible)
+            ensureProfilerPanel();
+    });
+    startup->defer([this]() { ensureProfilerPanel(); });
+}
+
+ProfilerPanel *EditorWindow::ensureProfilerPanel() {
+    if (!profilerPanel) {
+        profilerPanel = new ProfilerPanel(profilerDock);
+        profilerPanel->setTraceDirectory(projectPath);
+        profilerDock->setWidget(profilerPanel);
+    }
+    return profilerPanel;
+}
+
+void EditorWindow::setupMemoryPanel() {
+    memoryDock = new QDockWidget("Memory", this);
+    addDockWidget(Qt::BottomDockWidgetArea, memoryDock);
+    tabifyDockWidget(profilerDock, memoryDock);
+    buildDock->raise();
+    connect(memoryDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible)
+            ensureMemoryPanel();
+    });
+    startup->defer([this]() { ensureMemoryPanel(); });
+}
+
+MemoryPanel *EditorWindow::ensureMemoryPanel() {
+    if (!memoryPanel) {
+        memoryPanel = new MemoryPanel(memoryDock);
+        memoryDock->setWidget(memoryPanel);
+    }
+    return memoryPanel;
 }
 
 void EditorWindow::setupStatusBar() {
@@ -267,6 +542,103 @@ void EditorWindow::setupStatusBar() {
     setStatusBar(statusBar);
     statusBar->showMessage("Ready");
     statusBar->setStyleSheet("QStatusBar { background-color: #252526; color: #D4D4D4; }");
+
+    // Прогресс сборки, виден только во время неё
+    buildProgress = new QProgressBar(this);
+    buildProgress->setRange(0, 100);
+    buildProgress->setMaximumWidth(200);
+    buildProgress->setMaximumHeight(16);
+    buildProgress->setVisible(false);
+    statusBar->addPermanentWidget(buildProgress);
+
+    // Стадии открытия проекта
+    openProgress = new QProgressBar(this);
+    openProgress->setRange(0, ProjectLoader::StageCount);
+    openProgress->setMaximumWidth(120);
+    openProgress->setMaximumHeight(16);
+    openProgress->setTextVisible(false);
+    openProgress->setVisible(false);
+    statusBar->addPermanentWidget(openProgress);
+
+    memoryStatusLabel = new QLabel(this);
+    memoryStatusLabel->setToolTip("Memory tracked by engine allocators / process resident memory");
+    statusBar->addPermanentWidget(memoryStatusLabel);
+    connect(&assetDatabase, &AssetDatabase::indexingFinished, this, [this](int count) {
+        statusBar->showMessage(QString("Assets indexed: %1").arg(count), 5000);
+    });
+
+    // Загрузка проекта и опрос памяти не нужны для первого кадра
+    startup->defer([this]() { startProjectLoad(); });
+    startup->defer([this]() {
+        QTimer *memoryTimer = new QTimer(this);
+        connect(memoryTimer, &QTimer::timeout, this, &EditorWindow::updateMemoryStatus);
+        memoryTimer->start(1000);
+        updateMemoryStatus();
+    });
+}
+
+void EditorWindow::startProjectLoad() {
+    // Незавершённая загрузка прошлого проекта больше не нужна: её фоновые ответы отбросит QPointer
+    delete projectLoader;
+    projectLoader = new ProjectLoader(projectPath, &assetDatabase, this);
+    hotReload.open(projectPath);
+    // Запущенная игра подхватывает переимпортированные ассеты из журнала и общего кэша
+    buildOrchestrator.setGameEnvironment("SPECTER_RELOAD_FILE", AssetHotReload::journalPath(hotReload.projectRoot()));
+    buildOrchestrator.setGameEnvironment("SPECTER_COOKED_CACHE", importPipeline.cache().directory());
+    connect(projectLoader, &ProjectLoader::configLoaded, this, [this](const ProjectConfig &config) {
+        setWindowTitle(config.name + " - Specter Engine Editor");
+        history.setMemoryBudget(qint64(config.undoMemoryMB) * 1024 * 1024);
+    });
+    connect(projectLoader, &ProjectLoader::modulesResolved, this, [this](const QVector<LibraryInfo> &modules) {
+        projectModules = modules;
+        QVector<core::ModuleDescriptor> descriptors;
+        QStringList required;
+        for (const LibraryInfo &library : modules) {
+            if (library.modulePath.isEmpty())
+                continue;
+            core::ModuleDescriptor descriptor;
+            descriptor.name = library.name;
+            descriptor.path = library.modulePath;
+            descriptor.dependencies = library.dependencies;
+            descriptor.order = library.initOrder;
+            descriptors.append(descriptor);
+            // Зависимости подтянет require; модули по запросу ждут явной загрузки
+            if (!library.onDemand && projectLoader->config().libraries.contains(library.name))
+                required.append(library.name);
+        }
+        core::ModuleManager *manager = core::ModuleManager::instance();
+        manager->setModules(descriptors);
+        manager->require(required);
+    });
+    connect(projectLoader, &ProjectLoader::sceneReady, this, [this](const QString &path) {
+        // Сцену, которую пользователь уже начал править, не подменяем
+        if (scenePath.isEmpty() && scene.graph().nodeCount() == 0)
+            openSceneFile(path);
+    });
+    connect(projectLoader, &ProjectLoader::stageFinished, this,
+            [this](ProjectLoader::Stage stage, int completed, int total) {
+        openProgress->setValue(completed);
+        if (completed < total)
+            statusBar->showMessage(QString("Opening project: %1 ready (%2/%3)")
+                                       .arg(ProjectLoader::stageName(stage)).arg(completed).arg(total));
+    });
+    connect(projectLoader, &ProjectLoader::finished, this, [this](qint64 milliseconds) {
+        openProgress->setVisible(false);
+        statusBar->showMessage(QString("Project opened in %1 ms, %2 assets indexed")
+                                   .arg(milliseconds).arg(assetDatabase.count()), 5000);
+    });
+    openProgress->setValue(0);
+    openProgress->setVisible(true);
+    statusBar->showMessage("Opening project...");
+    projectLoader->start();
+}
+
+void EditorWindow::updateMemoryStatus() {
+    const int64_t resident = core::MemoryTracker::processResidentBytes();
+    QString text = "Mem " + MemoryPanel::formatBytes(core::MemoryTracker::totalBytes());
+    if (resident >= 0)
+        text += " / " + MemoryPanel::formatBytes(resident);
+    memoryStatusLabel->setText(text);
 }
 
 void EditorWindow::openProject() {
@@ -277,49 +649,234 @@ void EditorWindow::openProject() {
             QMessageBox::warning(this, "Error", "Selected directory does not contain a valid project (missing config.cfg)!");
             return;
         }
+        // Сцена, история и журнал прошлого проекта не должны переживать переключение:
+        // иначе сохранения уйдут в чужой .sscene, а последняя сцена нового проекта не откроется
+        importPipeline.cancel();
+        newScene();
         projectPath = dir;
-        QSettings config(projectPath + "/config.cfg", QSettings::IniFormat);
-        config.beginGroup("Project");
-        QString projectName = config.value("Name", "Unnamed Project").toString();
-        config.endGroup();
-        setWindowTitle(projectName + " - Specter Engine Editor");
+        RecentProjectStore().touch(projectPath, QString());
+        startProjectLoad();
+        buildOrchestrator.setProjectPath(projectPath);
+        ensureProfilerPanel()->setTraceDirectory(projectPath);
     }
 }
 
 void EditorWindow::saveProject() {
-    QMessageBox::information(this, "Save Project", "Project saved successfully!");
+    if (saveScene())
+        statusBar->showMessage("Project saved", 3000);
+}
+
+void EditorWindow::newScene() {
+    sceneJournal.close();
+    hierarchyModel->resetGraph([this]() { scene.clear(); });
+    history.clear();
+    scenePath.clear();
+    updateInspector();
+}
+
+void EditorWindow::loadScene() {
+    QString path = QFileDialog::getOpenFileName(this, "Load Scene", projectPath, "Specter Scene (*.sscene)");
+    if (path.isEmpty())
+        return;
+    openSceneFile(path);
+}
+
+void EditorWindow::openSceneFile(const QString &path) {
+    QElapsedTimer timer;
+    timer.start();
+    SceneFile file;
+    if (!file.open(path)) {
+        QMessageBox::warning(this, "Error", "Failed to load scene: " + file.errorString());
+        return;
+    }
+    sceneJournal.close();
+    // Базовый файл + записи журнала, не успевшие попасть в него (в том числе после аварийного выхода)
+    bool loaded = false;
+    int replayed = 0;
+    quint64 journalSequence = file.journalSequence();
+    hierarchyModel->resetGraph([&]() {
+        loaded = file.instantiate(scene);
+        if (loaded)
+            replayed = SceneJournal::replay(SceneJournal::pathFor(path), scene, file.journalSequence(), -1, &journalSequence);
+    });
+    history.clear();
+    if (!loaded) {
+        QMessageBox::warning(this, "Error", "Failed to load scene: " + file.errorString());
+        scenePath.clear();
+        return;
+    }
+    bindSceneFile(path, journalSequence);
+    updateInspector();
+    QString message = QString("Scene loaded: %1 objects in %2 ms").arg(scene.graph().nodeCount()).arg(timer.elapsed());
+    if (replayed > 0)
+        message += QString(", %1 journal changes applied").arg(replayed);
+    else if (replayed < 0)
+        message += ", journal is unreadable and was ignored";
+    statusBar->showMessage(message, 5000);
+}
+
+void EditorWindow::bindSceneFile(const QString &path, quint64 journalSequence) {
+    scenePath = path;
+    ProjectLoader::rememberScene(projectPath, path);
+    if (!sceneJournal.open(SceneJournal::pathFor(path), &scene, journalSequence))
+        qWarning() << "Scene journal unavailable:" << sceneJournal.errorString();
+}
+
+bool EditorWindow::saveScene() {
+    if (scenePath.isEmpty() || !sceneJournal.isOpen())
+        return saveSceneAs();
+    SPECTER_PROFILE_SCOPE("EditorWindow::saveScene");
+    // Сохранение — дозапись изменений в журнал; базовый файл пересобирается в фоне
+    if (!sceneJournal.flush()) {
+        QMessageBox::warning(this, "Error", "Failed to save scene: " + sceneJournal.errorString());
+        return false;
+    }
+    statusBar->showMessage("Scene saved: " + scenePath, 3000);
+    if (sceneJournal.needsCompaction())
+        sceneJournal.compact(scenePath);
+    return true;
+}
+
+bool EditorWindow::saveSceneAs() {
+    QString path = QFileDialog::getSaveFileName(this, "Save Scene",
+                                                scenePath.isEmpty() ? projectPath + "/scene.sscene" : scenePath,
+                                                "Specter Scene (*.sscene)");
+    if (path.isEmpty())
+        return false;
+    if (!path.endsWith(".sscene"))
+        path += ".sscene";
+    if (sceneJournal.isCompacting() && path == scenePath) {
+        statusBar->showMessage("Scene is being compacted, try again in a moment", 3000);
+        return false;
+    }
+
+    // Полная запись: новый базовый файл и пустой журнал рядом с ним
+    sceneJournal.close();
+    QFile::remove(SceneJournal::pathFor(path));
+    QString error;
+    if (!SceneFile::write(scene, path, &error)) {
+        QMessageBox::warning(this, "Error", "Failed to save scene: " + error);
+        scenePath.clear();
+        return false;
+    }
+    bindSceneFile(path, 0);
+    statusBar->showMessage("Scene saved: " + scenePath, 3000);
+    return true;
+}
+
+void EditorWindow::onSceneCompacted(bool ok, const QString &error) {
+    if (!ok)
+        qWarning() << "Scene compaction failed:" << error;
 }
 
 void EditorWindow::addToProject() {
     QStringList files = QFileDialog::getOpenFileNames(this, "Add Files to Project", "", "All Files (*.*)");
-    if (!files.isEmpty()) {
-        QMessageBox::information(this, "Add to Project", "Files added: " + files.join(", "));
+    if (files.isEmpty())
+        return;
+    // Копирование и приготовление идут в пуле потоков; новые файлы в assets/ подхватит AssetDatabase
+    importPipeline.import(files, projectPath);
+}
+
+void EditorWindow::onImportFinished(const QVector<ImportResult> &results, qint64 milliseconds) {
+    int cached = 0;
+    QStringList failures;
+    for (const ImportResult &result : results) {
+        if (!result.ok)
+            failures << QFileInfo(result.source).fileName() + ": " + result.error;
+        else if (result.cached)
+            ++cached;
     }
+    statusBar->showMessage(QString("Imported %1 files (%2 from cache, %3 failed) in %4 ms")
+                               .arg(results.size() - failures.size())
+                               .arg(cached)
+                               .arg(failures.size())
+                               .arg(milliseconds),
+                           5000);
+    if (!failures.isEmpty())
+        QMessageBox::warning(this, "Add to Project", "Some files could not be imported:\n" + failures.join("\n"));
+    hotReload.track(results);
+}
+
+void EditorWindow::onAssetsReloaded(const QVector<ImportResult> &results, qint64 milliseconds) {
+    // Сцена не перезагружается: обновляются только миниатюры и кадр вьюпорта.
+    // Ошибка не открывает диалог — файл, скорее всего, сохраняется ещё раз
+    QStringList failures;
+    for (const ImportResult &result : results) {
+        if (result.ok)
+            assetModel->refreshAsset(result.asset);
+        else
+            failures << QFileInfo(result.source).fileName() + ": " + result.error;
+    }
+    sceneViewport->update();
+    if (failures.isEmpty())
+        statusBar->showMessage(QString("Reloaded %1 assets in %2 ms").arg(results.size()).arg(milliseconds), 3000);
+    else
+        statusBar->showMessage("Reload failed: " + failures.join("; "));
 }
 
 void EditorWindow::openCodeEditor() {
     if (!codeEditorProcess) {
         codeEditorProcess = new QProcess(this);
+        // Ошибку запуска сообщает сам QProcess; waitForStarted() держал бы UI до 30 секунд
+        connect(codeEditorProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart)
+                QMessageBox::warning(this, "Error", "Failed to open code editor! Ensure 'code' command is available.");
+        });
     }
+    if (codeEditorProcess->state() != QProcess::NotRunning)
+        return;
     QString editorCommand = "code";
     QStringList arguments;
     arguments << projectPath;
     codeEditorProcess->start(editorCommand, arguments);
-    if (!codeEditorProcess->waitForStarted()) {
-        QMessageBox::warning(this, "Error", "Failed to open code editor! Ensure 'code' command is available.");
-    }
 }
 
 void EditorWindow::buildDebug() {
-    QMessageBox::information(this, "Build Debug", "Building project in Debug mode...");
+    buildOrchestrator.build(BuildOrchestrator::Debug);
 }
 
 void EditorWindow::buildRelease() {
-    QMessageBox::information(this, "Build Release", "Building project in Release mode...");
+    buildOrchestrator.build(BuildOrchestrator::Release);
 }
 
 void EditorWindow::runProject() {
-    QMessageBox::information(this, "Run Project", "Running project...");
+    // Сборка последней конфигурации; если исходники не менялись, она пропускается и игра запускается сразу
+    buildOrchestrator.build(buildOrchestrator.lastConfiguration(), true);
+    // Снимок игры появится рядом с её исполняемым файлом
+    ensureProfilerPanel()->setTraceDirectory(buildOrchestrator.buildDirectory(buildOrchestrator.lastConfiguration()));
+}
+
+void EditorWindow::cancelBuild() {
+    buildOrchestrator.cancel();
+}
+
+void EditorWindow::onBuildStarted(BuildOrchestrator::Configuration config) {
+    buildOutput->clear();
+    buildDock->show();
+    buildDock->raise();
+    buildProgress->setValue(0);
+    buildProgress->setVisible(true);
+    statusBar->showMessage(QString("Building %1...").arg(BuildOrchestrator::configurationName(config)));
+}
+
+void EditorWindow::onBuildFinished(bool ok, bool upToDate) {
+    buildProgress->setVisible(false);
+    const QString config = BuildOrchestrator::configurationName(buildOrchestrator.lastConfiguration());
+    if (upToDate)
+        statusBar->showMessage(QString("%1 is up to date").arg(config), 5000);
+    else if (ok)
+        statusBar->showMessage(QString("%1 build succeeded").arg(config), 5000);
+    else
+        statusBar->showMessage(QString("%1 build failed: %2 errors").arg(config).arg(buildOutput->errorCount()));
+    if (!ok)
+        buildOutput->showProblems();
+}
+
+void EditorWindow::openSourceLocation(const QString &file, int line, int column) {
+    // VS Code открывает файл сразу на нужной позиции; без него — программа по умолчанию
+    const QString location = QString("%1:%2:%3").arg(file).arg(line).arg(qMax(column, 1));
+    if (!QProcess::startDetached("code", {"-g", location}))
+        QDesktopServices::openUrl(QUrl::fromLocalFile(file));
 }
 
 void EditorWindow::showSettings() {
@@ -4,8 +4,8 @@
 #include <QMainWindow>
 #include <QDialog>
 #include <QDockWidget>
+#include <QTreeView>
 #include <QTreeWidget>
-#include <QListWidget>
 #include <QLabel>
 #include <QProcess>
 #include <QVBoxLayout>
@@ -13,6 +13,26 @@
 #include <QMenu>
 #include <QAction>
 #include <QStatusBar>
+#include "Scene/scene.h"
+#include "Scene/commandhistory.h"
+#include "Scene/scenejournal.h"
+#include "Assets/assetdatabase.h"
+#include "Assets/assethotreload.h"
+#include "Assets/librarycatalog.h"
+#include "Assets/assetimport.h"
+#include "Build/buildorchestrator.h"
+
+class SceneHierarchyModel;
+class AssetListModel;
+class QLineEdit;
+class QProgressBar;
+class BuildOutputPanel;
+class ProfilerPanel;
+class MemoryPanel;
+class StartupSequence;
+class ProjectLoader;
+class SceneViewport;
+class InspectorPanel;
 
 class SettingsDialog : public QDialog {
     Q_OBJECT
@@ -40,17 +60,34 @@ class EditorWindow : public QMainWindow {
 public:
     EditorWindow(const QString &projectPath, QWidget *parent = nullptr);
 
+    StartupSequence *startupSequence() const { return startup; }
+
 private slots:
     void openProject();
     void saveProject();
+    void newScene();
+    void loadScene();
+    bool saveScene();
+    bool saveSceneAs();
+    void onSceneCompacted(bool ok, const QString &error);
     void addToProject();
+    void onImportFinished(const QVector<ImportResult> &results, qint64 milliseconds);
+    void onAssetsReloaded(const QVector<ImportResult> &results, qint64 milliseconds);
     void openCodeEditor();
     void buildDebug();
     void buildRelease();
     void runProject();
+    void cancelBuild();
+    void onBuildStarted(BuildOrchestrator::Configuration config);
+    void onBuildFinished(bool ok, bool upToDate);
+    void openSourceLocation(const QString &file, int line, int column);
     void showSettings();
     void showAbout();
     void togglePlaceholder();
+    void updateInspector();
+    void undo();
+    void redo();
+    void updateUndoActions();
 
 private:
     void setupUI();
@@ -60,27 +97,74 @@ private:
     void setupInspectorPanel();
     void setupAssetBrowser();
     void setupModulesPanel();
+    void refreshModulesPanel();
+    void setupBuildPanel();
+    void setupProfilerPanel();
+    void setupMemoryPanel();
+    ProfilerPanel *ensureProfilerPanel();
+    MemoryPanel *ensureMemoryPanel();
     void setupStatusBar();
+    void startProjectLoad();
+    void openSceneFile(const QString &path);
+    void bindSceneFile(const QString &path, quint64 journalSequence);
+    void updateMemoryStatus();
+    // Выполняет команду истории в прямую (forward) или обратную сторону
+    bool runCommand(SceneCommand &command, bool forward);
 
     QString projectPath;
     QProcess *codeEditorProcess;
+    StartupSequence *startup;
+
+    // Сцена
+    Scene scene;
+    SceneHierarchyModel *hierarchyModel;
+    QTreeView *hierarchyView;
+    QString scenePath; // Файл текущей сцены, пусто — ещё не сохранялась
+    SceneJournal sceneJournal; // Сохранение дописывает изменения сюда, а не переписывает scenePath
+    CommandHistory history; // Undo/Redo правок сцены
+    QAction *undoAction;
+    QAction *redoAction;
+
+    // Ассеты проекта
+    AssetDatabase assetDatabase;
+    AssetListModel *assetModel;
+    ProjectLoader *projectLoader; // Стадии открытия текущего проекта
+    AssetImportPipeline importPipeline; // «Add to Project»
+    AssetHotReload hotReload; // Переимпорт изменённых на диске ассетов
+
+    // Сборка игры
+    BuildOrchestrator buildOrchestrator;
+    BuildOutputPanel *buildOutput;
+    ProfilerPanel *profilerPanel; // Создаётся лениво, см. ensureProfilerPanel
+    MemoryPanel *memoryPanel;
+    QProgressBar *buildProgress;
+    QProgressBar *openProgress;
+
+    // Инспектор
+    InspectorPanel *inspector;
 
     // Док-виджеты
     QDockWidget *hierarchyDock;
     QDockWidget *inspectorDock;
     QDockWidget *assetBrowserDock;
     QDockWidget *modulesDock;
+    QTreeWidget *modulesList; // Модуль / состояние / время загрузки
+    QVector<LibraryInfo> projectModules; // Библиотеки проекта и их зависимости
+    QDockWidget *buildDock;
+    QDockWidget *profilerDock;
+    QDockWidget *memoryDock;
 
     // Центральный виджет (Сцена)
     QWidget *sceneViewWidget;
     QVBoxLayout *sceneLayout; // Для управления содержимым сцены
-    QLabel *sceneLabel; // Метка сцены
+    SceneViewport *sceneViewport; // Программный рендер сцены
     QLabel *placeholderWidget; // Placeholder
     bool placeholderVisible; // Флаг состояния Placeholder
     QAction *placeholderAction; // Действие для переключения Placeholder
 
     // Статус-бар
     QStatusBar *statusBar;
+    QLabel *memoryStatusLabel; // Учтённая и резидентная память, обновляется раз в секунду
 };
 
 #endif // EDITORWINDOW_H
\ No newline at end of file
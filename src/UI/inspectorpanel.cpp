@@ -0,0 +1,263 @@
+#include "inspectorpanel.h"
+#include <QCheckBox>
+#include <QDoubleValidator>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QIntValidator>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMenu>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char *const ElementNames[4] = {"X", "Y", "Z", "W"};
+
+// Значение элемента поля как double: так сравниваются и показываются все типы
+double readElement(const unsigned char *component, const reflect::FieldDescriptor &field, int element) {
+    const unsigned char *data = component + field.offset + uint32_t(element) * field.elementSize();
+    switch (field.type) {
+    case reflect::FieldType::Float: {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    case reflect::FieldType::Int32: {
+        int32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    case reflect::FieldType::Bool:
+        return *data ? 1.0 : 0.0;
+    }
+    return 0.0;
+}
+
+int decimalsFor(float step) {
+    int decimals = 0;
+    while (decimals < 6 && std::fabs(step - std::round(step)) > 1.0e-6f) {
+        step *= 10.0f;
+        ++decimals;
+    }
+    return std::max(decimals, 3);
+}
+
+} // namespace
+
+InspectorPanel::InspectorPanel(Scene *scene, QWidget *parent) : QWidget(parent), scene(scene) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    titleLabel = new QLabel(this);
+    layout->addWidget(titleLabel);
+
+    fieldsWidget = new QWidget(this);
+    fieldsLayout = new QVBoxLayout(fieldsWidget);
+    fieldsLayout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(fieldsWidget);
+
+    addComponentButton = new QPushButton("Add Component", this);
+    connect(addComponentButton, &QPushButton::clicked, this, &InspectorPanel::showAddComponentMenu);
+    layout->addWidget(addComponentButton);
+    layout->addStretch();
+
+    rebuild();
+}
+
+const std::vector<InspectorPanel::ComponentType> &InspectorPanel::componentTypes() {
+    static const std::vector<ComponentType> types = typesOf(InspectableComponents());
+    return types;
+}
+
+void InspectorPanel::setSelection(std::vector<SceneGraph::NodeId> nodes) {
+    selected.clear();
+    for (SceneGraph::NodeId node : nodes) {
+        if (node != SceneGraph::RootNode && scene->graph().isValid(node))
+            selected.push_back(node);
+    }
+    rebuild();
+}
+
+bool InspectorPanel::allHave(const ComponentType &type) const {
+    const ecs::ComponentId id = type.id();
+    for (SceneGraph::NodeId node : selected) {
+        if (!scene->world().get(scene->entity(node), id))
+            return false;
+    }
+    return true;
+}
+
+void InspectorPanel::rebuild() {
+    editors.clear();
+    while (QLayoutItem *item = fieldsLayout->takeAt(0)) {
+        delete item->widget();
+        delete item;
+    }
+
+    const std::vector<ComponentType> &types = componentTypes();
+    for (int component = 0; component < int(types.size()); ++component) {
+        const ComponentType &type = types[component];
+        // Группа показывается, если компонент есть хотя бы у одного выделенного объекта
+        bool present = false;
+        for (SceneGraph::NodeId node : selected) {
+            if (scene->world().get(scene->entity(node), type.id())) {
+                present = true;
+                break;
+            }
+        }
+        if (!present)
+            continue;
+
+        QGroupBox *group = new QGroupBox(type.descriptor->name, fieldsWidget);
+        QFormLayout *form = new QFormLayout(group);
+        for (uint32_t field = 0; field < type.descriptor->fieldCount; ++field) {
+            const reflect::FieldDescriptor &descriptor = type.descriptor->fields[field];
+            QWidget *row = new QWidget(group);
+            QHBoxLayout *rowLayout = new QHBoxLayout(row);
+            rowLayout->setContentsMargins(0, 0, 0, 0);
+            for (int element = 0; element < descriptor.count; ++element) {
+                const int elementIndex = descriptor.count > 1 ? element : -1;
+                const int index = int(editors.size());
+                if (descriptor.type == reflect::FieldType::Bool) {
+                    QCheckBox *check = new QCheckBox(row);
+                    connect(check, &QCheckBox::clicked, this, [this, index]() { apply(editors[index]); });
+                    editors.push_back({component, field, elementIndex, check});
+                    rowLayout->addWidget(check);
+                    continue;
+                }
+                QLineEdit *edit = new QLineEdit(row);
+                if (descriptor.type == reflect::FieldType::Float) {
+                    QDoubleValidator *validator = new QDoubleValidator(descriptor.minimum, descriptor.maximum,
+                                                                      decimalsFor(descriptor.step), edit);
+                    validator->setNotation(QDoubleValidator::StandardNotation);
+                    edit->setValidator(validator);
+                } else {
+                    edit->setValidator(new QIntValidator(int(descriptor.minimum), int(descriptor.maximum), edit));
+                }
+                // editingFinished приходит и при потере фокуса без ввода — такие не применяем
+                connect(edit, &QLineEdit::editingFinished, this, [this, index, edit]() {
+                    if (edit->isModified())
+                        apply(editors[index]);
+                });
+                editors.push_back({component, field, elementIndex, edit});
+                rowLayout->addWidget(edit);
+            }
+            form->addRow(descriptor.label, row);
+        }
+        fieldsLayout->addWidget(group);
+    }
+    addComponentButton->setEnabled(!selected.empty());
+    refresh();
+}
+
+void InspectorPanel::refresh() {
+    if (selected.empty())
+        titleLabel->setText("Selected Object: None");
+    else if (selected.size() == 1)
+        titleLabel->setText("Selected Object: " + scene->graph().name(selected.front()));
+    else
+        titleLabel->setText(QString("%1 objects selected").arg(selected.size()));
+
+    const std::vector<ComponentType> &types = componentTypes();
+    std::vector<unsigned char *> components;
+    int loadedComponent = -1;
+    for (const Editor &editor : editors) {
+        // Указатели на компоненты собираются один раз на группу редакторов
+        if (editor.component != loadedComponent) {
+            loadedComponent = editor.component;
+            components.clear();
+            const ecs::ComponentId id = types[editor.component].id();
+            for (SceneGraph::NodeId node : selected) {
+                if (unsigned char *data = scene->world().get(scene->entity(node), id))
+                    components.push_back(data);
+            }
+        }
+        const reflect::FieldDescriptor &descriptor = types[editor.component].descriptor->fields[editor.field];
+        const int element = editor.element < 0 ? 0 : editor.element;
+        const double value = components.empty() ? 0.0 : readElement(components.front(), descriptor, element);
+        bool mixed = false;
+        for (size_t i = 1; i < components.size() && !mixed; ++i)
+            mixed = readElement(components[i], descriptor, element) != value;
+
+        if (QCheckBox *check = qobject_cast<QCheckBox *>(editor.widget)) {
+            const QSignalBlocker blocker(check);
+            check->setTristate(mixed);
+            check->setCheckState(mixed ? Qt::PartiallyChecked : value != 0.0 ? Qt::Checked : Qt::Unchecked);
+            continue;
+        }
+        QLineEdit *edit = static_cast<QLineEdit *>(editor.widget);
+        // setText сбрасывает isModified, поэтому обновление не считается вводом
+        if (mixed) {
+            edit->setText(QString());
+            edit->setPlaceholderText("—");
+        } else {
+            edit->setText(QString::number(value));
+            edit->setPlaceholderText(editor.element < 0 ? QString() : ElementNames[editor.element % 4]);
+        }
+    }
+}
+
+void InspectorPanel::apply(const Editor &editor) {
+    if (selected.empty())
+        return;
+    const ComponentType &type = componentTypes()[editor.component];
+    FieldEdit edit;
+    edit.component = type.descriptor;
+    edit.componentId = type.id();
+    edit.field = editor.field;
+    edit.element = editor.element;
+    edit.nodes = selected;
+    edit.value.resize(edit.size());
+
+    const reflect::FieldDescriptor &descriptor = edit.descriptor();
+    if (QCheckBox *check = qobject_cast<QCheckBox *>(editor.widget)) {
+        // Клик по смешанному флажку включает его у всех
+        edit.value.assign(edit.size(), check->checkState() != Qt::Unchecked ? 1 : 0);
+    } else {
+        QLineEdit *line = static_cast<QLineEdit *>(editor.widget);
+        bool ok = false;
+        const double value = line->text().toDouble(&ok);
+        if (!ok) {
+            refresh();
+            return;
+        }
+        const double clamped = std::min<double>(std::max<double>(value, descriptor.minimum), descriptor.maximum);
+        for (uint32_t offset = 0; offset < edit.size(); offset += descriptor.elementSize()) {
+            if (descriptor.type == reflect::FieldType::Float) {
+                const float number = float(clamped);
+                std::memcpy(edit.value.data() + offset, &number, sizeof(number));
+            } else {
+                const int32_t number = int32_t(std::lround(clamped));
+                std::memcpy(edit.value.data() + offset, &number, sizeof(number));
+            }
+        }
+    }
+
+    if (scene->applyFieldEdit(edit) > 0)
+        emit fieldEdited(edit);
+    refresh();
+}
+
+void InspectorPanel::showAddComponentMenu() {
+    QMenu menu(this);
+    for (const ComponentType &type : componentTypes()) {
+        QAction *action = menu.addAction(type.descriptor->name);
+        // Компонент, который уже есть у всех выделенных, добавить некуда
+        action->setEnabled(!allHave(type));
+        connect(action, &QAction::triggered, this, [this, &type]() {
+            std::vector<ecs::Entity> entities;
+            const ecs::ComponentId id = type.id();
+            for (SceneGraph::NodeId node : selected) {
+                const ecs::Entity entity = scene->entity(node);
+                if (!scene->world().get(entity, id))
+                    entities.push_back(entity);
+            }
+            type.add(scene->world(), entities);
+            rebuild();
+        });
+    }
+    menu.exec(addComponentButton->mapToGlobal(QPoint(0, addComponentButton->height())));
+}
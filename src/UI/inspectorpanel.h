@@ -0,0 +1,71 @@
+#ifndef INSPECTORPANEL_H
+#define INSPECTORPANEL_H
+
+#include <QWidget>
+#include <vector>
+#include "Scene/components.h"
+#include "Scene/fieldedit.h"
+#include "Scene/scene.h"
+
+class QLabel;
+class QPushButton;
+class QVBoxLayout;
+
+// Инспектор выделенных объектов. Редакторы строятся по описаниям reflect компонентов из
+// InspectableComponents: поле float[3] — три строки ввода, bool — флажок. При выделении
+// нескольких объектов расходящиеся значения показываются пустыми, а ввод применяется ко всем
+// выделенным одной пакетной правкой (Scene::applyFieldEdit)
+class InspectorPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit InspectorPanel(Scene *scene, QWidget *parent = nullptr);
+
+    void setSelection(std::vector<SceneGraph::NodeId> nodes);
+    const std::vector<SceneGraph::NodeId> &selection() const { return selected; }
+    // Перечитывает значения полей, не пересоздавая редакторы
+    void refresh();
+
+signals:
+    // Правка уже применена к сцене
+    void fieldEdited(const FieldEdit &edit);
+
+private:
+    struct ComponentType {
+        const reflect::ComponentDescriptor *descriptor;
+        ecs::ComponentId (*id)();
+        void (*add)(ecs::World &world, const std::vector<ecs::Entity> &entities);
+    };
+    struct Editor {
+        int component; // Индекс в componentTypes()
+        uint32_t field;
+        int element;
+        QWidget *widget; // QLineEdit или QCheckBox
+    };
+
+    template<typename T>
+    static void addComponent(ecs::World &world, const std::vector<ecs::Entity> &entities) {
+        world.addBatch<T>(entities);
+    }
+    template<typename... Ts>
+    static std::vector<ComponentType> typesOf(reflect::TypeList<Ts...>) {
+        return {{&reflect::descriptor<Ts>(), &ecs::componentId<Ts>, &addComponent<Ts>}...};
+    }
+    static const std::vector<ComponentType> &componentTypes();
+
+    void rebuild();
+    void showAddComponentMenu();
+    void apply(const Editor &editor);
+    // Есть ли компонент у всех выделенных объектов
+    bool allHave(const ComponentType &type) const;
+
+    Scene *scene;
+    std::vector<SceneGraph::NodeId> selected;
+    QLabel *titleLabel;
+    QWidget *fieldsWidget;
+    QVBoxLayout *fieldsLayout;
+    QPushButton *addComponentButton;
+    std::vector<Editor> editors;
+};
+
+#endif // INSPECTORPANEL_H
@@ -0,0 +1,152 @@
+#include "librarylistview.h"
+#include "createprojectdialog.h"
+#include <QResizeEvent>
+#include <QSize>
+
+// LibraryListModel
+
+LibraryListModel::LibraryListModel(QObject *parent)
+    : QAbstractListModel(parent) {
+}
+
+int LibraryListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : libraries.size();
+}
+
+QVariant LibraryListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= libraries.size())
+        return QVariant();
+    const LibraryInfo &library = libraries.at(index.row());
+    switch (role) {
+    case NameRole:
+        return library.name;
+    case DescriptionRole:
+    case Qt::ToolTipRole:
+        return library.description;
+    case AvatarRole:
+        return library.avatarPath;
+    case Qt::CheckStateRole:
+        return checked.at(index.row()) ? Qt::Checked : Qt::Unchecked;
+    case Qt::SizeHintRole:
+        return QSize(0, RowHeight);
+    default:
+        // DisplayRole намеренно пуст: строку целиком рисует LibraryItemWidget
+        return QVariant();
+    }
+}
+
+bool LibraryListModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    if (!index.isValid() || index.row() >= libraries.size() || role != Qt::CheckStateRole)
+        return false;
+    const bool state = value.toInt() == Qt::Checked;
+    if (checked[index.row()] == state)
+        return true;
+    checked[index.row()] = state;
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+    return true;
+}
+
+Qt::ItemFlags LibraryListModel::flags(const QModelIndex &index) const {
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+}
+
+void LibraryListModel::setLibraries(const QVector<LibraryInfo> &newLibraries) {
+    QSet<QString> selected;
+    for (int i = 0; i < libraries.size(); ++i) {
+        if (checked.at(i))
+            selected.insert(libraries.at(i).configPath);
+    }
+
+    beginResetModel();
+    libraries = newLibraries;
+    checked.fill(false, libraries.size());
+    for (int i = 0; i < libraries.size(); ++i)
+        checked[i] = selected.contains(libraries.at(i).configPath);
+    endResetModel();
+}
+
+QList<LibraryInfo> LibraryListModel::selectedLibraries() const {
+    QList<LibraryInfo> selected;
+    for (int i = 0; i < libraries.size(); ++i) {
+        if (checked.at(i))
+            selected.append(libraries.at(i));
+    }
+    return selected;
+}
+
+// LibraryListView
+
+LibraryListView::LibraryListView(QWidget *parent)
+    : QListView(parent) {
+    setUniformItemSizes(true);
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+}
+
+void LibraryListView::setModel(QAbstractItemModel *newModel) {
+    QListView::setModel(newModel);
+    if (newModel) {
+        // Виджеты создаются после раскладки строк, поэтому отложенно
+        connect(newModel, &QAbstractItemModel::rowsInserted, this, &LibraryListView::updateItemWidgets, Qt::QueuedConnection);
+        connect(newModel, &QAbstractItemModel::modelReset, this, &LibraryListView::updateItemWidgets, Qt::QueuedConnection);
+    }
+}
+
+void LibraryListView::reset() {
+    // QAbstractItemView::reset удаляет все index-виджеты
+    widgetRows.clear();
+    QListView::reset();
+}
+
+void LibraryListView::scrollContentsBy(int dx, int dy) {
+    QListView::scrollContentsBy(dx, dy);
+    updateItemWidgets();
+}
+
+void LibraryListView::resizeEvent(QResizeEvent *event) {
+    QListView::resizeEvent(event);
+    updateItemWidgets();
+}
+
+void LibraryListView::updateItemWidgets() {
+    QAbstractItemModel *listModel = model();
+    if (!listModel || listModel->rowCount() == 0)
+        return;
+
+    const int rows = listModel->rowCount();
+    const int margin = 2;
+    QModelIndex top = indexAt(QPoint(0, 0));
+    QModelIndex bottom = indexAt(QPoint(0, viewport()->height() - 1));
+    const int first = qMax(0, (top.isValid() ? top.row() : 0) - margin);
+    const int last = qMin(rows - 1, (bottom.isValid() ? bottom.row() : rows - 1) + margin);
+
+    // Ушедшие из видимой области строки отдают свои виджеты
+    for (auto it = widgetRows.begin(); it != widgetRows.end();) {
+        if (*it < first || *it > last || *it >= rows) {
+            setIndexWidget(listModel->index(*it, 0), nullptr);
+            it = widgetRows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (int row = first; row <= last; ++row) {
+        if (widgetRows.contains(row))
+            continue;
+        const QModelIndex index = listModel->index(row, 0);
+        LibraryItemWidget *item = new LibraryItemWidget(index.data(LibraryListModel::NameRole).toString(),
+                                                        index.data(LibraryListModel::DescriptionRole).toString(),
+                                                        index.data(LibraryListModel::AvatarRole).toString());
+        item->setAutoFillBackground(true);
+        item->setSelected(index.data(Qt::CheckStateRole).toInt() == Qt::Checked);
+        QPersistentModelIndex persistent(index);
+        connect(item, &LibraryItemWidget::selectionChanged, listModel, [listModel, persistent](bool selected) {
+            if (persistent.isValid())
+                listModel->setData(persistent, selected ? Qt::Checked : Qt::Unchecked, Qt::CheckStateRole);
+        });
+        setIndexWidget(index, item);
+        widgetRows.insert(row);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef LIBRARYLISTVIEW_H
+#define LIBRARYLISTVIEW_H
+
+#include <QAbstractListModel>
+#include <QListView>
+#include <QSet>
+#include <QVector>
+#include "Assets/librarycatalog.h"
+
+// Список библиотек с отметками выбора. Состояние выбора хранится в модели, а не в виджетах,
+// поэтому виджеты строк можно свободно создавать и удалять при прокрутке.
+class LibraryListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    static constexpr int RowHeight = 62;
+
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        DescriptionRole,
+        AvatarRole
+    };
+
+    explicit LibraryListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    // Заменяет список, сохраняя отметки у библиотек с теми же .cfg
+    void setLibraries(const QVector<LibraryInfo> &libraries);
+    QList<LibraryInfo> selectedLibraries() const;
+
+private:
+    QVector<LibraryInfo> libraries;
+    QVector<bool> checked;
+};
+
+// QListView, в котором LibraryItemWidget существуют только для видимых строк (плюс небольшой запас).
+class LibraryListView : public QListView {
+    Q_OBJECT
+
+public:
+    explicit LibraryListView(QWidget *parent = nullptr);
+
+    void setModel(QAbstractItemModel *model) override;
+    void reset() override;
+
+protected:
+    void scrollContentsBy(int dx, int dy) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void updateItemWidgets();
+
+private:
+    QSet<int> widgetRows;
+};
+
+#endif // LIBRARYLISTVIEW_H
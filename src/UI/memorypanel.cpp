@@ -0,0 +1,74 @@
+#include "memorypanel.h"
+#include "Core/memorytracker.h"
+#include <QHeaderView>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <algorithm>
+
+using core::MemoryTag;
+using core::MemoryTracker;
+
+MemoryPanel::MemoryPanel(QWidget *parent) : QWidget(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    table = new QTreeWidget(this);
+    table->setRootIsDecorated(false);
+    table->setUniformRowHeights(true);
+    table->setHeaderLabels({"Subsystem", "Current", "Peak", "Live blocks", "Allocations"});
+    table->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    for (int tag = 0; tag < int(MemoryTag::Count); ++tag) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(table);
+        item->setText(0, MemoryTracker::tagName(MemoryTag(tag)));
+        for (int column = 1; column < 5; ++column)
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+    }
+    layout->addWidget(table);
+
+    processLabel = new QLabel(this);
+    processLabel->setContentsMargins(4, 0, 4, 4);
+    layout->addWidget(processLabel);
+
+    refreshTimer.setInterval(RefreshInterval);
+    connect(&refreshTimer, &QTimer::timeout, this, &MemoryPanel::refresh);
+}
+
+QString MemoryPanel::formatBytes(int64_t bytes) {
+    if (bytes < 0)
+        return QString("n/a");
+    if (bytes < 1024)
+        return QString("%1 B").arg(bytes);
+    if (bytes < 1024 * 1024)
+        return QString("%1 KB").arg(double(bytes) / 1024.0, 0, 'f', 1);
+    return QString("%1 MB").arg(double(bytes) / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+void MemoryPanel::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    refresh();
+    refreshTimer.start();
+}
+
+void MemoryPanel::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    refreshTimer.stop();
+}
+
+void MemoryPanel::refresh() {
+    for (int tag = 0; tag < int(MemoryTag::Count); ++tag) {
+        const MemoryTracker::TagStatistics stats = MemoryTracker::statistics(MemoryTag(tag));
+        QTreeWidgetItem *item = table->topLevelItem(tag);
+        item->setText(1, formatBytes(stats.bytes));
+        item->setText(2, formatBytes(stats.peakBytes));
+        item->setText(3, QString::number(stats.liveBlocks));
+        item->setText(4, QString::number(stats.allocations));
+    }
+    const int64_t tracked = MemoryTracker::totalBytes();
+    const int64_t resident = MemoryTracker::processResidentBytes();
+    // Остаток — Qt, драйверы, стеки и всё, что идёт мимо аллокаторов движка
+    processLabel->setText(resident < 0 ? QString("Tracked: %1").arg(formatBytes(tracked))
+                                       : QString("Tracked: %1   Process resident: %2   Untracked: %3")
+                                             .arg(formatBytes(tracked), formatBytes(resident),
+                                                  formatBytes(std::max<int64_t>(0, resident - tracked))));
+}
@@ -0,0 +1,35 @@
+#ifndef MEMORYPANEL_H
+#define MEMORYPANEL_H
+
+#include <QTimer>
+#include <QWidget>
+#include <cstdint>
+
+class QLabel;
+class QTreeWidget;
+
+// Содержимое дока памяти: учтённая память по подсистемам и резидентная память процесса.
+// Обновляется раз в RefreshInterval, пока док виден
+class MemoryPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    static constexpr int RefreshInterval = 500; // мс
+
+    explicit MemoryPanel(QWidget *parent = nullptr);
+
+    static QString formatBytes(int64_t bytes);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refresh();
+
+    QTreeWidget *table;
+    QLabel *processLabel;
+    QTimer refreshTimer;
+};
+
+#endif // MEMORYPANEL_H
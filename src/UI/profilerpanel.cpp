@@ -0,0 +1,411 @@
+#include "profilerpanel.h"
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHash>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollArea>
+#include <QSplitter>
+#include <QToolButton>
+#include <QToolTip>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+using core::Profiler;
+
+namespace {
+
+const double MinViewDuration = 1000.0; // 1 мкс
+
+QString formatDuration(double ns) {
+    if (ns >= 1e6)
+        return QString::number(ns / 1e6, 'f', 2) + " ms";
+    if (ns >= 1e3)
+        return QString::number(ns / 1e3, 'f', 1) + " us";
+    return QString::number(ns, 'f', 0) + " ns";
+}
+
+// Цвет по имени: один и тот же замер одинаков во всех потоках
+QColor colorForName(int name) {
+    const uint hash = qHash(name) * 2654435761u;
+    return QColor::fromHsv(int(hash % 360), 110, 190);
+}
+
+// Элемент сводки сортируется по числу, а не по тексту
+class SummaryItem : public QTreeWidgetItem {
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem &other) const override {
+        const int column = treeWidget() ? treeWidget()->sortColumn() : 0;
+        if (column == 0)
+            return text(0) < other.text(0);
+        return data(column, Qt::UserRole).toDouble() < other.data(column, Qt::UserRole).toDouble();
+    }
+};
+
+} // namespace
+
+ProfilerTimeline::ProfilerTimeline(QWidget *parent)
+    : QWidget(parent), capture(nullptr), viewStart(0.0), viewDuration(1.0), dragViewStart(0.0), dragging(false) {
+    setMouseTracking(true);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void ProfilerTimeline::setCapture(const Profiler::Capture *newCapture) {
+    capture = newCapture;
+    longestEvent.clear();
+    if (capture) {
+        for (const Profiler::Thread &thread : capture->threads) {
+            uint64_t longest = 0;
+            for (const Profiler::Event &event : thread.events)
+                longest = std::max(longest, event.end - event.start);
+            longestEvent.push_back(longest);
+        }
+    }
+    layoutLanes();
+    resetView();
+}
+
+void ProfilerTimeline::resetView() {
+    viewStart = 0.0;
+    viewDuration = capture ? std::max(MinViewDuration, double(capture->end - capture->start)) : 1.0;
+    update();
+}
+
+void ProfilerTimeline::layoutLanes() {
+    laneTops.clear();
+    int top = RulerHeight;
+    if (capture) {
+        for (const Profiler::Thread &thread : capture->threads) {
+            laneTops.push_back(top);
+            top += LaneHeaderHeight + int(thread.maxDepth + 1) * RowHeight;
+        }
+    }
+    setMinimumHeight(top);
+    updateGeometry();
+}
+
+QSize ProfilerTimeline::sizeHint() const {
+    return QSize(600, minimumHeight());
+}
+
+double ProfilerTimeline::timeAt(double x) const {
+    return viewStart + x * viewDuration / std::max(1, width());
+}
+
+double ProfilerTimeline::xAt(uint64_t time) const {
+    return (double(time - capture->start) - viewStart) * width() / viewDuration;
+}
+
+void ProfilerTimeline::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), QColor(30, 30, 30));
+    if (!capture || capture->threads.empty()) {
+        painter.setPen(QColor(150, 150, 150));
+        painter.drawText(rect(), Qt::AlignCenter, "No capture. Press Record or open a trace.");
+        return;
+    }
+
+    const QFontMetrics metrics = painter.fontMetrics();
+    const int w = width();
+    const QRect dirty = event->rect();
+
+    for (size_t t = 0; t < capture->threads.size(); ++t) {
+        const Profiler::Thread &thread = capture->threads[t];
+        const int laneTop = laneTops[t];
+        const int laneBottom = laneTop + LaneHeaderHeight + int(thread.maxDepth + 1) * RowHeight;
+        if (laneBottom < dirty.top() || laneTop > dirty.bottom())
+            continue;
+
+        painter.fillRect(0, laneTop, w, LaneHeaderHeight, QColor(45, 45, 48));
+        painter.setPen(QColor(212, 212, 212));
+        painter.drawText(QRect(6, laneTop, w - 12, LaneHeaderHeight), Qt::AlignVCenter | Qt::AlignLeft,
+                         QString("%1  (%2 events)").arg(thread.name).arg(thread.events.size()));
+
+        // Первое событие, которое может пересекать видимую область
+        const double visibleStart = viewStart - double(longestEvent[t]);
+        const uint64_t searchFrom = capture->start + uint64_t(std::max(0.0, visibleStart));
+        auto first = std::lower_bound(thread.events.begin(), thread.events.end(), searchFrom,
+                                      [](const Profiler::Event &e, uint64_t time) { return e.start < time; });
+        const uint64_t visibleEnd = capture->start + uint64_t(std::max(0.0, viewStart + viewDuration));
+
+        std::vector<int> lastPixel(thread.maxDepth + 1, -1); // Правый закрашенный пиксель в ряду
+        for (auto it = first; it != thread.events.end() && it->start <= visibleEnd; ++it) {
+            const double x0 = xAt(it->start);
+            const double x1 = xAt(it->end);
+            if (x1 < 0.0 || x0 > w)
+                continue;
+            const int left = int(std::max(0.0, x0));
+            const int right = int(std::min(double(w), x1));
+            int &last = lastPixel[it->depth];
+            if (right <= last)
+                continue; // Сливается с уже нарисованным
+            const int y = laneTop + LaneHeaderHeight + int(it->depth) * RowHeight;
+            const int rectLeft = std::max(left, last + 1);
+            const int rectWidth = std::max(1, right - rectLeft);
+            const QColor color = colorForName(it->name);
+            painter.fillRect(rectLeft, y, rectWidth, RowHeight - 1, color);
+            last = rectLeft + rectWidth - 1;
+            if (rectWidth > 40) {
+                painter.setPen(Qt::black);
+                const QString label = capture->names[it->name] + "  " + formatDuration(double(it->end - it->start));
+                painter.drawText(QRect(rectLeft + 3, y, rectWidth - 6, RowHeight - 1), Qt::AlignVCenter | Qt::AlignLeft,
+                                 metrics.elidedText(label, Qt::ElideRight, rectWidth - 6));
+            }
+        }
+    }
+
+    // Линейка: шаг делений — круглое число наносекунд, примерно 100 пикселей
+    painter.fillRect(0, 0, w, RulerHeight, QColor(37, 37, 38));
+    const double rough = viewDuration * 100.0 / std::max(1, w);
+    double step = std::pow(10.0, std::floor(std::log10(rough)));
+    if (rough / step > 5.0)
+        step *= 5.0;
+    else if (rough / step > 2.0)
+        step *= 2.0;
+    painter.setPen(QColor(150, 150, 150));
+    for (double tick = std::ceil(viewStart / step) * step; tick < viewStart + viewDuration; tick += step) {
+        const int x = int((tick - viewStart) * w / viewDuration);
+        painter.drawLine(x, RulerHeight - 5, x, RulerHeight);
+        painter.drawText(x + 3, RulerHeight - 6, formatDuration(tick));
+    }
+}
+
+const Profiler::Event *ProfilerTimeline::eventAt(const QPoint &position, int *threadIndex) const {
+    if (!capture)
+        return nullptr;
+    for (size_t t = 0; t < capture->threads.size(); ++t) {
+        const Profiler::Thread &thread = capture->threads[t];
+        const int rowsTop = laneTops[t] + LaneHeaderHeight;
+        const int row = position.y() >= rowsTop ? (position.y() - rowsTop) / RowHeight : -1;
+        if (row < 0 || row > int(thread.maxDepth))
+            continue;
+        // Под курсором может оказаться слитая черта — берём ближайшее событие в пределах пикселя
+        const double pixel = viewDuration / std::max(1, width());
+        const double time = timeAt(position.x());
+        const uint64_t from = capture->start + uint64_t(std::max(0.0, time - pixel - double(longestEvent[t])));
+        const uint64_t to = capture->start + uint64_t(std::max(0.0, time + pixel));
+        auto it = std::lower_bound(thread.events.begin(), thread.events.end(), from,
+                                   [](const Profiler::Event &e, uint64_t value) { return e.start < value; });
+        for (; it != thread.events.end() && it->start <= to; ++it) {
+            if (int(it->depth) != row)
+                continue;
+            const double start = double(it->start - capture->start);
+            const double end = double(it->end - capture->start);
+            if (start <= time + pixel && end >= time - pixel) {
+                *threadIndex = int(t);
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+    return nullptr;
+}
+
+void ProfilerTimeline::wheelEvent(QWheelEvent *event) {
+    if (!capture)
+        return;
+    const double anchor = timeAt(event->pos().x());
+    const double factor = std::pow(0.998, double(event->angleDelta().y()));
+    const double total = std::max(MinViewDuration, double(capture->end - capture->start));
+    viewDuration = qBound(MinViewDuration, viewDuration * factor, total * 1.2);
+    viewStart = anchor - event->pos().x() * viewDuration / std::max(1, width());
+    update();
+    event->accept();
+}
+
+void ProfilerTimeline::mousePressEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        dragging = true;
+        dragOrigin = event->pos();
+        dragViewStart = viewStart;
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void ProfilerTimeline::mouseMoveEvent(QMouseEvent *event) {
+    if (dragging) {
+        viewStart = dragViewStart - (event->pos().x() - dragOrigin.x()) * viewDuration / std::max(1, width());
+        update();
+        return;
+    }
+    int threadIndex = -1;
+    if (const Profiler::Event *hit = eventAt(event->pos(), &threadIndex)) {
+        QToolTip::showText(event->globalPos(),
+                           QString("%1\n%2\n%3")
+                               .arg(capture->names[hit->name],
+                                    formatDuration(double(hit->end - hit->start)),
+                                    capture->threads[size_t(threadIndex)].name),
+                           this);
+    } else {
+        QToolTip::hideText();
+    }
+}
+
+void ProfilerTimeline::mouseReleaseEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        dragging = false;
+        unsetCursor();
+    }
+}
+
+void ProfilerTimeline::mouseDoubleClickEvent(QMouseEvent *) {
+    resetView();
+}
+
+ProfilerPanel::ProfilerPanel(QWidget *parent) : QWidget(parent), captureBytes(core::MemoryTag::UI) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    QHBoxLayout *toolbar = new QHBoxLayout;
+    toolbar->setContentsMargins(4, 4, 4, 0);
+    recordButton = new QToolButton(this);
+    recordButton->setText("Record");
+    recordButton->setCheckable(true);
+    connect(recordButton, &QToolButton::toggled, this, &ProfilerPanel::toggleRecording);
+    toolbar->addWidget(recordButton);
+
+    QToolButton *openButton = new QToolButton(this);
+    openButton->setText("Open Trace...");
+    connect(openButton, &QToolButton::clicked, this, &ProfilerPanel::openTraceDialog);
+    toolbar->addWidget(openButton);
+
+    saveButton = new QToolButton(this);
+    saveButton->setText("Export...");
+    saveButton->setEnabled(false);
+    connect(saveButton, &QToolButton::clicked, this, &ProfilerPanel::saveTraceDialog);
+    toolbar->addWidget(saveButton);
+
+    statusLabel = new QLabel(this);
+    toolbar->addWidget(statusLabel, 1);
+    layout->addLayout(toolbar);
+
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+    QScrollArea *scroll = new QScrollArea(splitter);
+    scroll->setWidgetResizable(true);
+    scroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff); // По горизонтали — масштаб и сдвиг шкалы
+    timeline = new ProfilerTimeline(scroll);
+    scroll->setWidget(timeline);
+    splitter->addWidget(scroll);
+
+    summary = new QTreeWidget(splitter);
+    summary->setRootIsDecorated(false);
+    summary->setUniformRowHeights(true);
+    summary->setHeaderLabels({"Scope", "Calls", "Total ms", "Self ms", "Max ms"});
+    summary->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    summary->setSortingEnabled(true);
+    splitter->addWidget(summary);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 1);
+    layout->addWidget(splitter);
+
+    showCapture();
+}
+
+void ProfilerPanel::toggleRecording(bool record) {
+    if (record) {
+        Profiler::beginCapture();
+        recordButton->setText("Stop");
+        statusLabel->setText("Recording...");
+        return;
+    }
+    capture = Profiler::endCapture();
+    recordButton->setText("Record");
+    showCapture();
+}
+
+void ProfilerPanel::openTraceDialog() {
+    const QString path = QFileDialog::getOpenFileName(this, "Open Trace", traceDirectory, "Chrome Trace (*.json)");
+    if (!path.isEmpty())
+        openTrace(path);
+}
+
+void ProfilerPanel::openTrace(const QString &path) {
+    if (recordButton->isChecked())
+        recordButton->setChecked(false);
+    Profiler::Capture loaded;
+    QString error;
+    if (!Profiler::readChromeTrace(path, &loaded, &error)) {
+        QMessageBox::warning(this, "Error", "Failed to open trace: " + error);
+        return;
+    }
+    capture = std::move(loaded);
+    showCapture();
+}
+
+void ProfilerPanel::saveTraceDialog() {
+    const QString path = QFileDialog::getSaveFileName(this, "Export Trace", traceDirectory + "/trace.json",
+                                                      "Chrome Trace (*.json)");
+    if (path.isEmpty())
+        return;
+    QString error;
+    if (!Profiler::writeChromeTrace(capture, path, &error))
+        QMessageBox::warning(this, "Error", "Failed to export trace: " + error);
+}
+
+void ProfilerPanel::showCapture() {
+    captureBytes.set(capture.eventCount() * sizeof(Profiler::Event));
+    timeline->setCapture(&capture);
+    saveButton->setEnabled(!capture.isEmpty());
+    statusLabel->setText(capture.isEmpty()
+                             ? QString()
+                             : QString("%1 events, %2 threads, %3 ms")
+                                   .arg(capture.eventCount())
+                                   .arg(capture.threads.size())
+                                   .arg(double(capture.end - capture.start) / 1e6, 0, 'f', 2));
+    fillSummary();
+}
+
+void ProfilerPanel::fillSummary() {
+    struct Totals {
+        int calls = 0;
+        uint64_t total = 0;
+        uint64_t self = 0;
+        uint64_t longest = 0;
+    };
+    std::vector<Totals> totals(size_t(capture.names.size()));
+    for (const Profiler::Thread &thread : capture.threads) {
+        // Собственное время = длительность минус время прямых потомков
+        std::vector<const Profiler::Event *> stack;
+        for (const Profiler::Event &event : thread.events) {
+            const uint64_t duration = event.end - event.start;
+            while (!stack.empty() && stack.back()->depth >= event.depth)
+                stack.pop_back();
+            if (!stack.empty() && stack.back()->depth + 1 == event.depth)
+                totals[size_t(stack.back()->name)].self -= duration;
+            stack.push_back(&event);
+            Totals &entry = totals[size_t(event.name)];
+            ++entry.calls;
+            entry.total += duration;
+            entry.self += duration;
+            entry.longest = std::max(entry.longest, duration);
+        }
+    }
+
+    summary->setSortingEnabled(false);
+    summary->clear();
+    for (int i = 0; i < capture.names.size(); ++i) {
+        const Totals &entry = totals[size_t(i)];
+        if (entry.calls == 0)
+            continue;
+        SummaryItem *item = new SummaryItem(summary);
+        item->setText(0, capture.names[i]);
+        const double values[4] = {double(entry.calls), entry.total / 1e6, double(int64_t(entry.self)) / 1e6,
+                                  entry.longest / 1e6};
+        for (int column = 1; column <= 4; ++column) {
+            item->setText(column, column == 1 ? QString::number(entry.calls)
+                                              : QString::number(values[column - 1], 'f', 3));
+            item->setData(column, Qt::UserRole, values[column - 1]);
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+    summary->setSortingEnabled(true);
+    summary->sortByColumn(3, Qt::DescendingOrder);
+}
@@ -0,0 +1,83 @@
+#ifndef PROFILERPANEL_H
+#define PROFILERPANEL_H
+
+#include <QWidget>
+#include "Core/memorytracker.h"
+#include "Core/profiler.h"
+
+class QLabel;
+class QToolButton;
+class QTreeWidget;
+
+// Временная шкала снимка: по дорожке на поток, внутри — ряды по вложенности (flame chart).
+// Колесо — масштаб вокруг курсора, перетаскивание — сдвиг, двойной щелчок — весь снимок.
+// Рисуются только видимые события; события уже пикселя сливаются в одну черту
+class ProfilerTimeline : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ProfilerTimeline(QWidget *parent = nullptr);
+
+    void setCapture(const core::Profiler::Capture *capture);
+    void resetView();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    static constexpr int RulerHeight = 20;
+    static constexpr int LaneHeaderHeight = 18;
+    static constexpr int RowHeight = 18;
+
+    double timeAt(double x) const;
+    double xAt(uint64_t time) const;
+    const core::Profiler::Event *eventAt(const QPoint &position, int *threadIndex) const;
+    void layoutLanes();
+
+    const core::Profiler::Capture *capture;
+    std::vector<int> laneTops;             // Верх дорожки каждого потока
+    std::vector<uint64_t> longestEvent;    // Самое длинное событие потока: граница поиска видимых
+    double viewStart;                      // нс от начала снимка
+    double viewDuration;
+    QPoint dragOrigin;
+    double dragViewStart;
+    bool dragging;
+};
+
+// Содержимое дока профилировщика: запись снимка редактора, открытие снимков игры,
+// экспорт в Chrome Trace и сводка по именам замеров
+class ProfilerPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ProfilerPanel(QWidget *parent = nullptr);
+
+    // Каталог, который предлагается при открытии снимка (сборка проекта)
+    void setTraceDirectory(const QString &directory) { traceDirectory = directory; }
+    void openTrace(const QString &path);
+
+private:
+    void toggleRecording(bool record);
+    void openTraceDialog();
+    void saveTraceDialog();
+    void showCapture();
+    void fillSummary();
+
+    core::Profiler::Capture capture;
+    core::TrackedBytes captureBytes; // Снимок — самая крупная структура интерфейса
+    ProfilerTimeline *timeline;
+    QTreeWidget *summary;
+    QToolButton *recordButton;
+    QToolButton *saveButton;
+    QLabel *statusLabel;
+    QString traceDirectory;
+};
+
+#endif // PROFILERPANEL_H
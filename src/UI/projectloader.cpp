@@ -0,0 +1,148 @@
+#include "projectloader.h"
+#include "Assets/assetdatabase.h"
+#include "Core/jobsystem.h"
+#include "Core/profiler.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+
+namespace {
+
+// Читает файл целиком блоками, чтобы последующий разбор в UI-потоке шёл из кэша страниц
+void prefetchFile(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    QByteArray block(1 << 20, Qt::Uninitialized);
+    while (file.read(block.data(), block.size()) > 0) {
+    }
+}
+
+} // namespace
+
+ProjectLoader::ProjectLoader(const QString &projectPath, AssetDatabase *assets, QObject *parent)
+    : QObject(parent), path(projectPath), assets(assets), completed(0), stageDone{} {}
+
+const char *ProjectLoader::stageName(Stage stage) {
+    switch (stage) {
+    case ConfigStage:
+        return "config";
+    case AssetsStage:
+        return "asset index";
+    case ModulesStage:
+        return "modules";
+    case SceneStage:
+        return "scene";
+    case StageCount:
+        break;
+    }
+    return "?";
+}
+
+ProjectConfig ProjectLoader::readConfig(const QString &projectPath) {
+    SPECTER_PROFILE_FUNCTION();
+    ProjectConfig result;
+    QSettings config(projectPath + "/config.cfg", QSettings::IniFormat);
+    config.beginGroup("Project");
+    result.name = config.value("Name", "Unnamed Project").toString();
+    result.description = config.value("Description").toString();
+    result.renderMode = config.value("RenderMode").toString();
+    config.endGroup();
+    // Render1, Render2, ... в порядке приоритета, как их пишет CreateProjectDialog
+    for (int i = 1; config.childGroups().contains(QString("Render%1").arg(i)); ++i)
+        result.renderApis.append(config.value(QString("Render%1/API").arg(i)).toString());
+    result.libraries = config.value("Libraries/Selected").toStringList();
+    const QString lastScene = config.value("Editor/LastScene").toString();
+    if (!lastScene.isEmpty())
+        result.lastScene = QDir(projectPath).absoluteFilePath(lastScene);
+    result.undoMemoryMB = config.value("Editor/UndoMemoryMB", result.undoMemoryMB).toInt();
+    return result;
+}
+
+void ProjectLoader::rememberScene(const QString &projectPath, const QString &scenePath) {
+    QSettings config(projectPath + "/config.cfg", QSettings::IniFormat);
+    config.setValue("Editor/LastScene", QDir(projectPath).relativeFilePath(scenePath));
+}
+
+void ProjectLoader::start() {
+    timer.start();
+
+    // Индекс ассетов нужен только путь — запускаем сразу, он сам уходит в свой поток
+    connect(assets, &AssetDatabase::indexingFinished, this, [this]() { finishStage(AssetsStage); });
+    assets->open(path);
+
+    const QString projectPath = path;
+    core::JobSystem::instance().runThen([projectPath]() { return readConfig(projectPath); }, this,
+                                        [this](const ProjectConfig &loaded) { onConfigLoaded(loaded); });
+}
+
+void ProjectLoader::onConfigLoaded(const ProjectConfig &loaded) {
+    projectConfig = loaded;
+    emit configLoaded(projectConfig);
+    finishStage(ConfigStage);
+    startModules();
+    startScene();
+}
+
+void ProjectLoader::startModules() {
+    if (projectConfig.libraries.isEmpty()) {
+        emit modulesResolved({});
+        finishStage(ModulesStage);
+        return;
+    }
+    // Каталог отвечает из своего кэша; берём из него выбранные проектом библиотеки и всё,
+    // от чего они зависят. Сами модули здесь не открываются — это делает ModuleManager
+    LibraryCatalog *catalog = LibraryCatalog::instance();
+    connect(catalog, &LibraryCatalog::loaded, this, [this](const QVector<LibraryInfo> &libraries) {
+        if (stageDone[ModulesStage])
+            return;
+        QStringList wanted = projectConfig.libraries;
+        for (int i = 0; i < wanted.size(); ++i) {
+            for (const LibraryInfo &library : libraries) {
+                if (library.name != wanted[i])
+                    continue;
+                for (const QString &dependency : library.dependencies) {
+                    if (!wanted.contains(dependency))
+                        wanted.append(dependency);
+                }
+            }
+        }
+        QVector<LibraryInfo> modules;
+        for (const LibraryInfo &library : libraries) {
+            if (wanted.contains(library.name))
+                modules.append(library);
+        }
+        emit modulesResolved(modules);
+        finishStage(ModulesStage);
+    });
+    catalog->refresh({"libs/standart", "libs/custom"});
+}
+
+void ProjectLoader::startScene() {
+    const QString scenePath = projectConfig.lastScene;
+    if (scenePath.isEmpty()) {
+        finishStage(SceneStage);
+        return;
+    }
+    core::JobSystem::instance().runThen([scenePath]() {
+        const bool exists = QFileInfo(scenePath).isFile();
+        if (exists)
+            prefetchFile(scenePath);
+        return exists;
+    }, this, [this, scenePath](bool exists) {
+        if (exists)
+            emit sceneReady(scenePath);
+        finishStage(SceneStage);
+    });
+}
+
+void ProjectLoader::finishStage(Stage stage) {
+    if (stageDone[stage])
+        return;
+    stageDone[stage] = true;
+    ++completed;
+    emit stageFinished(stage, completed, StageCount);
+    if (completed == StageCount)
+        emit finished(timer.elapsed());
+}
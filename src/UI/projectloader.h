@@ -0,0 +1,77 @@
+#ifndef PROJECTLOADER_H
+#define PROJECTLOADER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "Assets/librarycatalog.h"
+
+class AssetDatabase;
+
+struct ProjectConfig {
+    QString name;
+    QString description;
+    QString renderMode;
+    QStringList renderApis;
+    QStringList libraries; // Имена выбранных библиотек
+    QString lastScene;     // Абсолютный путь, пусто — сцена ещё не сохранялась
+    int undoMemoryMB = 64; // Бюджет памяти истории правок, остальное уходит на диск
+};
+
+// Открытие проекта по стадиям. Разбор config.cfg идёт в пуле потоков и сразу даёт минимум
+// для работы окна (configLoaded). Индекс ассетов стартует одновременно с ним, модули и последняя
+// сцена — как только известен конфиг; друг от друга они не зависят и идут параллельно.
+// Сцена заранее дочитывается с диска в фоне, в UI-потоке остаётся только её разбор (sceneReady)
+class ProjectLoader : public QObject {
+    Q_OBJECT
+
+public:
+    enum Stage {
+        ConfigStage,
+        AssetsStage,
+        ModulesStage,
+        SceneStage,
+        StageCount
+    };
+
+    ProjectLoader(const QString &projectPath, AssetDatabase *assets, QObject *parent = nullptr);
+
+    void start();
+
+    QString projectPath() const { return path; }
+    const ProjectConfig &config() const { return projectConfig; }
+    int completedStages() const { return completed; }
+    bool isFinished() const { return completed == StageCount; }
+    static const char *stageName(Stage stage);
+
+    // Любой поток
+    static ProjectConfig readConfig(const QString &projectPath);
+    // Запоминает в config.cfg сцену, которую откроет следующий запуск
+    static void rememberScene(const QString &projectPath, const QString &scenePath);
+
+signals:
+    void configLoaded(const ProjectConfig &config);
+    // Выбранные в проекте библиотеки и их зависимости
+    void modulesResolved(const QVector<LibraryInfo> &modules);
+    // Файл уже прочитан с диска; обработчик разбирает его в UI-потоке
+    void sceneReady(const QString &scenePath);
+    void stageFinished(ProjectLoader::Stage stage, int completed, int total);
+    void finished(qint64 milliseconds);
+
+private:
+    void onConfigLoaded(const ProjectConfig &loaded);
+    void startModules();
+    void startScene();
+    void finishStage(Stage stage);
+
+    QString path;
+    AssetDatabase *assets;
+    ProjectConfig projectConfig;
+    QElapsedTimer timer;
+    int completed;
+    bool stageDone[StageCount];
+};
+
+#endif // PROJECTLOADER_H
@@ -0,0 +1,197 @@
+#include "recentprojects.h"
+#include "Core/jobsystem.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QTimer>
+
+namespace {
+
+const quint32 StoreMagic = 0x53525050; // "SRPP"
+const quint32 StoreVersion = 1;
+
+// Свой пул, который никогда не удаляется: поток, повисший на недоступном сетевом диске,
+// не должен занимать планировщик и не должен держать выход из приложения (JobSystem и пул
+// при удалении ждут свои потоки)
+QThreadPool *validationPool() {
+    static QThreadPool *pool = [] {
+        QThreadPool *created = new QThreadPool;
+        created->setMaxThreadCount(4);
+        return created;
+    }();
+    return pool;
+}
+
+// Выполняется в пуле: любое обращение к файлам здесь может висеть сколько угодно
+RecentProject inspect(const QString &path) {
+    RecentProject result;
+    result.path = path;
+    const QString configPath = path + "/config.cfg";
+    if (!QFileInfo(configPath).isFile()) {
+        result.status = RecentProject::Missing;
+        return result;
+    }
+    result.status = RecentProject::Available;
+
+    QSettings config(configPath, QSettings::IniFormat);
+    result.name = config.value("Project/Name").toString();
+
+    const QStringList logos = QDir(path + "/files").entryList({"logo.*"}, QDir::Files);
+    if (!logos.isEmpty()) {
+        QImageReader reader(path + "/files/" + logos.first());
+        const QSize size = reader.size();
+        if (size.isValid())
+            reader.setScaledSize(size.scaled(RecentProjectStore::LogoSize, RecentProjectStore::LogoSize,
+                                              Qt::KeepAspectRatio));
+        result.logo = reader.read();
+    }
+    return result;
+}
+
+} // namespace
+
+RecentProjectStore::RecentProjectStore(QObject *parent) : RecentProjectStore(defaultFile(), parent) {}
+
+RecentProjectStore::RecentProjectStore(const QString &file, QObject *parent)
+    : QObject(parent), file(file), validationRound(0) {
+    load();
+}
+
+QString RecentProjectStore::defaultFile() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/recent_projects.bin";
+}
+
+int RecentProjectStore::indexOf(const QString &path) const {
+    for (int i = 0; i < list.size(); ++i) {
+        if (list[i].path == path)
+            return i;
+    }
+    return -1;
+}
+
+void RecentProjectStore::load() {
+    QFile input(file);
+    if (!input.open(QIODevice::ReadOnly)) {
+        // Первый запуск с новым хранилищем — переносим старый список из ../recent_projects.ini
+        if (importLegacy())
+            save();
+        return;
+    }
+    QDataStream stream(&input);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (magic != StoreMagic || version != StoreVersion)
+        return;
+    list.reserve(int(qMin<quint32>(count, MaxProjects)));
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        RecentProject project;
+        quint8 status;
+        stream >> project.path >> project.name >> project.lastOpened >> project.logo >> status;
+        // Состояние прошлого запуска показывается, пока не придёт свежая проверка
+        project.status = RecentProject::Status(status);
+        if (stream.status() == QDataStream::Ok && list.size() < MaxProjects)
+            list.append(project);
+    }
+}
+
+bool RecentProjectStore::importLegacy() {
+    QSettings legacy("../recent_projects.ini", QSettings::IniFormat);
+    const QStringList entries = legacy.value("recent_projects").toStringList();
+    for (const QString &entry : entries) {
+        const QStringList parts = entry.split('|');
+        if (parts.size() != 2 || indexOf(parts[1]) >= 0 || list.size() >= MaxProjects)
+            continue;
+        RecentProject project;
+        project.name = parts[0];
+        project.path = parts[1];
+        list.append(project);
+    }
+    return !list.isEmpty();
+}
+
+bool RecentProjectStore::save() const {
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    QSaveFile output(file);
+    if (!output.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&output);
+    stream << StoreMagic << StoreVersion << quint32(list.size());
+    for (const RecentProject &project : list)
+        stream << project.path << project.name << project.lastOpened << project.logo << quint8(project.status);
+    return output.commit();
+}
+
+void RecentProjectStore::touch(const QString &path, const QString &name) {
+    const QString cleanPath = QDir::cleanPath(path);
+    RecentProject project;
+    const int index = indexOf(cleanPath);
+    if (index >= 0)
+        project = list.takeAt(index);
+    project.path = cleanPath;
+    if (!name.isEmpty())
+        project.name = name;
+    project.lastOpened = QDateTime::currentDateTimeUtc();
+    project.status = RecentProject::Available; // Его только что открыли
+    list.prepend(project);
+    if (list.size() > MaxProjects)
+        list.resize(MaxProjects);
+    save();
+    emit listChanged();
+}
+
+void RecentProjectStore::remove(const QString &path) {
+    const int index = indexOf(path);
+    if (index < 0)
+        return;
+    list.removeAt(index);
+    save();
+    emit listChanged();
+}
+
+void RecentProjectStore::validate() {
+    const quint64 round = ++validationRound;
+    for (const RecentProject &project : list) {
+        const QString path = project.path;
+        if (inFlight.contains(path))
+            continue; // Прошлая проверка ещё висит — второй поток на тот же путь не нужен
+        inFlight.insert(path);
+        core::runThen(validationPool(), [path]() { return inspect(path); }, this,
+                      [this](const RecentProject &result) { applyValidation(result); });
+    }
+    QTimer::singleShot(ValidationTimeout, this, [this, round]() { expireValidation(round); });
+}
+
+void RecentProjectStore::applyValidation(const RecentProject &result) {
+    inFlight.remove(result.path);
+    const int index = indexOf(result.path);
+    if (index < 0)
+        return;
+    RecentProject &project = list[index];
+    project.status = result.status;
+    if (result.status == RecentProject::Available) {
+        if (!result.name.isEmpty())
+            project.name = result.name;
+        project.logo = result.logo;
+    }
+    // Пишем файл один раз, когда вернулись все проверки, а не на каждый проект
+    if (inFlight.isEmpty())
+        save();
+    emit projectChanged(index);
+}
+
+void RecentProjectStore::expireValidation(quint64 round) {
+    if (round != validationRound || inFlight.isEmpty())
+        return;
+    for (int i = 0; i < list.size(); ++i) {
+        if (inFlight.contains(list[i].path) && list[i].status != RecentProject::Unreachable) {
+            list[i].status = RecentProject::Unreachable;
+            emit projectChanged(i);
+        }
+    }
+    save();
+}
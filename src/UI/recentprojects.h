@@ -0,0 +1,70 @@
+#ifndef RECENTPROJECTS_H
+#define RECENTPROJECTS_H
+
+#include <QDateTime>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+struct RecentProject {
+    enum Status : quint8 {
+        Unknown,     // Ещё не проверялся в этом запуске
+        Available,
+        Missing,     // Каталога или config.cfg нет
+        Unreachable  // Проверка не уложилась в таймаут (например, повисший сетевой диск)
+    };
+
+    QString path;
+    QString name;
+    QDateTime lastOpened;
+    QImage logo; // Уменьшенный логотип проекта, пустой — логотипа нет
+    Status status = Unknown;
+};
+
+// Недавние проекты в каталоге настроек пользователя (recent_projects.bin), от нового к старому.
+// Список читается из файла сразу и показывается по сохранённым данным; проверка путей, чтение
+// config.cfg и логотипов идут в фоне. Если проверка не ответила за ValidationTimeout, проект
+// помечается Unreachable, а запоздавший ответ всё равно применяется, когда придёт
+class RecentProjectStore : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MaxProjects = 20;
+    static constexpr int ValidationTimeout = 2000; // мс
+    static constexpr int LogoSize = 32;
+
+    explicit RecentProjectStore(QObject *parent = nullptr);
+    explicit RecentProjectStore(const QString &file, QObject *parent = nullptr);
+
+    static QString defaultFile();
+
+    const QVector<RecentProject> &projects() const { return list; }
+    int indexOf(const QString &path) const;
+
+    // Проект открыт: поднимается в начало списка, список сохраняется
+    void touch(const QString &path, const QString &name);
+    void remove(const QString &path);
+
+    // Фоновая проверка всех проектов; итог по каждому — projectChanged
+    void validate();
+
+signals:
+    void projectChanged(int index);
+    void listChanged();
+
+private:
+    void load();
+    bool importLegacy();
+    bool save() const;
+    void applyValidation(const RecentProject &result);
+    void expireValidation(quint64 round);
+
+    QString file;
+    QVector<RecentProject> list;
+    QSet<QString> inFlight; // Пути, проверка которых ещё не вернулась
+    quint64 validationRound;
+};
+
+#endif // RECENTPROJECTS_H
@@ -0,0 +1,225 @@
+#include "scenehierarchymodel.h"
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+SceneHierarchyModel::SceneHierarchyModel(Scene *scene, QObject *parent)
+    : QAbstractItemModel(parent), scene(scene), graph(&scene->graph()) {
+    fetched.assign(graph->capacity(), 0);
+}
+
+int SceneHierarchyModel::fetchedRows(SceneGraph::NodeId node) const {
+    return node < fetched.size() ? fetched[node] : 0;
+}
+
+SceneGraph::NodeId SceneHierarchyModel::nodeForIndex(const QModelIndex &index) const {
+    if (!index.isValid())
+        return SceneGraph::RootNode;
+    return static_cast<SceneGraph::NodeId>(index.internalId());
+}
+
+QModelIndex SceneHierarchyModel::indexForNode(SceneGraph::NodeId node) const {
+    if (node == SceneGraph::RootNode || !graph->isValid(node))
+        return QModelIndex();
+    int row = graph->row(node);
+    if (row >= fetchedRows(graph->parent(node)))
+        return QModelIndex();
+    return createIndex(row, 0, quintptr(node));
+}
+
+QModelIndex SceneHierarchyModel::index(int row, int column, const QModelIndex &parent) const {
+    SceneGraph::NodeId parentNode = nodeForIndex(parent);
+    if (column != 0 || row < 0 || row >= fetchedRows(parentNode))
+        return QModelIndex();
+    return createIndex(row, column, quintptr(graph->child(parentNode, row)));
+}
+
+QModelIndex SceneHierarchyModel::parent(const QModelIndex &child) const {
+    if (!child.isValid())
+        return QModelIndex();
+    SceneGraph::NodeId parentNode = graph->parent(nodeForIndex(child));
+    if (parentNode == SceneGraph::RootNode || parentNode == SceneGraph::InvalidNode)
+        return QModelIndex();
+    return createIndex(graph->row(parentNode), 0, quintptr(parentNode));
+}
+
+int SceneHierarchyModel::rowCount(const QModelIndex &parent) const {
+    if (parent.column() > 0)
+        return 0;
+    return fetchedRows(nodeForIndex(parent));
+}
+
+int SceneHierarchyModel::columnCount(const QModelIndex &) const {
+    return 1;
+}
+
+bool SceneHierarchyModel::hasChildren(const QModelIndex &parent) const {
+    // Стрелка раскрытия должна быть видна до того, как дети подгружены
+    return graph->childCount(nodeForIndex(parent)) > 0;
+}
+
+bool SceneHierarchyModel::canFetchMore(const QModelIndex &parent) const {
+    SceneGraph::NodeId node = nodeForIndex(parent);
+    return fetchedRows(node) < graph->childCount(node);
+}
+
+void SceneHierarchyModel::fetchMore(const QModelIndex &parent) {
+    SceneGraph::NodeId node = nodeForIndex(parent);
+    int first = fetchedRows(node);
+    int remaining = graph->childCount(node) - first;
+    if (remaining <= 0)
+        return;
+    int batch = std::min(remaining, FetchBatchSize);
+    beginInsertRows(parent, first, first + batch - 1);
+    fetched[node] += batch;
+    endInsertRows();
+}
+
+QVariant SceneHierarchyModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid())
+        return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return graph->name(nodeForIndex(index));
+    return QVariant();
+}
+
+bool SceneHierarchyModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    if (!index.isValid() || role != Qt::EditRole)
+        return false;
+    QString newName = value.toString();
+    if (newName.isEmpty())
+        return false;
+    const SceneGraph::NodeId node = nodeForIndex(index);
+    const QString oldName = graph->name(node);
+    if (newName == oldName)
+        return true;
+    scene->setName(node, newName);
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    emit nodeRenamed(node, oldName, newName);
+    return true;
+}
+
+Qt::ItemFlags SceneHierarchyModel::flags(const QModelIndex &index) const {
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+std::vector<SceneGraph::NodeId> SceneHierarchyModel::addObjects(SceneGraph::NodeId parent, int count, const QString &baseName) {
+    if (count <= 0 || !graph->isValid(parent))
+        return {};
+    int oldCount = graph->childCount(parent);
+    // Если у родителя подгружены не все строки, новые придут через fetchMore
+    bool visible = fetchedRows(parent) == oldCount
+            && (parent == SceneGraph::RootNode || indexForNode(parent).isValid());
+
+    if (visible)
+        beginInsertRows(indexForNode(parent), oldCount, oldCount + count - 1);
+    std::vector<SceneGraph::NodeId> created = scene->createObjects(parent, count, baseName);
+    fetched.resize(graph->capacity(), 0);
+    for (SceneGraph::NodeId node : created)
+        fetched[node] = 0; // Индекс мог быть переиспользован
+    if (visible) {
+        fetched[parent] += count;
+        endInsertRows();
+    }
+    return created;
+}
+
+void SceneHierarchyModel::removeNodes(const std::vector<SceneGraph::NodeId> &nodes, std::vector<SceneFragment> *removed) {
+    // Помечаем удаляемые узлы и отбрасываем те, чей предок тоже удаляется
+    std::vector<char> marked(graph->capacity(), 0);
+    for (SceneGraph::NodeId node : nodes) {
+        if (node != SceneGraph::RootNode && graph->isValid(node))
+            marked[node] = 1;
+    }
+
+    std::unordered_map<SceneGraph::NodeId, std::vector<int>> rowsByParent;
+    for (SceneGraph::NodeId node : nodes) {
+        if (node == SceneGraph::RootNode || !graph->isValid(node) || marked[node] != 1)
+            continue;
+        bool ancestorMarked = false;
+        for (SceneGraph::NodeId p = graph->parent(node); p != SceneGraph::RootNode; p = graph->parent(p)) {
+            if (marked[p]) {
+                ancestorMarked = true;
+                break;
+            }
+        }
+        marked[node] = 2; // Защита от дубликатов во входном списке
+        if (!ancestorMarked)
+            rowsByParent[graph->parent(node)].push_back(graph->row(node));
+    }
+
+    // Сущности всех диапазонов уничтожаются одним пакетом
+    Scene::RemovalBatch batch(*scene);
+    for (auto &entry : rowsByParent) {
+        SceneGraph::NodeId parentNode = entry.first;
+        std::vector<int> &rows = entry.second;
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+        // Удаляем непрерывные диапазоны строк с конца, чтобы не пересчитывать индексы
+        size_t i = 0;
+        while (i < rows.size()) {
+            int last = rows[i];
+            int first = last;
+            while (i + 1 < rows.size() && rows[i + 1] == first - 1) {
+                --first;
+                ++i;
+            }
+            ++i;
+
+            if (removed) {
+                removed->emplace_back();
+                removeChildren(parentNode, first, last - first + 1, &removed->back());
+            } else {
+                removeChildren(parentNode, first, last - first + 1);
+            }
+        }
+    }
+}
+
+void SceneHierarchyModel::removeChildren(SceneGraph::NodeId parent, int firstRow, int count, SceneFragment *removed) {
+    if (count <= 0 || firstRow < 0 || !graph->isValid(parent) || firstRow + count > graph->childCount(parent))
+        return;
+    const int last = firstRow + count - 1;
+    int visibleRows = fetchedRows(parent);
+    if (firstRow < visibleRows) {
+        int lastVisible = std::min(last, visibleRows - 1);
+        beginRemoveRows(indexForNode(parent), firstRow, lastVisible);
+        scene->removeChildren(parent, firstRow, count, removed);
+        fetched[parent] -= lastVisible - firstRow + 1;
+        endRemoveRows();
+    } else {
+        scene->removeChildren(parent, firstRow, count, removed);
+    }
+}
+
+bool SceneHierarchyModel::restoreChildren(const SceneFragment &fragment, SceneGraph::NodeId parentHint) {
+    const SceneGraph::NodeId parent = scene->node(fragment.parent, parentHint);
+    if (!fragment.isCaptured() || parent == SceneGraph::InvalidNode || fragment.firstRow > graph->childCount(parent))
+        return false;
+    // Строки видны, если вставляются среди уже отданных представлению; иначе придут через fetchMore
+    const int visibleRows = fetchedRows(parent);
+    const bool visible = (fragment.firstRow < visibleRows || visibleRows == graph->childCount(parent))
+            && (parent == SceneGraph::RootNode || indexForNode(parent).isValid());
+
+    if (visible)
+        beginInsertRows(indexForNode(parent), fragment.firstRow, fragment.firstRow + fragment.count - 1);
+    std::vector<SceneGraph::NodeId> restored = scene->restoreChildren(fragment, parent);
+    fetched.resize(graph->capacity(), 0);
+    for (SceneGraph::NodeId node : restored)
+        fetched[node] = 0; // Индекс мог быть переиспользован
+    if (visible) {
+        fetched[parent] += fragment.count;
+        endInsertRows();
+    }
+    return !restored.empty();
+}
+
+void SceneHierarchyModel::resetGraph(const std::function<void()> &change) {
+    beginResetModel();
+    if (change)
+        change();
+    fetched.assign(graph->capacity(), 0);
+    endResetModel();
+}
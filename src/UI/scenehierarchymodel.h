@@ -0,0 +1,58 @@
+#ifndef SCENEHIERARCHYMODEL_H
+#define SCENEHIERARCHYMODEL_H
+
+#include <QAbstractItemModel>
+#include <functional>
+#include <vector>
+#include "Scene/scene.h"
+#include "Scene/scenefragment.h"
+
+// Модель иерархии сцены поверх SceneGraph из Scene.
+// Строки отдаются представлению порциями через canFetchMore/fetchMore,
+// поэтому раскрытие узла с миллионом детей не создаёт миллион строк сразу.
+class SceneHierarchyModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    static constexpr int FetchBatchSize = 1024;
+
+    explicit SceneHierarchyModel(Scene *scene, QObject *parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    SceneGraph::NodeId nodeForIndex(const QModelIndex &index) const;
+    QModelIndex indexForNode(SceneGraph::NodeId node) const;
+
+    // Пакетные структурные изменения: одна пара begin/end на непрерывный диапазон строк
+    std::vector<SceneGraph::NodeId> addObjects(SceneGraph::NodeId parent, int count, const QString &baseName);
+    // Если removed задан, в него дописываются снятые поддеревья в порядке удаления — для отмены
+    void removeNodes(const std::vector<SceneGraph::NodeId> &nodes, std::vector<SceneFragment> *removed = nullptr);
+    void removeChildren(SceneGraph::NodeId parent, int firstRow, int count, SceneFragment *removed = nullptr);
+    // Возвращает поддеревья, снятые removeNodes/removeChildren, на прежние места;
+    // parentHint — как у Scene::restoreChildren
+    bool restoreChildren(const SceneFragment &fragment, SceneGraph::NodeId parentHint = SceneGraph::InvalidNode);
+    // Полная перестройка: change заменяет содержимое сцены (загрузка, новая сцена) внутри begin/endResetModel
+    void resetGraph(const std::function<void()> &change = std::function<void()>());
+
+signals:
+    // Переименование из представления или через setData; для истории правок
+    void nodeRenamed(SceneGraph::NodeId node, const QString &oldName, const QString &newName);
+
+private:
+    int fetchedRows(SceneGraph::NodeId node) const;
+
+    Scene *scene;
+    SceneGraph *graph;
+    std::vector<int> fetched; // Сколько детей каждого узла уже отдано представлению
+};
+
+#endif // SCENEHIERARCHYMODEL_H
@@ -0,0 +1,75 @@
+#include "sceneviewport.h"
+#include "Scene/components.h"
+#include "Scene/scene.h"
+#include "Core/profiler.h"
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <cmath>
+
+namespace {
+
+const uint32_t BackgroundColor = 0x333333; // Как фон прежней метки
+const uint32_t ObjectColor = 0x4F9BE8;
+
+} // namespace
+
+SceneViewport::SceneViewport(Scene *scene, QWidget *parent)
+    : QWidget(parent), scene(scene), cubeMesh(render::Mesh::cube()), yaw(35.0f), pitch(25.0f),
+      distance(12.0f), lastFrameNs(0) {
+    setAttribute(Qt::WA_OpaquePaintEvent); // Кадр закрывает весь виджет, фон не нужен
+    setMinimumSize(64, 64);
+}
+
+render::Mat4 SceneViewport::viewProjection() const {
+    const float toRadians = 3.14159265f / 180.0f;
+    const render::Vec3 eye(distance * std::cos(pitch * toRadians) * std::sin(yaw * toRadians),
+                           distance * std::sin(pitch * toRadians),
+                           distance * std::cos(pitch * toRadians) * std::cos(yaw * toRadians));
+    const float aspect = float(width()) / float(qMax(1, height()));
+    return render::Mat4::perspective(60.0f, aspect, 0.1f, 1000.0f)
+         * render::Mat4::lookAt(eye, render::Vec3(), render::Vec3(0.0f, 1.0f, 0.0f));
+}
+
+void SceneViewport::paintEvent(QPaintEvent *) {
+    SPECTER_PROFILE_SCOPE("SceneViewport::paint");
+    QElapsedTimer timer;
+    timer.start();
+    rasterizer.resize(width(), height());
+    rasterizer.beginFrame(viewProjection(), BackgroundColor);
+    scene->world().each<Transform>([this](Transform &transform) {
+        rasterizer.draw(cubeMesh, render::Mat4::fromTransform(transform.position, transform.rotation, transform.scale),
+                        ObjectColor);
+    });
+    rasterizer.render();
+
+    QPainter painter(this);
+    painter.drawImage(0, 0, rasterizer.image());
+    painter.setPen(QColor(212, 212, 212));
+    painter.drawText(rect().adjusted(8, 6, -8, -6), Qt::AlignTop | Qt::AlignLeft,
+                     QString("%1 / %2 triangles  %3 ms")
+                         .arg(rasterizer.visibleTriangles())
+                         .arg(rasterizer.submittedTriangles())
+                         .arg(lastFrameNs / 1e6, 0, 'f', 1));
+    lastFrameNs = timer.nsecsElapsed();
+}
+
+void SceneViewport::mousePressEvent(QMouseEvent *event) {
+    lastMousePos = event->pos();
+}
+
+void SceneViewport::mouseMoveEvent(QMouseEvent *event) {
+    if (!(event->buttons() & Qt::LeftButton))
+        return;
+    const QPoint delta = event->pos() - lastMousePos;
+    lastMousePos = event->pos();
+    yaw -= delta.x() * 0.4f;
+    pitch = qBound(-89.0f, pitch + delta.y() * 0.4f, 89.0f);
+    update();
+}
+
+void SceneViewport::wheelEvent(QWheelEvent *event) {
+    distance = qBound(1.0f, distance * std::pow(0.999f, float(event->angleDelta().y())), 500.0f);
+    update();
+}
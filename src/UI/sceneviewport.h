@@ -0,0 +1,40 @@
+#ifndef SCENEVIEWPORT_H
+#define SCENEVIEWPORT_H
+
+#include <QPoint>
+#include <QWidget>
+#include "Render/mesh.h"
+#include "Render/rasterizer.h"
+
+class Scene;
+
+// Окно сцены на программном растеризаторе: каждый объект с Transform рисуется кубом.
+// Кадр перерисовывается только по update() (изменение сцены, камера, размер окна),
+// готовый буфер выводится в QPainter без копирования.
+// Камера: ЛКМ — вращение вокруг цели, колесо — приближение
+class SceneViewport : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SceneViewport(Scene *scene, QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+
+private:
+    render::Mat4 viewProjection() const;
+
+    Scene *scene;
+    render::Rasterizer rasterizer;
+    render::Mesh cubeMesh;
+    float yaw;      // Градусы
+    float pitch;    // Градусы
+    float distance; // От камеры до цели
+    QPoint lastMousePos;
+    qint64 lastFrameNs;
+};
+
+#endif // SCENEVIEWPORT_H
@@ -1,47 +1,27 @@
 #include "startupdialog.h"
 #include "createprojectdialog.h"
+#include "startupsequence.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QApplication>
-#include <QStyleFactory>
 #include <QDebug>
-#include <QIcon>
 #include <QMouseEvent>
+#include <QSettings>
 
 StartupDialog::StartupDialog(QWidget* parent) : QDialog(parent) {
     setWindowTitle("Specter Game Engine");
     setFixedSize(450, 350);
 
-    // Установка иконки для окна
-    QIcon windowIcon(":/resources/SpecterEngineLogo.png");
-    if (!windowIcon.isNull()) {
-        setWindowIcon(windowIcon);
-    } else {
-        qWarning() << "Иконка приложения не найдена! Проверьте путь: /resources/SpecterEngineLogo.png";
-    }
+    setWindowIcon(EditorResources::windowIcon());
+    // Тёмная тема ставится приложением до создания окон (EditorApplication)
+    startup = new StartupSequence(this);
 
-    // Тёмная тема
-    qApp->setStyle(QStyleFactory::create("Fusion"));
-    QPalette darkPalette;
-    darkPalette.setColor(QPalette::Window, QColor(53, 53, 53));
-    darkPalette.setColor(QPalette::WindowText, Qt::white);
-    darkPalette.setColor(QPalette::Base, QColor(35, 35, 35));
-    darkPalette.setColor(QPalette::AlternateBase, QColor(53, 53, 53));
-    darkPalette.setColor(QPalette::ToolTipBase, Qt::white);
-    darkPalette.setColor(QPalette::ToolTipText, Qt::white);
-    darkPalette.setColor(QPalette::Text, Qt::white);
-    darkPalette.setColor(QPalette::Button, QColor(53, 53, 53));
-    darkPalette.setColor(QPalette::ButtonText, Qt::white);
-    darkPalette.setColor(QPalette::BrightText, Qt::red);
-    darkPalette.setColor(QPalette::Link, QColor(42, 130, 218));
-    darkPalette.setColor(QPalette::Highlight, QColor(42, 130, 218));
-    darkPalette.setColor(QPalette::HighlightedText, Qt::black);
-    qApp->setPalette(darkPalette);
-
-    // Настройки для хранения проектов
-    settings = new QSettings("../recent_projects.ini", QSettings::IniFormat, this);
+    // Недавние проекты: список из кэша, проверка путей в фоне
+    recentProjects = new RecentProjectStore(this);
+    connect(recentProjects, &RecentProjectStore::listChanged, this, &StartupDialog::loadRecentProjects);
+    connect(recentProjects, &RecentProjectStore::projectChanged, this, &StartupDialog::updateRecentProject);
 
     // Главный макет (вертикальный)
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
@@ -63,9 +43,9 @@ StartupDialog::StartupDialog(QWidget* parent) : QDialog(parent) {
     // Настройка кнопки "Create Project" с иконкой
     QVBoxLayout* createButtonLayout = new QVBoxLayout(createButton);
     QLabel* createIconLabel = new QLabel(this);
-    QPixmap createIcon(":/resources/create_icon.png");
+    const QPixmap createIcon = EditorResources::pixmap(":/resources/create_icon.png", 120);
     if (!createIcon.isNull()) {
-        createIconLabel->setPixmap(createIcon.scaled(120, 120, Qt::KeepAspectRatio));
+        createIconLabel->setPixmap(createIcon);
         createIconLabel->setAlignment(Qt::AlignCenter);
     } else {
         createIconLabel->setText("Icon missing");
@@ -79,9 +59,9 @@ StartupDialog::StartupDialog(QWidget* parent) : QDialog(parent) {
     // Настройка кнопки "Open Project" с иконкой
     QVBoxLayout* openButtonLayout = new QVBoxLayout(openButton);
     QLabel* openIconLabel = new QLabel(this);
-    QPixmap openIcon(":/resources/open_icon.png");
+    const QPixmap openIcon = EditorResources::pixmap(":/resources/open_icon.png", 120);
     if (!openIcon.isNull()) {
-        openIconLabel->setPixmap(openIcon.scaled(120, 120, Qt::KeepAspectRatio));
+        openIconLabel->setPixmap(openIcon);
         openIconLabel->setAlignment(Qt::AlignCenter);
     } else {
         openIconLabel->setText("Icon missing");
@@ -103,12 +83,9 @@ StartupDialog::StartupDialog(QWidget* parent) : QDialog(parent) {
     contentLayout->addLayout(buttonLayout);
     mainLayout->addLayout(contentLayout);
 
-    // Загрузка последних проектов
+    // Список строится из сохранённых данных сразу, к диску обращается только проверка после первого кадра
     loadRecentProjects();
-}
-
-StartupDialog::~StartupDialog() {
-    saveRecentProjects();
+    startup->defer([this]() { recentProjects->validate(); });
 }
 
 void StartupDialog::onCreateProjectClicked() {
@@ -116,9 +93,7 @@ void StartupDialog::onCreateProjectClicked() {
     if (dialog.exec() == QDialog::Accepted) {
         selectedProjectPath = dialog.getProjectPath();
         if (!selectedProjectPath.isEmpty()) {
-            loadRecentProjects();
-            emit projectSelected(selectedProjectPath); // Испускаем сигнал
-            accept();
+            openSelectedProject();
         }
     }
 }
@@ -134,26 +109,42 @@ void StartupDialog::onOpenProjectClicked() {
             return;
         }
         selectedProjectPath = dir;
-        loadRecentProjects();
-        emit projectSelected(selectedProjectPath); // Испускаем сигнал
-        accept();
+        openSelectedProject();
     }
 }
 
 void StartupDialog::onProjectSelected(int index) {
-    selectedProjectPath = projectWidgets[index]->findChild<QLabel*>()->toolTip();
+    const RecentProject project = recentProjects->projects().value(index);
+    if (project.status == RecentProject::Missing) {
+        const QMessageBox::StandardButton answer = QMessageBox::question(
+            this, "Project Not Found",
+            QString("No project found at %1.\nRemove it from the recent projects list?").arg(project.path));
+        if (answer == QMessageBox::Yes)
+            recentProjects->remove(project.path);
+        return;
+    }
+    selectedProjectPath = project.path;
+    openSelectedProject();
+}
+
+void StartupDialog::openSelectedProject() {
+    // Выбранный проект существует: имя берём из его config.cfg
+    QSettings config(selectedProjectPath + "/config.cfg", QSettings::IniFormat);
+    recentProjects->touch(selectedProjectPath, config.value("Project/Name").toString());
     emit projectSelected(selectedProjectPath); // Испускаем сигнал
     accept();
 }
 
 void StartupDialog::loadRecentProjects() {
+    // deleteLater: список пересобирается и из обработчика щелчка по одной из строк
     for (auto* widget : projectWidgets) {
         projectsLayout->removeWidget(widget);
-        delete widget;
+        widget->hide();
+        widget->deleteLater();
     }
     projectWidgets.clear();
 
-    QStringList projects = settings->value("recent_projects").toStringList();
+    const QVector<RecentProject>& projects = recentProjects->projects();
     if (projects.isEmpty()) {
         projectsWidget->hide();
         return;
@@ -162,13 +153,8 @@ void StartupDialog::loadRecentProjects() {
     projectsWidget->show();
 
     for (int i = 0; i < projects.size(); ++i) {
-        QStringList parts = projects[i].split("|");
-        if (parts.size() != 2) continue;
-
-        QString name = parts[0];
-        QString path = parts[1];
-
-        ProjectWidget* projectWidget = new ProjectWidget(name, path, i, this);
+        ProjectWidget* projectWidget = new ProjectWidget(i, this);
+        projectWidget->setProject(projects[i]);
         projectsLayout->addWidget(projectWidget);
         projectWidgets.append(projectWidget);
 
@@ -176,13 +162,7 @@ void StartupDialog::loadRecentProjects() {
     }
 }
 
-void StartupDialog::saveRecentProjects() {
-    QStringList projects;
-    for (const auto* widget : projectWidgets) {
-        QLabel* label = widget->findChild<QLabel*>();
-        QString name = label->text().split("\n")[0];
-        QString path = label->toolTip();
-        projects << name + "|" + path;
-    }
-    settings->setValue("recent_projects", projects);
-}
\ No newline at end of file
+void StartupDialog::updateRecentProject(int index) {
+    if (index >= 0 && index < projectWidgets.size())
+        projectWidgets[index]->setProject(recentProjects->projects()[index]);
+}
@@ -4,27 +4,26 @@
 #include <QDialog>
 #include <QLabel>
 #include <QPushButton>
-#include <QSettings>
+#include <QFileInfo>
 #include <QVBoxLayout>
+#include "editorresources.h"
+#include "recentprojects.h"
 
+class StartupSequence;
+
+// Строка недавнего проекта: логотип или значок папки, имя, путь и состояние проверки
 class ProjectWidget : public QWidget {
     Q_OBJECT
 public:
-    explicit ProjectWidget(const QString& name, const QString& path, int index, QWidget* parent = nullptr)
+    explicit ProjectWidget(int index, QWidget* parent = nullptr)
         : QWidget(parent), index_(index) {
         QHBoxLayout* layout = new QHBoxLayout(this);
-        QLabel* iconLabel = new QLabel(this);
-        QPixmap folderIcon(":/resources/folder_icon.png");
-        if (!folderIcon.isNull()) {
-            iconLabel->setPixmap(folderIcon.scaled(16, 16, Qt::KeepAspectRatio));
-        } else {
-            iconLabel->setText("[Icon]");
-        }
+        iconLabel = new QLabel(this);
+        iconLabel->setFixedSize(RecentProjectStore::LogoSize, RecentProjectStore::LogoSize);
+        iconLabel->setAlignment(Qt::AlignCenter);
         layout->addWidget(iconLabel);
 
-        QLabel* textLabel = new QLabel(QString("%1\n%2").arg(name, path), this);
-        textLabel->setStyleSheet("color: white;");
-        textLabel->setToolTip(path);
+        textLabel = new QLabel(this);
         textLabel->setWordWrap(true);
         layout->addWidget(textLabel);
         layout->addStretch();
@@ -32,6 +31,30 @@ public:
         setCursor(Qt::PointingHandCursor);
     }
 
+    void setProject(const RecentProject& project) {
+        if (!project.logo.isNull()) {
+            iconLabel->setPixmap(QPixmap::fromImage(project.logo));
+        } else {
+            const QPixmap folderIcon = EditorResources::pixmap(":/resources/folder_icon.png", 16);
+            if (!folderIcon.isNull()) {
+                iconLabel->setPixmap(folderIcon);
+            } else {
+                iconLabel->setText("[Icon]");
+            }
+        }
+
+        QString state;
+        if (project.status == RecentProject::Missing)
+            state = " (not found)";
+        else if (project.status == RecentProject::Unreachable)
+            state = " (not responding)";
+        const QString name = project.name.isEmpty() ? QFileInfo(project.path).fileName() : project.name;
+        textLabel->setText(QString("%1%2\n%3").arg(name, state, project.path));
+        const bool available = project.status == RecentProject::Available || project.status == RecentProject::Unknown;
+        textLabel->setStyleSheet(available ? "color: white;" : "color: gray;");
+        setToolTip(project.path);
+    }
+
     int index() const { return index_; }
 
 signals:
@@ -45,6 +68,8 @@ protected:
 
 private:
     int index_;
+    QLabel* iconLabel;
+    QLabel* textLabel;
 };
 
 class StartupDialog : public QDialog {
@@ -52,9 +77,9 @@ class StartupDialog : public QDialog {
 
 public:
     explicit StartupDialog(QWidget* parent = nullptr);
-    ~StartupDialog();
 
     QString getSelectedProjectPath() const { return selectedProjectPath; }
+    StartupSequence *startupSequence() const { return startup; }
 
 signals:
     void projectSelected(const QString &path); // Сигнал для открытия редактора
@@ -66,12 +91,14 @@ private slots:
 
 private:
     void loadRecentProjects();
-    void saveRecentProjects();
+    void updateRecentProject(int index);
+    void openSelectedProject();
 
     QPushButton* createButton;
     QPushButton* openButton;
     QString selectedProjectPath;
-    QSettings* settings;
+    RecentProjectStore* recentProjects;
+    StartupSequence* startup; // Проверка недавних проектов начинается после первого кадра
 
     // Для списка проектов
     QVBoxLayout* projectsLayout;
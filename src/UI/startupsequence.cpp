@@ -0,0 +1,70 @@
+#include "startupsequence.h"
+#include "Core/profiler.h"
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QTimer>
+#include <QWidget>
+
+StartupSequence::StartupSequence(QWidget *window)
+    : QObject(window), window(window), painted(false), scheduled(false), running(false), reportedInteractive(false) {
+    window->installEventFilter(this);
+}
+
+qint64 StartupSequence::sinceLaunch() {
+    static QElapsedTimer clock = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+void StartupSequence::defer(std::function<void()> task) {
+    tasks.push_back(std::move(task));
+    if (painted)
+        schedule();
+}
+
+bool StartupSequence::eventFilter(QObject *watched, QEvent *event) {
+    if (watched == window && event->type() == QEvent::Paint && !painted) {
+        // Само окно ещё рисуется: отмечаем кадр, когда цикл событий вернётся
+        window->removeEventFilter(this);
+        QTimer::singleShot(0, this, &StartupSequence::onPainted);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void StartupSequence::onPainted() {
+    painted = true;
+    emit firstFrame(sinceLaunch());
+    schedule();
+}
+
+void StartupSequence::schedule() {
+    if (scheduled)
+        return;
+    scheduled = true;
+    QTimer::singleShot(0, this, &StartupSequence::runNext);
+}
+
+void StartupSequence::runNext() {
+    scheduled = false;
+    if (!tasks.empty()) {
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        running = true;
+        {
+            SPECTER_PROFILE_SCOPE("StartupSequence::task");
+            task();
+        }
+        running = false;
+        if (!tasks.empty()) {
+            schedule();
+            return;
+        }
+    }
+    if (!reportedInteractive) {
+        reportedInteractive = true;
+        emit interactive(sinceLaunch());
+    }
+}
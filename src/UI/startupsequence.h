@@ -0,0 +1,49 @@
+#ifndef STARTUPSEQUENCE_H
+#define STARTUPSEQUENCE_H
+
+#include <QObject>
+#include <deque>
+#include <functional>
+
+class QWidget;
+
+// Порядок запуска окна: сначала первый кадр, потом всё остальное.
+// Отложенные задачи начинают выполняться после первой отрисовки окна, по одной за проход
+// цикла событий, чтобы ввод между ними не ждал. Когда очередь опустела, окно готово к работе.
+// Время отсчитывается от запуска процесса (sinceLaunch)
+class StartupSequence : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StartupSequence(QWidget *window);
+
+    // Наносекунды с первого вызова; main вызывает его первым делом
+    static qint64 sinceLaunch();
+
+    // Задача на время после первого кадра; после него — на ближайший проход цикла событий
+    void defer(std::function<void()> task);
+
+    bool hasFirstFrame() const { return painted; }
+    bool isInteractive() const { return painted && tasks.empty() && !running; }
+
+signals:
+    void firstFrame(qint64 nanoseconds);
+    void interactive(qint64 nanoseconds);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void onPainted();
+    void schedule();
+    void runNext();
+
+    QWidget *window;
+    std::deque<std::function<void()>> tasks;
+    bool painted;
+    bool scheduled;
+    bool running;
+    bool reportedInteractive;
+};
+
+#endif // STARTUPSEQUENCE_H
@@ -1,9 +1,15 @@
 #include "UI/startupdialog.h"
 #include "UI/editorwindow.h"
-#include <QApplication>
+#include "UI/editorapplication.h"
+#include "UI/startupsequence.h"
+#include "Core/profiler.h"
 
 int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+    StartupSequence::sinceLaunch(); // Точка отсчёта времени запуска
+    EditorApplication app(argc, argv);
+    core::Profiler::setThreadName("Main");
+    // SPECTER_TRACE_FILE=trace.json — профилирование самого редактора с запуска
+    core::Profiler::startFromEnvironment();
 
     StartupDialog startupDialog;
     startupDialog.show();